@@ -12,6 +12,9 @@ extern "C" {
 
 #define TCP_NODELAY 10
 #define TCP_MAXSEG 11
+#define TCP_CONGESTION 13
+
+#define TCP_CA_NAME_MAX 16
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EVENT_POLL_CLOEXEC (1u << 0)
+
+#define EVENT_POLL_CTL_ADD 1
+#define EVENT_POLL_CTL_DEL 2
+#define EVENT_POLL_CTL_MOD 3
+
+/* The interest mask of an event poll entry consists of the POLL* bits from <poll.h>,
+ * optionally combined with EVENT_POLL_EDGE_TRIGGERED. */
+#define EVENT_POLL_EDGE_TRIGGERED (1u << 31)
+
+struct event_poll_event {
+    unsigned events;
+    uint64_t data;
+};
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* The most submission entries a ring can have. There are always twice as many completion entries. */
+#define IO_RING_MAX_ENTRIES 256
+
+#define IO_RING_CLOEXEC 1
+
+#define IO_RING_OP_NOP 0
+/* Reads `length` bytes into `address`, from `offset` or the current file offset if it is IO_RING_CURRENT_OFFSET. */
+#define IO_RING_OP_READ 1
+/* Writes `length` bytes from `address`, at `offset` or the current file offset if it is IO_RING_CURRENT_OFFSET. */
+#define IO_RING_OP_WRITE 2
+/* Accepts a connection, `address` and `length` point to a sockaddr and socklen_t like for accept(). `flags` takes SOCK_NONBLOCK and SOCK_CLOEXEC. */
+#define IO_RING_OP_ACCEPT 3
+/* Connects to the sockaddr at `address`, which is `length` bytes long. */
+#define IO_RING_OP_CONNECT 4
+/* Sends `length` bytes from `address`, with the MSG_* `flags`. */
+#define IO_RING_OP_SEND 5
+/* Receives up to `length` bytes into `address`, with the MSG_* `flags`. */
+#define IO_RING_OP_RECV 6
+#define IO_RING_OP_FSYNC 7
+/* Completes with -ETIMEDOUT after `offset` nanoseconds. */
+#define IO_RING_OP_TIMEOUT 8
+/* Completes with the POLL* events that are ready, once any of the ones in `offset` are. */
+#define IO_RING_OP_POLL 9
+/* Cancels the pending operation whose user_data is `offset`. */
+#define IO_RING_OP_CANCEL 10
+
+#define IO_RING_CURRENT_OFFSET ((uint64_t)-1)
+
+struct io_ring_submission {
+    uint8_t opcode;
+    uint8_t reserved[3];
+    int32_t fd;
+    uint64_t offset;
+    uint64_t address;
+    uint64_t length;
+    uint32_t flags;
+    uint32_t reserved2;
+    uint64_t user_data;
+};
+
+struct io_ring_completion {
+    uint64_t user_data;
+    /* The result of the operation, or a negated errno code. */
+    int64_t result;
+};
+
+/* This sits at the start of the ring's shared memory, which is mapped by calling mmap() on the ring's fd.
+ * Userspace adds submissions at submission_tail, and the kernel consumes them from submission_head.
+ * The kernel adds completions at completion_tail, and userspace consumes them from completion_head.
+ * The indices only ever grow, and are masked with (entries - 1) to find the corresponding array slot. */
+struct io_ring_header {
+    uint32_t submission_head;
+    uint32_t submission_tail;
+    uint32_t completion_head;
+    uint32_t completion_tail;
+    uint32_t submission_entries;
+    uint32_t completion_entries;
+    /* Offsets of the submission and completion arrays from the start of the mapping. */
+    uint32_t submissions_offset;
+    uint32_t completions_offset;
+    uint32_t mapping_size;
+};
+
+#ifdef __cplusplus
+}
+#endif
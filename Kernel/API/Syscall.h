@@ -10,6 +10,7 @@
 #include <AK/Types.h>
 #include <AK/Userspace.h>
 #include <Kernel/API/POSIX/sched.h>
+#include <Kernel/API/POSIX/signal.h>
 
 #ifdef KERNEL
 #    include <AK/Error.h>
@@ -17,6 +18,7 @@
 #endif
 
 extern "C" {
+struct event_poll_event;
 struct pollfd;
 struct timeval;
 struct timespec;
@@ -62,13 +64,17 @@ enum class NeedsBigProcessLock {
     S(close, NeedsBigProcessLock::No)                      \
     S(connect, NeedsBigProcessLock::No)                    \
     S(copy_mount, NeedsBigProcessLock::No)                 \
+    S(create_event_poll, NeedsBigProcessLock::No)          \
     S(create_inode_watcher, NeedsBigProcessLock::No)       \
+    S(create_io_ring, NeedsBigProcessLock::No)             \
     S(create_thread, NeedsBigProcessLock::No)              \
     S(dbgputstr, NeedsBigProcessLock::No)                  \
     S(detach_thread, NeedsBigProcessLock::No)              \
     S(disown, NeedsBigProcessLock::No)                     \
     S(dump_backtrace, NeedsBigProcessLock::No)             \
     S(dup2, NeedsBigProcessLock::No)                       \
+    S(event_poll_ctl, NeedsBigProcessLock::No)             \
+    S(event_poll_wait, NeedsBigProcessLock::No)            \
     S(execve, NeedsBigProcessLock::Yes)                    \
     S(exit, NeedsBigProcessLock::Yes)                      \
     S(exit_thread, NeedsBigProcessLock::Yes)               \
@@ -84,7 +90,7 @@ enum class NeedsBigProcessLock {
     S(fsmount, NeedsBigProcessLock::No)                    \
     S(fsync, NeedsBigProcessLock::No)                      \
     S(ftruncate, NeedsBigProcessLock::No)                  \
-    S(futex, NeedsBigProcessLock::Yes)                     \
+    S(futex, NeedsBigProcessLock::No)                     \
     S(futimens, NeedsBigProcessLock::No)                   \
     S(get_dir_entries, NeedsBigProcessLock::No)            \
     S(get_root_session_id, NeedsBigProcessLock::No)        \
@@ -112,6 +118,7 @@ enum class NeedsBigProcessLock {
     S(getuid, NeedsBigProcessLock::No)                     \
     S(inode_watcher_add_watch, NeedsBigProcessLock::No)    \
     S(inode_watcher_remove_watch, NeedsBigProcessLock::No) \
+    S(io_ring_enter, NeedsBigProcessLock::No)              \
     S(ioctl, NeedsBigProcessLock::No)                      \
     S(join_thread, NeedsBigProcessLock::No)                \
     S(kill, NeedsBigProcessLock::No)                       \
@@ -136,26 +143,28 @@ enum class NeedsBigProcessLock {
     S(pledge, NeedsBigProcessLock::No)                     \
     S(poll, NeedsBigProcessLock::No)                       \
     S(posix_fallocate, NeedsBigProcessLock::No)            \
+    S(posix_spawn, NeedsBigProcessLock::No)                \
     S(prctl, NeedsBigProcessLock::No)                      \
     S(profiling_disable, NeedsBigProcessLock::Yes)         \
     S(profiling_enable, NeedsBigProcessLock::Yes)          \
     S(profiling_free_buffer, NeedsBigProcessLock::Yes)     \
     S(ptrace, NeedsBigProcessLock::Yes)                    \
     S(purge, NeedsBigProcessLock::Yes)                     \
-    S(read, NeedsBigProcessLock::Yes)                      \
-    S(pread, NeedsBigProcessLock::Yes)                     \
+    S(read, NeedsBigProcessLock::No)                       \
+    S(pread, NeedsBigProcessLock::No)                      \
     S(readlink, NeedsBigProcessLock::No)                   \
-    S(readv, NeedsBigProcessLock::Yes)                     \
+    S(readv, NeedsBigProcessLock::No)                      \
     S(realpath, NeedsBigProcessLock::No)                   \
     S(recvfd, NeedsBigProcessLock::No)                     \
-    S(recvmsg, NeedsBigProcessLock::Yes)                   \
+    S(recvmsg, NeedsBigProcessLock::No)                    \
     S(rename, NeedsBigProcessLock::No)                     \
     S(remount, NeedsBigProcessLock::No)                    \
     S(rmdir, NeedsBigProcessLock::No)                      \
     S(scheduler_get_parameters, NeedsBigProcessLock::No)   \
     S(scheduler_set_parameters, NeedsBigProcessLock::No)   \
     S(sendfd, NeedsBigProcessLock::No)                     \
-    S(sendmsg, NeedsBigProcessLock::Yes)                   \
+    S(sendfile, NeedsBigProcessLock::Yes)                  \
+    S(sendmsg, NeedsBigProcessLock::No)                    \
     S(set_mmap_name, NeedsBigProcessLock::No)              \
     S(setegid, NeedsBigProcessLock::No)                    \
     S(seteuid, NeedsBigProcessLock::No)                    \
@@ -197,8 +206,8 @@ enum class NeedsBigProcessLock {
     S(utime, NeedsBigProcessLock::No)                      \
     S(utimensat, NeedsBigProcessLock::No)                  \
     S(waitid, NeedsBigProcessLock::Yes)                    \
-    S(write, NeedsBigProcessLock::Yes)                     \
-    S(pwritev, NeedsBigProcessLock::Yes)                   \
+    S(write, NeedsBigProcessLock::No)                      \
+    S(pwritev, NeedsBigProcessLock::No)                    \
     S(yield, NeedsBigProcessLock::No)
 
 namespace Syscall {
@@ -264,6 +273,34 @@ struct SC_poll_params {
     u32 const* sigmask;
 };
 
+struct SC_sendfile_params {
+    int out_fd;
+    int in_fd;
+    off_t* offset;
+    size_t count;
+};
+
+struct SC_event_poll_ctl_params {
+    int event_poll_fd;
+    int op;
+    int fd;
+    struct event_poll_event const* event;
+};
+
+struct SC_event_poll_wait_params {
+    int event_poll_fd;
+    struct event_poll_event* events;
+    int max_events;
+    const struct timespec* timeout;
+};
+
+struct SC_io_ring_enter_params {
+    int ring_fd;
+    unsigned to_submit;
+    unsigned min_complete;
+    const struct timespec* timeout;
+};
+
 struct SC_clock_nanosleep_params {
     int clock_id;
     int flags;
@@ -391,6 +428,39 @@ struct SC_execve_params {
     StringListArgument environment;
 };
 
+enum class SpawnFileActionType : u32 {
+    Open,
+    Close,
+    Dup2,
+    Chdir,
+    Fchdir,
+};
+
+struct SpawnFileAction {
+    SpawnFileActionType type;
+    int fd;
+    // The fd that Dup2 duplicates fd onto.
+    int new_fd;
+    int options;
+    u16 mode;
+    // The path to open, or to change into.
+    StringArgument path;
+};
+
+struct SC_posix_spawn_params {
+    StringArgument path;
+    StringListArgument arguments;
+    StringListArgument environment;
+    SpawnFileAction const* file_actions;
+    size_t file_actions_count;
+    // The POSIX_SPAWN_* attribute flags, and the attributes they enable.
+    int flags;
+    pid_t pgroup;
+    int sched_priority;
+    sigset_t sigdefault;
+    sigset_t sigmask;
+};
+
 struct SC_readlink_params {
     StringArgument path;
     MutableBufferArgument<char, size_t> buffer;
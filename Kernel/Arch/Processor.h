@@ -29,6 +29,7 @@ enum class InterruptsState {
 
 namespace Memory {
 class PageDirectory;
+class VirtualRange;
 }
 
 struct TrapFrame;
@@ -68,6 +69,10 @@ public:
 
     static void flush_tlb_local(VirtualAddress vaddr, size_t page_count);
     static void flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    // Flushes several ranges of a page directory with a single round of IPIs.
+    static void flush_tlb(Memory::PageDirectory const*, ReadonlySpan<Memory::VirtualRange>);
+    // Flushes all user mappings of a page directory, for when invalidating them page by page would take longer.
+    static void flush_entire_tlb(Memory::PageDirectory const*);
 
     static void flush_instruction_cache(VirtualAddress vaddr, size_t byte_count);
 
@@ -253,8 +258,9 @@ struct ProcessorMessage {
         alignas(CallbackFunction) u8 callback_storage[sizeof(CallbackFunction)];
         struct {
             Memory::PageDirectory const* page_directory;
-            u8* ptr;
-            size_t page_count;
+            Memory::VirtualRange const* ranges;
+            // Zero means all user mappings of the page directory.
+            size_t range_count;
         } flush_tlb;
     };
 
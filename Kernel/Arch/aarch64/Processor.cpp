@@ -96,6 +96,19 @@ void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, VirtualAddress va
     flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, ReadonlySpan<Memory::VirtualRange>)
+{
+    // flush_tlb_local() flushes everything anyway.
+    flush_entire_tlb_local();
+}
+
+template<typename T>
+void ProcessorBase<T>::flush_entire_tlb(Memory::PageDirectory const*)
+{
+    flush_entire_tlb_local();
+}
+
 template<typename T>
 void ProcessorBase<T>::flush_instruction_cache(VirtualAddress vaddr, size_t byte_count)
 {
@@ -8,6 +8,7 @@
 #include <Kernel/Arch/Processor.h>
 #include <Kernel/Arch/TrapFrame.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
+#include <Kernel/Memory/VirtualRange.h>
 #include <Kernel/Sections.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/Process.h>
@@ -167,6 +168,19 @@ void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, VirtualAddress va
     flush_tlb_local(vaddr, page_count);
 }
 
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const*, ReadonlySpan<Memory::VirtualRange> ranges)
+{
+    for (auto const& range : ranges)
+        flush_tlb_local(range.base(), range.size() / PAGE_SIZE);
+}
+
+template<typename T>
+void ProcessorBase<T>::flush_entire_tlb(Memory::PageDirectory const*)
+{
+    flush_entire_tlb_local();
+}
+
 template<typename T>
 void ProcessorBase<T>::flush_instruction_cache(VirtualAddress, size_t)
 {
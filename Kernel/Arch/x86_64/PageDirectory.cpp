@@ -47,12 +47,16 @@ LockRefPtr<PageDirectory> PageDirectory::find_current()
 
 void activate_kernel_page_directory(PageDirectory const& pgd)
 {
+    Processor::set_active_page_directory(pgd.cr3());
+    full_memory_barrier();
     write_cr3(pgd.cr3());
 }
 
 void activate_page_directory(PageDirectory const& pgd, Thread* current_thread)
 {
     current_thread->regs().cr3 = pgd.cr3();
+    Processor::set_active_page_directory(pgd.cr3());
+    full_memory_barrier();
     write_cr3(pgd.cr3());
 }
 
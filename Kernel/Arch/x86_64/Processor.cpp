@@ -33,6 +33,7 @@
 
 #include <Kernel/Arch/PageDirectory.h>
 #include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 
 namespace Kernel {
 
@@ -847,10 +848,33 @@ void ProcessorBase<T>::flush_entire_tlb_local()
 template<typename T>
 void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
 {
-    if (s_smp_enabled && (!Memory::is_user_address(vaddr) || Process::current().thread_count() > 1))
-        Processor::smp_broadcast_flush_tlb(page_directory, vaddr, page_count);
-    else
-        flush_tlb_local(vaddr, page_count);
+    Memory::VirtualRange range { vaddr, page_count * PAGE_SIZE };
+    flush_tlb(page_directory, { &range, 1 });
+}
+
+template<typename T>
+void ProcessorBase<T>::flush_tlb(Memory::PageDirectory const* page_directory, ReadonlySpan<Memory::VirtualRange> ranges)
+{
+    VERIFY(!ranges.is_empty());
+    if (s_smp_enabled) {
+        Processor::smp_broadcast_flush_tlb(page_directory, ranges);
+        return;
+    }
+    ++Memory::g_tlb_shootdown_statistics.local_flushes;
+    for (auto const& range : ranges)
+        flush_tlb_local(range.base(), range.size() / PAGE_SIZE);
+}
+
+template<typename T>
+void ProcessorBase<T>::flush_entire_tlb(Memory::PageDirectory const* page_directory)
+{
+    if (s_smp_enabled) {
+        Processor::smp_broadcast_flush_tlb(page_directory, {});
+        return;
+    }
+    ++Memory::g_tlb_shootdown_statistics.local_flushes;
+    if (read_cr3() == page_directory->cr3())
+        flush_entire_tlb_local();
 }
 
 template<typename T>
@@ -1017,19 +1041,28 @@ bool Processor::smp_process_pending_messages()
             case ProcessorMessage::Callback:
                 msg->invoke_callback();
                 break;
-            case ProcessorMessage::FlushTlb:
-                if (Memory::is_user_address(VirtualAddress(msg->flush_tlb.ptr))) {
-                    // We assume that we don't cross into kernel land!
-                    VERIFY(Memory::is_user_range(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count * PAGE_SIZE));
+            case ProcessorMessage::FlushTlb: {
+                ReadonlySpan<Memory::VirtualRange> ranges { msg->flush_tlb.ranges, msg->flush_tlb.range_count };
+                if (ranges.is_empty() || Memory::is_user_address(ranges.first().base())) {
                     if (read_cr3() != msg->flush_tlb.page_directory->cr3()) {
                         // This processor isn't using this page directory right now, we can ignore this request
-                        dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} pages at {}", current_id(), msg->flush_tlb.page_count, VirtualAddress(msg->flush_tlb.ptr));
+                        dbgln_if(SMP_DEBUG, "SMP[{}]: No need to flush {} ranges", current_id(), ranges.size());
                         break;
                     }
                 }
-                flush_tlb_local(VirtualAddress(msg->flush_tlb.ptr), msg->flush_tlb.page_count);
+                if (ranges.is_empty()) {
+                    flush_entire_tlb_local();
+                    break;
+                }
+                for (auto const& range : ranges) {
+                    // We assume that we don't cross into kernel land!
+                    if (Memory::is_user_address(ranges.first().base()))
+                        VERIFY(Memory::is_user_range(range));
+                    flush_tlb_local(range.base(), range.size() / PAGE_SIZE);
+                }
                 break;
             }
+            }
 
             bool is_async = msg->async; // Need to cache this value *before* dropping the ref count!
             auto prev_refs = msg->refs.fetch_sub(1u, AK::MemoryOrder::memory_order_acq_rel);
@@ -1097,6 +1130,18 @@ void Processor::smp_broadcast_message(ProcessorMessage& msg)
         APIC::the().broadcast_ipi();
 }
 
+void Processor::smp_multicast_message(ProcessorMessage& msg, u64 processor_mask)
+{
+    VERIFY(!(processor_mask & (1ull << current_id())));
+    msg.refs.store(popcount(processor_mask), AK::MemoryOrder::memory_order_release);
+    VERIFY(msg.refs > 0);
+    for_each(
+        [&](Processor& proc) {
+            if ((processor_mask & (1ull << proc.id())) && proc.smp_enqueue_message(msg))
+                APIC::the().send_ipi(proc.id());
+        });
+}
+
 void Processor::smp_broadcast_wait_sync(ProcessorMessage& msg)
 {
     auto& cur_proc = Processor::current();
@@ -1155,19 +1200,63 @@ void Processor::smp_unicast(u32 cpu, Function<void()> callback, bool async)
     smp_unicast_message(cpu, msg, async);
 }
 
-void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, VirtualAddress vaddr, size_t page_count)
+void Processor::smp_broadcast_flush_tlb(Memory::PageDirectory const* page_directory, ReadonlySpan<Memory::VirtualRange> ranges)
 {
-    auto& msg = smp_get_from_pool();
-    msg.async = false;
-    msg.type = ProcessorMessage::FlushTlb;
-    msg.flush_tlb.page_directory = page_directory;
-    msg.flush_tlb.ptr = vaddr.as_ptr();
-    msg.flush_tlb.page_count = page_count;
-    smp_broadcast_message(msg);
+    ScopedCritical critical;
+    auto& statistics = Memory::g_tlb_shootdown_statistics;
+    bool is_user_flush = ranges.is_empty() || Memory::is_user_address(ranges.first().base());
+
+    // Kernel mappings are shared by all page directories, so every processor has to flush them.
+    // For user mappings, we only have to interrupt the processors that are running on this page directory.
+    // NOTE: The page tables have already been changed. A processor that switches to this page directory
+    //       after we've looked at it can only ever see the new entries, so make sure our changes are visible first.
+    full_memory_barrier();
+    u64 processor_mask = 0;
+    size_t other_processor_count = 0;
+    for_each(
+        [&](Processor& proc) {
+            if (&proc == &Processor::current())
+                return;
+            ++other_processor_count;
+            auto active_cr3 = proc.m_active_cr3.load();
+            if (is_user_flush && active_cr3 != 0 && active_cr3 != page_directory->cr3())
+                return;
+            processor_mask |= 1ull << proc.id();
+        });
+
+    size_t target_count = popcount(processor_mask);
+    statistics.ipis_avoided += other_processor_count - target_count;
+
+    ProcessorMessage* msg = nullptr;
+    if (processor_mask != 0) {
+        ++statistics.shootdowns;
+        statistics.ipis_sent += target_count;
+        msg = &smp_get_from_pool();
+        msg->async = false;
+        msg->type = ProcessorMessage::FlushTlb;
+        msg->flush_tlb.page_directory = page_directory;
+        msg->flush_tlb.ranges = ranges.data();
+        msg->flush_tlb.range_count = ranges.size();
+        if (target_count == other_processor_count)
+            smp_broadcast_message(*msg);
+        else
+            smp_multicast_message(*msg, processor_mask);
+    } else {
+        ++statistics.local_flushes;
+    }
+
     // While the other processors handle this request, we'll flush ours
-    flush_tlb_local(vaddr, page_count);
+    if (ranges.is_empty()) {
+        if (read_cr3() == page_directory->cr3())
+            flush_entire_tlb_local();
+    } else {
+        for (auto const& range : ranges)
+            flush_tlb_local(range.base(), range.size() / PAGE_SIZE);
+    }
+
     // Now wait until everybody is done as well
-    smp_broadcast_wait_sync(msg);
+    if (msg)
+        smp_broadcast_wait_sync(*msg);
 }
 
 void Processor::smp_broadcast_halt()
@@ -1274,8 +1363,12 @@ extern "C" void enter_thread_context(Thread* from_thread, Thread* to_thread)
     auto& processor = Processor::current();
     Processor::set_fs_base(to_thread->arch_specific_data().fs_base);
 
-    if (from_regs.cr3 != to_regs.cr3)
+    if (from_regs.cr3 != to_regs.cr3) {
+        // This has to be visible before we start using the new page directory, see smp_broadcast_flush_tlb().
+        Processor::set_active_page_directory(to_regs.cr3);
+        full_memory_barrier();
         write_cr3(to_regs.cr3);
+    }
 
     to_thread->set_cpu(processor.id());
 
@@ -79,6 +79,11 @@ private:
 
     Atomic<ProcessorMessageEntry*> m_message_queue;
 
+    // The page directory this processor is running on, or zero if we don't know yet.
+    // We don't use PCIDs, so loading CR3 flushes all user mappings: Processors that are
+    // running on a different page directory have nothing to flush when it changes.
+    Atomic<FlatPtr, AK::MemoryOrder::memory_order_relaxed> m_active_cr3 { 0 };
+
     void gdt_init();
     void write_raw_gdt_entry(u16 selector, u32 low, u32 high);
     void write_gdt_entry(u16 selector, Descriptor& descriptor);
@@ -90,6 +95,7 @@ private:
     bool smp_enqueue_message(ProcessorMessage&);
     static void smp_unicast_message(u32 cpu, ProcessorMessage& msg, bool async);
     static void smp_broadcast_message(ProcessorMessage& msg);
+    static void smp_multicast_message(ProcessorMessage& msg, u64 processor_mask);
     static void smp_broadcast_wait_sync(ProcessorMessage& msg);
     static void smp_broadcast_halt();
 
@@ -153,7 +159,8 @@ public:
     bool smp_process_pending_messages();
 
     static void smp_unicast(u32 cpu, Function<void()>, bool async);
-    static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, VirtualAddress, size_t);
+    static void smp_broadcast_flush_tlb(Memory::PageDirectory const*, ReadonlySpan<Memory::VirtualRange>);
+    static void set_active_page_directory(FlatPtr cr3) { current().m_active_cr3 = cr3; }
 
     static void set_fs_base(FlatPtr);
 };
@@ -62,6 +62,11 @@ public:
 
     [[nodiscard]] RequestWaitResult wait(Duration* = nullptr);
 
+    // NOTE: Requests only leave the pending state in do_start(), which is called with the device's request lock held.
+    [[nodiscard]] bool is_pending() const { return m_result == Pending; }
+
+    RequestResult get_request_result() const;
+
     void do_start(SpinlockLocker<Spinlock<LockRank::None>>&& requests_lock)
     {
         if (is_completed_result(m_result))
@@ -132,8 +137,6 @@ public:
 protected:
     AsyncDeviceRequest(Device&);
 
-    RequestResult get_request_result() const;
-
 private:
     void sub_request_finished(AsyncDeviceRequest&);
     void request_finished();
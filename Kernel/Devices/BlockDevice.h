@@ -28,6 +28,11 @@ public:
 
     virtual void start_request(AsyncBlockDeviceRequest&) = 0;
 
+    // While a device is plugged, it holds back new requests, so that a batch of them can be merged before any is sent.
+    // Plugs nest, and every plug() must be followed by an unplug() before waiting for any of the requests.
+    virtual void plug() { }
+    virtual void unplug() { }
+
 protected:
     BlockDevice(MajorAllocation::BlockDeviceFamily, MinorNumber minor, size_t block_size = PAGE_SIZE);
 
@@ -52,10 +57,16 @@ public:
         Read,
         Write
     };
+    // Merged requests are made up by the storage request queue, and cover several adjacent requests at once.
+    enum class IsMerged {
+        No,
+        Yes,
+    };
     AsyncBlockDeviceRequest(Device& block_device, RequestType request_type,
-        u64 block_index, u32 block_count, UserOrKernelBuffer const& buffer, size_t buffer_size);
+        u64 block_index, u32 block_count, UserOrKernelBuffer const& buffer, size_t buffer_size, IsMerged = IsMerged::No);
 
     RequestType request_type() const { return m_request_type; }
+    bool is_merged() const { return m_is_merged == IsMerged::Yes; }
     u64 block_index() const { return m_block_index; }
     u32 block_count() const { return m_block_count; }
     size_t block_size() const { return m_block_device.block_size(); }
@@ -83,6 +94,7 @@ private:
     u32 const m_block_count;
     UserOrKernelBuffer m_buffer;
     size_t const m_buffer_size;
+    IsMerged const m_is_merged { IsMerged::No };
 };
 
 }
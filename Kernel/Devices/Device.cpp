@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Find.h>
 #include <AK/Singleton.h>
 #include <Kernel/Devices/BaseDevices.h>
 #include <Kernel/Devices/BlockDevice.h>
@@ -117,15 +118,38 @@ ErrorOr<NonnullRefPtr<OpenFileDescription>> Device::open(int options)
     return File::open(options);
 }
 
+ErrorOr<void> Device::try_queue_request(NonnullLockRefPtr<AsyncDeviceRequest> request)
+{
+    SpinlockLocker lock(m_requests_lock);
+    TRY(m_requests.try_append(request));
+    if (m_started_request_count < max_concurrent_requests()) {
+        ++m_started_request_count;
+        request->do_start(move(lock));
+    }
+    return {};
+}
+
 void Device::process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const& completed_request)
 {
+    did_finish_request(completed_request);
+
     SpinlockLocker lock(m_requests_lock);
-    VERIFY(!m_requests.is_empty());
-    VERIFY(m_requests.first().ptr() == &completed_request);
-    m_requests.remove(m_requests.begin());
-    if (!m_requests.is_empty()) {
-        auto* next_request = m_requests.first().ptr();
-        next_request->do_start(move(lock));
+    auto completed_request_iterator = AK::find_if(m_requests.begin(), m_requests.end(), [&](auto& request) { return request.ptr() == &completed_request; });
+    VERIFY(!completed_request_iterator.is_end());
+    m_requests.remove(completed_request_iterator);
+    VERIFY(m_started_request_count > 0);
+    --m_started_request_count;
+
+    // Requests may complete out of order, so the next one to start isn't necessarily at the front.
+    if (m_started_request_count < max_concurrent_requests()) {
+        for (auto& request : m_requests) {
+            if (!request->is_pending())
+                continue;
+            ++m_started_request_count;
+            NonnullLockRefPtr next_request = *request;
+            next_request->do_start(move(lock));
+            break;
+        }
     }
 
     evaluate_block_conditions();
@@ -54,18 +54,22 @@ public:
     virtual bool is_openable_by_jailed_processes() const { return false; }
     void process_next_queued_request(Badge<AsyncDeviceRequest>, AsyncDeviceRequest const&);
 
+    // Devices that can process several requests at once (e.g. through multiple hardware queues) override this.
+    virtual size_t max_concurrent_requests() const { return 1; }
+    // Called whenever one of this device's requests finished, before the next queued one gets started.
+    virtual void did_finish_request(AsyncDeviceRequest const&) { }
+
     template<typename AsyncRequestType, typename... Args>
     ErrorOr<NonnullLockRefPtr<AsyncRequestType>> try_make_request(Args&&... args)
     {
         auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncRequestType(*this, forward<Args>(args)...)));
-        SpinlockLocker lock(m_requests_lock);
-        bool was_empty = m_requests.is_empty();
-        TRY(m_requests.try_append(request));
-        if (was_empty)
-            request->do_start(move(lock));
+        TRY(try_queue_request(request));
         return request;
     }
 
+    // Queues a request that was created for this device, and starts it right away if there is room for it.
+    ErrorOr<void> try_queue_request(NonnullLockRefPtr<AsyncDeviceRequest>);
+
     static RecursiveSpinlockProtected<CircularQueue<DeviceEvent, 100>, LockRank::None>& event_queue();
     static BaseDevices* base_devices();
     static void after_inserting_device(Badge<Device>, Device&);
@@ -120,6 +124,7 @@ private:
 
     Spinlock<LockRank::None> m_requests_lock {};
     DoublyLinkedList<LockRefPtr<AsyncDeviceRequest>> m_requests;
+    size_t m_started_request_count { 0 };
 
 protected:
     // FIXME: This pointer will be eventually removed after all nodes in /sys/dev/block/ and
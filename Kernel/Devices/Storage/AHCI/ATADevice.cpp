@@ -26,10 +26,16 @@ ATADevice::ATADevice(AHCIController const& controller, ATA::Address ata_address,
 
 ATADevice::~ATADevice() = default;
 
-void ATADevice::start_request(AsyncBlockDeviceRequest& request)
+void ATADevice::submit_request(AsyncBlockDeviceRequest& request)
 {
     VERIFY(m_controller);
     m_controller->start_request(m_ata_address, request);
 }
 
+size_t ATADevice::hardware_queue_depth() const
+{
+    VERIFY(m_controller);
+    return m_controller->command_queue_depth(m_ata_address);
+}
+
 }
@@ -17,8 +17,9 @@ class ATADevice : public StorageDevice {
 public:
     virtual ~ATADevice() override;
 
-    // ^BlockDevice
-    virtual void start_request(AsyncBlockDeviceRequest&) override;
+    // ^StorageDevice
+    virtual void submit_request(AsyncBlockDeviceRequest&) override;
+    virtual size_t hardware_queue_depth() const override;
 
     u16 ata_capabilites() const { return m_capabilities; }
     ATA::Address const& ata_address() const { return m_ata_address; }
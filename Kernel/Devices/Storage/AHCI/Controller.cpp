@@ -90,6 +90,13 @@ void AHCIController::start_request(ATA::Address address, AsyncBlockDeviceRequest
     port->start_request(request);
 }
 
+size_t AHCIController::command_queue_depth(ATA::Address address) const
+{
+    auto port = m_ports[address.port];
+    VERIFY(port);
+    return port->command_queue_depth();
+}
+
 void AHCIController::complete_current_request(AsyncDeviceRequest::RequestResult)
 {
     VERIFY_NOT_REACHED();
@@ -35,6 +35,7 @@ public:
     virtual void complete_current_request(AsyncDeviceRequest::RequestResult) override;
 
     void start_request(ATA::Address, AsyncBlockDeviceRequest&);
+    size_t command_queue_depth(ATA::Address) const;
 
     void handle_interrupt_for_port(Badge<AHCIInterruptHandler>, u32 port_index) const;
 
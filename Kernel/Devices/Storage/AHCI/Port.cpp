@@ -37,14 +37,20 @@ ErrorOr<void> AHCIPort::allocate_resources_and_initialize_ports()
 
     m_fis_receive_page = TRY(MM.allocate_physical_page());
 
-    for (size_t index = 0; index < 1; index++) {
+    // We don't know yet whether the device supports NCQ, so prepare for as many commands as the HBA can queue.
+    size_t command_slots_count = 1;
+    if (m_hba_capabilities.native_command_queuing_supported)
+        command_slots_count = min<size_t>(m_hba_capabilities.max_command_list_entries_count, AHCI::Limits::MaxCommands);
+
+    for (size_t index = 0; index < command_slots_count; index++) {
         auto dma_page = TRY(MM.allocate_physical_page());
         m_dma_buffers.append(move(dma_page));
     }
-    for (size_t index = 0; index < 1; index++) {
+    for (size_t index = 0; index < command_slots_count; index++) {
         auto command_table_page = TRY(MM.allocate_physical_page());
         m_command_table_pages.append(move(command_table_page));
     }
+    m_command_tables_region = TRY(MM.allocate_kernel_region_with_physical_pages(m_command_table_pages.span(), "AHCI Command Tables"sv, Memory::Region::Access::ReadWrite, Memory::MemoryType::IO));
 
     // FIXME: Synchronize DMA buffer accesses correctly and set the MemoryType to NonCacheable.
     m_command_list_region = TRY(MM.allocate_dma_buffer_page("AHCI Port Command List"sv, Memory::Region::Access::ReadWrite, m_command_list_page, Memory::MemoryType::IO));
@@ -86,20 +92,14 @@ void AHCIPort::handle_interrupt()
             auto work_item_creation_result = g_io_work->try_queue([this]() {
                 m_connected_device.clear();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                complete_all_requests(AsyncDeviceRequest::OutOfMemory);
         } else {
             auto work_item_creation_result = g_io_work->try_queue([this]() {
                 reset();
             });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
-            }
+            if (work_item_creation_result.is_error())
+                complete_all_requests(AsyncDeviceRequest::OutOfMemory);
         }
         return;
     }
@@ -112,66 +112,83 @@ void AHCIPort::handle_interrupt()
         auto work_item_creation_result = g_io_work->try_queue([this]() {
             reset();
         });
-        if (work_item_creation_result.is_error()) {
-            auto current_request = m_current_request;
-            m_current_request.clear();
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-        }
+        if (work_item_creation_result.is_error())
+            complete_all_requests(AsyncDeviceRequest::OutOfMemory);
         return;
     }
     if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::IF) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::TFE) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBD) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::HBF)) {
         auto work_item_creation_result = g_io_work->try_queue([this]() {
             recover_from_fatal_error();
         });
-        if (work_item_creation_result.is_error()) {
-            auto current_request = m_current_request;
-            m_current_request.clear();
-            current_request->complete(AsyncDeviceRequest::OutOfMemory);
-        }
+        if (work_item_creation_result.is_error())
+            complete_all_requests(AsyncDeviceRequest::OutOfMemory);
         return;
     }
-    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS)) {
-        m_wait_for_completion = false;
+    if (m_interrupt_status.is_set(AHCI::PortInterruptFlag::DHR) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::PS) || m_interrupt_status.is_set(AHCI::PortInterruptFlag::SDB)) {
+        // Acknowledge the interrupt before looking at which commands are done, so that we get
+        // another one for any command that finishes after we looked.
+        m_interrupt_status.clear();
 
-        // Now schedule reading/writing the buffer as soon as we leave the irq handler.
+        u32 finished_command_slots = 0;
+        {
+            SpinlockLocker lock(m_hard_lock);
+            // NCQ commands stay set in PxSACT until the device reports them as done with a Set Device Bits FIS,
+            // which can happen in any order and for several of them at once.
+            u32 running_command_slots = m_port_registers.ci | m_port_registers.sact;
+            finished_command_slots = m_issued_command_slots & ~running_command_slots;
+            m_issued_command_slots &= ~finished_command_slots;
+        }
+
+        if (finished_command_slots == 0) {
+            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
+            return;
+        }
+
+        // Now schedule reading/writing the buffers as soon as we leave the irq handler.
         // This is important so that we can safely access the buffers, which could
         // trigger page faults
-        if (!m_current_request) {
-            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled, probably identify request", representative_port_index());
-        } else {
-            auto work_item_creation_result = g_io_work->try_queue([this]() {
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request handled", representative_port_index());
-                MutexLocker locker(m_lock);
-                VERIFY(m_current_request);
-                VERIFY(m_current_scatter_list);
-                if (!m_connected_device) {
-                    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                    complete_current_request(AsyncDeviceRequest::Failure);
-                    return;
-                }
-                if (m_current_request->request_type() == AsyncBlockDeviceRequest::Read) {
-                    if (auto result = m_current_request->write_to_buffer(m_current_request->buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * m_current_request->block_count()); result.is_error()) {
-                        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
-                        m_current_scatter_list = nullptr;
-                        complete_current_request(AsyncDeviceRequest::MemoryFault);
-                        return;
-                    }
-                }
-                m_current_scatter_list = nullptr;
-                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
-                complete_current_request(AsyncDeviceRequest::Success);
-            });
-            if (work_item_creation_result.is_error()) {
-                auto current_request = m_current_request;
-                m_current_request.clear();
-                current_request->complete(AsyncDeviceRequest::OutOfMemory);
+        auto work_item_creation_result = g_io_work->try_queue([this, finished_command_slots]() {
+            complete_finished_requests(finished_command_slots);
+        });
+        if (work_item_creation_result.is_error()) {
+            for (u8 command_slot = 0; command_slot < AHCI::Limits::MaxCommands; command_slot++) {
+                if (finished_command_slots & (1u << command_slot))
+                    complete_request(command_slot, AsyncDeviceRequest::OutOfMemory);
             }
         }
+        return;
     }
 
     m_interrupt_status.clear();
 }
 
+void AHCIPort::complete_finished_requests(u32 finished_command_slots)
+{
+    MutexLocker locker(m_lock);
+    for (u8 command_slot = 0; command_slot < AHCI::Limits::MaxCommands; command_slot++) {
+        if (!(finished_command_slots & (1u << command_slot)))
+            continue;
+        auto& slot = m_command_slots[command_slot];
+        VERIFY(slot.request);
+        VERIFY(slot.scatter_list);
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request in command slot {} handled", representative_port_index(), command_slot);
+        if (!m_connected_device) {
+            dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, device is gone.", representative_port_index());
+            complete_request(command_slot, AsyncDeviceRequest::Failure);
+            continue;
+        }
+        if (slot.request->request_type() == AsyncBlockDeviceRequest::Read) {
+            if (auto result = slot.request->write_to_buffer(slot.request->buffer(), slot.scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * slot.request->block_count()); result.is_error()) {
+                dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, memory fault occurred when reading in data.", representative_port_index());
+                complete_request(command_slot, AsyncDeviceRequest::MemoryFault);
+                continue;
+            }
+        }
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request success", representative_port_index());
+        complete_request(command_slot, AsyncDeviceRequest::Success);
+    }
+}
+
 bool AHCIPort::is_interrupts_enabled() const
 {
     return !m_interrupt_enable.is_cleared();
@@ -180,13 +197,17 @@ bool AHCIPort::is_interrupts_enabled() const
 void AHCIPort::recover_from_fatal_error()
 {
     MutexLocker locker(m_lock);
-    SpinlockLocker lock(m_hard_lock);
-
-    dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_controller->device_identifier().address(), representative_port_index());
-    dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_controller->device_identifier().address(), representative_port_index(), (u32)m_port_registers.serr);
-    stop_command_list_processing();
-    stop_fis_receiving();
-    m_interrupt_enable.clear();
+    {
+        SpinlockLocker lock(m_hard_lock);
+
+        dmesgln("{}: AHCI Port {} fatal error, shutting down!", m_parent_controller->device_identifier().address(), representative_port_index());
+        dmesgln("{}: AHCI Port {} fatal error, SError {}", m_parent_controller->device_identifier().address(), representative_port_index(), (u32)m_port_registers.serr);
+        stop_command_list_processing();
+        stop_fis_receiving();
+        m_interrupt_enable.clear();
+    }
+    // The commands that were in flight are never going to finish now.
+    complete_all_requests(AsyncDeviceRequest::Failure);
 }
 
 bool AHCIPort::reset()
@@ -274,7 +295,17 @@ bool AHCIPort::initialize()
             m_port_registers.cmd = m_port_registers.cmd | (1 << 24);
         }
 
-        dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size);
+        m_command_queue_depth = 1;
+        m_native_command_queuing_enabled = false;
+        // Word 76 bit 8 tells whether the device supports NCQ, and word 75 holds its maximum queue depth minus one.
+        // A value of 0 or 0xffff in word 76 means that the device doesn't report its SATA capabilities at all.
+        auto serial_ata_capabilities = identify_block->serial_ata_capabilities;
+        if (!is_atapi_attached() && m_hba_capabilities.native_command_queuing_supported && serial_ata_capabilities != 0xffff && (serial_ata_capabilities & (1 << 8))) {
+            m_command_queue_depth = min<size_t>((identify_block->queue_depth & 0x1f) + 1, m_command_table_pages.size());
+            m_native_command_queuing_enabled = m_command_queue_depth > 1;
+        }
+
+        dmesgln("AHCI Port {}: Device found, Capacity={}, Bytes per logical sector={}, Bytes per physical sector={}, Queue depth={}", representative_port_index(), max_addressable_sector * logical_sector_size, logical_sector_size, physical_sector_size, m_command_queue_depth);
 
         // FIXME: We don't support ATAPI devices yet, so for now we don't "create" them
         if (!is_atapi_attached()) {
@@ -404,64 +435,113 @@ void AHCIPort::set_sleep_state() const
 size_t AHCIPort::calculate_descriptors_count(size_t block_count) const
 {
     VERIFY(m_connected_device);
+    // Every command slot has a single page for its DMA buffer.
     size_t needed_dma_regions_count = Memory::page_round_up((block_count * m_connected_device->block_size())).value() / PAGE_SIZE;
-    VERIFY(needed_dma_regions_count <= m_dma_buffers.size());
+    VERIFY(needed_dma_regions_count <= 1);
     return needed_dma_regions_count;
 }
 
-Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request)
+Optional<AsyncDeviceRequest::RequestResult> AHCIPort::prepare_and_set_scatter_list(u8 command_slot, AsyncBlockDeviceRequest& request)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(request.block_count() > 0);
 
     Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> allocated_dma_regions;
     for (size_t index = 0; index < calculate_descriptors_count(request.block_count()); index++) {
-        allocated_dma_regions.append(m_dma_buffers.at(index));
+        allocated_dma_regions.append(m_dma_buffers.at(command_slot + index));
     }
 
-    m_current_scatter_list = Memory::ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size(), "AHCI Scattered DMA"sv).release_value_but_fixme_should_propagate_errors();
-    if (!m_current_scatter_list)
+    auto& scatter_list = m_command_slots[command_slot].scatter_list;
+    scatter_list = Memory::ScatterGatherList::try_create(request, allocated_dma_regions.span(), m_connected_device->block_size(), "AHCI Scattered DMA"sv).release_value_but_fixme_should_propagate_errors();
+    if (!scatter_list)
         return AsyncDeviceRequest::Failure;
     if (request.request_type() == AsyncBlockDeviceRequest::Write) {
-        if (auto result = request.read_from_buffer(request.buffer(), m_current_scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
+        if (auto result = request.read_from_buffer(request.buffer(), scatter_list->dma_region().as_ptr(), m_connected_device->block_size() * request.block_count()); result.is_error()) {
             return AsyncDeviceRequest::MemoryFault;
         }
     }
     return {};
 }
 
+Optional<u8> AHCIPort::try_to_allocate_command_slot()
+{
+    SpinlockLocker lock(m_hard_lock);
+    for (u8 command_slot = 0; command_slot < m_command_queue_depth; command_slot++) {
+        if (m_allocated_command_slots & (1u << command_slot))
+            continue;
+        m_allocated_command_slots |= 1u << command_slot;
+        return command_slot;
+    }
+    return {};
+}
+
 void AHCIPort::start_request(AsyncBlockDeviceRequest& request)
 {
     MutexLocker locker(m_lock);
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request start", representative_port_index());
-    VERIFY(!m_current_request);
-    VERIFY(!m_current_scatter_list);
 
-    m_current_request = request;
+    // The device never starts more requests than our queue depth, unless that shrank when the port was reset.
+    auto command_slot = try_to_allocate_command_slot();
+    if (!command_slot.has_value()) {
+        dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure, no free command slot.", representative_port_index());
+        locker.unlock();
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+    VERIFY(!m_command_slots[command_slot.value()].request);
+    VERIFY(!m_command_slots[command_slot.value()].scatter_list);
+    m_command_slots[command_slot.value()].request = request;
 
-    auto result = prepare_and_set_scatter_list(request);
+    auto result = prepare_and_set_scatter_list(command_slot.value(), request);
     if (result.has_value()) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(result.value());
+        complete_request(command_slot.value(), result.value());
         return;
     }
 
-    auto success = access_device(request.request_type(), request.block_index(), request.block_count());
+    auto success = access_device(command_slot.value(), request.request_type(), request.block_index(), request.block_count());
     if (!success) {
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Request failure.", representative_port_index());
         locker.unlock();
-        complete_current_request(AsyncDeviceRequest::Failure);
+        complete_request(command_slot.value(), AsyncDeviceRequest::Failure);
         return;
     }
 }
 
-void AHCIPort::complete_current_request(AsyncDeviceRequest::RequestResult result)
+void AHCIPort::complete_request(u8 command_slot, AsyncDeviceRequest::RequestResult result)
+{
+    auto& slot = m_command_slots[command_slot];
+    VERIFY(slot.request);
+    auto request = slot.request;
+    slot.request.clear();
+    slot.scatter_list = nullptr;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        m_allocated_command_slots &= ~(1u << command_slot);
+    }
+    // This might start the next queued request right away, so the slot has to be free by now.
+    request->complete(result);
+}
+
+void AHCIPort::complete_all_requests(AsyncDeviceRequest::RequestResult result)
 {
-    VERIFY(m_current_request);
-    auto current_request = m_current_request;
-    m_current_request.clear();
-    current_request->complete(result);
+    u32 allocated_command_slots = 0;
+    {
+        SpinlockLocker lock(m_hard_lock);
+        allocated_command_slots = m_allocated_command_slots;
+        m_issued_command_slots = 0;
+    }
+    for (u8 command_slot = 0; command_slot < AHCI::Limits::MaxCommands; command_slot++) {
+        if ((allocated_command_slots & (1u << command_slot)) && m_command_slots[command_slot].request)
+            complete_request(command_slot, result);
+    }
+}
+
+volatile AHCI::CommandTable& AHCIPort::command_table(u8 command_slot) const
+{
+    VERIFY(command_slot < m_command_table_pages.size());
+    return *(volatile AHCI::CommandTable*)m_command_tables_region->vaddr().offset(command_slot * PAGE_SIZE).as_ptr();
 }
 
 bool AHCIPort::spin_until_ready() const
@@ -480,44 +560,42 @@ bool AHCIPort::spin_until_ready() const
     return true;
 }
 
-bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
+bool AHCIPort::access_device(u8 command_slot, AsyncBlockDeviceRequest::RequestType direction, u64 lba, u8 block_count)
 {
     VERIFY(m_connected_device);
     VERIFY(is_operable());
     VERIFY(m_lock.is_locked());
-    VERIFY(m_current_scatter_list);
+    auto& scatter_list = m_command_slots[command_slot].scatter_list;
+    VERIFY(scatter_list);
     SpinlockLocker lock(m_hard_lock);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count);
-    if (!spin_until_ready())
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {}, command slot {}", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, command_slot);
+    // With NCQ, the HBA takes care of not sending a command while the device is busy with the previous one.
+    bool must_wait_until_ready = m_issued_command_slots == 0;
+    if (must_wait_until_ready && !spin_until_ready())
         return false;
 
-    auto unused_command_header = try_to_find_unused_command_header();
-    VERIFY(unused_command_header.has_value());
     auto* command_list_entries = (volatile AHCI::CommandHeader*)m_command_list_region->vaddr().as_ptr();
-    command_list_entries[unused_command_header.value()].ctba = m_command_table_pages[unused_command_header.value()]->paddr().get();
-    command_list_entries[unused_command_header.value()].ctbau = 0;
-    command_list_entries[unused_command_header.value()].prdbc = 0;
-    command_list_entries[unused_command_header.value()].prdtl = m_current_scatter_list->scatters_count();
+    command_list_entries[command_slot].ctba = m_command_table_pages[command_slot]->paddr().get();
+    command_list_entries[command_slot].ctbau = 0;
+    command_list_entries[command_slot].prdbc = 0;
+    command_list_entries[command_slot].prdtl = scatter_list->scatters_count();
 
     // Note: we must set the correct Dword count in this register. Real hardware
     // AHCI controllers do care about this field! QEMU doesn't care if we don't
     // set the correct CFL field in this register, real hardware will set an
     // handshake error bit in PxSERR register if CFL is incorrect.
-    command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
+    command_list_entries[command_slot].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P | (is_atapi_attached() ? AHCI::CommandHeaderAttributes::A : 0) | (direction == AsyncBlockDeviceRequest::RequestType::Write ? AHCI::CommandHeaderAttributes::W : 0);
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[unused_command_header.value()].ctba, (u32)command_list_entries[unused_command_header.value()].ctbau, (u32)command_list_entries[unused_command_header.value()].prdbc, (u16)command_list_entries[unused_command_header.value()].prdtl, (u16)command_list_entries[unused_command_header.value()].attributes);
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: CLE: ctba={:#08x}, ctbau={:#08x}, prdbc={:#08x}, prdtl={:#04x}, attributes={:#04x}", representative_port_index(), (u32)command_list_entries[command_slot].ctba, (u32)command_list_entries[command_slot].ctbau, (u32)command_list_entries[command_slot].prdbc, (u16)command_list_entries[command_slot].prdtl, (u16)command_list_entries[command_slot].attributes);
 
-    auto command_table_region = MM.allocate_kernel_region_with_physical_pages({ &m_command_table_pages[unused_command_header.value()], 1 }, "AHCI Command Table"sv, Memory::Region::Access::ReadWrite, Memory::MemoryType::IO).release_value();
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
-
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Allocated command table at {}", representative_port_index(), command_table_region->vaddr());
+    auto& command_table = this->command_table(command_slot);
 
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
 
     size_t scatter_entry_index = 0;
     size_t data_transfer_count = (block_count * m_connected_device->block_size());
-    for (auto scatter_page : m_current_scatter_list->vmobject().physical_pages()) {
+    for (auto scatter_page : scatter_list->vmobject().physical_pages()) {
         VERIFY(data_transfer_count != 0);
         VERIFY(scatter_page);
         dbgln_if(AHCI_DEBUG, "AHCI Port {}: Add a transfer scatter entry @ {}", representative_port_index(), scatter_page->paddr());
@@ -541,6 +619,11 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     if (is_atapi_attached()) {
         fis.command = ATA_CMD_PACKET;
         TODO();
+    } else if (m_native_command_queuing_enabled) {
+        if (direction == AsyncBlockDeviceRequest::RequestType::Write)
+            fis.command = ATA_CMD_WRITE_FPDMA_QUEUED;
+        else
+            fis.command = ATA_CMD_READ_FPDMA_QUEUED;
     } else {
         if (direction == AsyncBlockDeviceRequest::RequestType::Write)
             fis.command = ATA_CMD_WRITE_DMA_EXT;
@@ -559,17 +642,24 @@ bool AHCIPort::access_device(AsyncBlockDeviceRequest::RequestType direction, u64
     fis.lba_low[0] = lba & 0xff;
     fis.lba_low[1] = (lba >> 8) & 0xff;
     fis.lba_low[2] = (lba >> 16) & 0xff;
-    fis.count = (block_count);
+    if (m_native_command_queuing_enabled) {
+        // Queued commands carry their sector count in the features register, and their tag in bits 7:3 of the count register.
+        fis.features_low = block_count;
+        fis.features_high = 0;
+        fis.count = command_slot << 3;
+    } else {
+        fis.count = (block_count);
+    }
 
     // The below loop waits until the port is no longer busy before issuing a new command
-    if (!spin_until_ready())
+    if (must_wait_until_ready && !spin_until_ready())
         return false;
 
     full_memory_barrier();
-    mark_command_header_ready_to_process(unused_command_header.value());
+    mark_command_header_ready_to_process(command_slot);
     full_memory_barrier();
 
-    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[0]->paddr());
+    dbgln_if(AHCI_DEBUG, "AHCI Port {}: Do a {}, lba {}, block count {} @ {}, ended", representative_port_index(), direction == AsyncBlockDeviceRequest::RequestType::Write ? "write" : "read", lba, block_count, m_dma_buffers[command_slot]->paddr());
     return true;
 }
 
@@ -592,8 +682,7 @@ bool AHCIPort::identify_device()
     // QEMU doesn't care if we don't set the correct CFL field in this register, real hardware will set an handshake error bit in PxSERR register.
     command_list_entries[unused_command_header.value()].attributes = (size_t)FIS::DwordCount::RegisterHostToDevice | AHCI::CommandHeaderAttributes::P;
 
-    auto command_table_region = MM.allocate_kernel_region_with_physical_pages({ &m_command_table_pages[unused_command_header.value()], 1 }, "AHCI Command Table"sv, Memory::Region::Access::ReadWrite, Memory::MemoryType::IO).release_value();
-    auto& command_table = *(volatile AHCI::CommandTable*)command_table_region->vaddr().as_ptr();
+    auto& command_table = this->command_table(unused_command_header.value());
     memset(const_cast<u8*>(command_table.command_fis), 0, 64);
     command_table.descriptors[0].base_high = 0;
     command_table.descriptors[0].base_low = m_identify_buffer_page->paddr().get();
@@ -690,15 +779,18 @@ void AHCIPort::start_command_list_processing() const
     m_port_registers.cmd = m_port_registers.cmd | 1;
 }
 
-void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index) const
+void AHCIPort::mark_command_header_ready_to_process(u8 command_header_index)
 {
     VERIFY(m_lock.is_locked());
     VERIFY(m_hard_lock.is_locked());
     VERIFY(is_operable());
-    VERIFY(!m_wait_for_completion);
-    m_wait_for_completion = true;
+    VERIFY(!(m_issued_command_slots & (1u << command_header_index)));
+    m_issued_command_slots |= 1u << command_header_index;
     dbgln_if(AHCI_DEBUG, "AHCI Port {}: Marking command header at index {} as ready to process.", representative_port_index(), command_header_index);
-    m_port_registers.ci = 1 << command_header_index;
+    // Queued commands have to be marked as active before they are issued.
+    if (m_native_command_queuing_enabled)
+        m_port_registers.sact = 1u << command_header_index;
+    m_port_registers.ci = 1u << command_header_index;
 }
 
 void AHCIPort::stop_command_list_processing() const
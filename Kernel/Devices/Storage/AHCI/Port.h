@@ -6,6 +6,7 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/OwnPtr.h>
 #include <AK/RefPtr.h>
 #include <Kernel/Devices/Device.h>
@@ -45,6 +46,9 @@ public:
 
     RefPtr<StorageDevice> connected_device() const { return m_connected_device; }
 
+    // How many requests can be in flight at once, which is more than one only if both the HBA and the device support NCQ.
+    size_t command_queue_depth() const { return m_command_queue_depth; }
+
     bool reset();
     bool initialize_without_reset();
     void handle_interrupt();
@@ -70,10 +74,14 @@ private:
     ALWAYS_INLINE void power_on() const;
 
     void start_request(AsyncBlockDeviceRequest&);
-    void complete_current_request(AsyncDeviceRequest::RequestResult);
-    bool access_device(AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
+    void complete_request(u8 command_slot, AsyncDeviceRequest::RequestResult);
+    void complete_finished_requests(u32 finished_command_slots);
+    void complete_all_requests(AsyncDeviceRequest::RequestResult);
+    bool access_device(u8 command_slot, AsyncBlockDeviceRequest::RequestType, u64 lba, u8 block_count);
     size_t calculate_descriptors_count(size_t block_count) const;
-    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(AsyncBlockDeviceRequest& request);
+    [[nodiscard]] Optional<AsyncDeviceRequest::RequestResult> prepare_and_set_scatter_list(u8 command_slot, AsyncBlockDeviceRequest& request);
+    Optional<u8> try_to_allocate_command_slot();
+    volatile AHCI::CommandTable& command_table(u8 command_slot) const;
 
     ALWAYS_INLINE bool is_interrupts_enabled() const;
 
@@ -82,7 +90,7 @@ private:
     bool identify_device();
 
     ALWAYS_INLINE void start_command_list_processing() const;
-    ALWAYS_INLINE void mark_command_header_ready_to_process(u8 command_header_index) const;
+    ALWAYS_INLINE void mark_command_header_ready_to_process(u8 command_header_index);
     ALWAYS_INLINE void stop_command_list_processing() const;
 
     ALWAYS_INLINE void start_fis_receiving() const;
@@ -102,14 +110,26 @@ private:
     // Data members
 
     EntropySource m_entropy_source;
-    LockRefPtr<AsyncBlockDeviceRequest> m_current_request;
     Spinlock<LockRank::None> m_hard_lock {};
     Mutex m_lock { "AHCIPort"sv };
 
-    mutable bool m_wait_for_completion { false };
+    // Every request in flight occupies a command slot, whose index doubles as its NCQ tag.
+    // Each slot has its own command table and DMA buffer, so requests can complete in any order.
+    struct CommandSlot {
+        LockRefPtr<AsyncBlockDeviceRequest> request;
+        LockRefPtr<Memory::ScatterGatherList> scatter_list;
+    };
+    Array<CommandSlot, AHCI::Limits::MaxCommands> m_command_slots;
+    // Slots that have a request assigned, until that request is completed. Protected by m_hard_lock.
+    u32 m_allocated_command_slots { 0 };
+    // Slots that were handed to the HBA and that it didn't report back as done yet. Protected by m_hard_lock.
+    u32 m_issued_command_slots { 0 };
+    size_t m_command_queue_depth { 1 };
+    bool m_native_command_queuing_enabled { false };
 
     Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> m_dma_buffers;
     Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> m_command_table_pages;
+    OwnPtr<Memory::Region> m_command_tables_region;
     RefPtr<Memory::PhysicalRAMPage> m_command_list_page;
     OwnPtr<Memory::Region> m_command_list_region;
     RefPtr<Memory::PhysicalRAMPage> m_fis_receive_page;
@@ -131,7 +151,6 @@ private:
     AHCI::PortInterruptStatusBitField m_interrupt_status;
     AHCI::PortInterruptEnableBitField m_interrupt_enable;
 
-    LockRefPtr<Memory::ScatterGatherList> m_current_scatter_list;
     bool m_disabled_by_firmware { false };
 };
 }
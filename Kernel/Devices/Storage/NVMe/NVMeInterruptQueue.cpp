@@ -55,6 +55,7 @@ void NVMeInterruptQueue::complete_current_request(u16 cmdid, u16 status)
                 request_pdu.end_io_handler(status);
             request_pdu.clear();
         });
+        did_release_request_cid();
     }
 }
 }
@@ -25,18 +25,15 @@ UNMAP_AFTER_INIT NVMeNameSpace::NVMeNameSpace(LUNAddress logical_unit_number_add
 {
 }
 
-void NVMeNameSpace::start_request(AsyncBlockDeviceRequest& request)
+void NVMeNameSpace::submit_request(AsyncBlockDeviceRequest& request)
 {
-    auto index = Processor::current_id();
+    // Submit to the queue of the current processor, so requests issued on different processors don't contend on the same queue.
+    auto index = Processor::current_id() % m_queues.size();
     auto& queue = m_queues.at(index);
     // TODO: For now we support only IO transfers of size PAGE_SIZE (Going along with the current constraint in the block layer)
     // Eventually remove this constraint by using the PRP2 field in the submission struct and remove block layer constraint for NVMe driver.
     VERIFY(request.block_count() <= (PAGE_SIZE / block_size()));
 
-    if (request.request_type() == AsyncBlockDeviceRequest::Read) {
-        queue->read(request, m_nsid, request.block_index(), request.block_count());
-    } else {
-        queue->write(request, m_nsid, request.block_index(), request.block_count());
-    }
+    queue->submit_request(request, m_nsid);
 }
 }
@@ -26,7 +26,10 @@ public:
     static ErrorOr<NonnullRefPtr<NVMeNameSpace>> create(NVMeController const&, Vector<NonnullLockRefPtr<NVMeQueue>> queues, u16 nsid, size_t storage_size, size_t lba_size);
 
     CommandSet command_set() const override { return CommandSet::NVMe; }
-    void start_request(AsyncBlockDeviceRequest& request) override;
+    void submit_request(AsyncBlockDeviceRequest& request) override;
+
+    // NOTE: Requests are spread over the per-processor queues, but may all end up in the same one.
+    virtual size_t hardware_queue_depth() const override { return IO_QUEUE_SIZE - 1; }
 
 private:
     NVMeNameSpace(LUNAddress, u32 hardware_relative_controller_id, Vector<NonnullLockRefPtr<NVMeQueue>> queues, size_t storage_size, size_t lba_size, u16 nsid);
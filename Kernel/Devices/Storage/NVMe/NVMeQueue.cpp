@@ -14,20 +14,21 @@
 namespace Kernel {
 ErrorOr<NonnullLockRefPtr<NVMeQueue>> NVMeQueue::try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type)
 {
-    // Note: Allocate DMA region for RW operation. For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
-    RefPtr<Memory::PhysicalRAMPage> rw_dma_page;
+    // Note: Allocate DMA region for RW operation, with one page for each command identifier.
+    //       For now the requests don't exceed more than 4096 bytes (Storage device takes care of it)
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> rw_dma_pages;
     // FIXME: Synchronize DMA buffer accesses correctly and set the MemoryType to NonCacheable.
-    auto rw_dma_region = TRY(MM.allocate_dma_buffer_page("NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_page, Memory::MemoryType::IO));
+    auto rw_dma_region = TRY(MM.allocate_dma_buffer_pages(q_depth * PAGE_SIZE, "NVMe Queue Read/Write DMA"sv, Memory::Region::Access::ReadWrite, rw_dma_pages, Memory::MemoryType::IO));
 
-    if (rw_dma_page.is_null())
+    if (rw_dma_pages.is_empty())
         return ENOMEM;
 
     if (queue_type == QueueType::Polled) {
-        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_page.release_nonnull(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+        auto queue = NVMePollQueue::try_create(move(rw_dma_region), rw_dma_pages.first(), qid, q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
         return queue;
     }
 
-    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_page.release_nonnull(), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
+    auto queue = NVMeInterruptQueue::try_create(device, move(rw_dma_region), rw_dma_pages.first(), qid, irq.release_value(), q_depth, move(cq_dma_region), move(sq_dma_region), move(db_regs));
     return queue;
 }
 
@@ -92,8 +93,71 @@ u32 NVMeQueue::process_cq()
     return nr_of_processed_cqes;
 }
 
+ErrorOr<u16> NVMeQueue::reserve_request_cid(NVMeIO io)
+{
+    return m_requests.with([&](auto& requests) -> ErrorOr<u16> {
+        // NOTE: Commands can complete out of order, so we have to skip over the ones that are still in flight.
+        for (u32 attempt = 0; attempt < m_qdepth; ++attempt) {
+            u16 cid = get_request_cid();
+            auto it = requests.find(cid);
+            if (it != requests.end() && it->value.is_in_use())
+                continue;
+            requests.set(cid, move(io));
+            return cid;
+        }
+        return EBUSY;
+    });
+}
+
+void NVMeQueue::did_release_request_cid()
+{
+    m_request_cid_wait_queue.wake_all();
+    submit_deferred_requests();
+}
+
+void NVMeQueue::defer_request(AsyncBlockDeviceRequest& request, u16 nsid)
+{
+    dbgln_if(NVME_DEBUG, "NVMe: All command identifiers are in flight, deferring request for block {}", request.block_index());
+    auto result = m_deferred_requests.with([&](auto& deferred_requests) {
+        return deferred_requests.try_append(DeferredRequest { .request = request, .nsid = nsid });
+    });
+    if (result.is_error()) {
+        request.complete(AsyncDeviceRequest::OutOfMemory);
+        return;
+    }
+    // A command identifier might have been released since we failed to reserve one, without anyone seeing this request yet.
+    submit_deferred_requests();
+}
+
+void NVMeQueue::submit_deferred_requests()
+{
+    for (;;) {
+        // NOTE: Taking a deferred request and reserving its command identifier has to happen under the same lock as
+        //       releasing a command identifier, otherwise the request could be put back right after the last one completed.
+        u16 cid = 0;
+        auto deferred_request = m_requests.with([&](auto&) {
+            return m_deferred_requests.with([&](auto& deferred_requests) -> Optional<DeferredRequest> {
+                if (deferred_requests.is_empty())
+                    return {};
+                auto cid_or_error = reserve_request_cid({ deferred_requests.first().request, nullptr });
+                if (cid_or_error.is_error())
+                    return {};
+                cid = cid_or_error.release_value();
+                return deferred_requests.take_first();
+            });
+        });
+        if (!deferred_request.has_value())
+            return;
+        start_request(cid, deferred_request->request, deferred_request->nsid);
+    }
+}
+
 void NVMeQueue::submit_sqe(NVMeSubmission& sub)
 {
+    // Submitters that are already waiting for the lock will ring the doorbell after us, so back-to-back
+    // submissions only cost a single doorbell write. We must not be preempted before we get to it.
+    ScopedCritical critical;
+    m_pending_submitters.fetch_add(1, AK::memory_order_relaxed);
     SpinlockLocker lock(m_sq_lock);
 
     memcpy(&m_sqe_array[m_sq_tail], &sub, sizeof(NVMeSubmission));
@@ -106,7 +170,8 @@ void NVMeQueue::submit_sqe(NVMeSubmission& sub)
     }
 
     dbgln_if(NVME_DEBUG, "NVMe: Submission with command identifier {}. SQ_TAIL: {}", sub.cmdid, m_sq_tail);
-    update_sq_doorbell();
+    if (m_pending_submitters.fetch_sub(1, AK::memory_order_acq_rel) == 1)
+        update_sq_doorbell();
 }
 
 void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
@@ -135,24 +200,26 @@ void NVMeQueue::complete_current_request(u16 cmdid, u16 status)
         }
 
         if (current_request->request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
-            if (auto result = current_request->write_to_buffer(current_request->buffer(), m_rw_dma_region->vaddr().as_ptr(), current_request->buffer_size()); result.is_error()) {
+            if (auto result = current_request->write_to_buffer(current_request->buffer(), rw_dma_buffer(cmdid), current_request->buffer_size()); result.is_error()) {
                 req_result = AsyncBlockDeviceRequest::MemoryFault;
                 return;
             }
         }
     });
+    did_release_request_cid();
 }
 
 u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
 {
-    // For now let's use sq tail as a unique command id.
     u16 cmd_status;
-    u16 cid = get_request_cid();
-    sub.cmdid = cid;
-
-    m_requests.with([this, &sub, &cmd_status](auto& requests) {
-        requests.set(sub.cmdid, { nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
-    });
+    for (;;) {
+        auto cid_or_error = reserve_request_cid({ nullptr, [this, &cmd_status](u16 status) mutable { cmd_status = status; m_sync_wait_queue.wake_all(); } });
+        if (!cid_or_error.is_error()) {
+            sub.cmdid = cid_or_error.release_value();
+            break;
+        }
+        m_request_cid_wait_queue.wait_forever("NVMe command identifier"sv);
+    }
     submit_sqe(sub);
 
     // FIXME: Only sync submissions (usually used for admin commands) use a WaitQueue based IO. Eventually we need to
@@ -161,44 +228,32 @@ u16 NVMeQueue::submit_sync_sqe(NVMeSubmission& sub)
     return cmd_status;
 }
 
-void NVMeQueue::read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::submit_request(AsyncBlockDeviceRequest& request, u16 nsid)
 {
-    NVMeSubmission sub {};
-    sub.op = OP_NVME_READ;
-    sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
-    // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
-
-    full_memory_barrier();
-    submit_sqe(sub);
+    auto cid_or_error = reserve_request_cid({ request, nullptr });
+    if (cid_or_error.is_error()) {
+        defer_request(request, nsid);
+        return;
+    }
+    start_request(cid_or_error.release_value(), request, nsid);
 }
 
-void NVMeQueue::write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count)
+void NVMeQueue::start_request(u16 cid, AsyncBlockDeviceRequest& request, u16 nsid)
 {
     NVMeSubmission sub {};
-
-    sub.op = OP_NVME_WRITE;
+    sub.op = request.request_type() == AsyncBlockDeviceRequest::Read ? OP_NVME_READ : OP_NVME_WRITE;
     sub.rw.nsid = nsid;
-    sub.rw.slba = AK::convert_between_host_and_little_endian(index);
+    sub.rw.slba = AK::convert_between_host_and_little_endian(request.block_index());
     // No. of lbas is 0 based
-    sub.rw.length = AK::convert_between_host_and_little_endian((count - 1) & 0xFFFF);
-    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(m_rw_dma_page->paddr().as_ptr()));
-    sub.cmdid = get_request_cid();
-
-    m_requests.with([&sub, &request](auto& requests) {
-        requests.set(sub.cmdid, { request, nullptr });
-    });
+    sub.rw.length = AK::convert_between_host_and_little_endian((request.block_count() - 1) & 0xFFFF);
+    sub.cmdid = cid;
+    sub.rw.data_ptr.prp1 = reinterpret_cast<u64>(AK::convert_between_host_and_little_endian(rw_dma_paddr(sub.cmdid).as_ptr()));
 
-    if (auto result = request.read_from_buffer(request.buffer(), m_rw_dma_region->vaddr().as_ptr(), request.buffer_size()); result.is_error()) {
-        complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
-        return;
+    if (request.request_type() == AsyncBlockDeviceRequest::Write) {
+        if (auto result = request.read_from_buffer(request.buffer(), rw_dma_buffer(sub.cmdid), request.buffer_size()); result.is_error()) {
+            complete_current_request(sub.cmdid, AsyncDeviceRequest::MemoryFault);
+            return;
+        }
     }
 
     full_memory_barrier();
@@ -10,12 +10,14 @@
 #include <AK/HashMap.h>
 #include <AK/OwnPtr.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <Kernel/Bus/PCI/Device.h>
 #include <Kernel/Devices/Storage/NVMe/NVMeDefinitions.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Library/LockRefPtr.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
 #include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Memory/TypedMapping.h>
 
@@ -45,6 +47,7 @@ struct NVMeIO {
         request = nullptr;
         end_io_handler = nullptr;
     }
+    bool is_in_use() const { return request || end_io_handler; }
     RefPtr<AsyncBlockDeviceRequest> request;
     Function<void(u16 status)> end_io_handler;
 };
@@ -55,8 +58,7 @@ public:
     static ErrorOr<NonnullLockRefPtr<NVMeQueue>> try_create(NVMeController& device, u16 qid, Optional<u8> irq, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs, QueueType queue_type);
     bool is_admin_queue() { return m_admin_queue; }
     u16 submit_sync_sqe(NVMeSubmission&);
-    void read(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
-    void write(AsyncBlockDeviceRequest& request, u16 nsid, u64 index, u32 count);
+    void submit_request(AsyncBlockDeviceRequest& request, u16 nsid);
     virtual void submit_sqe(NVMeSubmission&);
     virtual ~NVMeQueue();
 
@@ -85,6 +87,15 @@ protected:
 
     NVMeQueue(NonnullOwnPtr<Memory::Region> rw_dma_region, Memory::PhysicalRAMPage const& rw_dma_page, u16 qid, u32 q_depth, OwnPtr<Memory::Region> cq_dma_region, OwnPtr<Memory::Region> sq_dma_region, Doorbell db_regs);
 
+    // Every command identifier has its own page in the read/write DMA region, so multiple commands can be in flight at once.
+    PhysicalAddress rw_dma_paddr(u16 cid) const { return m_rw_dma_page->paddr().offset(cid * PAGE_SIZE); }
+    u8* rw_dma_buffer(u16 cid) const { return m_rw_dma_region->vaddr().offset(cid * PAGE_SIZE).as_ptr(); }
+
+    // Fails with EBUSY if every command identifier is in flight.
+    ErrorOr<u16> reserve_request_cid(NVMeIO);
+    // Must be called whenever a command identifier is released, so that whoever waits for one gets it.
+    void did_release_request_cid();
+
     [[nodiscard]] u32 get_request_cid()
     {
         u32 expected_tag = m_tag.load(AK::memory_order_acquire);
@@ -101,6 +112,15 @@ protected:
     virtual void complete_current_request(u16 cmdid, u16 status);
 
 private:
+    struct DeferredRequest {
+        NonnullRefPtr<AsyncBlockDeviceRequest> request;
+        u16 nsid;
+    };
+
+    void start_request(u16 cid, AsyncBlockDeviceRequest&, u16 nsid);
+    void defer_request(AsyncBlockDeviceRequest&, u16 nsid);
+    void submit_deferred_requests();
+
     bool cqe_available();
     void update_cqe_head();
     void update_cq_doorbell()
@@ -124,11 +144,15 @@ private:
     u32 m_qdepth {};
     Atomic<u32> m_tag { 0 }; // used for the cid in a submission queue entry
     Spinlock<LockRank::Interrupts> m_sq_lock {};
+    Atomic<u32> m_pending_submitters { 0 };
     OwnPtr<Memory::Region> m_cq_dma_region;
     Span<NVMeSubmission> m_sqe_array;
     OwnPtr<Memory::Region> m_sq_dma_region;
     Span<NVMeCompletion> m_cqe_array;
     WaitQueue m_sync_wait_queue;
+    // Requests that came in while every command identifier was in flight, in the order they came in.
+    SpinlockProtected<Vector<DeferredRequest>, LockRank::None> m_deferred_requests {};
+    WaitQueue m_request_cid_wait_queue;
     Doorbell m_db_regs;
     NonnullRefPtr<Memory::PhysicalRAMPage const> const m_rw_dma_page;
 };
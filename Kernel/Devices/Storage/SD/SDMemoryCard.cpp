@@ -20,7 +20,7 @@ SDMemoryCard::SDMemoryCard(SDHostController& sdhc, StorageDevice::LUNAddress lun
 {
 }
 
-void SDMemoryCard::start_request(AsyncBlockDeviceRequest& request)
+void SDMemoryCard::submit_request(AsyncBlockDeviceRequest& request)
 {
     // FIXME: Make this asynchronous
     MutexLocker locker(m_lock);
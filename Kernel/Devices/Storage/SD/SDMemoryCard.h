@@ -23,9 +23,7 @@ public:
 
     // ^StorageDevice
     virtual CommandSet command_set() const override { return CommandSet::SD; }
-
-    // ^BlockDevice
-    virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual void submit_request(AsyncBlockDeviceRequest&) override;
 
 private:
     enum class CardAddressingMode {
@@ -25,9 +25,25 @@ StorageDevice::StorageDevice(LUNAddress logical_unit_number_address, u32 hardwar
     , m_hardware_relative_controller_id(hardware_relative_controller_id)
     , m_max_addressable_block(max_addressable_block)
     , m_blocks_per_page(PAGE_SIZE / block_size())
+    , m_request_queue(*this)
 {
 }
 
+void StorageDevice::start_request(AsyncBlockDeviceRequest& request)
+{
+    // Merged requests were made up by the request queue, so they are ready to go.
+    if (request.is_merged()) {
+        submit_request(request);
+        return;
+    }
+    m_request_queue.add_request(request);
+}
+
+void StorageDevice::did_finish_request(AsyncDeviceRequest const& request)
+{
+    m_request_queue.request_finished(request);
+}
+
 ErrorOr<void> StorageDevice::after_inserting()
 {
     auto sysfs_storage_device_directory = StorageDeviceSysFSDirectory::create(SysFSStorageDirectory::the(), *this);
@@ -10,6 +10,7 @@
 #include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/Devices/Storage/StorageController.h>
 #include <Kernel/Devices/Storage/StorageDevicePartition.h>
+#include <Kernel/Devices/Storage/StorageRequestQueue.h>
 #include <Kernel/Interrupts/IRQHandler.h>
 #include <Kernel/Locking/Mutex.h>
 
@@ -18,6 +19,7 @@ namespace Kernel {
 class StorageDevice : public BlockDevice {
     friend class StorageManagement;
     friend class Device;
+    friend class StorageRequestQueue;
 
 public:
     // Note: this attribute describes the internal command set of a Storage device.
@@ -67,6 +69,18 @@ public:
     virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
     virtual void prepare_for_unplug() { m_partitions.clear(); }
 
+    // NOTE: Every request goes through the request queue first, which hands them to submit_request() when the driver has room.
+    virtual void start_request(AsyncBlockDeviceRequest&) override final;
+    virtual void plug() override { m_request_queue.plug(); }
+    virtual void unplug() override { m_request_queue.unplug(); }
+
+    // ^Device
+    // The request queue keeps track of how many requests the hardware can take, so let all of them through to it.
+    virtual size_t max_concurrent_requests() const override final { return NumericLimits<size_t>::max(); }
+
+    StorageRequestQueue& request_queue() { return m_request_queue; }
+    StorageRequestQueue const& request_queue() const { return m_request_queue; }
+
     Vector<NonnullRefPtr<StorageDevicePartition>> const& partitions() const { return m_partitions; }
 
     void add_partition(NonnullRefPtr<StorageDevicePartition> disk_partition) { MUST(m_partitions.try_append(disk_partition)); }
@@ -88,10 +102,20 @@ protected:
     // ^DiskDevice
     virtual StringView class_name() const override;
 
+    // Drivers implement this to send a request to the hardware, which might be a merged one made up by the request queue.
+    virtual void submit_request(AsyncBlockDeviceRequest&) = 0;
+    // How many requests the driver can have in flight at once.
+    virtual size_t hardware_queue_depth() const { return 1; }
+    // The largest transfer the driver can handle in a single request, which merged requests don't grow beyond.
+    virtual u32 max_blocks_per_request() const { return m_blocks_per_page; }
+
 private:
     virtual ErrorOr<void> after_inserting() override;
     virtual void will_be_destroyed() override;
 
+    // ^Device
+    virtual void did_finish_request(AsyncDeviceRequest const&) override;
+
     mutable IntrusiveListNode<StorageDevice, LockRefPtr<StorageDevice>> m_list_node;
     // NOTE: This probably need a better locking once we support hotplug and
     // refresh of the partition table.
@@ -108,6 +132,8 @@ private:
 
     u64 const m_max_addressable_block { 0 };
     size_t const m_blocks_per_page { 0 };
+
+    StorageRequestQueue m_request_queue;
 };
 
 }
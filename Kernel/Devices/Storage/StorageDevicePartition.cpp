@@ -44,6 +44,28 @@ void StorageDevicePartition::start_request(AsyncBlockDeviceRequest& request)
     request.add_sub_request(sub_request_or_error.release_value());
 }
 
+void StorageDevicePartition::plug()
+{
+    // Our requests end up in the underlying device's queue, so that is the one to hold back.
+    if (auto device = m_device.strong_ref())
+        device->plug();
+}
+
+void StorageDevicePartition::unplug()
+{
+    if (auto device = m_device.strong_ref())
+        device->unplug();
+}
+
+size_t StorageDevicePartition::max_concurrent_requests() const
+{
+    // Every request is forwarded to the underlying device as a sub-request, so we can have as many in flight as it can.
+    auto device = m_device.strong_ref();
+    if (!device)
+        return 1;
+    return device->max_concurrent_requests();
+}
+
 ErrorOr<size_t> StorageDevicePartition::read(OpenFileDescription& fd, u64 offset, UserOrKernelBuffer& outbuf, size_t len)
 {
     auto device = m_device.strong_ref();
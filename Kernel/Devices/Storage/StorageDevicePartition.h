@@ -22,6 +22,11 @@ public:
     virtual ~StorageDevicePartition();
 
     virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual void plug() override;
+    virtual void unplug() override;
+
+    // ^Device
+    virtual size_t max_concurrent_requests() const override;
 
     // ^BlockDevice
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
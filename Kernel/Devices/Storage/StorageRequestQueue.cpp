@@ -0,0 +1,312 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Debug.h>
+#include <Kernel/Devices/Storage/StorageDevice.h>
+#include <Kernel/Devices/Storage/StorageRequestQueue.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+StringView StorageRequestQueue::policy_to_string_view(Policy policy)
+{
+    switch (policy) {
+    case Policy::FIFO:
+        return "fifo"sv;
+    case Policy::Deadline:
+        return "deadline"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<StorageRequestQueue::Policy> StorageRequestQueue::policy_from_string_view(StringView name)
+{
+    if (name == "fifo"sv)
+        return Policy::FIFO;
+    if (name == "deadline"sv)
+        return Policy::Deadline;
+    return {};
+}
+
+StorageRequestQueue::StorageRequestQueue(StorageDevice& device)
+    : m_device(device)
+{
+}
+
+void StorageRequestQueue::add_request(AsyncBlockDeviceRequest& request)
+{
+    auto deadline = TimeManagement::the().monotonic_time() + (request.request_type() == AsyncBlockDeviceRequest::Read ? read_deadline : write_deadline);
+    auto result = m_state.with([&](State& state) -> ErrorOr<void> {
+        TRY(state.queued.try_append(QueuedRequest { .request = request, .deadline = deadline }));
+        ++state.statistics.requests;
+        state.statistics.max_queued_requests = max(state.statistics.max_queued_requests, state.queued.size());
+        return {};
+    });
+    if (result.is_error()) {
+        dbgln_if(STORAGE_DEVICE_DEBUG, "StorageRequestQueue: Failed to queue request for block {}", request.block_index());
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+    dispatch();
+}
+
+void StorageRequestQueue::dispatch()
+{
+    for (;;) {
+        auto hardware_queue_depth = m_device.hardware_queue_depth();
+        Batch batch;
+        bool has_taken_requests = m_state.with([&](State& state) {
+            if (state.queued.is_empty())
+                return false;
+            if (state.plug_depth > 0 && state.queued.size() < maximum_plugged_requests)
+                return false;
+            if (state.in_flight.size() + state.dispatching_count >= hardware_queue_depth)
+                return false;
+            take_request_and_its_neighbors(state, pick_next_request(state), batch);
+            ++state.dispatching_count;
+            return true;
+        });
+        if (!has_taken_requests)
+            return;
+        submit(batch);
+    }
+}
+
+size_t StorageRequestQueue::pick_next_request(State& state) const
+{
+    VERIFY(!state.queued.is_empty());
+    if (state.policy == Policy::FIFO)
+        return 0;
+
+    auto now = TimeManagement::the().monotonic_time();
+    Optional<size_t> most_overdue_index;
+    Optional<size_t> next_in_sweep_index;
+    size_t lowest_index = 0;
+    for (size_t index = 0; index < state.queued.size(); ++index) {
+        auto const& queued_request = state.queued[index];
+        if (queued_request.deadline <= now && (!most_overdue_index.has_value() || queued_request.deadline < state.queued[*most_overdue_index].deadline))
+            most_overdue_index = index;
+        auto block_index = queued_request.request->block_index();
+        if (block_index >= state.next_block_index && (!next_in_sweep_index.has_value() || block_index < state.queued[*next_in_sweep_index].request->block_index()))
+            next_in_sweep_index = index;
+        if (block_index < state.queued[lowest_index].request->block_index())
+            lowest_index = index;
+    }
+
+    if (most_overdue_index.has_value()) {
+        ++state.statistics.expired_deadlines;
+        return *most_overdue_index;
+    }
+    // Once we reached the end of the device, start over from the lowest block that anyone is waiting for.
+    return next_in_sweep_index.value_or(lowest_index);
+}
+
+bool StorageRequestQueue::is_mergeable(AsyncBlockDeviceRequest const& request) const
+{
+    return request.buffer().is_kernel_buffer() && request.buffer_size() >= request.block_count() * m_device.block_size();
+}
+
+void StorageRequestQueue::take_request_and_its_neighbors(State& state, size_t index, Batch& batch) const
+{
+    batch.unchecked_append(state.queued.take(index));
+    auto const& first_request = *batch.first().request;
+    u64 first_block_index = first_request.block_index();
+    u64 end_block_index = first_block_index + first_request.block_count();
+
+    if (is_mergeable(first_request)) {
+        auto max_block_count = m_device.max_blocks_per_request();
+        bool has_merged_request = true;
+        while (has_merged_request && batch.size() < maximum_merged_requests) {
+            has_merged_request = false;
+            for (size_t candidate_index = 0; candidate_index < state.queued.size(); ++candidate_index) {
+                auto const& candidate = *state.queued[candidate_index].request;
+                if (candidate.request_type() != first_request.request_type() || !is_mergeable(candidate))
+                    continue;
+                if (end_block_index - first_block_index + candidate.block_count() > max_block_count)
+                    continue;
+                if (candidate.block_index() == end_block_index)
+                    end_block_index += candidate.block_count();
+                else if (candidate.block_index() + candidate.block_count() == first_block_index)
+                    first_block_index = candidate.block_index();
+                else
+                    continue;
+                batch.unchecked_append(state.queued.take(candidate_index));
+                has_merged_request = true;
+                break;
+            }
+        }
+    }
+
+    state.next_block_index = end_block_index;
+}
+
+ErrorOr<NonnullOwnPtr<StorageRequestQueue::MergedRequest>> StorageRequestQueue::try_create_merged_request(Batch& batch)
+{
+    auto request_type = batch.first().request->request_type();
+    u64 block_index = batch.first().request->block_index();
+    u32 block_count = 0;
+    for (auto const& part : batch) {
+        block_index = min(block_index, part.request->block_index());
+        block_count += part.request->block_count();
+    }
+    size_t size = block_count * m_device.block_size();
+
+    Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages;
+    for (size_t offset = 0; offset < size; offset += PAGE_SIZE)
+        TRY(pages.try_append(TRY(MM.allocate_physical_page())));
+    auto buffer = TRY(Memory::ScatterGatherList::try_create(pages.span(), size, "StorageRequestQueue Merged Request"sv));
+    if (!buffer)
+        return ENOMEM;
+
+    auto* data = buffer->dma_region().as_ptr();
+    if (request_type == AsyncBlockDeviceRequest::Write) {
+        for (auto& part : batch) {
+            auto& request = *part.request;
+            auto offset = (request.block_index() - block_index) * m_device.block_size();
+            TRY(request.read_from_buffer(request.buffer(), data + offset, request.block_count() * m_device.block_size()));
+        }
+    }
+
+    // NOTE: Requests must be started once they exist, so this has to be the last thing that can fail.
+    auto request = TRY(adopt_nonnull_lock_ref_or_enomem(new (nothrow) AsyncBlockDeviceRequest(m_device, request_type, block_index, block_count, UserOrKernelBuffer::for_kernel_buffer(data), size, AsyncBlockDeviceRequest::IsMerged::Yes)));
+    return adopt_nonnull_own_or_enomem(new (nothrow) MergedRequest { .request = move(request), .buffer = buffer.release_nonnull(), .parts = move(batch) });
+}
+
+void StorageRequestQueue::submit(Batch& batch)
+{
+    if (batch.size() > 1) {
+        auto merged_request_or_error = try_create_merged_request(batch);
+        if (!merged_request_or_error.is_error()) {
+            auto merged_request = merged_request_or_error.release_value();
+            auto request = merged_request->request;
+            dbgln_if(STORAGE_DEVICE_DEBUG, "StorageRequestQueue: Merged {} requests into block {}, count {}", merged_request->parts.size(), request->block_index(), request->block_count());
+            auto result = m_state.with([&](State& state) -> ErrorOr<void> {
+                --state.dispatching_count;
+                TRY(state.in_flight.try_ensure_capacity(state.in_flight.size() + 1));
+                ++state.statistics.dispatched_requests;
+                state.statistics.merged_requests += merged_request->parts.size();
+                state.in_flight.unchecked_append(InFlightRequest { .request = request.ptr(), .merged = move(merged_request) });
+                return {};
+            });
+            // This goes through the device's own request list, which then hands it right back to the driver.
+            if (!result.is_error())
+                result = m_device.try_queue_request(request);
+            if (result.is_error()) {
+                // The merged request was never started, so we have to finish its parts ourselves.
+                auto in_flight_request = m_state.with([&](State& state) -> Optional<InFlightRequest> {
+                    for (size_t index = 0; index < state.in_flight.size(); ++index) {
+                        if (state.in_flight[index].request == request.ptr())
+                            return state.in_flight.take(index);
+                    }
+                    return {};
+                });
+                auto& parts = in_flight_request.has_value() ? in_flight_request->merged->parts : merged_request->parts;
+                for (auto& part : parts)
+                    part.request->complete(AsyncDeviceRequest::Failure);
+            }
+            return;
+        }
+
+        // We couldn't merge the requests, so send the first one on its own and put the others back.
+        dbgln_if(STORAGE_DEVICE_DEBUG, "StorageRequestQueue: Failed to merge requests: {}", merged_request_or_error.error());
+        for (size_t index = 1; index < batch.size(); ++index) {
+            auto& request = *batch[index].request;
+            auto result = m_state.with([&](State& state) {
+                return state.queued.try_insert(index - 1, move(batch[index]));
+            });
+            if (result.is_error())
+                request.complete(AsyncDeviceRequest::Failure);
+        }
+    }
+
+    auto& request = *batch.first().request;
+    auto result = m_state.with([&](State& state) -> ErrorOr<void> {
+        --state.dispatching_count;
+        TRY(state.in_flight.try_append(InFlightRequest { .request = &request, .merged = nullptr }));
+        ++state.statistics.dispatched_requests;
+        return {};
+    });
+    if (result.is_error()) {
+        request.complete(AsyncDeviceRequest::Failure);
+        return;
+    }
+    m_device.submit_request(request);
+}
+
+void StorageRequestQueue::finish_merged_request(MergedRequest& merged_request)
+{
+    auto result = merged_request.request->get_request_result();
+    auto* data = merged_request.buffer->dma_region().as_ptr();
+    for (auto& part : merged_request.parts) {
+        auto& request = *part.request;
+        auto part_result = result;
+        if (result == AsyncDeviceRequest::Success && request.request_type() == AsyncBlockDeviceRequest::Read) {
+            auto offset = (request.block_index() - merged_request.request->block_index()) * m_device.block_size();
+            if (request.write_to_buffer(request.buffer(), data + offset, request.block_count() * m_device.block_size()).is_error())
+                part_result = AsyncDeviceRequest::MemoryFault;
+        }
+        request.complete(part_result);
+    }
+}
+
+void StorageRequestQueue::request_finished(AsyncDeviceRequest const& finished_request)
+{
+    auto in_flight_request = m_state.with([&](State& state) -> Optional<InFlightRequest> {
+        for (size_t index = 0; index < state.in_flight.size(); ++index) {
+            if (state.in_flight[index].request == &finished_request)
+                return state.in_flight.take(index);
+        }
+        return {};
+    });
+    // Requests that were merged into another one are finished by us, and never were in flight on their own.
+    if (!in_flight_request.has_value())
+        return;
+    if (in_flight_request->merged)
+        finish_merged_request(*in_flight_request->merged);
+    dispatch();
+}
+
+void StorageRequestQueue::plug()
+{
+    m_state.with([](State& state) {
+        ++state.plug_depth;
+        ++state.statistics.plugs;
+    });
+}
+
+void StorageRequestQueue::unplug()
+{
+    m_state.with([](State& state) {
+        VERIFY(state.plug_depth > 0);
+        --state.plug_depth;
+    });
+    dispatch();
+}
+
+StorageRequestQueue::Policy StorageRequestQueue::policy() const
+{
+    return m_state.with([](State const& state) { return state.policy; });
+}
+
+void StorageRequestQueue::set_policy(Policy policy)
+{
+    m_state.with([&](State& state) { state.policy = policy; });
+}
+
+StorageRequestQueue::Statistics StorageRequestQueue::statistics() const
+{
+    auto statistics = m_state.with([](State const& state) {
+        auto statistics = state.statistics;
+        statistics.queued_requests = state.queued.size();
+        statistics.in_flight_requests = state.in_flight.size();
+        return statistics;
+    });
+    statistics.max_blocks_per_request = m_device.max_blocks_per_request();
+    return statistics;
+}
+
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <Kernel/Devices/BlockDevice.h>
+#include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/ScatterGatherList.h>
+
+namespace Kernel {
+
+class StorageDevice;
+
+// Sits between the users of a storage device and its driver. Requests wait here until the driver has
+// room for them, and on their way out, adjacent ones are merged into a single, larger transfer.
+// While the queue is plugged, requests only pile up, so that a whole batch can be merged before any of it is sent.
+//
+// Only requests with kernel buffers are merged, as the data of a merged request has to be copied
+// around in whatever context its driver happens to complete it.
+class StorageRequestQueue {
+    AK_MAKE_NONCOPYABLE(StorageRequestQueue);
+    AK_MAKE_NONMOVABLE(StorageRequestQueue);
+
+public:
+    enum class Policy {
+        // Requests go to the driver in the order they arrived.
+        FIFO,
+        // Requests go to the driver sorted by block index, sweeping across the device in one direction,
+        // unless one of them has been waiting for longer than its deadline.
+        Deadline,
+    };
+
+    static StringView policy_to_string_view(Policy);
+    static Optional<Policy> policy_from_string_view(StringView);
+
+    struct Statistics {
+        // Requests that were added to the queue.
+        u64 requests { 0 };
+        // Requests that were handed to the driver, counting every merged request once.
+        u64 dispatched_requests { 0 };
+        // Requests that were merged into another one, and thus never went to the driver on their own.
+        u64 merged_requests { 0 };
+        u64 expired_deadlines { 0 };
+        u64 plugs { 0 };
+        size_t queued_requests { 0 };
+        size_t max_queued_requests { 0 };
+        size_t in_flight_requests { 0 };
+        // Merged requests don't grow beyond this many blocks.
+        u32 max_blocks_per_request { 0 };
+    };
+
+    explicit StorageRequestQueue(StorageDevice&);
+
+    void add_request(AsyncBlockDeviceRequest&);
+    void request_finished(AsyncDeviceRequest const&);
+
+    void plug();
+    void unplug();
+
+    Policy policy() const;
+    void set_policy(Policy);
+
+    Statistics statistics() const;
+
+private:
+    static constexpr size_t maximum_merged_requests = 32;
+    // Even a plugged queue lets requests through once this many piled up.
+    static constexpr size_t maximum_plugged_requests = 128;
+    static constexpr Duration read_deadline = Duration::from_milliseconds(500);
+    static constexpr Duration write_deadline = Duration::from_seconds(5);
+
+    struct QueuedRequest {
+        NonnullLockRefPtr<AsyncBlockDeviceRequest> request;
+        MonotonicTime deadline;
+    };
+    using Batch = Vector<QueuedRequest, maximum_merged_requests>;
+
+    struct MergedRequest {
+        NonnullLockRefPtr<AsyncBlockDeviceRequest> request;
+        NonnullLockRefPtr<Memory::ScatterGatherList> buffer;
+        Batch parts;
+    };
+
+    struct InFlightRequest {
+        AsyncDeviceRequest const* request { nullptr };
+        // Only set for requests that were merged out of several queued ones.
+        OwnPtr<MergedRequest> merged;
+    };
+
+    struct State {
+        Policy policy { Policy::Deadline };
+        // In the order the requests arrived.
+        Vector<QueuedRequest> queued;
+        Vector<InFlightRequest> in_flight;
+        // Requests that were taken off the queue, but aren't in flight yet.
+        size_t dispatching_count { 0 };
+        size_t plug_depth { 0 };
+        // The deadline policy continues sweeping from here.
+        u64 next_block_index { 0 };
+        Statistics statistics;
+    };
+
+    void dispatch();
+    size_t pick_next_request(State&) const;
+    void take_request_and_its_neighbors(State&, size_t index, Batch&) const;
+    bool is_mergeable(AsyncBlockDeviceRequest const&) const;
+    ErrorOr<NonnullOwnPtr<MergedRequest>> try_create_merged_request(Batch&);
+    void submit(Batch&);
+    void finish_merged_request(MergedRequest&);
+
+    StorageDevice& m_device;
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
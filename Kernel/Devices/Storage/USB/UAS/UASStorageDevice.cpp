@@ -139,7 +139,7 @@ u32 UASStorageDevice::optimal_block_count(u32 blocks)
     return blocks - (blocks % m_optimal_transfer_length_granularity.value());
 }
 
-void UASStorageDevice::start_request(AsyncBlockDeviceRequest& request)
+void UASStorageDevice::submit_request(AsyncBlockDeviceRequest& request)
 {
     if (request.request_type() == AsyncBlockDeviceRequest::RequestType::Read) {
         if (do_read(request.block_index(), request.block_count(), request.buffer(), request.buffer_size()).is_error()) {
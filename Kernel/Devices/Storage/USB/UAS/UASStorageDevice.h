@@ -20,7 +20,7 @@ public:
 private:
     UASInterface& m_interface;
 
-    virtual void start_request(AsyncBlockDeviceRequest&) override;
+    virtual void submit_request(AsyncBlockDeviceRequest&) override;
     virtual CommandSet command_set() const override { return CommandSet::SCSI; }
 
     u32 optimal_block_count(u32 blocks);
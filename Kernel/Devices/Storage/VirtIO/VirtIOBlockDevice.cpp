@@ -129,9 +129,14 @@ ErrorOr<void> VirtIOBlockDevice::handle_device_config_change()
     return {};
 }
 
-void VirtIOBlockDevice::start_request(AsyncBlockDeviceRequest& request)
+u32 VirtIOBlockDevice::max_blocks_per_request() const
 {
-    dbgln_if(VIRTIO_DEBUG, "VirtIOBlockDevice::start_request type={}", (int)request.request_type());
+    return (INFLIGHT_BUFFER_SIZE - sizeof(VirtIOBlkReqTrailer)) / block_size();
+}
+
+void VirtIOBlockDevice::submit_request(AsyncBlockDeviceRequest& request)
+{
+    dbgln_if(VIRTIO_DEBUG, "VirtIOBlockDevice::submit_request type={}", (int)request.request_type());
 
     m_current_request.with([&](auto& current_request) {
         VERIFY(current_request.is_null());
@@ -21,8 +21,9 @@ public:
     // ^StorageDevice
     virtual CommandSet command_set() const override { return CommandSet::SCSI; }
 
-    // ^BlockDevice
-    virtual void start_request(AsyncBlockDeviceRequest&) override;
+    // ^StorageDevice
+    virtual void submit_request(AsyncBlockDeviceRequest&) override;
+    virtual u32 max_blocks_per_request() const override;
 
 protected:
     // ^VirtIO::Device
@@ -28,6 +28,17 @@ ErrorOr<File::VMObjectAndMemoryType> AnonymousFile::vmobject_and_memory_type_for
     };
 }
 
+// NOTE: Like a memfd on other systems, this looks like a regular file that isn't linked anywhere.
+//       It isn't backed by an inode either, so st_ino is always 0.
+ErrorOr<struct stat> AnonymousFile::stat() const
+{
+    struct stat st = {};
+    st.st_mode = S_IFREG | 0600;
+    st.st_size = m_vmobject->size();
+    st.st_blksize = PAGE_SIZE;
+    return st;
+}
+
 ErrorOr<NonnullOwnPtr<KString>> AnonymousFile::pseudo_path(OpenFileDescription const&) const
 {
     return KString::try_create(":anonymous-file:"sv);
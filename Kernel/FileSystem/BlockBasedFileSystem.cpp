@@ -6,6 +6,7 @@
 
 #include <AK/IntrusiveList.h>
 #include <Kernel/Debug.h>
+#include <Kernel/Devices/BlockDevice.h>
 #include <Kernel/FileSystem/BlockBasedFileSystem.h>
 #include <Kernel/Tasks/Process.h>
 
@@ -155,6 +156,12 @@ ErrorOr<void> BlockBasedFileSystem::write_block(BlockIndex index, UserOrKernelBu
             u64 base_offset = index.value() * logical_block_size() + offset;
             auto nwritten = TRY(file_description().write(base_offset, data, count));
             VERIFY(nwritten == count);
+            // Keep a cached copy of this block (if any) in sync with what's on disk now.
+            if (auto* entry = cache->get(index); entry && entry->has_data) {
+                memcpy(entry->data + offset, buffered_data.data(), count);
+                if (cache->entry_is_dirty(*entry))
+                    cache->mark_clean(*entry);
+            }
             return {};
         }
 
@@ -211,6 +218,26 @@ ErrorOr<void> BlockBasedFileSystem::write_blocks(BlockIndex index, unsigned coun
 {
     VERIFY(m_device_block_size);
     dbgln_if(BBFS_DEBUG, "BlockBasedFileSystem::write_blocks {}, count={}", index, count);
+    if (!allow_cache && count > 1) {
+        // Uncached writes of consecutive blocks are coalesced into a single transfer.
+        return m_cache.with_exclusive([&](auto& cache) -> ErrorOr<void> {
+            for (unsigned i = 0; i < count; ++i)
+                flush_specific_block_if_needed(BlockIndex { index.value() + i });
+            u64 base_offset = index.value() * logical_block_size();
+            auto nwritten = TRY(file_description().write(base_offset, data, count * logical_block_size()));
+            VERIFY(nwritten == count * logical_block_size());
+            // Keep cached copies of these blocks (if any) in sync with what's on disk now.
+            for (unsigned i = 0; i < count; ++i) {
+                auto* entry = cache->get(BlockIndex { index.value() + i });
+                if (!entry || !entry->has_data)
+                    continue;
+                TRY(data.read(entry->data, i * logical_block_size(), logical_block_size()));
+                if (cache->entry_is_dirty(*entry))
+                    cache->mark_clean(*entry);
+            }
+            return {};
+        });
+    }
     for (unsigned i = 0; i < count; ++i) {
         TRY(write_block(BlockIndex { index.value() + i }, data.offset(i * logical_block_size()), logical_block_size(), 0, allow_cache));
     }
@@ -253,6 +280,17 @@ ErrorOr<void> BlockBasedFileSystem::read_blocks(BlockIndex index, unsigned count
         return EINVAL;
     if (count == 1)
         return read_block(index, &buffer, logical_block_size(), 0, allow_cache);
+    if (!allow_cache) {
+        // Uncached reads of consecutive blocks are coalesced into a single transfer.
+        return m_cache.with_exclusive([&](auto&) -> ErrorOr<void> {
+            for (unsigned i = 0; i < count; ++i)
+                const_cast<BlockBasedFileSystem*>(this)->flush_specific_block_if_needed(BlockIndex { index.value() + i });
+            u64 base_offset = index.value() * logical_block_size();
+            auto nread = TRY(file_description().read(buffer, base_offset, count * logical_block_size()));
+            VERIFY(nread == count * logical_block_size());
+            return {};
+        });
+    }
     auto out = buffer;
     for (unsigned i = 0; i < count; ++i) {
         TRY(read_block(BlockIndex { index.value() + i }, &out, logical_block_size(), 0, allow_cache));
@@ -278,12 +316,66 @@ void BlockBasedFileSystem::flush_specific_block_if_needed(BlockIndex index)
     });
 }
 
+// Sends the dirty blocks to the device in plugged batches, so that its request queue can merge neighboring blocks into larger transfers.
+static ErrorOr<size_t> flush_dirty_entries_to_block_device(BlockDevice& device, DiskCache& cache, size_t logical_block_size)
+{
+    static constexpr size_t max_requests_per_batch = 64;
+
+    Vector<CacheEntry*> dirty_entries;
+    ErrorOr<void> result {};
+    cache.for_each_dirty_entry([&](CacheEntry& entry) {
+        if (!result.is_error())
+            result = dirty_entries.try_append(&entry);
+    });
+    TRY(result);
+
+    auto blocks_per_entry = logical_block_size / device.block_size();
+    for (size_t batch_start = 0; batch_start < dirty_entries.size(); batch_start += max_requests_per_batch) {
+        Vector<NonnullLockRefPtr<AsyncBlockDeviceRequest>, max_requests_per_batch> requests;
+        device.plug();
+        for (size_t index = batch_start; index < min(batch_start + max_requests_per_batch, dirty_entries.size()); ++index) {
+            auto& entry = *dirty_entries[index];
+            auto request_or_error = device.try_make_request<AsyncBlockDeviceRequest>(AsyncBlockDeviceRequest::Write,
+                entry.block_index.value() * blocks_per_entry, blocks_per_entry, UserOrKernelBuffer::for_kernel_buffer(entry.data), logical_block_size);
+            if (request_or_error.is_error()) {
+                result = request_or_error.release_error();
+                break;
+            }
+            requests.unchecked_append(request_or_error.release_value());
+        }
+        // NOTE: Nothing goes out while the device is plugged, so we have to unplug it before waiting for anything.
+        device.unplug();
+
+        for (auto& request : requests) {
+            auto request_result = request->wait();
+            if (result.is_error())
+                continue;
+            if (request_result.wait_result().was_interrupted())
+                result = EINTR;
+            else if (request_result.request_result() != AsyncDeviceRequest::Success)
+                result = EIO;
+        }
+        TRY(result);
+    }
+    return dirty_entries.size();
+}
+
 void BlockBasedFileSystem::flush_writes_impl()
 {
     size_t count = 0;
     m_cache.with_exclusive([&](auto& cache) {
         if (!cache->is_dirty())
             return;
+        auto& file = file_description().file();
+        if (file.is_block_device() && logical_block_size() % static_cast<BlockDevice&>(file).block_size() == 0) {
+            auto count_or_error = flush_dirty_entries_to_block_device(static_cast<BlockDevice&>(file), *cache, logical_block_size());
+            if (!count_or_error.is_error()) {
+                cache->mark_all_clean();
+                dbgln("{}: Flushed {} blocks to disk", class_name(), count_or_error.value());
+                return;
+            }
+            dbgln("{}: Failed to flush blocks in batches, writing them one by one: {}", class_name(), count_or_error.error());
+        }
         cache->for_each_dirty_entry([&](CacheEntry& entry) {
             auto base_offset = entry.block_index.value() * logical_block_size();
             auto entry_data_buffer = UserOrKernelBuffer::for_kernel_buffer(entry.data);
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Singleton.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/DentryCache.h>
+#include <Kernel/FileSystem/Inode.h>
+
+namespace Kernel {
+
+static Singleton<DentryCache> s_the;
+
+DentryCache& DentryCache::the()
+{
+    return *s_the;
+}
+
+ErrorOr<NonnullRefPtr<Inode>> DentryCache::lookup(Inode& parent, StringView name)
+{
+    // File systems that don't tell us about changes to their directories (like ProcFS and SysFS,
+    // whose contents come and go with processes and devices) have to be asked every time.
+    if (!parent.fs().supports_watchers())
+        return parent.lookup(name);
+
+    auto parent_identifier = parent.identifier();
+    Optional<u64> generation;
+    auto cached = m_state.with([&](auto& state) -> Optional<ErrorOr<NonnullRefPtr<Inode>>> {
+        auto it = state.entries.find(Key { parent_identifier, name });
+        if (it == state.entries.end()) {
+            ++state.statistics.misses;
+            generation = state.generation;
+            return {};
+        }
+
+        auto& entry = *it->value;
+        if (entry.is_negative) {
+            ++state.statistics.negative_hits;
+            state.lru_list.remove(entry);
+            state.lru_list.append(entry);
+            return ErrorOr<NonnullRefPtr<Inode>> { ENOENT };
+        }
+
+        auto inode = entry.inode.strong_ref();
+        if (!inode) {
+            // The inode was evicted from its file system in the meantime.
+            ++state.statistics.misses;
+            remove_entry(state, entry);
+            generation = state.generation;
+            return {};
+        }
+
+        ++state.statistics.hits;
+        state.lru_list.remove(entry);
+        state.lru_list.append(entry);
+        return ErrorOr<NonnullRefPtr<Inode>> { NonnullRefPtr<Inode> { *inode } };
+    });
+    if (cached.has_value())
+        return cached.release_value();
+
+    auto child_or_error = parent.lookup(name);
+    if (!child_or_error.is_error())
+        insert(parent_identifier, name, child_or_error.value().ptr(), *generation);
+    else if (child_or_error.error().code() == ENOENT)
+        insert(parent_identifier, name, nullptr, *generation);
+    return child_or_error;
+}
+
+void DentryCache::insert(InodeIdentifier parent, StringView name, Inode* inode, u64 generation)
+{
+    auto name_string_or_error = KString::try_create(name);
+    if (name_string_or_error.is_error())
+        return;
+    LockWeakPtr<Inode> weak_inode;
+    if (inode) {
+        auto weak_inode_or_error = inode->try_make_weak_ptr<Inode>();
+        if (weak_inode_or_error.is_error())
+            return;
+        weak_inode = weak_inode_or_error.release_value();
+    }
+    auto new_entry_or_error = adopt_nonnull_own_or_enomem(new (nothrow) Entry {
+        .parent = parent,
+        .name = name_string_or_error.release_value(),
+        .inode = move(weak_inode),
+        .is_negative = !inode,
+        .lru_list_node = {},
+    });
+    if (new_entry_or_error.is_error())
+        return;
+    auto new_entry = new_entry_or_error.release_value();
+
+    m_state.with([&](auto& state) {
+        // Someone changed a directory while we were looking at the file system, and we can't tell whether
+        // it was this one. Not caching the result is always correct, so don't bother finding out.
+        if (state.generation != generation)
+            return;
+
+        auto key = new_entry->key();
+        if (state.entries.contains(key))
+            return;
+
+        while (state.size_in_bytes + new_entry->size_in_bytes() > maximum_size_in_bytes && !state.lru_list.is_empty()) {
+            ++state.statistics.evictions;
+            remove_entry(state, *state.lru_list.first());
+        }
+
+        auto& entry = *new_entry;
+        if (state.entries.try_set(key, move(new_entry)).is_error())
+            return;
+        state.lru_list.append(entry);
+        state.size_in_bytes += entry.size_in_bytes();
+    });
+}
+
+void DentryCache::remove_entry(State& state, Entry& entry)
+{
+    state.lru_list.remove(entry);
+    state.size_in_bytes -= entry.size_in_bytes();
+    // NOTE: This destroys the entry, which owns the name that the key refers to.
+    state.entries.remove(entry.key());
+}
+
+void DentryCache::invalidate(InodeIdentifier parent, StringView name)
+{
+    m_state.with([&](auto& state) {
+        ++state.generation;
+        auto it = state.entries.find(Key { parent, name });
+        if (it == state.entries.end())
+            return;
+        dbgln_if(DENTRY_CACHE_DEBUG, "DentryCache: Invalidating {}/{}", parent, name);
+        ++state.statistics.invalidations;
+        remove_entry(state, *it->value);
+    });
+}
+
+void DentryCache::invalidate_file_system(FileSystemID fsid)
+{
+    m_state.with([&](auto& state) {
+        ++state.generation;
+        state.entries.remove_all_matching([&](auto const&, auto const& entry) {
+            if (entry->parent.fsid() != fsid)
+                return false;
+            state.lru_list.remove(*entry);
+            state.size_in_bytes -= entry->size_in_bytes();
+            return true;
+        });
+    });
+}
+
+DentryCache::Statistics DentryCache::statistics() const
+{
+    return m_state.with([&](auto const& state) {
+        auto statistics = state.statistics;
+        statistics.entry_count = state.entries.size();
+        statistics.size_in_bytes = state.size_in_bytes;
+        statistics.maximum_size_in_bytes = maximum_size_in_bytes;
+        return statistics;
+    });
+}
+
+}
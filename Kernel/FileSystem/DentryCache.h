@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/StringView.h>
+#include <Kernel/FileSystem/InodeIdentifier.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Library/LockWeakPtr.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// A global cache of directory entries, keyed by (parent directory, name).
+// Path resolution consults it before asking the file system, and it remembers names that
+// don't exist as well, since build systems and shells keep probing for the same missing files.
+//
+// Entries don't keep their inodes alive, and are only created for file systems that notify
+// their inodes about added and removed children, which is what keeps the cache coherent.
+// Deleted directories need no special treatment: They are empty by then, so only negative entries
+// can be left below them, and those stay correct even if the inode number gets reused.
+class DentryCache {
+public:
+    static DentryCache& the();
+
+    // Looks up `name` in `parent`, going to the file system only on a cache miss.
+    ErrorOr<NonnullRefPtr<Inode>> lookup(Inode& parent, StringView name);
+
+    void invalidate(InodeIdentifier parent, StringView name);
+    void invalidate_file_system(FileSystemID);
+
+    struct Statistics {
+        u64 hits { 0 };
+        u64 negative_hits { 0 };
+        u64 misses { 0 };
+        u64 invalidations { 0 };
+        u64 evictions { 0 };
+        size_t entry_count { 0 };
+        size_t size_in_bytes { 0 };
+        size_t maximum_size_in_bytes { 0 };
+    };
+    Statistics statistics() const;
+
+private:
+    static constexpr size_t maximum_size_in_bytes = 2 * MiB;
+
+    struct Key {
+        InodeIdentifier parent;
+        StringView name;
+
+        bool operator==(Key const&) const = default;
+    };
+
+    struct KeyTraits : public DefaultTraits<Key> {
+        static unsigned hash(Key const& key) { return pair_int_hash(pair_int_hash(key.parent.fsid().value(), u64_hash(key.parent.index().value())), key.name.hash()); }
+        static bool equals(Key const& a, Key const& b) { return a == b; }
+    };
+
+    struct Entry {
+        InodeIdentifier parent;
+        NonnullOwnPtr<KString> name;
+        // Null for negative entries, i.e. names that are known not to exist.
+        LockWeakPtr<Inode> inode;
+        bool is_negative { false };
+        IntrusiveListNode<Entry> lru_list_node;
+
+        Key key() const { return { parent, name->view() }; }
+        size_t size_in_bytes() const { return sizeof(Entry) + name->length(); }
+    };
+
+    struct State {
+        HashMap<Key, NonnullOwnPtr<Entry>, KeyTraits> entries;
+        // Least recently used entries are at the front.
+        IntrusiveList<&Entry::lru_list_node> lru_list;
+        // Bumped on every invalidation, so that a lookup that raced with one doesn't insert a stale entry.
+        u64 generation { 0 };
+        size_t size_in_bytes { 0 };
+        Statistics statistics;
+    };
+
+    static void remove_entry(State&, Entry&);
+    void insert(InodeIdentifier parent, StringView name, Inode* inode, u64 generation);
+
+    SpinlockProtected<State, LockRank::None> m_state {};
+};
+
+}
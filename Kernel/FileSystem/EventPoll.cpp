@@ -0,0 +1,258 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KString.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+BlockFlags EventPoll::block_flags_for_events(u32 events)
+{
+    BlockFlags block_flags = BlockFlags::WriteError | BlockFlags::WriteHangUp; // always want POLLERR, POLLHUP
+    if (events & POLLIN)
+        block_flags |= BlockFlags::Read;
+    if (events & POLLOUT)
+        block_flags |= BlockFlags::Write;
+    if (events & POLLPRI)
+        block_flags |= BlockFlags::ReadPriority;
+    if (events & POLLWRBAND)
+        block_flags |= BlockFlags::WritePriority;
+    if (events & POLLRDHUP)
+        block_flags |= BlockFlags::ReadHangUp;
+    return block_flags;
+}
+
+u32 EventPoll::events_for_unblocked_flags(BlockFlags unblocked_flags)
+{
+    u32 events = 0;
+    if (has_flag(unblocked_flags, BlockFlags::WriteHangUp))
+        events |= POLLHUP;
+    if (has_flag(unblocked_flags, BlockFlags::WriteError))
+        events |= POLLERR;
+    if (has_flag(unblocked_flags, BlockFlags::Read))
+        events |= POLLIN;
+    if (has_flag(unblocked_flags, BlockFlags::ReadPriority))
+        events |= POLLPRI;
+    if (!has_flag(unblocked_flags, BlockFlags::WriteHangUp) && has_flag(unblocked_flags, BlockFlags::Write))
+        events |= POLLOUT;
+    if (has_flag(unblocked_flags, BlockFlags::WritePriority))
+        events |= POLLWRBAND;
+    if (has_flag(unblocked_flags, BlockFlags::ReadHangUp))
+        events |= POLLRDHUP;
+    return events;
+}
+
+EventPoll::Entry::Entry(EventPoll& event_poll, int fd, OpenFileDescription& description, u32 events, u64 data)
+    : FileBlockerSet::Observer(description)
+    , event_poll(event_poll)
+    , fd(fd)
+    , file(description.file())
+    , description(description)
+    , events(events)
+    , data(data)
+{
+}
+
+void EventPoll::Entry::file_state_may_have_changed()
+{
+    bool did_become_ready = event_poll.m_state.with([&](auto& state) {
+        if (!is_registered)
+            return false;
+        // NOTE: Bumping the generation makes sure a concurrent wait that found this entry
+        //       not ready doesn't drop it from the ready list after this notification.
+        ++generation;
+        if (ready_list_node.is_in_list())
+            return false;
+        state.ready_list.append(*this);
+        return true;
+    });
+    if (did_become_ready)
+        event_poll.evaluate_block_conditions();
+}
+
+void EventPoll::Entry::observed_description_will_be_destroyed()
+{
+    RefPtr<Entry> protector;
+    event_poll.m_state.with([&](auto& state) {
+        if (!is_registered)
+            return;
+        protector = this;
+        state.entries.remove(fd);
+        unregister_entry(state, *this);
+    });
+}
+
+ErrorOr<NonnullRefPtr<EventPoll>> EventPoll::try_create()
+{
+    return adopt_nonnull_ref_or_enomem(new (nothrow) EventPoll);
+}
+
+EventPoll::~EventPoll()
+{
+    auto entries = m_state.with([](auto& state) {
+        auto entries = move(state.entries);
+        for (auto& it : entries)
+            unregister_entry(state, *it.value);
+        return entries;
+    });
+    for (auto& it : entries)
+        it.value->file->blocker_set().remove_observer(*it.value);
+}
+
+void EventPoll::unregister_entry(State& state, Entry& entry)
+{
+    entry.is_registered = false;
+    if (entry.ready_list_node.is_in_list())
+        state.ready_list.remove(entry);
+}
+
+bool EventPoll::can_read(OpenFileDescription const&, u64) const
+{
+    return m_state.with([](auto& state) { return !state.ready_list.is_empty(); });
+}
+
+ErrorOr<NonnullOwnPtr<KString>> EventPoll::pseudo_path(OpenFileDescription const&) const
+{
+    return m_state.with([](auto& state) -> ErrorOr<NonnullOwnPtr<KString>> {
+        return KString::formatted("EventPoll:({})", state.entries.size());
+    });
+}
+
+ErrorOr<void> EventPoll::add(int fd, OpenFileDescription& description, u32 events, u64 data)
+{
+    if (description.is_event_poll())
+        return EINVAL;
+
+    MutexLocker locker(m_control_lock);
+    auto entry = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Entry(*this, fd, description, events, data)));
+    RefPtr<Entry> replaced_entry;
+
+    TRY(m_state.with([&](auto& state) -> ErrorOr<void> {
+        if (auto existing_entry = state.entries.get(fd); existing_entry.has_value()) {
+            // NOTE: If the fd has been closed and reused since it was added, the old entry
+            //       refers to a description that is still alive somewhere else. We follow the fd.
+            if (&existing_entry.value()->description == &description)
+                return EEXIST;
+            replaced_entry = existing_entry.value();
+        }
+        TRY(state.entries.try_set(fd, entry));
+        if (replaced_entry)
+            unregister_entry(state, *replaced_entry);
+        // New entries start out on the ready list so the next wait picks up their current state.
+        entry->is_registered = true;
+        state.ready_list.append(*entry);
+        return {};
+    }));
+
+    if (replaced_entry)
+        replaced_entry->file->blocker_set().remove_observer(*replaced_entry);
+    entry->file->blocker_set().add_observer(*entry);
+
+    evaluate_block_conditions();
+    return {};
+}
+
+ErrorOr<void> EventPoll::modify(int fd, u32 events, u64 data)
+{
+    MutexLocker locker(m_control_lock);
+    TRY(m_state.with([&](auto& state) -> ErrorOr<void> {
+        auto entry = state.entries.get(fd);
+        if (!entry.has_value())
+            return ENOENT;
+        auto& entry_ref = *entry.value();
+        entry_ref.events = events;
+        entry_ref.data = data;
+        ++entry_ref.generation;
+        if (!entry_ref.ready_list_node.is_in_list())
+            state.ready_list.append(entry_ref);
+        return {};
+    }));
+
+    evaluate_block_conditions();
+    return {};
+}
+
+ErrorOr<void> EventPoll::remove(int fd)
+{
+    MutexLocker locker(m_control_lock);
+    auto entry = TRY(m_state.with([&](auto& state) -> ErrorOr<NonnullRefPtr<Entry>> {
+        auto entry = state.entries.take(fd);
+        if (!entry.has_value())
+            return ENOENT;
+        unregister_entry(state, *entry.value());
+        return entry.release_value();
+    }));
+
+    entry->file->blocker_set().remove_observer(*entry);
+    return {};
+}
+
+ErrorOr<void> EventPoll::collect_ready_events(Vector<event_poll_event>& events, size_t max_events)
+{
+    struct Candidate {
+        NonnullRefPtr<Entry> entry;
+        NonnullRefPtr<OpenFileDescription> description;
+        u64 generation { 0 };
+        u32 events { 0 };
+        u64 data { 0 };
+        u32 ready_events { 0 };
+    };
+    Vector<Candidate> candidates;
+
+    // NOTE: Readiness is evaluated without holding the state lock, since checking it may
+    //       take the locks of the observed files, which in turn notify us with theirs held.
+    TRY(m_state.with([&](auto& state) -> ErrorOr<void> {
+        TRY(candidates.try_ensure_capacity(state.ready_list.size_slow()));
+        for (auto& entry : state.ready_list) {
+            // The description is being destroyed, and its entry will be unregistered shortly.
+            if (!entry.description.try_ref())
+                continue;
+            candidates.unchecked_append({ entry, adopt_ref(entry.description), entry.generation, entry.events, entry.data });
+        }
+        return {};
+    }));
+
+    size_t ready_count = 0;
+    size_t evaluated_count = 0;
+    for (auto& candidate : candidates) {
+        if (ready_count == max_events)
+            break;
+        auto unblocked_flags = candidate.description->should_unblock(block_flags_for_events(candidate.events));
+        candidate.ready_events = events_for_unblocked_flags(unblocked_flags) & (candidate.events | POLLERR | POLLHUP);
+        if (candidate.ready_events != 0)
+            ++ready_count;
+        ++evaluated_count;
+    }
+
+    TRY(events.try_ensure_capacity(events.size() + ready_count));
+
+    m_state.with([&](auto& state) {
+        for (size_t i = 0; i < evaluated_count; ++i) {
+            auto& candidate = candidates[i];
+            auto& entry = *candidate.entry;
+            if (!entry.is_registered)
+                continue;
+            bool is_edge_triggered = entry.events & EVENT_POLL_EDGE_TRIGGERED;
+            bool state_is_unchanged = entry.generation == candidate.generation;
+            bool should_stay_ready = true;
+            if (candidate.ready_events != 0) {
+                events.unchecked_append({ candidate.ready_events, candidate.data });
+                should_stay_ready = !is_edge_triggered || !state_is_unchanged;
+            } else {
+                should_stay_ready = !state_is_unchanged;
+            }
+            // NOTE: Another thread waiting on this EventPoll may have dropped the entry already.
+            if (!should_stay_ready && entry.ready_list_node.is_in_list())
+                state.ready_list.remove(entry);
+        }
+    });
+    return {};
+}
+
+}
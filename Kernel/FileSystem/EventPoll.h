@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/AtomicRefCounted.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Vector.h>
+#include <Kernel/API/POSIX/sys/event_poll.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+
+namespace Kernel {
+
+// EventPoll is a persistent interest set: file descriptions are registered once, and the
+// EventPoll observes their blocker sets from then on. Whenever the state of a registered
+// file may have changed, its entry is put on the ready list, so waiting only has to look
+// at entries that actually saw activity instead of every registered file.
+//
+// Level-triggered entries stay on the ready list for as long as they are ready, while
+// edge-triggered entries are dropped from it as soon as they have been reported once.
+class EventPoll final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<EventPoll>> try_create();
+    virtual ~EventPoll() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return true; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "EventPoll"sv; }
+    virtual bool is_event_poll() const override { return true; }
+
+    ErrorOr<void> add(int fd, OpenFileDescription&, u32 events, u64 data);
+    ErrorOr<void> modify(int fd, u32 events, u64 data);
+    ErrorOr<void> remove(int fd);
+
+    // Appends up to `max_events` ready events to `events`, without blocking.
+    ErrorOr<void> collect_ready_events(Vector<event_poll_event>& events, size_t max_events);
+
+    // Translate between POLL* events and the flags that file blockers understand.
+    static Thread::FileBlocker::BlockFlags block_flags_for_events(u32 events);
+    static u32 events_for_unblocked_flags(Thread::FileBlocker::BlockFlags);
+
+private:
+    EventPoll() = default;
+
+    class Entry final
+        : public AtomicRefCounted<Entry>
+        , public FileBlockerSet::Observer {
+    public:
+        Entry(EventPoll&, int fd, OpenFileDescription&, u32 events, u64 data);
+
+        virtual void file_state_may_have_changed() override;
+        virtual void observed_description_will_be_destroyed() override;
+
+        EventPoll& event_poll;
+        int const fd;
+        NonnullRefPtr<File> const file;
+        OpenFileDescription& description;
+
+        // NOTE: These are guarded by the EventPoll state lock.
+        u32 events { 0 };
+        u64 data { 0 };
+        u64 generation { 0 };
+        bool is_registered { false };
+        IntrusiveListNode<Entry, RefPtr<Entry>> ready_list_node;
+    };
+
+    struct State {
+        HashMap<int, NonnullRefPtr<Entry>> entries;
+        IntrusiveList<&Entry::ready_list_node> ready_list;
+    };
+
+    static void unregister_entry(State&, Entry&);
+
+    mutable SpinlockProtected<State, LockRank::None> m_state {};
+
+    // Serializes add(), modify() and remove(), so that registering an entry and starting
+    // to observe its file happen atomically with respect to each other.
+    Mutex m_control_lock { "EventPoll"sv };
+};
+
+}
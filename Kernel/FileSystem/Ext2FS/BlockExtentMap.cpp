@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/Ext2FS/BlockExtentMap.h>
+
+namespace Kernel {
+
+size_t Ext2FSBlockExtentMap::upper_bound(BlockIndex block) const
+{
+    // Returns the index of the first extent that starts after the given block.
+    size_t low = 0;
+    size_t high = m_extents.size();
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (m_extents[middle].logical_start <= block)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+Ext2FSBlockExtentMap::Extent const* Ext2FSBlockExtentMap::find(BlockIndex block) const
+{
+    auto index = upper_bound(block);
+    if (index == 0)
+        return nullptr;
+    auto const& extent = m_extents[index - 1];
+    if (!extent.contains(block))
+        return nullptr;
+    return &extent;
+}
+
+Ext2FSBlockExtentMap::Extent const* Ext2FSBlockExtentMap::find_next(BlockIndex block) const
+{
+    auto index = upper_bound(block);
+    if (index > 0 && m_extents[index - 1].contains(block))
+        return &m_extents[index - 1];
+    if (index == m_extents.size())
+        return nullptr;
+    return &m_extents[index];
+}
+
+Ext2FSBlockExtentMap::BlockIndex Ext2FSBlockExtentMap::get(BlockIndex block) const
+{
+    auto const* extent = find(block);
+    if (!extent)
+        return 0;
+    return extent->on_disk_start.value() + (block.value() - extent->logical_start.value());
+}
+
+ErrorOr<void> Ext2FSBlockExtentMap::append_extent(Vector<Extent>& extents, Extent const& extent)
+{
+    if (!extents.is_empty()) {
+        auto& last = extents.last();
+        VERIFY(last.logical_end() <= extent.logical_start.value());
+        if (last.logical_end() == extent.logical_start.value()
+            && last.on_disk_end() == extent.on_disk_start.value()
+            && static_cast<u64>(last.length) + extent.length <= NumericLimits<u32>::max()) {
+            last.length += extent.length;
+            return {};
+        }
+    }
+    return extents.try_append(extent);
+}
+
+ErrorOr<void> Ext2FSBlockExtentMap::append(BlockIndex logical_block, BlockIndex on_disk_block)
+{
+    VERIFY(on_disk_block != 0);
+    return append_extent(m_extents, { logical_block, on_disk_block, 1 });
+}
+
+ErrorOr<void> Ext2FSBlockExtentMap::set(BlockIndex logical_block, BlockIndex on_disk_block)
+{
+    VERIFY(on_disk_block != 0);
+
+    if (find(logical_block)) {
+        if (get(logical_block) == on_disk_block)
+            return {};
+        TRY(remove(logical_block));
+    }
+
+    // Now that no extent contains the block, try to grow one of its neighbors to cover it.
+    auto index = upper_bound(logical_block);
+    auto* previous = index > 0 ? &m_extents[index - 1] : nullptr;
+    auto* next = index < m_extents.size() ? &m_extents[index] : nullptr;
+
+    bool extends_previous = previous
+        && previous->logical_end() == logical_block.value()
+        && previous->on_disk_end() == on_disk_block.value()
+        && previous->length < NumericLimits<u32>::max();
+    bool extends_next = next
+        && next->logical_start.value() == logical_block.value() + 1
+        && next->on_disk_start.value() == on_disk_block.value() + 1
+        && next->length < NumericLimits<u32>::max();
+
+    if (extends_previous && extends_next && static_cast<u64>(previous->length) + next->length < NumericLimits<u32>::max()) {
+        previous->length += next->length + 1;
+        m_extents.remove(index);
+        return {};
+    }
+    if (extends_previous) {
+        ++previous->length;
+        return {};
+    }
+    if (extends_next) {
+        next->logical_start = logical_block;
+        next->on_disk_start = on_disk_block;
+        ++next->length;
+        return {};
+    }
+    return m_extents.try_insert(index, { logical_block, on_disk_block, 1 });
+}
+
+ErrorOr<void> Ext2FSBlockExtentMap::remove(BlockIndex logical_block)
+{
+    auto index = upper_bound(logical_block);
+    if (index == 0 || !m_extents[index - 1].contains(logical_block))
+        return {};
+
+    auto& extent = m_extents[index - 1];
+    u64 offset = logical_block.value() - extent.logical_start.value();
+
+    if (extent.length == 1) {
+        m_extents.remove(index - 1);
+        return {};
+    }
+    if (offset == 0) {
+        extent.logical_start = extent.logical_start.value() + 1;
+        extent.on_disk_start = extent.on_disk_start.value() + 1;
+        --extent.length;
+        return {};
+    }
+    if (offset == extent.length - 1u) {
+        --extent.length;
+        return {};
+    }
+
+    // The block is in the middle of the extent, so split it in two.
+    Extent tail {
+        logical_block.value() + 1,
+        extent.on_disk_start.value() + offset + 1,
+        static_cast<u32>(extent.length - offset - 1),
+    };
+    TRY(m_extents.try_insert(index, tail));
+    m_extents[index - 1].length = offset;
+    return {};
+}
+
+ErrorOr<void> Ext2FSBlockExtentMap::merge(Ext2FSBlockExtentMap&& other)
+{
+    if (other.m_extents.is_empty())
+        return {};
+    if (m_extents.is_empty()) {
+        m_extents = move(other.m_extents);
+        return {};
+    }
+
+    auto insertion_index = upper_bound(other.m_extents.first().logical_start);
+
+    Vector<Extent> extents;
+    TRY(extents.try_ensure_capacity(m_extents.size() + other.m_extents.size()));
+    for (size_t i = 0; i < insertion_index; ++i)
+        TRY(append_extent(extents, m_extents[i]));
+    for (auto const& extent : other.m_extents)
+        TRY(append_extent(extents, extent));
+    for (size_t i = insertion_index; i < m_extents.size(); ++i)
+        TRY(append_extent(extents, m_extents[i]));
+
+    m_extents = move(extents);
+    other.m_extents.clear();
+    return {};
+}
+
+}
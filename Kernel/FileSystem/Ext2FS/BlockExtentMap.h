@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/Vector.h>
+#include <Kernel/FileSystem/BlockBasedFileSystem.h>
+
+namespace Kernel {
+
+// Maps logical block indices of an inode to on-disk block indices.
+// Runs of logical blocks that are also contiguous on disk are stored as a single extent,
+// and the extents are kept sorted so that lookups are a binary search.
+class Ext2FSBlockExtentMap {
+public:
+    using BlockIndex = BlockBasedFileSystem::BlockIndex;
+
+    struct Extent {
+        BlockIndex logical_start;
+        BlockIndex on_disk_start;
+        u32 length { 0 };
+
+        u64 logical_end() const { return logical_start.value() + length; }
+        u64 on_disk_end() const { return on_disk_start.value() + length; }
+        bool contains(BlockIndex block) const { return block >= logical_start && block.value() < logical_end(); }
+    };
+
+    // A run of blocks starting at some logical block.
+    // An on-disk start of 0 means that the run is a hole.
+    struct Run {
+        BlockIndex on_disk_start;
+        u64 length { 0 };
+    };
+
+    BlockIndex get(BlockIndex) const;
+    Extent const* find(BlockIndex) const;
+
+    // Returns the first extent that ends after the given block, if any.
+    Extent const* find_next(BlockIndex) const;
+
+    // NOTE: Blocks must be appended in ascending logical order.
+    ErrorOr<void> append(BlockIndex logical_block, BlockIndex on_disk_block);
+
+    ErrorOr<void> set(BlockIndex logical_block, BlockIndex on_disk_block);
+    ErrorOr<void> remove(BlockIndex logical_block);
+
+    // Inserts all extents of another map, which must not overlap any of the extents in this one.
+    ErrorOr<void> merge(Ext2FSBlockExtentMap&&);
+
+    void clear() { m_extents.clear(); }
+    size_t extent_count() const { return m_extents.size(); }
+    Vector<Extent> const& extents() const { return m_extents; }
+
+private:
+    size_t upper_bound(BlockIndex) const;
+    static ErrorOr<void> append_extent(Vector<Extent>&, Extent const&);
+
+    Vector<Extent> m_extents;
+};
+
+}
@@ -11,71 +11,100 @@ namespace Kernel {
 
 static constexpr size_t max_blocks_in_view = 16384; // 2^14
 
+// Mostly contiguous files only need a handful of extents per window, so we can afford to keep every window
+// we have looked at so far. Heavily fragmented files are bounded by starting over once this many extents are cached.
+static constexpr size_t max_cached_extents = 16384;
+
 Ext2FSBlockView::Ext2FSBlockView(Ext2FSInode& inode)
     : m_inode(inode) {};
 
 ErrorOr<void> Ext2FSBlockView::ensure_block(BlockBasedFileSystem::BlockIndex block)
 {
-    VERIFY(m_block_list_lock.is_locked());
-    if (block >= m_first_block && block <= m_last_block && m_block_list_initialized.was_set())
+    VERIFY(m_block_map_lock.is_locked());
+    u64 window = block.value() / max_blocks_in_view;
+    if (m_loaded_windows.contains(window))
         return {};
 
-    BlockBasedFileSystem::BlockIndex new_first_block = (block.value() / max_blocks_in_view) * max_blocks_in_view;
-    BlockBasedFileSystem::BlockIndex new_last_block = new_first_block.value() + max_blocks_in_view - 1;
-
-    m_block_list = TRY(m_inode.compute_block_list(new_first_block, new_last_block));
+    if (m_block_map.extent_count() >= max_cached_extents) {
+        m_block_map.clear();
+        m_loaded_windows.clear();
+    }
 
-    m_first_block = new_first_block;
-    m_last_block = new_last_block;
+    BlockBasedFileSystem::BlockIndex first_block = window * max_blocks_in_view;
+    BlockBasedFileSystem::BlockIndex last_block = first_block.value() + max_blocks_in_view - 1;
 
-    m_block_list_initialized.set();
+    auto window_map = TRY(m_inode.compute_block_extents(first_block, last_block));
+    TRY(m_loaded_windows.try_set(window));
+    if (auto result = m_block_map.merge(move(window_map)); result.is_error()) {
+        m_loaded_windows.remove(window);
+        return result.release_error();
+    }
 
     return {};
 }
 
 ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_block(BlockBasedFileSystem::BlockIndex block)
 {
-    MutexLocker block_list_locker(m_block_list_lock);
+    MutexLocker block_map_locker(m_block_map_lock);
     TRY(ensure_block(block));
+    return m_block_map.get(block);
+}
 
-    auto it = m_block_list.find(block);
-    if (it == m_block_list.end())
-        return BlockBasedFileSystem::BlockIndex { 0 };
+ErrorOr<Ext2FSBlockExtentMap::Run> Ext2FSBlockView::get_block_run(BlockBasedFileSystem::BlockIndex block, u64 max_length)
+{
+    VERIFY(max_length > 0);
+    MutexLocker block_map_locker(m_block_map_lock);
+    TRY(ensure_block(block));
 
-    auto on_disk_block = (*it).value;
-    VERIFY(on_disk_block != 0);
-    return on_disk_block;
+    // NOTE: Holes end at the start of the next extent, but we only know about extents in windows that have been loaded.
+    u64 end_of_window = (block.value() / max_blocks_in_view + 1) * max_blocks_in_view;
+    auto const* extent = m_block_map.find_next(block);
+    if (!extent || extent->logical_start > block) {
+        u64 hole_end = extent ? min(extent->logical_start.value(), end_of_window) : end_of_window;
+        return Ext2FSBlockExtentMap::Run { 0, min(hole_end - block.value(), max_length) };
+    }
+
+    u64 offset = block.value() - extent->logical_start.value();
+    return Ext2FSBlockExtentMap::Run { extent->on_disk_start.value() + offset, min(extent->length - offset, max_length) };
 }
 
-ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_or_allocate_block(BlockBasedFileSystem::BlockIndex block, bool zero_newly_allocated_block, bool allow_cache)
+ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSBlockView::get_or_allocate_block(BlockBasedFileSystem::BlockIndex block, size_t blocks_needed, bool zero_newly_allocated_block, bool allow_cache)
 {
-    MutexLocker block_list_locker(m_block_list_lock);
+    MutexLocker block_map_locker(m_block_map_lock);
     TRY(ensure_block(block));
 
-    auto it = m_block_list.find(block);
-    if (it != m_block_list.end()) {
-        auto on_disk_block = (*it).value;
-        VERIFY(on_disk_block != 0);
+    if (auto on_disk_block = m_block_map.get(block); on_disk_block != 0)
         return on_disk_block;
+
+    // Try to place the new block right after the one before it.
+    BlockBasedFileSystem::BlockIndex goal = 0;
+    if (block != 0) {
+        if (auto previous_on_disk_block = m_block_map.get(block.value() - 1); previous_on_disk_block != 0)
+            goal = previous_on_disk_block.value() + 1;
     }
 
-    auto on_disk_block = TRY(m_inode.allocate_block(block, zero_newly_allocated_block, allow_cache));
-    TRY(m_block_list.try_set(block, on_disk_block));
+    auto on_disk_block = TRY(m_inode.allocate_block(goal, blocks_needed, zero_newly_allocated_block, allow_cache));
+    TRY(m_block_map.set(block, on_disk_block));
 
     return on_disk_block;
 }
 
 ErrorOr<void> Ext2FSBlockView::write_block_pointer(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex on_disk_index)
 {
-    MutexLocker block_list_locker(m_block_list_lock);
+    MutexLocker block_map_locker(m_block_map_lock);
 
     TRY(m_inode.write_block_pointer(logical_block_index, on_disk_index));
 
-    if (on_disk_index == 0)
-        m_block_list.remove(logical_block_index);
-    else
-        TRY(m_block_list.try_set(logical_block_index, on_disk_index));
+    // Windows that haven't been loaded yet will pick up the new pointer from the disk.
+    if (!m_loaded_windows.contains(logical_block_index.value() / max_blocks_in_view))
+        return {};
 
+    auto result = on_disk_index == 0 ? m_block_map.remove(logical_block_index) : m_block_map.set(logical_block_index, on_disk_index);
+    if (result.is_error()) {
+        // The pointer made it to the disk, so just forget everything we know and reload it when needed.
+        m_block_map.clear();
+        m_loaded_windows.clear();
+    }
     return {};
 }
 
@@ -315,60 +315,125 @@ auto Ext2FS::allocate_blocks(GroupIndex preferred_group_index, size_t count) ->
 
     MutexLocker locker(m_lock);
 
-    size_t free_blocks = 0;
-    for (GroupIndex i = 1; i <= m_block_group_count; i = GroupIndex { i.value() + 1 }) {
-        free_blocks += group_descriptor(i).bg_free_blocks_count;
-        if (free_blocks >= count)
-            break;
+    if (super_block().s_free_blocks_count < count)
+        return Error::from_errno(ENOSPC);
+
+    BlockIndex goal = 0;
+    while (blocks.size() < count) {
+        auto run = TRY(allocate_block_run(preferred_group_index, goal, count - blocks.size()));
+        for (size_t i = 0; i < run.count; ++i)
+            blocks.unchecked_append(run.first_block.value() + i);
+        goal = run.first_block.value() + run.count;
     }
 
-    if (free_blocks < count)
-        return Error::from_errno(ENOSPC);
+    VERIFY(blocks.size() == count);
+    return blocks;
+}
 
-    auto group_index = preferred_group_index;
+auto Ext2FS::allocate_block_run(GroupIndex preferred_group_index, BlockIndex goal, size_t max_count) -> ErrorOr<BlockRun>
+{
+    VERIFY(max_count > 0);
+    MutexLocker locker(m_lock);
 
-    if (!group_descriptor(preferred_group_index).bg_free_blocks_count) {
-        group_index = 1;
-    }
+    if (super_block().s_free_blocks_count == 0)
+        return Error::from_errno(ENOSPC);
 
-    while (blocks.size() < count) {
-        bool found_a_group = false;
-        if (group_descriptor(group_index).bg_free_blocks_count) {
-            found_a_group = true;
-        } else {
-            if (group_index == preferred_group_index)
-                group_index = 1;
-            for (; group_index <= m_block_group_count; group_index = GroupIndex { group_index.value() + 1 }) {
-                if (group_descriptor(group_index).bg_free_blocks_count) {
-                    found_a_group = true;
-                    break;
-                }
-            }
-        }
+    auto first_group_index = goal != 0 ? group_index_from_block_index(goal) : preferred_group_index;
+    if (first_group_index == 0 || first_group_index > m_block_group_count)
+        first_group_index = 1;
 
-        VERIFY(found_a_group);
-        auto const& bgd = group_descriptor(group_index);
+    size_t blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+    max_count = min(max_count, blocks_in_group);
 
-        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    for (u64 i = 0; i < m_block_group_count; ++i) {
+        GroupIndex group_index = (first_group_index.value() - 1 + i) % m_block_group_count + 1;
+        auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
+        if (!bgd.bg_free_blocks_count)
+            continue;
 
-        int blocks_in_group = min(blocks_per_group(), super_block().s_blocks_count);
+        auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
         auto block_bitmap = cached_bitmap->bitmap(blocks_in_group);
-
         BlockIndex first_block_in_group = first_block_of_group(group_index);
-        size_t free_region_size = 0;
-        auto first_unset_bit_index = block_bitmap.find_longest_range_of_unset_bits(count - blocks.size(), free_region_size);
-        VERIFY(first_unset_bit_index.has_value());
-        dbgln_if(EXT2_DEBUG, "Ext2FS: allocating free region of size: {} [{}]", free_region_size, group_index);
-        for (size_t i = 0; i < free_region_size; ++i) {
-            BlockIndex block_index = (first_unset_bit_index.value() + i) + first_block_in_group.value();
-            TRY(set_block_allocation_state(block_index, true));
-            blocks.unchecked_append(block_index);
-            dbgln_if(EXT2_DEBUG, "  allocated > {}", block_index);
-        }
+
+        bool goal_is_in_group = goal != 0 && group_index_from_block_index(goal) == group_index;
+        size_t goal_bit = goal_is_in_group ? goal.value() - first_block_in_group.value() : 0;
+
+        struct FreeRange {
+            size_t first_bit { 0 };
+            size_t length { 0 };
+        };
+
+        // NOTE: The bitmap is searched a machine word at a time, so full and empty stretches are skipped quickly.
+        auto find_free_range = [&](size_t from, size_t min_length) -> Optional<FreeRange> {
+            auto length = block_bitmap.find_next_range_of_unset_bits(from, min_length, max_count);
+            if (!length.has_value())
+                return {};
+            return FreeRange { from, length.value() };
+        };
+
+        Optional<FreeRange> range;
+        // First try to continue right at the goal, so the caller ends up with contiguous blocks.
+        if (goal_is_in_group && !block_bitmap.get(goal_bit))
+            range = find_free_range(goal_bit, 1);
+        // Otherwise look for a free range that can satisfy the whole request, preferably after the goal.
+        if (!range.has_value())
+            range = find_free_range(goal_bit, max_count);
+        if (!range.has_value() && goal_bit != 0)
+            range = find_free_range(0, max_count);
+        // Settle for whatever we can get.
+        if (!range.has_value())
+            range = find_free_range(goal_bit, 1);
+        if (!range.has_value() && goal_bit != 0)
+            range = find_free_range(0, 1);
+        if (!range.has_value())
+            continue;
+
+        auto bit_index = range->first_bit;
+        auto count = range->length;
+        block_bitmap.set_range_and_verify_that_all_bits_flip(bit_index, count, true);
+        cached_bitmap->dirty = true;
+
+        m_super_block.s_free_blocks_count -= count;
+        bgd.bg_free_blocks_count -= count;
+        m_super_block_dirty = true;
+        m_block_group_descriptors_dirty = true;
+
+        BlockRun allocated_run { first_block_in_group.value() + bit_index, count };
+        dbgln_if(EXT2_DEBUG, "Ext2FS: allocated {} blocks at {} [{}] (goal: {})", allocated_run.count, allocated_run.first_block, group_index, goal);
+        return allocated_run;
     }
 
-    VERIFY(blocks.size() == count);
-    return blocks;
+    dmesgln("Ext2FS: allocate_block_run found no free blocks, despite the superblock claiming there are {}", super_block().s_free_blocks_count);
+    return EIO;
+}
+
+ErrorOr<void> Ext2FS::free_block_run(BlockRun run)
+{
+    if (run.count == 0)
+        return {};
+    VERIFY(run.first_block != 0);
+    MutexLocker locker(m_lock);
+
+    auto group_index = group_index_from_block_index(run.first_block);
+    VERIFY(group_index_from_block_index(run.first_block.value() + run.count - 1) == group_index);
+    size_t bit_index = run.first_block.value() - first_block_of_group(group_index).value();
+    auto& bgd = const_cast<ext2_group_desc&>(group_descriptor(group_index));
+
+    dbgln_if(EXT2_DEBUG, "Ext2FS: Freeing {} blocks at {} (in bitmap block {})", run.count, run.first_block, bgd.bg_block_bitmap);
+    auto* cached_bitmap = TRY(get_bitmap_block(bgd.bg_block_bitmap));
+    auto block_bitmap = cached_bitmap->bitmap(blocks_per_group());
+    if (block_bitmap.count_in_range(bit_index, run.count, true) != run.count) {
+        dbgln("Ext2FS: Blocks {}-{} weren't all allocated", run.first_block, run.first_block.value() + run.count - 1);
+        return EIO;
+    }
+    block_bitmap.set_range(bit_index, run.count, false);
+    cached_bitmap->dirty = true;
+
+    m_super_block.s_free_blocks_count += run.count;
+    bgd.bg_free_blocks_count += run.count;
+    m_super_block_dirty = true;
+    m_block_group_descriptors_dirty = true;
+    return {};
 }
 
 ErrorOr<InodeIndex> Ext2FS::allocate_inode(GroupIndex preferred_group)
@@ -772,7 +837,9 @@ ErrorOr<void> Ext2FS::flush_writes()
             if (cached_inode == nullptr)
                 return true;
 
-            return cached_inode->ref_count() == 1 && !cached_inode->has_watchers();
+            // Inodes with pages in the page cache are kept around as well, so their cached pages stay useful.
+            // Those pages are reclaimed once memory gets tight, at which point the Inode can go too.
+            return cached_inode->ref_count() == 1 && !cached_inode->has_watchers() && !cached_inode->has_cached_pages();
         });
     }
 
@@ -843,6 +910,10 @@ ErrorOr<NonnullRefPtr<Inode>> Ext2FS::get_inode(InodeIdentifier inode) const
 
     TRY(read_block(block_index, &buffer, size, offset));
 
+    // NOTE: The page cache works in whole pages, so it can only be used if a page always covers whole blocks.
+    if (Kernel::is_regular_file(new_inode->m_raw_inode.i_mode) && logical_block_size() <= PAGE_SIZE)
+        TRY(new_inode->try_enable_page_cache());
+
     TRY(m_inode_cache.try_set(inode.index(), new_inode));
     return new_inode;
 }
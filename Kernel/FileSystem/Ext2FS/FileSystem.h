@@ -62,8 +62,6 @@ public:
     virtual StringView class_name() const override { return "Ext2FS"sv; }
     virtual Inode& root_inode() override;
 
-    using BlockList = HashMap<BlockBasedFileSystem::BlockIndex, BlockBasedFileSystem::BlockIndex>;
-
 private:
     AK_TYPEDEF_DISTINCT_ORDERED_ID(unsigned, GroupIndex);
 
@@ -102,6 +100,15 @@ private:
     BlockIndex first_block_of_block_group_descriptors() const;
     ErrorOr<InodeIndex> allocate_inode(GroupIndex preferred_group = 0);
     ErrorOr<Vector<BlockIndex>> allocate_blocks(GroupIndex preferred_group_index, size_t count);
+
+    struct BlockRun {
+        BlockIndex first_block { 0 };
+        size_t count { 0 };
+    };
+
+    // Allocates between 1 and max_count contiguous blocks, preferring to continue right at the goal block.
+    ErrorOr<BlockRun> allocate_block_run(GroupIndex preferred_group_index, BlockIndex goal, size_t max_count);
+    ErrorOr<void> free_block_run(BlockRun);
     GroupIndex group_index_from_inode(InodeIndex) const;
     GroupIndex group_index_from_block_index(BlockIndex) const;
     BlockIndex first_block_of_group(GroupIndex) const;
@@ -13,12 +13,17 @@
 #include <Kernel/FileSystem/Ext2FS/FileSystem.h>
 #include <Kernel/FileSystem/Ext2FS/Inode.h>
 #include <Kernel/FileSystem/InodeMetadata.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/UnixTypes.h>
 
 namespace Kernel {
 
 static constexpr size_t max_inline_symlink_length = 60;
 
+static constexpr size_t min_preallocation_window = 8;
+static constexpr size_t max_preallocation_window = 256;
+static constexpr size_t max_blocks_per_allocation = 2048;
+
 u8 Ext2FSInode::to_ext2_file_type(mode_t mode)
 {
     if (Kernel::is_regular_file(mode))
@@ -253,10 +258,10 @@ ErrorOr<void> Ext2FSInode::write_block_pointer(BlockBasedFileSystem::BlockIndex
     VERIFY_NOT_REACHED();
 }
 
-ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem::BlockIndex first_block, BlockBasedFileSystem::BlockIndex last_block) const
+ErrorOr<Ext2FSBlockExtentMap> Ext2FSInode::compute_block_extents(BlockBasedFileSystem::BlockIndex first_block, BlockBasedFileSystem::BlockIndex last_block) const
 {
-    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::block_list_for_inode(): i_size={}, i_blocks={}", identifier(), m_raw_inode.i_size, m_raw_inode.i_blocks);
-    Ext2FS::BlockList list {};
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::compute_block_extents(): i_size={}, i_blocks={}", identifier(), m_raw_inode.i_size, m_raw_inode.i_blocks);
+    Ext2FSBlockExtentMap map {};
 
     // If we are handling a symbolic link, the path is stored in the 60 bytes in
     // the inode that are used for the 12 direct and 3 indirect block pointers,
@@ -264,7 +269,7 @@ ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem:
     // block contains the destination path. The file size corresponds to the
     // path length of the destination.
     if (Kernel::is_symlink(m_raw_inode.i_mode) && m_raw_inode.i_blocks == 0)
-        return list;
+        return map;
 
     unsigned const block_size = fs().logical_block_size();
     unsigned const entries_per_block = EXT2_ADDR_PER_BLOCK(&fs().super_block());
@@ -275,7 +280,8 @@ ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem:
         if (logical_index > last_block)
             return IterationDecision::Break;
 
-        TRY(list.try_set(logical_index, on_disk_index));
+        // NOTE: Blocks are visited in ascending logical order, so they can simply be appended.
+        TRY(map.append(logical_index, on_disk_index));
         return IterationDecision::Continue;
     };
 
@@ -284,9 +290,16 @@ ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem:
         auto* array = (u32*)array_storage.data();
         auto buffer = UserOrKernelBuffer::for_kernel_buffer((u8*)array);
         TRY(fs().read_block(array_block_index, &buffer, block_size, 0));
+        u64 const blocks_per_entry = AK::pow<u64>(entries_per_block, level - 1);
         for (unsigned i = 0; i < block_size / sizeof(u32); ++i) {
+            u64 entry_logical_index = current_logical_index + i * blocks_per_entry;
+            if (entry_logical_index > last_block.value())
+                return IterationDecision::Break;
+            // Don't bother reading indirect blocks that only cover blocks before the requested range.
+            if (entry_logical_index + blocks_per_entry <= first_block.value())
+                continue;
             if (array[i] != 0) {
-                if (TRY(callback(current_logical_index + i * AK::pow(entries_per_block, level - 1), array[i])) == IterationDecision::Break)
+                if (TRY(callback(entry_logical_index, array[i])) == IterationDecision::Break)
                     return IterationDecision::Break;
             }
         }
@@ -302,13 +315,13 @@ ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem:
 
     ByteBuffer block_storage[3] = {};
 
-    if (first_block < singly_indirect_block_capacity() && m_raw_inode.i_block[EXT2_IND_BLOCK]) {
+    if (first_block < singly_indirect_block_capacity() && last_block >= EXT2_NDIR_BLOCKS && m_raw_inode.i_block[EXT2_IND_BLOCK]) {
         TRY(process_block_array(EXT2_NDIR_BLOCKS, 1, m_raw_inode.i_block[EXT2_IND_BLOCK], block_storage[0], [&](auto logical_block_index, auto on_disk_index) -> ErrorOr<IterationDecision> {
             return set_block(logical_block_index, on_disk_index);
         }));
     }
 
-    if (first_block < doubly_indirect_block_capacity() && m_raw_inode.i_block[EXT2_DIND_BLOCK]) {
+    if (first_block < doubly_indirect_block_capacity() && last_block >= singly_indirect_block_capacity() && m_raw_inode.i_block[EXT2_DIND_BLOCK]) {
         TRY(process_block_array(singly_indirect_block_capacity(), 2, m_raw_inode.i_block[EXT2_DIND_BLOCK], block_storage[1], [&](auto logical_block_index, auto on_disk_index) -> ErrorOr<IterationDecision> {
             return process_block_array(logical_block_index, 1, on_disk_index, block_storage[0], [&](auto logical_block_index2, auto on_disk_index2) -> ErrorOr<IterationDecision> {
                 return set_block(logical_block_index2, on_disk_index2);
@@ -316,7 +329,7 @@ ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem:
         }));
     }
 
-    if (first_block < triply_indirect_block_capacity() && m_raw_inode.i_block[EXT2_TIND_BLOCK]) {
+    if (first_block < triply_indirect_block_capacity() && last_block >= doubly_indirect_block_capacity() && m_raw_inode.i_block[EXT2_TIND_BLOCK]) {
         TRY(process_block_array(doubly_indirect_block_capacity(), 3, m_raw_inode.i_block[EXT2_TIND_BLOCK], block_storage[2], [&](auto logical_block_index, auto on_disk_index) -> ErrorOr<IterationDecision> {
             return process_block_array(logical_block_index, 2, on_disk_index, block_storage[1], [&](auto logical_block_index2, auto on_disk_index2) -> ErrorOr<IterationDecision> {
                 return process_block_array(logical_block_index2, 1, on_disk_index2, block_storage[0], [&](auto logical_block_index3, auto on_disk_index3) -> ErrorOr<IterationDecision> {
@@ -326,7 +339,7 @@ ErrorOr<Ext2FS::BlockList> Ext2FSInode::compute_block_list(BlockBasedFileSystem:
         }));
     }
 
-    return list;
+    return map;
 }
 
 ErrorOr<void> Ext2FSInode::free_all_blocks()
@@ -335,6 +348,8 @@ ErrorOr<void> Ext2FSInode::free_all_blocks()
 
     dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::free_all_blocks(): i_size={}, i_blocks={}", identifier(), m_raw_inode.i_size, m_raw_inode.i_blocks);
 
+    TRY(discard_preallocated_blocks());
+
     if (Kernel::is_symlink(m_raw_inode.i_mode) && m_raw_inode.i_blocks == 0)
         return {};
 
@@ -404,6 +419,11 @@ Ext2FSInode::Ext2FSInode(Ext2FS& fs, InodeIndex index)
 
 Ext2FSInode::~Ext2FSInode()
 {
+    if (m_preallocated_blocks.count > 0) {
+        MutexLocker locker(m_inode_lock);
+        (void)discard_preallocated_blocks();
+    }
+
     if (m_raw_inode.i_links_count == 0) {
         // Alas, we have nowhere to propagate any errors that occur here.
         (void)fs().free_inode(*this);
@@ -509,6 +529,15 @@ ErrorOr<size_t> Ext2FSInode::read_bytes_locked(off_t offset, size_t count, UserO
 
     bool allow_cache = !description || !description->is_direct();
 
+    if (m_page_cache) {
+        // NOTE: Reading from the page cache doesn't modify the file, so doing this while holding the lock in shared mode is fine.
+        auto& page_cache = const_cast<InodePageCache&>(*m_page_cache);
+        if (allow_cache)
+            return page_cache.read(offset, count, buffer, size());
+        // Direct reads go straight to the disk, so make sure it has seen everything that's still sitting in the page cache.
+        TRY(page_cache.writeback(offset, count));
+    }
+
     int const block_size = fs().logical_block_size();
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
@@ -553,6 +582,11 @@ ErrorOr<void> Ext2FSInode::resize(u64 new_size)
         return ENOSPC;
 
     if (new_size < size()) {
+        if (m_page_cache)
+            m_page_cache->truncate(new_size);
+
+        TRY(discard_preallocated_blocks());
+
         auto block_size = fs().logical_block_size();
         BlockBasedFileSystem::BlockIndex first_block_logical_index = ceil_div(new_size, block_size);
         BlockBasedFileSystem::BlockIndex last_block_logical_index = size() / block_size;
@@ -603,12 +637,32 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     bool allow_cache = !description || !description->is_direct();
 
     auto const block_size = fs().logical_block_size();
-    auto new_size = max(static_cast<u64>(offset) + count, size());
+    auto old_size = size();
+    auto new_size = max(static_cast<u64>(offset) + count, old_size);
 
     TRY(resize(new_size));
 
     BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
 
+    if (m_page_cache) {
+        // Allocate all blocks up front, so running out of space is reported to the writer instead of being lost during writeback.
+        // NOTE: Blocks beyond the old end of the file are never read back into the page cache, and the pages covering them
+        //       are always written out in their entirety, so only blocks that fill a hole need to be zeroed.
+        BlockBasedFileSystem::BlockIndex last_block_logical_index = (offset + count - 1) / block_size;
+        for (auto bi = first_block_logical_index; bi <= last_block_logical_index; bi = bi.value() + 1) {
+            bool fills_hole = bi.value() * block_size < old_size;
+            auto block_index = TRY(m_block_view.get_or_allocate_block(bi, last_block_logical_index.value() - bi.value() + 1, fills_hole, allow_cache));
+            TRY(m_block_view.write_block_pointer(bi, block_index));
+        }
+
+        auto nwritten = TRY(m_page_cache->write(offset, count, data, old_size));
+        if (!allow_cache)
+            TRY(m_page_cache->writeback(offset, count));
+
+        did_modify_contents();
+        return nwritten;
+    }
+
     size_t offset_into_first_block = offset % block_size;
 
     size_t nwritten = 0;
@@ -620,7 +674,8 @@ ErrorOr<size_t> Ext2FSInode::write_bytes_locked(off_t offset, size_t count, User
     while (remaining_count) {
         size_t offset_into_block = (current_block_logical_index == first_block_logical_index) ? offset_into_first_block : 0;
         size_t num_bytes_to_copy = min((size_t)block_size - offset_into_block, (size_t)remaining_count);
-        auto block_index = TRY(m_block_view.get_or_allocate_block(current_block_logical_index, num_bytes_to_copy != block_size, allow_cache));
+        size_t blocks_needed = ceil_div(offset_into_block + remaining_count, static_cast<off_t>(block_size));
+        auto block_index = TRY(m_block_view.get_or_allocate_block(current_block_logical_index, blocks_needed, num_bytes_to_copy != block_size, allow_cache));
         TRY(m_block_view.write_block_pointer(current_block_logical_index, block_index));
 
         dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::write_bytes_locked(): Writing block {} (offset_into_block: {})", identifier(), block_index, offset_into_block);
@@ -732,19 +787,36 @@ ErrorOr<void> Ext2FSInode::write_directory(Vector<Ext2FSDirectoryEntry>& entries
     return {};
 }
 
-ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_block(BlockBasedFileSystem::BlockIndex block_index, bool zero_newly_allocated_block, bool allow_cache)
+ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_block(BlockBasedFileSystem::BlockIndex goal, size_t blocks_needed, bool zero_newly_allocated_block, bool allow_cache)
 {
-    // FIXME: Preallocate some extra blocks here.
-    auto blocks = TRY(fs().allocate_blocks(fs().group_index_from_inode(index()), 1));
-    m_raw_inode.i_blocks += fs().i_blocks_increment();
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(blocks_needed > 0);
 
-    VERIFY(blocks.size() == 1);
-    auto block = blocks.first();
+    if (m_preallocated_blocks.count > 0 && goal != 0 && m_preallocated_blocks.first_block != goal) {
+        // We're not growing sequentially anymore, so the preallocated blocks wouldn't end up next to each other.
+        TRY(discard_preallocated_blocks());
+        m_preallocation_window = 0;
+    }
+
+    if (m_preallocated_blocks.count == 0) {
+        // Reserve a window past what is needed right now, which grows for as long as the file keeps growing sequentially.
+        // This keeps files that are appended to concurrently from interleaving their blocks.
+        m_preallocation_window = clamp(m_preallocation_window * 2, min_preallocation_window, max_preallocation_window);
+        size_t blocks_to_allocate = min(blocks_needed, max_blocks_per_allocation);
+        if (Kernel::is_regular_file(m_raw_inode.i_mode))
+            blocks_to_allocate += m_preallocation_window;
+        m_preallocated_blocks = TRY(fs().allocate_block_run(fs().group_index_from_inode(index()), goal, blocks_to_allocate));
+    }
+
+    auto block = m_preallocated_blocks.first_block;
+    m_preallocated_blocks.first_block = block.value() + 1;
+    --m_preallocated_blocks.count;
+    m_raw_inode.i_blocks += fs().i_blocks_increment();
 
     if (zero_newly_allocated_block) {
         u8 zero_buffer[PAGE_SIZE] {};
         if (auto result = fs().write_block(block, UserOrKernelBuffer::for_kernel_buffer(zero_buffer), fs().logical_block_size(), 0, allow_cache); result.is_error()) {
-            dbgln("Ext2FSInode[{}]::allocate_block(): Failed to zero block {} (index {})", identifier(), block, block_index);
+            dbgln("Ext2FSInode[{}]::allocate_block(): Failed to zero block {}", identifier(), block);
             return result.release_error();
         }
     }
@@ -752,6 +824,26 @@ ErrorOr<BlockBasedFileSystem::BlockIndex> Ext2FSInode::allocate_block(BlockBased
     return block;
 }
 
+ErrorOr<void> Ext2FSInode::discard_preallocated_blocks()
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (m_preallocated_blocks.count == 0)
+        return {};
+
+    dbgln_if(EXT2_DEBUG, "Ext2FSInode[{}]::discard_preallocated_blocks(): Freeing {} blocks at {}", identifier(), m_preallocated_blocks.count, m_preallocated_blocks.first_block);
+    auto run = exchange(m_preallocated_blocks, {});
+    return fs().free_block_run(run);
+}
+
+void Ext2FSInode::detach(OpenFileDescription& description)
+{
+    if (!description.is_writable())
+        return;
+    MutexLocker locker(m_inode_lock);
+    if (auto result = discard_preallocated_blocks(); result.is_error())
+        dbgln("Ext2FSInode[{}]::detach(): Failed to discard preallocated blocks: {}", identifier(), result.error());
+}
+
 ErrorOr<NonnullRefPtr<Inode>> Ext2FSInode::create_child(StringView name, mode_t mode, dev_t dev, UserID uid, GroupID gid)
 {
     if (Kernel::is_directory(mode))
@@ -973,6 +1065,113 @@ ErrorOr<void> Ext2FSInode::truncate_locked(u64 size)
     return {};
 }
 
+ErrorOr<void> Ext2FSInode::allocate_range_locked(u64 offset, u64 length)
+{
+    VERIFY(m_inode_lock.is_locked());
+    VERIFY(length > 0);
+    if (fs().is_readonly())
+        return EROFS;
+
+    if (is_symlink())
+        return Inode::allocate_range_locked(offset, length);
+
+    auto const block_size = fs().logical_block_size();
+    u64 const end = offset + length;
+    if (end > size())
+        TRY(resize(end));
+
+    BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
+    BlockBasedFileSystem::BlockIndex last_block_logical_index = (end - 1) / block_size;
+
+    auto bi = first_block_logical_index;
+    while (bi <= last_block_logical_index) {
+        auto run = TRY(m_block_view.get_block_run(bi, last_block_logical_index.value() - bi.value() + 1));
+        if (run.on_disk_start.value() != 0) {
+            bi = bi.value() + run.length;
+            continue;
+        }
+
+        // Fill the whole hole at once, so it ends up in as few contiguous runs as possible.
+        for (u64 i = 0; i < run.length; ++i, bi = bi.value() + 1) {
+            auto block_index = TRY(m_block_view.get_or_allocate_block(bi, run.length - i, true, true));
+            TRY(m_block_view.write_block_pointer(bi, block_index));
+        }
+    }
+
+    set_metadata_dirty(true);
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::read_page_cache_range(u64 offset, Bytes bytes) const
+{
+    VERIFY(m_inode_lock.is_locked());
+    auto const block_size = fs().logical_block_size();
+    VERIFY(offset % block_size == 0);
+    VERIFY(bytes.size() % block_size == 0);
+
+    BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
+    u64 const block_count = bytes.size() / block_size;
+    u64 const blocks_in_file = ceil_div(size(), static_cast<u64>(block_size));
+
+    u64 i = 0;
+    while (i < block_count) {
+        u64 logical_index = first_block_logical_index.value() + i;
+        if (logical_index >= blocks_in_file) {
+            // Act as if everything beyond the end of the file is filled with zeroes.
+            memset(bytes.offset_pointer(i * block_size), 0, (block_count - i) * block_size);
+            break;
+        }
+
+        auto run = TRY(m_block_view.get_block_run(logical_index, min(block_count - i, blocks_in_file - logical_index)));
+        if (run.on_disk_start.value() == 0) {
+            // This is a hole, act as if it's filled with zeroes.
+            memset(bytes.offset_pointer(i * block_size), 0, run.length * block_size);
+            i += run.length;
+            continue;
+        }
+
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(bytes.offset_pointer(i * block_size));
+        if (auto result = fs().read_blocks(run.on_disk_start, run.length, buffer, false); result.is_error()) {
+            dmesgln("Ext2FSInode[{}]::read_page_cache_range(): Failed to read {} blocks at {} (index {})", identifier(), run.length, run.on_disk_start, logical_index);
+            return result.release_error();
+        }
+        i += run.length;
+    }
+    return {};
+}
+
+ErrorOr<void> Ext2FSInode::write_page_cache_range(u64 offset, ReadonlyBytes bytes)
+{
+    VERIFY(m_inode_lock.is_locked());
+    auto const block_size = fs().logical_block_size();
+    VERIFY(offset % block_size == 0);
+
+    BlockBasedFileSystem::BlockIndex first_block_logical_index = offset / block_size;
+    u64 const blocks_in_file = ceil_div(size(), static_cast<u64>(block_size));
+    if (first_block_logical_index.value() >= blocks_in_file)
+        return {};
+    u64 const block_count = min(static_cast<u64>(bytes.size() / block_size), blocks_in_file - first_block_logical_index.value());
+
+    u64 i = 0;
+    while (i < block_count) {
+        u64 logical_index = first_block_logical_index.value() + i;
+        auto run = TRY(m_block_view.get_block_run(logical_index, block_count - i));
+        if (run.on_disk_start.value() == 0) {
+            // NOTE: Blocks are allocated when data is written into the page cache, so a hole still only contains zeroes.
+            i += run.length;
+            continue;
+        }
+
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(const_cast<u8*>(bytes.offset_pointer(i * block_size)));
+        if (auto result = fs().write_blocks(run.on_disk_start, run.length, buffer, false); result.is_error()) {
+            dbgln("Ext2FSInode[{}]::write_page_cache_range(): Failed to write {} blocks at {} (index {})", identifier(), run.length, run.on_disk_start, logical_index);
+            return result.release_error();
+        }
+        i += run.length;
+    }
+    return {};
+}
+
 ErrorOr<int> Ext2FSInode::get_block_address(int index)
 {
     MutexLocker locker(m_inode_lock);
@@ -44,7 +44,11 @@ private:
     virtual ErrorOr<void> chmod(mode_t) override;
     virtual ErrorOr<void> chown(UserID, GroupID) override;
     virtual ErrorOr<void> truncate_locked(u64) override;
+    virtual ErrorOr<void> allocate_range_locked(u64 offset, u64 length) override;
+    virtual void detach(OpenFileDescription&) override;
     virtual ErrorOr<int> get_block_address(int) override;
+    virtual ErrorOr<void> read_page_cache_range(u64, Bytes) const override;
+    virtual ErrorOr<void> write_page_cache_range(u64, ReadonlyBytes) override;
 
     bool is_within_inode_bounds(FlatPtr base, FlatPtr value_offset, size_t value_size) const;
 
@@ -54,7 +58,8 @@ private:
     static u32 decode_nanoseconds_from_extra(u32 extra) { return (extra & EXT4_NSEC_MASK) >> EXT4_EPOCH_BITS; }
     static u32 encode_time_to_extra(time_t seconds, u32 nanoseconds) { return (((static_cast<time_t>(seconds) - static_cast<i32>(seconds)) >> 32) & EXT4_EPOCH_MASK) | (nanoseconds << EXT4_EPOCH_BITS); }
 
-    ErrorOr<BlockBasedFileSystem::BlockIndex> allocate_block(BlockBasedFileSystem::BlockIndex, bool zero_newly_allocated_block, bool allow_cache);
+    ErrorOr<BlockBasedFileSystem::BlockIndex> allocate_block(BlockBasedFileSystem::BlockIndex goal, size_t blocks_needed, bool zero_newly_allocated_block, bool allow_cache);
+    ErrorOr<void> discard_preallocated_blocks();
     ErrorOr<u32> allocate_and_zero_block();
 
     enum class RemoveDotEntries {
@@ -71,7 +76,7 @@ private:
     ErrorOr<void> write_triply_indirect_block_pointer(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex on_disk_index);
     ErrorOr<void> write_block_pointer(BlockBasedFileSystem::BlockIndex logical_block_index, BlockBasedFileSystem::BlockIndex on_disk_index);
 
-    ErrorOr<Ext2FS::BlockList> compute_block_list(BlockBasedFileSystem::BlockIndex, BlockBasedFileSystem::BlockIndex) const;
+    ErrorOr<Ext2FSBlockExtentMap> compute_block_extents(BlockBasedFileSystem::BlockIndex, BlockBasedFileSystem::BlockIndex) const;
 
     ErrorOr<void> free_all_blocks();
 
@@ -98,6 +103,11 @@ private:
     Ext2FSInode(Ext2FS&, InodeIndex);
 
     mutable Ext2FSBlockView m_block_view;
+
+    // Blocks that are already marked as used in the bitmap so this inode can keep growing contiguously,
+    // but that don't belong to it yet. They are given back once the file is no longer being written to.
+    Ext2FS::BlockRun m_preallocated_blocks;
+    size_t m_preallocation_window { 0 };
     HashMap<NonnullOwnPtr<KString>, InodeIndex> m_lookup_cache;
     ext2_inode_large m_raw_inode {};
 };
@@ -8,12 +8,14 @@
 
 #include <AK/AtomicRefCounted.h>
 #include <AK/Error.h>
+#include <AK/IntrusiveList.h>
 #include <AK/StringView.h>
 #include <AK/Types.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
 #include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Memory/VirtualAddress.h>
 #include <Kernel/UnixTypes.h>
 
@@ -23,6 +25,41 @@ class File;
 
 class FileBlockerSet final : public Thread::BlockerSet {
 public:
+    // An Observer is told whenever the state of the file may have changed, right after all
+    // blocked threads have been given a chance to wake up. Unlike blockers, observers stay
+    // registered across wakeups, which is what EventPoll uses to avoid rebuilding its
+    // interest set on every wait.
+    //
+    // NOTE: Observer callbacks are invoked with the observer lock held, so they must not
+    //       block, and they must not add or remove observers on this blocker set.
+    class Observer {
+        AK_MAKE_NONCOPYABLE(Observer);
+        AK_MAKE_NONMOVABLE(Observer);
+
+    public:
+        virtual ~Observer() = default;
+
+        virtual void file_state_may_have_changed() = 0;
+
+        // Called when the OpenFileDescription this observer was registered for is destroyed.
+        // The observer has already been removed from the blocker set at this point.
+        virtual void observed_description_will_be_destroyed() = 0;
+
+        OpenFileDescription const& observed_description() const { return m_description; }
+
+    protected:
+        explicit Observer(OpenFileDescription const& description)
+            : m_description(description)
+        {
+        }
+
+    private:
+        friend class FileBlockerSet;
+
+        OpenFileDescription const& m_description;
+        IntrusiveListNode<Observer> m_list_node;
+    };
+
     FileBlockerSet() { }
 
     virtual bool should_add_blocker(Thread::Blocker& b, void* data) override
@@ -34,13 +71,55 @@ public:
 
     void unblock_all_blockers_whose_conditions_are_met()
     {
-        SpinlockLocker lock(m_lock);
-        BlockerSet::unblock_all_blockers_whose_conditions_are_met_locked([&](auto& b, void* data, bool&) {
-            VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
-            auto& blocker = static_cast<Thread::FileBlocker&>(b);
-            return blocker.unblock_if_conditions_are_met(false, data);
-        });
+        {
+            SpinlockLocker lock(m_lock);
+            BlockerSet::unblock_all_blockers_whose_conditions_are_met_locked([&](auto& b, void* data, bool&) {
+                VERIFY(b.blocker_type() == Thread::Blocker::Type::File);
+                auto& blocker = static_cast<Thread::FileBlocker&>(b);
+                return blocker.unblock_if_conditions_are_met(false, data);
+            });
+        }
+        notify_observers();
+    }
+
+    void add_observer(Observer& observer)
+    {
+        SpinlockLocker lock(m_observers_lock);
+        VERIFY(!observer.m_list_node.is_in_list());
+        m_observers.append(observer);
+    }
+
+    // NOTE: Once this returns, no callback for this observer is running or will run again.
+    void remove_observer(Observer& observer)
+    {
+        SpinlockLocker lock(m_observers_lock);
+        if (observer.m_list_node.is_in_list())
+            m_observers.remove(observer);
+    }
+
+    void description_will_be_destroyed(OpenFileDescription const& description)
+    {
+        SpinlockLocker lock(m_observers_lock);
+        for (auto it = m_observers.begin(); it != m_observers.end();) {
+            auto& observer = *it;
+            ++it;
+            if (&observer.m_description != &description)
+                continue;
+            m_observers.remove(observer);
+            observer.observed_description_will_be_destroyed();
+        }
     }
+
+private:
+    void notify_observers()
+    {
+        SpinlockLocker lock(m_observers_lock);
+        for (auto& observer : m_observers)
+            observer.file_state_may_have_changed();
+    }
+
+    Spinlock<LockRank::None> m_observers_lock {};
+    IntrusiveList<&Observer::m_list_node> m_observers;
 };
 
 // File is the base class for anything that can be referenced by a OpenFileDescription.
@@ -119,6 +198,8 @@ public:
     virtual bool is_character_device() const { return false; }
     virtual bool is_socket() const { return false; }
     virtual bool is_inode_watcher() const { return false; }
+    virtual bool is_event_poll() const { return false; }
+    virtual bool is_io_ring() const { return false; }
     virtual bool is_mount_file() const { return false; }
     virtual bool is_loop_device() const { return false; }
 
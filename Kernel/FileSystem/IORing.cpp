@@ -0,0 +1,406 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KString.h>
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+ErrorOr<NonnullRefPtr<IORing>> IORing::try_create(Process& owner, u32 entries)
+{
+    if (entries == 0 || entries > IO_RING_MAX_ENTRIES)
+        return EINVAL;
+    u32 submission_entries = 1;
+    while (submission_entries < entries)
+        submission_entries <<= 1;
+    u32 completion_entries = submission_entries * 2;
+
+    size_t submissions_offset = round_up_to_power_of_two(sizeof(io_ring_header), alignof(io_ring_submission));
+    size_t completions_offset = round_up_to_power_of_two(submissions_offset + submission_entries * sizeof(io_ring_submission), alignof(io_ring_completion));
+    size_t mapping_size = TRY(Memory::page_round_up(completions_offset + completion_entries * sizeof(io_ring_completion)));
+
+    // NOTE: The kernel writes into the shared memory with its own mapping, so it must never have to fault pages in.
+    auto vmobject = TRY(Memory::AnonymousVMObject::try_create_with_size(mapping_size, AllocationStrategy::AllocateNow));
+    auto region = TRY(MM.allocate_kernel_region_with_vmobject(*vmobject, mapping_size, "IORing"sv, Memory::Region::Access::ReadWrite));
+
+    auto& header = *reinterpret_cast<io_ring_header*>(region->vaddr().as_ptr());
+    header.submission_entries = submission_entries;
+    header.completion_entries = completion_entries;
+    header.submissions_offset = submissions_offset;
+    header.completions_offset = completions_offset;
+    header.mapping_size = mapping_size;
+
+    auto ring = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) IORing(owner.pid(), move(vmobject), move(region), submission_entries, completion_entries)));
+    TRY(ring->m_pending.try_ensure_capacity(completion_entries));
+    TRY(ring->m_overflowed_completions.try_ensure_capacity(completion_entries));
+    return ring;
+}
+
+IORing::IORing(ProcessID owner, NonnullLockRefPtr<Memory::AnonymousVMObject> vmobject, NonnullOwnPtr<Memory::Region> region, u32 submission_entries, u32 completion_entries)
+    : m_owner(owner)
+    , m_vmobject(move(vmobject))
+    , m_region(move(region))
+    , m_submission_entries(submission_entries)
+    , m_completion_entries(completion_entries)
+{
+}
+
+IORing::~IORing() = default;
+
+io_ring_submission const* IORing::submissions() const
+{
+    return reinterpret_cast<io_ring_submission const*>(m_region->vaddr().offset(header().submissions_offset).as_ptr());
+}
+
+io_ring_completion* IORing::completions()
+{
+    return reinterpret_cast<io_ring_completion*>(m_region->vaddr().offset(header().completions_offset).as_ptr());
+}
+
+bool IORing::can_read(OpenFileDescription const&, u64) const
+{
+    return available_completions() > 0;
+}
+
+ErrorOr<File::VMObjectAndMemoryType> IORing::vmobject_and_memory_type_for_mmap(Process& process, Memory::VirtualRange const& range, u64& offset, bool shared)
+{
+    if (process.pid() != m_owner)
+        return EPERM;
+    // A private copy of the ring would never see anything the kernel does.
+    if (!shared || offset != 0 || range.size() > m_vmobject->size())
+        return EINVAL;
+
+    return VMObjectAndMemoryType {
+        .vmobject = m_vmobject,
+        .memory_type = Memory::MemoryType::Normal,
+    };
+}
+
+ErrorOr<NonnullOwnPtr<KString>> IORing::pseudo_path(OpenFileDescription const&) const
+{
+    return KString::try_create(":io-ring:"sv);
+}
+
+u32 IORing::available_completions() const
+{
+    auto completion_head = AK::atomic_load(&header().completion_head, AK::memory_order_acquire);
+    auto available = m_completion_tail.load(AK::memory_order_relaxed) - completion_head;
+    // If userspace moved its head past our tail, pretend that the ring is full until it comes to its senses.
+    return min(available, m_completion_entries);
+}
+
+void IORing::complete(u64 user_data, i64 result)
+{
+    if (!m_overflowed_completions.is_empty() || available_completions() == m_completion_entries) {
+        m_overflowed_completions.unchecked_append({ user_data, result });
+        return;
+    }
+    auto tail = m_completion_tail.load(AK::memory_order_relaxed);
+    completions()[tail & (m_completion_entries - 1)] = { user_data, result };
+    m_completion_tail.store(tail + 1, AK::memory_order_relaxed);
+    AK::atomic_store(&header().completion_tail, tail + 1, AK::memory_order_release);
+    evaluate_block_conditions();
+}
+
+void IORing::post_overflowed_completions()
+{
+    size_t posted_count = 0;
+    while (posted_count < m_overflowed_completions.size() && available_completions() < m_completion_entries) {
+        auto tail = m_completion_tail.load(AK::memory_order_relaxed);
+        completions()[tail & (m_completion_entries - 1)] = m_overflowed_completions[posted_count++];
+        m_completion_tail.store(tail + 1, AK::memory_order_relaxed);
+        AK::atomic_store(&header().completion_tail, tail + 1, AK::memory_order_release);
+    }
+    if (posted_count == 0)
+        return;
+    m_overflowed_completions.remove(0, posted_count);
+    evaluate_block_conditions();
+}
+
+ErrorOr<void> IORing::prepare_operation(Process& process, Operation& operation)
+{
+    auto const& submission = operation.submission;
+    if (submission.opcode == IO_RING_OP_TIMEOUT) {
+        auto nanoseconds = min(submission.offset, static_cast<u64>(NumericLimits<i64>::max()));
+        operation.deadline = operation.deadline + Duration::from_nanoseconds(static_cast<i64>(nanoseconds));
+        return {};
+    }
+
+    operation.description = TRY(process.open_file_description(submission.fd));
+    auto& description = *operation.description;
+    // Rings can't wait on each other, that way lie deadlocks.
+    if (description.is_io_ring())
+        return EINVAL;
+
+    switch (submission.opcode) {
+    case IO_RING_OP_READ:
+    case IO_RING_OP_WRITE: {
+        bool is_read = submission.opcode == IO_RING_OP_READ;
+        if (is_read ? !description.is_readable() : !description.is_writable())
+            return EBADF;
+        if (submission.length > NumericLimits<ssize_t>::max())
+            return EINVAL;
+        if (submission.offset != IO_RING_CURRENT_OFFSET) {
+            if (submission.offset > static_cast<u64>(NumericLimits<off_t>::max()))
+                return EINVAL;
+            if (!description.file().is_seekable())
+                return EINVAL;
+        }
+        return {};
+    }
+    case IO_RING_OP_ACCEPT:
+    case IO_RING_OP_CONNECT:
+    case IO_RING_OP_SEND:
+    case IO_RING_OP_RECV: {
+        if (!description.is_socket())
+            return ENOTSOCK;
+        if (submission.opcode == IO_RING_OP_ACCEPT)
+            TRY(process.require_promise(Pledge::accept));
+        if (submission.opcode == IO_RING_OP_CONNECT) {
+            auto domain = description.socket()->domain();
+            if (domain == AF_INET || domain == AF_INET6)
+                TRY(process.require_promise(Pledge::inet));
+            else if (domain == AF_LOCAL)
+                TRY(process.require_promise(Pledge::unix));
+        }
+        if (submission.length > NumericLimits<ssize_t>::max())
+            return EINVAL;
+        return {};
+    }
+    case IO_RING_OP_FSYNC:
+    case IO_RING_OP_POLL:
+        return {};
+    default:
+        return EINVAL;
+    }
+}
+
+void IORing::prepare(Process& process, io_ring_submission const& submission)
+{
+    if (submission.opcode == IO_RING_OP_NOP) {
+        complete(submission.user_data, 0);
+        return;
+    }
+    if (submission.opcode == IO_RING_OP_CANCEL) {
+        cancel(submission.user_data, submission.offset);
+        return;
+    }
+
+    Operation operation { .submission = submission, .description = nullptr, .deadline = TimeManagement::the().monotonic_time() };
+    auto result = prepare_operation(process, operation);
+    if (result.is_error()) {
+        complete(submission.user_data, -static_cast<i64>(result.error().code()));
+        return;
+    }
+    m_pending.unchecked_append(move(operation));
+}
+
+void IORing::cancel(u64 user_data, u64 cancel_user_data)
+{
+    for (size_t i = 0; i < m_pending.size(); ++i) {
+        if (m_pending[i].submission.user_data != cancel_user_data)
+            continue;
+        auto operation = m_pending.take(i);
+        complete(operation.submission.user_data, -ECANCELED);
+        complete(user_data, 0);
+        return;
+    }
+    complete(user_data, -ENOENT);
+}
+
+BlockFlags IORing::block_flags_for(Operation const& operation) const
+{
+    switch (operation.submission.opcode) {
+    case IO_RING_OP_READ:
+    case IO_RING_OP_RECV:
+        return BlockFlags::Read;
+    case IO_RING_OP_WRITE:
+    case IO_RING_OP_SEND:
+        return BlockFlags::Write;
+    case IO_RING_OP_ACCEPT:
+        return BlockFlags::Accept;
+    case IO_RING_OP_CONNECT:
+        return operation.is_connecting ? BlockFlags::Connect : BlockFlags::None;
+    case IO_RING_OP_POLL:
+        return EventPoll::block_flags_for_events(operation.submission.offset);
+    default:
+        return BlockFlags::None;
+    }
+}
+
+ErrorOr<FlatPtr> IORing::perform(Process& process, Operation& operation)
+{
+    auto const& submission = operation.submission;
+    auto& description = *operation.description;
+    switch (submission.opcode) {
+    case IO_RING_OP_READ: {
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            return TRY(description.read(buffer, submission.length));
+        return TRY(description.read(buffer, submission.offset, submission.length));
+    }
+    case IO_RING_OP_WRITE: {
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+        if (submission.offset == IO_RING_CURRENT_OFFSET)
+            return TRY(description.write(buffer, submission.length));
+        return TRY(description.write(submission.offset, buffer, submission.length));
+    }
+    case IO_RING_OP_RECV: {
+        auto& socket = *description.socket();
+        if (socket.is_shut_down_for_reading())
+            return 0;
+        auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+        UnixDateTime timestamp {};
+        return TRY(socket.recvfrom(description, buffer, submission.length, submission.flags, {}, {}, timestamp, false));
+    }
+    case IO_RING_OP_SEND: {
+        auto& socket = *description.socket();
+        auto result = [&]() -> ErrorOr<size_t> {
+            if (socket.is_shut_down_for_writing())
+                return EPIPE;
+            auto buffer = TRY(UserOrKernelBuffer::for_user_buffer(reinterpret_cast<u8*>(submission.address), submission.length));
+            return socket.sendto(description, buffer, submission.length, submission.flags, {}, 0);
+        }();
+        if (result.is_error() && result.error().code() == EPIPE && !(submission.flags & MSG_NOSIGNAL))
+            Thread::current()->send_signal(SIGPIPE, &process);
+        return TRY(result);
+    }
+    case IO_RING_OP_ACCEPT:
+        return process.accept_impl(description, Userspace<sockaddr*>(static_cast<FlatPtr>(submission.address)), Userspace<socklen_t*>(static_cast<FlatPtr>(submission.length)), submission.flags, false);
+    case IO_RING_OP_CONNECT: {
+        auto& socket = *description.socket();
+        if (operation.is_connecting)
+            return socket.is_connected() ? 0 : ECONNREFUSED;
+        // NOTE: Only non-blocking descriptions return EINPROGRESS here, blocking ones (and local sockets) finish the connection right away.
+        auto result = socket.connect(process.credentials(), description, Userspace<sockaddr const*>(static_cast<FlatPtr>(submission.address)), static_cast<socklen_t>(submission.length));
+        if (result.is_error() && result.error().code() == EINPROGRESS) {
+            operation.is_connecting = true;
+            return EAGAIN;
+        }
+        TRY(result);
+        return 0;
+    }
+    case IO_RING_OP_FSYNC:
+        TRY(description.sync());
+        return 0;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+Optional<i64> IORing::try_to_perform(Process& process, Operation& operation)
+{
+    auto const& submission = operation.submission;
+    if (submission.opcode == IO_RING_OP_TIMEOUT) {
+        if (TimeManagement::the().monotonic_time() < operation.deadline)
+            return {};
+        return -ETIMEDOUT;
+    }
+
+    auto block_flags = block_flags_for(operation);
+    if (block_flags != BlockFlags::None && operation.description->should_unblock(block_flags) == BlockFlags::None)
+        return {};
+
+    if (submission.opcode == IO_RING_OP_POLL) {
+        auto unblocked_flags = operation.description->should_unblock(block_flags);
+        auto events = EventPoll::events_for_unblocked_flags(unblocked_flags) & (submission.offset | POLLERR | POLLHUP);
+        if (events == 0)
+            return {};
+        return events;
+    }
+
+    auto result = perform(process, operation);
+    if (result.is_error()) {
+        // Someone else might have gotten there first, so keep waiting if we can.
+        if (result.error().code() == EAGAIN && block_flags_for(operation) != BlockFlags::None)
+            return {};
+        return -static_cast<i64>(result.error().code());
+    }
+    return static_cast<i64>(result.value());
+}
+
+void IORing::perform_ready_operations(Process& process)
+{
+    post_overflowed_completions();
+    for (size_t i = 0; i < m_pending.size();) {
+        auto result = try_to_perform(process, m_pending[i]);
+        if (!result.has_value()) {
+            ++i;
+            continue;
+        }
+        auto operation = m_pending.take(i);
+        complete(operation.submission.user_data, *result);
+    }
+}
+
+ErrorOr<size_t> IORing::enter(u32 to_submit, u32 min_complete, Optional<MonotonicTime> give_up_time)
+{
+    auto& process = Process::current();
+    if (process.pid() != m_owner)
+        return EPERM;
+
+    MutexLocker locker(m_lock);
+
+    size_t submitted_count = 0;
+    auto submission_tail = AK::atomic_load(&header().submission_tail, AK::memory_order_acquire);
+    while (submitted_count < to_submit && m_submission_head != submission_tail) {
+        // Every operation gets a completion slot, so that we never lose a completion.
+        if (m_pending.size() + m_overflowed_completions.size() >= m_completion_entries)
+            break;
+        io_ring_submission submission;
+        memcpy(&submission, &submissions()[m_submission_head & (m_submission_entries - 1)], sizeof(submission));
+        ++m_submission_head;
+        ++submitted_count;
+        prepare(process, submission);
+    }
+    AK::atomic_store(&header().submission_head, m_submission_head, AK::memory_order_release);
+
+    min_complete = min(min_complete, m_completion_entries);
+    for (;;) {
+        perform_ready_operations(process);
+        if (m_pending.is_empty() || available_completions() >= min_complete)
+            break;
+
+        auto now = TimeManagement::the().monotonic_time();
+        if (give_up_time.has_value() && now >= *give_up_time)
+            break;
+
+        Thread::SelectBlocker::FDVector fds_info;
+        auto wake_up_time = give_up_time;
+        for (auto const& operation : m_pending) {
+            if (operation.submission.opcode == IO_RING_OP_TIMEOUT) {
+                if (!wake_up_time.has_value() || operation.deadline < *wake_up_time)
+                    wake_up_time = operation.deadline;
+                continue;
+            }
+            auto block_flags = block_flags_for(operation);
+            if (block_flags != BlockFlags::None)
+                fds_info.unchecked_append({ operation.description, block_flags });
+        }
+
+        Thread::BlockTimeout timeout;
+        Duration remaining;
+        if (wake_up_time.has_value()) {
+            remaining = max(*wake_up_time - now, Duration::zero());
+            timeout = Thread::BlockTimeout(false, &remaining);
+        }
+        if (Thread::current()->block<Thread::SelectBlocker>(timeout, fds_info).was_interrupted()) {
+            if (submitted_count == 0)
+                return EINTR;
+            break;
+        }
+    }
+    return submitted_count;
+}
+
+}
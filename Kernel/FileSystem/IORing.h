@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Vector.h>
+#include <Kernel/API/POSIX/sys/io_ring.h>
+#include <Kernel/FileSystem/File.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Memory/AnonymousVMObject.h>
+#include <Kernel/Memory/Region.h>
+#include <Kernel/Tasks/Thread.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// IORing is a pair of queues in memory that is shared with the process that created it.
+// The process fills in submissions and then calls io_ring_enter() to hand a whole batch of
+// them to the kernel at once, which posts a completion for each of them when it is done.
+//
+// Operations are only carried out from within io_ring_enter(): the calling thread performs
+// everything that is ready, and then blocks on the pending file descriptions until enough
+// completions are available. Operations that can't make progress yet stay pending across
+// calls, so a ring with pending operations should be entered again to wait for them.
+class IORing final : public File {
+public:
+    static ErrorOr<NonnullRefPtr<IORing>> try_create(Process& owner, u32 entries);
+    virtual ~IORing() override;
+
+    virtual bool can_read(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override { return EINVAL; }
+    virtual bool can_write(OpenFileDescription const&, u64) const override { return false; }
+    virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override { return EINVAL; }
+    virtual ErrorOr<VMObjectAndMemoryType> vmobject_and_memory_type_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
+
+    virtual ErrorOr<NonnullOwnPtr<KString>> pseudo_path(OpenFileDescription const&) const override;
+    virtual StringView class_name() const override { return "IORing"sv; }
+    virtual bool is_io_ring() const override { return true; }
+
+    // Consumes up to `to_submit` submissions, and then waits until at least `min_complete`
+    // completions are available or nothing is pending anymore. Returns the number of
+    // submissions that were consumed.
+    ErrorOr<size_t> enter(u32 to_submit, u32 min_complete, Optional<MonotonicTime> give_up_time);
+
+private:
+    struct Operation {
+        io_ring_submission submission;
+        RefPtr<OpenFileDescription> description;
+        MonotonicTime deadline;
+        bool is_connecting { false };
+    };
+
+    IORing(ProcessID owner, NonnullLockRefPtr<Memory::AnonymousVMObject>, NonnullOwnPtr<Memory::Region>, u32 submission_entries, u32 completion_entries);
+
+    io_ring_header& header() { return *reinterpret_cast<io_ring_header*>(m_region->vaddr().as_ptr()); }
+    io_ring_header const& header() const { return *reinterpret_cast<io_ring_header const*>(m_region->vaddr().as_ptr()); }
+    io_ring_submission const* submissions() const;
+    io_ring_completion* completions();
+
+    void prepare(Process&, io_ring_submission const&);
+    ErrorOr<void> prepare_operation(Process&, Operation&);
+    void cancel(u64 user_data, u64 cancel_user_data);
+    void perform_ready_operations(Process&);
+    // Returns the result of the operation once it is done, or nothing if it has to wait.
+    Optional<i64> try_to_perform(Process&, Operation&);
+    ErrorOr<FlatPtr> perform(Process&, Operation&);
+    Thread::FileBlocker::BlockFlags block_flags_for(Operation const&) const;
+
+    void complete(u64 user_data, i64 result);
+    void post_overflowed_completions();
+    u32 available_completions() const;
+
+    ProcessID const m_owner;
+    NonnullLockRefPtr<Memory::AnonymousVMObject> m_vmobject;
+    NonnullOwnPtr<Memory::Region> m_region;
+    u32 const m_submission_entries;
+    u32 const m_completion_entries;
+
+    // NOTE: Userspace can write anything into the shared header, so the kernel keeps its
+    //       own copies of the indices that it is responsible for advancing.
+    u32 m_submission_head { 0 };
+    Atomic<u32> m_completion_tail { 0 };
+
+    // Serializes io_ring_enter() calls, and guards everything below.
+    Mutex m_lock { "IORing"sv };
+    Vector<Operation> m_pending;
+    Vector<io_ring_completion> m_overflowed_completions;
+};
+
+}
@@ -10,7 +10,9 @@
 #include <AK/StringView.h>
 #include <Kernel/API/InodeWatcherEvent.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/DentryCache.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
 #include <Kernel/FileSystem/VFSRootContext.h>
@@ -34,18 +36,21 @@ void Inode::sync_all()
     Vector<NonnullRefPtr<Inode>, 32> inodes;
     Inode::all_instances().with([&](auto& all_inodes) {
         for (auto& inode : all_inodes) {
-            if (inode.is_metadata_dirty())
+            if (inode.is_metadata_dirty() || inode.has_dirty_cached_pages())
                 inodes.append(inode);
         }
     });
 
     for (auto& inode : inodes) {
+        // NOTE: Data goes out first, so the metadata never points at blocks we haven't written yet.
+        (void)inode->writeback_page_cache();
         (void)inode->flush_metadata();
     }
 }
 
 void Inode::sync()
 {
+    (void)writeback_page_cache();
     (void)flush_metadata();
     auto result = fs().flush_writes();
     if (result.is_error()) {
@@ -85,22 +90,95 @@ Inode::~Inode()
 void Inode::will_be_destroyed()
 {
     MutexLocker locker(m_inode_lock);
+    if (m_page_cache)
+        (void)m_page_cache->writeback();
     if (m_metadata_dirty)
         (void)flush_metadata();
 }
 
+ErrorOr<void> Inode::try_enable_page_cache()
+{
+    VERIFY(!m_page_cache);
+    m_page_cache = TRY(InodePageCache::try_create(*this));
+    return {};
+}
+
+bool Inode::has_cached_pages() const
+{
+    return m_page_cache && !m_page_cache->is_empty();
+}
+
+bool Inode::has_dirty_cached_pages() const
+{
+    return m_page_cache && m_page_cache->is_dirty();
+}
+
+ErrorOr<RefPtr<Memory::PhysicalRAMPage>> Inode::page_cache_physical_page(size_t page_index)
+{
+    VERIFY(m_page_cache);
+    // NOTE: We can't take the lock in shared mode here, as metadata() may want to lock it exclusively.
+    MutexLocker locker(m_inode_lock);
+    auto file_size = size();
+    if (static_cast<u64>(page_index) * PAGE_SIZE >= file_size)
+        return nullptr;
+    return TRY(m_page_cache->physical_page(page_index, file_size));
+}
+
+ErrorOr<size_t> Inode::read_ahead(u64 offset, u64 length)
+{
+    VERIFY(m_page_cache);
+    // NOTE: size() may want to lock the inode exclusively, so we have to ask before taking the lock in shared mode.
+    //       If the file shrinks in the meantime, the backing store simply reads back zeroes past the new end.
+    auto file_size = size();
+    MutexLocker locker(m_inode_lock, Mutex::Mode::Shared);
+    return m_page_cache->read_ahead(offset, length, file_size);
+}
+
+ErrorOr<void> Inode::writeback_page_cache()
+{
+    if (!m_page_cache)
+        return {};
+    MutexLocker locker(m_inode_lock);
+    return m_page_cache->writeback();
+}
+
 ErrorOr<void> Inode::truncate(u64 size)
 {
     MutexLocker locker(m_inode_lock);
     return truncate_locked(size);
 }
 
+ErrorOr<void> Inode::allocate_range(u64 offset, u64 length)
+{
+    MutexLocker locker(m_inode_lock);
+    return allocate_range_locked(offset, length);
+}
+
+ErrorOr<void> Inode::allocate_range_locked(u64 offset, u64 length)
+{
+    VERIFY(m_inode_lock.is_locked());
+    if (metadata().size >= static_cast<off_t>(offset + length))
+        return {};
+    return truncate_locked(offset + length);
+}
+
 ErrorOr<size_t> Inode::write_bytes(off_t offset, size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description)
 {
     MutexLocker locker(m_inode_lock);
     return prepare_and_write_bytes_locked(offset, length, target_buffer, open_description);
 }
 
+ErrorOr<size_t> Inode::append_bytes(size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description, off_t& offset)
+{
+    // NOTE: Finding the end of the file and writing there has to happen under the inode lock,
+    //       otherwise appends through different open file descriptions could overwrite each other.
+    MutexLocker locker(m_inode_lock);
+    offset = metadata().size;
+    if (Checked<off_t>::addition_would_overflow(offset, length))
+        return EOVERFLOW;
+    return prepare_and_write_bytes_locked(offset, length, target_buffer, open_description);
+}
+
 ErrorOr<size_t> Inode::prepare_and_write_bytes_locked(off_t offset, size_t length, UserOrKernelBuffer const& target_buffer, OpenFileDescription* open_description)
 {
     VERIFY(m_inode_lock.is_locked());
@@ -227,6 +305,8 @@ void Inode::set_metadata_dirty(bool metadata_dirty)
 
 void Inode::did_add_child(InodeIdentifier, StringView name)
 {
+    DentryCache::the().invalidate(identifier(), name);
+
     m_watchers.for_each([&](auto& watcher) {
         watcher->notify_inode_event({}, identifier(), InodeWatcherEvent::Type::ChildCreated, name);
     });
@@ -234,6 +314,8 @@ void Inode::did_add_child(InodeIdentifier, StringView name)
 
 void Inode::did_remove_child(InodeIdentifier, StringView name)
 {
+    DentryCache::the().invalidate(identifier(), name);
+
     if (name == "." || name == "..") {
         // These are just aliases and are not interesting to userspace.
         return;
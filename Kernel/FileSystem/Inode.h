@@ -33,6 +33,7 @@ class Inode : public ListedRefCounted<Inode, LockType::Spinlock>
     , public LockWeakable<Inode> {
     friend class FileSystem;
     friend class InodeFile;
+    friend class InodePageCache;
 
 public:
     virtual ~Inode();
@@ -54,9 +55,11 @@ public:
     virtual InodeMetadata metadata() const = 0;
 
     ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const& data, OpenFileDescription*);
+    ErrorOr<size_t> append_bytes(size_t, UserOrKernelBuffer const& data, OpenFileDescription*, off_t& offset);
     ErrorOr<size_t> read_bytes(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const;
     ErrorOr<size_t> read_until_filled_or_end(off_t, size_t, UserOrKernelBuffer buffer, OpenFileDescription*) const;
     ErrorOr<void> truncate(u64);
+    ErrorOr<void> allocate_range(u64 offset, u64 length);
 
     virtual ErrorOr<void> attach(OpenFileDescription&) { return {}; }
     virtual void detach(OpenFileDescription&) { }
@@ -93,6 +96,13 @@ public:
     static void sync_all();
     void sync();
 
+    bool has_page_cache() const { return m_page_cache; }
+    bool has_cached_pages() const;
+    bool has_dirty_cached_pages() const;
+    ErrorOr<RefPtr<Memory::PhysicalRAMPage>> page_cache_physical_page(size_t page_index);
+    ErrorOr<void> writeback_page_cache();
+    ErrorOr<size_t> read_ahead(u64 offset, u64 length);
+
     bool has_watchers() const;
 
     ErrorOr<void> register_watcher(Badge<InodeWatcher>, InodeWatcher&);
@@ -124,6 +134,19 @@ protected:
     virtual ErrorOr<size_t> read_bytes_locked(off_t, size_t, UserOrKernelBuffer& buffer, OpenFileDescription*) const = 0;
     virtual ErrorOr<void> truncate_locked(u64) { return {}; }
 
+    // Makes sure that the given range can be written to without running out of space.
+    // File systems that don't allocate ahead of time only need the file to be large enough.
+    virtual ErrorOr<void> allocate_range_locked(u64 offset, u64 length);
+
+    // NOTE: These are used by the page cache to move whole pages between the cache and the backing store.
+    //       Ranges are always page aligned, and may extend past the end of the file.
+    virtual ErrorOr<void> read_page_cache_range(u64, Bytes) const { return ENOTSUP; }
+    virtual ErrorOr<void> write_page_cache_range(u64, ReadonlyBytes) { return ENOTSUP; }
+
+    ErrorOr<void> try_enable_page_cache();
+
+    OwnPtr<InodePageCache> m_page_cache;
+
 private:
     ErrorOr<bool> try_apply_flock(Process const&, OpenFileDescription const&, flock const&);
 
@@ -4,9 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Atomic.h>
 #include <AK/StringView.h>
 #include <Kernel/API/Ioctl.h>
 #include <Kernel/API/POSIX/errno.h>
+#include <Kernel/Debug.h>
 #include <Kernel/FileSystem/Inode.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/OpenFileDescription.h>
@@ -15,6 +17,7 @@
 #include <Kernel/Memory/PrivateInodeVMObject.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
 #include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/WorkQueue.h>
 
 namespace Kernel {
 
@@ -25,6 +28,80 @@ InodeFile::InodeFile(NonnullRefPtr<Inode> inode)
 
 InodeFile::~InodeFile() = default;
 
+static constexpr size_t minimum_readahead_window = 32 * KiB;
+static constexpr size_t maximum_readahead_window = 512 * KiB;
+
+static Atomic<u64> s_readahead_hits;
+static Atomic<u64> s_readahead_misses;
+static Atomic<u64> s_readahead_requests;
+static Atomic<u64> s_readahead_bytes;
+
+InodeFile::ReadaheadStatistics InodeFile::readahead_statistics()
+{
+    return {
+        .hits = s_readahead_hits.load(AK::MemoryOrder::memory_order_relaxed),
+        .misses = s_readahead_misses.load(AK::MemoryOrder::memory_order_relaxed),
+        .requests = s_readahead_requests.load(AK::MemoryOrder::memory_order_relaxed),
+        .bytes = s_readahead_bytes.load(AK::MemoryOrder::memory_order_relaxed),
+    };
+}
+
+void InodeFile::update_readahead(OpenFileDescription& description, u64 offset, size_t nread)
+{
+    struct ReadaheadRange {
+        u64 offset;
+        u64 length;
+    };
+
+    u64 end = offset + nread;
+    auto range = description.with_readahead_state([&](auto& state) -> Optional<ReadaheadRange> {
+        bool is_sequential = offset == state.next_offset;
+        state.next_offset = end;
+        if (!is_sequential) {
+            // This looks like random access, so whatever we've read ahead so far is probably useless.
+            state.window = 0;
+            state.readahead_end = 0;
+            return {};
+        }
+
+        if (state.window) {
+            if (end <= state.readahead_end)
+                s_readahead_hits.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            else
+                s_readahead_misses.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+        }
+
+        // Don't bother until the reader has consumed at least half of what we've read ahead.
+        if (state.readahead_end > end && state.readahead_end - end >= state.window / 2)
+            return {};
+
+        // Grow the window as long as the reader keeps reading sequentially.
+        if (state.window)
+            state.window = min(state.window * 2, maximum_readahead_window);
+        else
+            state.window = clamp(round_up_to_power_of_two(nread * 4, PAGE_SIZE), minimum_readahead_window, maximum_readahead_window);
+
+        u64 start = max(state.readahead_end, end);
+        state.readahead_end = end + state.window;
+        if (start >= state.readahead_end)
+            return {};
+        return ReadaheadRange { start, state.readahead_end - start };
+    });
+    if (!range.has_value())
+        return;
+
+    auto result = g_readahead_work->try_queue([inode = m_inode, range = range.value()] {
+        auto nread_ahead = inode->read_ahead(range.offset, range.length);
+        if (nread_ahead.is_error()) {
+            dbgln_if(PAGE_CACHE_DEBUG, "InodeFile: Readahead of {} bytes at offset {} failed: {}", range.length, range.offset, nread_ahead.error());
+            return;
+        }
+        s_readahead_bytes.fetch_add(nread_ahead.value(), AK::MemoryOrder::memory_order_relaxed);
+    });
+    if (!result.is_error())
+        s_readahead_requests.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
 ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, UserOrKernelBuffer& buffer, size_t count)
 {
     if (Checked<off_t>::addition_would_overflow(offset, count))
@@ -33,6 +110,8 @@ ErrorOr<size_t> InodeFile::read(OpenFileDescription& description, u64 offset, Us
     auto nread = TRY(m_inode->read_bytes(offset, count, buffer, &description));
     if (nread > 0) {
         Thread::current()->did_file_read(nread);
+        if (m_inode->has_page_cache() && !description.is_direct())
+            update_readahead(description, offset, nread);
         evaluate_block_conditions();
     }
     return nread;
@@ -44,16 +123,27 @@ ErrorOr<size_t> InodeFile::write(OpenFileDescription& description, u64 offset, U
         return EOVERFLOW;
 
     size_t nwritten = TRY(m_inode->write_bytes(offset, count, data, &description));
-    if (nwritten > 0) {
-        auto mtime_result = m_inode->update_timestamps({}, {}, kgettimeofday());
-        Thread::current()->did_file_write(nwritten);
-        evaluate_block_conditions();
-        if (mtime_result.is_error())
-            return mtime_result.release_error();
-    }
+    TRY(did_write(nwritten));
+    return nwritten;
+}
+
+ErrorOr<size_t> InodeFile::append(OpenFileDescription& description, UserOrKernelBuffer const& data, size_t count, off_t& offset)
+{
+    size_t nwritten = TRY(m_inode->append_bytes(count, data, &description, offset));
+    TRY(did_write(nwritten));
     return nwritten;
 }
 
+ErrorOr<void> InodeFile::did_write(size_t nwritten)
+{
+    if (nwritten == 0)
+        return {};
+    auto mtime_result = m_inode->update_timestamps({}, {}, kgettimeofday());
+    Thread::current()->did_file_write(nwritten);
+    evaluate_block_conditions();
+    return mtime_result;
+}
+
 ErrorOr<void> InodeFile::ioctl(OpenFileDescription& description, unsigned request, Userspace<void*> arg)
 {
     switch (request) {
@@ -14,6 +14,14 @@ class Inode;
 
 class InodeFile final : public File {
 public:
+    struct ReadaheadStatistics {
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 requests { 0 };
+        u64 bytes { 0 };
+    };
+    static ReadaheadStatistics readahead_statistics();
+
     static ErrorOr<NonnullRefPtr<InodeFile>> create(NonnullRefPtr<Inode> inode)
     {
         auto file = adopt_ref_if_nonnull(new (nothrow) InodeFile(move(inode)));
@@ -32,6 +40,7 @@ public:
 
     virtual ErrorOr<size_t> read(OpenFileDescription&, u64, UserOrKernelBuffer&, size_t) override;
     virtual ErrorOr<size_t> write(OpenFileDescription&, u64, UserOrKernelBuffer const&, size_t) override;
+    ErrorOr<size_t> append(OpenFileDescription&, UserOrKernelBuffer const&, size_t, off_t& offset);
     virtual ErrorOr<void> ioctl(OpenFileDescription&, unsigned request, Userspace<void*> arg) override;
     virtual ErrorOr<VMObjectAndMemoryType> vmobject_and_memory_type_for_mmap(Process&, Memory::VirtualRange const&, u64& offset, bool shared) override;
     virtual ErrorOr<struct stat> stat() const override { return inode().metadata().stat(); }
@@ -52,6 +61,10 @@ private:
     virtual bool is_regular_file() const override;
 
     explicit InodeFile(NonnullRefPtr<Inode>);
+
+    ErrorOr<void> did_write(size_t nwritten);
+    void update_readahead(OpenFileDescription&, u64 offset, size_t nread);
+
     NonnullRefPtr<Inode> const m_inode;
 };
 
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/BuiltinWrappers.h>
+#include <AK/Singleton.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/InodePageCache.h>
+#include <Kernel/Locking/SpinlockProtected.h>
+#include <Kernel/Memory/MemoryManager.h>
+
+namespace Kernel {
+
+struct PageCacheState {
+    // NOTE: Chunks are moved to the front whenever they are used, so the least recently used chunk is always last.
+    InodePageCache::ChunkList lru_list;
+    InodePageCache::Statistics statistics;
+};
+
+// NOTE: This lock also guards the chunk maps of all InodePageCaches.
+static Singleton<RecursiveSpinlockProtected<PageCacheState, LockRank::None>> s_state;
+
+static constexpr u32 page_mask(size_t first_page, size_t page_count)
+{
+    if (page_count == 0)
+        return 0;
+    return (page_count >= 32 ? 0xffffffffu : ((1u << page_count) - 1)) << first_page;
+}
+
+ErrorOr<NonnullOwnPtr<InodePageCache>> InodePageCache::try_create(Inode& inode)
+{
+    return adopt_nonnull_own_or_enomem(new (nothrow) InodePageCache(inode));
+}
+
+InodePageCache::InodePageCache(Inode& inode)
+    : m_inode(inode)
+{
+}
+
+InodePageCache::~InodePageCache()
+{
+    HashMap<u64, NonnullRefPtr<Chunk>> chunks;
+    s_state->with([&](auto& state) {
+        for (auto& it : m_chunks) {
+            auto& chunk = *it.value;
+            state.lru_list.remove(chunk);
+            state.statistics.cached_pages -= chunk.page_count();
+            state.statistics.dirty_pages -= popcount(chunk.dirty_page_mask);
+        }
+        chunks = move(m_chunks);
+    });
+    // NOTE: The chunks (and with them, their kernel mappings) are released here, outside of the spinlock.
+}
+
+bool InodePageCache::Chunk::has_pages_in_use_elsewhere() const
+{
+    for (size_t i = 0; i < pages.size(); ++i) {
+        // One reference is held by `pages`, and one by each mapping that covers this page.
+        size_t expected_ref_count = 2;
+        for (auto& retired_mapping : retired_mappings) {
+            if (retired_mapping->page_count() > i)
+                ++expected_ref_count;
+        }
+        if (pages[i]->ref_count() > expected_ref_count)
+            return true;
+    }
+    return false;
+}
+
+bool InodePageCache::is_empty() const
+{
+    return s_state->with([&](auto&) { return m_chunks.is_empty(); });
+}
+
+bool InodePageCache::is_dirty() const
+{
+    return s_state->with([&](auto&) {
+        for (auto& it : m_chunks) {
+            if (it.value->dirty_page_mask)
+                return true;
+        }
+        return false;
+    });
+}
+
+InodePageCache::Statistics InodePageCache::statistics()
+{
+    return s_state->with([](auto& state) { return state.statistics; });
+}
+
+size_t InodePageCache::reclaim_clean_pages(size_t page_count)
+{
+    // NOTE: Releasing a chunk unmaps its kernel region, which we must not do while holding a spinlock
+    //       or while handling an IRQ. This also keeps us from recursing into ourselves when an allocation
+    //       made while holding the page cache lock ends up here.
+    if (Processor::in_critical() || Processor::current_in_irq())
+        return 0;
+
+    Vector<NonnullRefPtr<Chunk>, 16> reclaimed_chunks;
+    size_t reclaimed_page_count = 0;
+    s_state->with([&](auto& state) {
+        for (auto it = state.lru_list.rbegin(); it != state.lru_list.rend() && reclaimed_page_count < page_count; ++it) {
+            auto& chunk = *it;
+            if (chunk.dirty_page_mask)
+                continue;
+            // NOTE: A ref count above 1 means someone is copying data in or out of this chunk right now.
+            if (chunk.ref_count() > 1)
+                continue;
+            if (chunk.has_pages_in_use_elsewhere())
+                continue;
+            if (reclaimed_chunks.try_append(chunk).is_error())
+                break;
+            reclaimed_page_count += chunk.page_count();
+        }
+
+        for (auto& chunk : reclaimed_chunks) {
+            state.lru_list.remove(*chunk);
+            chunk->cache.m_chunks.remove(chunk->index);
+        }
+        state.statistics.cached_pages -= reclaimed_page_count;
+        state.statistics.reclaimed_pages += reclaimed_page_count;
+    });
+
+    dbgln_if(PAGE_CACHE_DEBUG, "InodePageCache: Reclaimed {} clean pages", reclaimed_page_count);
+    return reclaimed_page_count;
+}
+
+static u64 pages_below_low_watermark()
+{
+    auto memory_info = MM.get_system_memory_info();
+    auto low_watermark = max(memory_info.physical_pages / 32, static_cast<u64>(InodePageCache::pages_per_chunk * 4));
+    if (memory_info.physical_pages_uncommitted >= low_watermark)
+        return 0;
+    return low_watermark - memory_info.physical_pages_uncommitted;
+}
+
+static void reclaim_pages_if_memory_is_low()
+{
+    if (auto page_count = pages_below_low_watermark())
+        InodePageCache::reclaim_clean_pages(page_count);
+}
+
+ErrorOr<void> InodePageCache::fill_pages(u8* chunk_data, u64 chunk_index, size_t first_page, size_t page_count, u64 file_size, u64 write_offset, u64 write_count)
+{
+    u64 const chunk_offset = chunk_index * chunk_size;
+    size_t page = first_page;
+    while (page < first_page + page_count) {
+        u64 page_offset = chunk_offset + page * PAGE_SIZE;
+        u8* page_data = chunk_data + page * PAGE_SIZE;
+
+        // A page that is completely overwritten by the pending write doesn't need any initial contents.
+        if (write_count && page_offset >= write_offset && page_offset + PAGE_SIZE <= write_offset + write_count) {
+            ++page;
+            continue;
+        }
+
+        if (page_offset >= file_size) {
+            memset(page_data, 0, PAGE_SIZE);
+            ++page;
+            continue;
+        }
+
+        // Read as many consecutive pages as possible from the backing store in one go.
+        size_t run_length = 1;
+        while (page + run_length < first_page + page_count) {
+            u64 next_page_offset = page_offset + run_length * PAGE_SIZE;
+            if (next_page_offset >= file_size)
+                break;
+            if (write_count && next_page_offset >= write_offset && next_page_offset + PAGE_SIZE <= write_offset + write_count)
+                break;
+            ++run_length;
+        }
+
+        TRY(m_inode.read_page_cache_range(page_offset, { page_data, run_length * PAGE_SIZE }));
+
+        // Make sure nothing beyond the end of the file is ever visible through the cache.
+        u64 run_end = page_offset + run_length * PAGE_SIZE;
+        if (run_end > file_size)
+            memset(page_data + (file_size - page_offset), 0, run_end - file_size);
+
+        page += run_length;
+    }
+    return {};
+}
+
+ErrorOr<InodePageCache::ChunkAccess> InodePageCache::ensure_chunk(u64 chunk_index, size_t required_pages, u64 file_size, AccessType access_type, u64 write_offset, u64 write_count)
+{
+    VERIFY(required_pages > 0 && required_pages <= pages_per_chunk);
+
+    // Cover everything up to the end of the file (or the end of the chunk) right away,
+    // so that sequential access doesn't have to grow the chunk page by page.
+    u64 const chunk_offset = chunk_index * chunk_size;
+    size_t pages_up_to_eof = file_size > chunk_offset ? min(ceil_div(file_size - chunk_offset, static_cast<u64>(PAGE_SIZE)), static_cast<u64>(pages_per_chunk)) : 0;
+
+    bool counted_miss = false;
+    for (;;) {
+        RefPtr<Chunk> existing_chunk;
+        Optional<ChunkAccess> hit;
+        s_state->with([&](auto& state) {
+            auto it = m_chunks.find(chunk_index);
+            if (it == m_chunks.end())
+                return;
+            existing_chunk = it->value;
+            if (existing_chunk->page_count() < required_pages)
+                return;
+            if (state.lru_list.first() != existing_chunk.ptr())
+                state.lru_list.prepend(*existing_chunk);
+            if (!counted_miss && access_type == AccessType::Demand)
+                ++state.statistics.hits;
+            hit = ChunkAccess { *existing_chunk, existing_chunk->data() };
+        });
+        if (hit.has_value())
+            return hit.release_value();
+
+        if (!counted_miss) {
+            if (access_type == AccessType::Demand)
+                s_state->with([](auto& state) { ++state.statistics.misses; });
+            counted_miss = true;
+        }
+
+        size_t existing_page_count = 0;
+        Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages;
+        if (existing_chunk) {
+            s_state->with([&](auto&) {
+                existing_page_count = existing_chunk->page_count();
+                pages.ensure_capacity(existing_page_count);
+                for (auto& page : existing_chunk->pages)
+                    pages.unchecked_append(page);
+            });
+        }
+
+        size_t target_page_count = max(required_pages, pages_up_to_eof);
+        if (existing_page_count)
+            target_page_count = max(target_page_count, min(existing_page_count * 2, pages_per_chunk));
+        VERIFY(target_page_count > existing_page_count);
+
+        if (!existing_chunk)
+            reclaim_pages_if_memory_is_low();
+
+        TRY(pages.try_ensure_capacity(target_page_count));
+        for (size_t i = existing_page_count; i < target_page_count; ++i)
+            pages.unchecked_append(TRY(MM.allocate_physical_page(Memory::MemoryManager::ShouldZeroFill::No)));
+
+        auto mapping = TRY(MM.allocate_kernel_region_with_physical_pages(pages, "InodePageCache"sv, Memory::Region::Access::ReadWrite));
+        auto* data = mapping->vaddr().as_ptr();
+        TRY(fill_pages(data, chunk_index, existing_page_count, target_page_count - existing_page_count, file_size, write_offset, write_count));
+
+        RefPtr<Chunk> new_chunk;
+        if (!existing_chunk)
+            new_chunk = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Chunk(*this, chunk_index, move(pages), move(mapping))));
+
+        // NOTE: The new pages are not visible to anyone else until we publish them here.
+        //       If someone else changed the chunk in the meantime, we throw our work away and start over.
+        auto published = TRY(s_state->with([&](auto& state) -> ErrorOr<bool> {
+            auto it = m_chunks.find(chunk_index);
+            if (existing_chunk) {
+                if (it == m_chunks.end() || it->value.ptr() != existing_chunk.ptr() || existing_chunk->page_count() != existing_page_count)
+                    return false;
+                TRY(existing_chunk->retired_mappings.try_append(move(existing_chunk->mapping)));
+                existing_chunk->mapping = move(mapping);
+                existing_chunk->pages = move(pages);
+            } else {
+                if (it != m_chunks.end())
+                    return false;
+                TRY(m_chunks.try_set(chunk_index, *new_chunk));
+                existing_chunk = new_chunk;
+            }
+            state.statistics.cached_pages += target_page_count - existing_page_count;
+            if (access_type == AccessType::Readahead)
+                state.statistics.readahead_pages += target_page_count - existing_page_count;
+            if (state.lru_list.first() != existing_chunk.ptr())
+                state.lru_list.prepend(*existing_chunk);
+            return true;
+        }));
+        if (published)
+            return ChunkAccess { existing_chunk.release_nonnull(), data };
+
+        dbgln_if(PAGE_CACHE_DEBUG, "InodePageCache: Lost race for chunk {}, retrying", chunk_index);
+    }
+}
+
+ErrorOr<size_t> InodePageCache::read(u64 offset, size_t count, UserOrKernelBuffer& buffer, u64 file_size)
+{
+    if (offset >= file_size)
+        return 0;
+    count = min(static_cast<u64>(count), file_size - offset);
+
+    size_t nread = 0;
+    while (nread < count) {
+        u64 current_offset = offset + nread;
+        u64 chunk_index = current_offset / chunk_size;
+        size_t offset_in_chunk = current_offset % chunk_size;
+        size_t length = min(count - nread, chunk_size - offset_in_chunk);
+        size_t required_pages = ceil_div(offset_in_chunk + length, static_cast<size_t>(PAGE_SIZE));
+
+        auto access = TRY(ensure_chunk(chunk_index, required_pages, file_size, AccessType::Demand));
+        TRY(buffer.write(access.data + offset_in_chunk, nread, length));
+        nread += length;
+    }
+    return nread;
+}
+
+ErrorOr<size_t> InodePageCache::write(u64 offset, size_t count, UserOrKernelBuffer const& data, u64 file_size)
+{
+    size_t nwritten = 0;
+    while (nwritten < count) {
+        u64 current_offset = offset + nwritten;
+        u64 chunk_index = current_offset / chunk_size;
+        size_t offset_in_chunk = current_offset % chunk_size;
+        size_t length = min(count - nwritten, chunk_size - offset_in_chunk);
+        size_t first_page = offset_in_chunk / PAGE_SIZE;
+        size_t required_pages = ceil_div(offset_in_chunk + length, static_cast<size_t>(PAGE_SIZE));
+
+        auto access = TRY(ensure_chunk(chunk_index, required_pages, file_size, AccessType::Demand, current_offset, length));
+        auto result = data.read(access.data + offset_in_chunk, nwritten, length);
+
+        // NOTE: Even a failed copy may have modified the pages, so they are marked dirty either way.
+        s_state->with([&](auto& state) {
+            auto& chunk = *access.chunk;
+            auto new_dirty_pages = page_mask(first_page, required_pages - first_page) & ~chunk.dirty_page_mask;
+            chunk.dirty_page_mask |= new_dirty_pages;
+            state.statistics.dirty_pages += popcount(new_dirty_pages);
+        });
+        TRY(result);
+        nwritten += length;
+    }
+    return nwritten;
+}
+
+ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> InodePageCache::physical_page(size_t page_index, u64 file_size)
+{
+    u64 chunk_index = page_index / pages_per_chunk;
+    size_t page_in_chunk = page_index % pages_per_chunk;
+    auto access = TRY(ensure_chunk(chunk_index, page_in_chunk + 1, file_size, AccessType::Demand));
+    return s_state->with([&](auto&) { return access.chunk->pages[page_in_chunk]; });
+}
+
+ErrorOr<size_t> InodePageCache::read_ahead(u64 offset, u64 length, u64 file_size)
+{
+    if (offset >= file_size)
+        return 0;
+    u64 end = min(offset + length, file_size);
+
+    u64 chunk_index = offset / chunk_size;
+    for (; chunk_index * chunk_size < end; ++chunk_index) {
+        // Readahead is purely speculative, so it must never push actually useful pages out of the cache.
+        if (pages_below_low_watermark())
+            break;
+        size_t required_pages = ceil_div(min(end - chunk_index * chunk_size, static_cast<u64>(chunk_size)), static_cast<u64>(PAGE_SIZE));
+        TRY(ensure_chunk(chunk_index, required_pages, file_size, AccessType::Readahead));
+    }
+    return min(chunk_index * chunk_size, end) - offset;
+}
+
+ErrorOr<void> InodePageCache::writeback(u64 offset, u64 count)
+{
+    struct DirtyChunk {
+        NonnullRefPtr<Chunk> chunk;
+        u8* data;
+        u32 dirty_page_mask;
+    };
+    Vector<DirtyChunk> dirty_chunks;
+
+    u64 first_chunk_index = offset / chunk_size;
+    u64 last_chunk_index = count > NumericLimits<u64>::max() - offset ? NumericLimits<u64>::max() : (offset + count - 1) / chunk_size;
+    TRY(s_state->with([&](auto& state) -> ErrorOr<void> {
+        for (auto& it : m_chunks) {
+            auto& chunk = *it.value;
+            if (!chunk.dirty_page_mask || chunk.index < first_chunk_index || chunk.index > last_chunk_index)
+                continue;
+            TRY(dirty_chunks.try_append({ chunk, chunk.data(), chunk.dirty_page_mask }));
+            state.statistics.dirty_pages -= popcount(chunk.dirty_page_mask);
+            chunk.dirty_page_mask = 0;
+        }
+        return {};
+    }));
+
+    ErrorOr<void> result;
+    for (auto& dirty_chunk : dirty_chunks) {
+        auto& chunk = *dirty_chunk.chunk;
+        size_t page = 0;
+        while (page < pages_per_chunk) {
+            if (!(dirty_chunk.dirty_page_mask & (1u << page))) {
+                ++page;
+                continue;
+            }
+            size_t run_length = 1;
+            while (page + run_length < pages_per_chunk && (dirty_chunk.dirty_page_mask & (1u << (page + run_length))))
+                ++run_length;
+
+            u64 run_offset = chunk.index * chunk_size + page * PAGE_SIZE;
+            auto run_result = m_inode.write_page_cache_range(run_offset, { dirty_chunk.data + page * PAGE_SIZE, run_length * PAGE_SIZE });
+            if (run_result.is_error()) {
+                dbgln("InodePageCache: Failed to write back {} pages at offset {} of inode {}: {}", run_length, run_offset, m_inode.identifier(), run_result.error());
+                s_state->with([&](auto& state) {
+                    auto mask = page_mask(page, run_length) & ~chunk.dirty_page_mask;
+                    chunk.dirty_page_mask |= mask;
+                    state.statistics.dirty_pages += popcount(mask);
+                });
+                if (!result.is_error())
+                    result = run_result.release_error();
+            }
+            page += run_length;
+        }
+    }
+    return result;
+}
+
+void InodePageCache::truncate(u64 new_size)
+{
+    Vector<NonnullRefPtr<Chunk>> removed_chunks;
+    s_state->with([&](auto& state) {
+        m_chunks.remove_all_matching([&](u64 chunk_index, NonnullRefPtr<Chunk> const& chunk) {
+            if (chunk_index * chunk_size < new_size)
+                return false;
+            // NOTE: If we can't keep the chunk alive until we've left the spinlock, we'll have to keep it in the cache.
+            //       Its contents lie entirely beyond the end of the file, so it will never be written back.
+            if (removed_chunks.try_append(chunk).is_error())
+                return false;
+            state.lru_list.remove(*chunk);
+            state.statistics.cached_pages -= chunk->page_count();
+            state.statistics.dirty_pages -= popcount(chunk->dirty_page_mask);
+            return true;
+        });
+
+        auto it = m_chunks.find(new_size / chunk_size);
+        if (it == m_chunks.end())
+            return;
+        auto& chunk = *it->value;
+        size_t offset_in_chunk = new_size % chunk_size;
+        size_t chunk_length = chunk.page_count() * PAGE_SIZE;
+        if (offset_in_chunk < chunk_length)
+            memset(chunk.data() + offset_in_chunk, 0, chunk_length - offset_in_chunk);
+
+        size_t pages_to_keep = ceil_div(offset_in_chunk, static_cast<size_t>(PAGE_SIZE));
+        auto discarded_dirty_pages = chunk.dirty_page_mask & ~page_mask(0, pages_to_keep);
+        chunk.dirty_page_mask &= ~discarded_dirty_pages;
+        state.statistics.dirty_pages -= popcount(discarded_dirty_pages);
+    });
+}
+
+}
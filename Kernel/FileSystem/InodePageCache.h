@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/HashMap.h>
+#include <AK/IntrusiveList.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/RefCounted.h>
+#include <AK/Vector.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Memory/PhysicalRAMPage.h>
+#include <Kernel/Memory/Region.h>
+
+namespace Kernel {
+
+// InodePageCache keeps the contents of a regular file in physical pages. Pages are
+// grouped into chunks of up to `pages_per_chunk` pages which are mapped into the kernel
+// address space, so read() and write() only ever copy once. The very same physical pages
+// are handed out to SharedInodeVMObjects, which means file data is only cached once no
+// matter whether it is accessed through a file descriptor or through a shared mapping.
+//
+// Dirty pages are written back through the owning Inode by the sync task, and clean
+// chunks are reclaimed (least recently used first) when physical memory runs low.
+class InodePageCache {
+    AK_MAKE_NONCOPYABLE(InodePageCache);
+    AK_MAKE_NONMOVABLE(InodePageCache);
+
+public:
+    static constexpr size_t pages_per_chunk = 16;
+    static constexpr size_t chunk_size = pages_per_chunk * PAGE_SIZE;
+
+    struct Statistics {
+        size_t cached_pages { 0 };
+        size_t dirty_pages { 0 };
+        u64 hits { 0 };
+        u64 misses { 0 };
+        u64 reclaimed_pages { 0 };
+        u64 readahead_pages { 0 };
+    };
+
+    static ErrorOr<NonnullOwnPtr<InodePageCache>> try_create(Inode&);
+    ~InodePageCache();
+
+    // NOTE: The caller must hold the inode lock, in shared mode for read() and physical_page(),
+    //       and in exclusive mode for everything else. `file_size` is the size of the inode
+    //       before the operation, and is used to decide which parts of the cache have to be
+    //       filled from the backing store.
+    ErrorOr<size_t> read(u64 offset, size_t count, UserOrKernelBuffer&, u64 file_size);
+    ErrorOr<size_t> write(u64 offset, size_t count, UserOrKernelBuffer const&, u64 file_size);
+    ErrorOr<NonnullRefPtr<Memory::PhysicalRAMPage>> physical_page(size_t page_index, u64 file_size);
+    ErrorOr<size_t> read_ahead(u64 offset, u64 length, u64 file_size);
+    ErrorOr<void> writeback(u64 offset, u64 count);
+    ErrorOr<void> writeback() { return writeback(0, NumericLimits<u64>::max()); }
+    void truncate(u64 new_size);
+
+    bool is_empty() const;
+    bool is_dirty() const;
+
+    static size_t reclaim_clean_pages(size_t page_count);
+    static Statistics statistics();
+
+private:
+    struct Chunk final : public RefCounted<Chunk> {
+        Chunk(InodePageCache& cache, u64 index, Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages, NonnullOwnPtr<Memory::Region> mapping)
+            : cache(cache)
+            , index(index)
+            , pages(move(pages))
+            , mapping(move(mapping))
+        {
+        }
+
+        size_t page_count() const { return pages.size(); }
+        u8* data() { return mapping->vaddr().as_ptr(); }
+        bool has_pages_in_use_elsewhere() const;
+
+        InodePageCache& cache;
+        u64 const index;
+        Vector<NonnullRefPtr<Memory::PhysicalRAMPage>> pages;
+        NonnullOwnPtr<Memory::Region> mapping;
+        // NOTE: When a chunk grows it gets a new mapping, but readers may still be copying
+        //       out of the old one. Both map the same physical pages, so we simply keep the
+        //       old mappings around for as long as the chunk lives.
+        Vector<NonnullOwnPtr<Memory::Region>> retired_mappings;
+        u32 dirty_page_mask { 0 };
+        IntrusiveListNode<Chunk> lru_list_node;
+    };
+    static_assert(pages_per_chunk <= sizeof(Chunk::dirty_page_mask) * 8);
+
+public:
+    using ChunkList = IntrusiveList<&Chunk::lru_list_node>;
+
+private:
+    explicit InodePageCache(Inode&);
+
+    struct ChunkAccess {
+        NonnullRefPtr<Chunk> chunk;
+        u8* data;
+    };
+    enum class AccessType {
+        Demand,
+        Readahead,
+    };
+    ErrorOr<ChunkAccess> ensure_chunk(u64 chunk_index, size_t required_pages, u64 file_size, AccessType, u64 write_offset = 0, u64 write_count = 0);
+    ErrorOr<void> fill_pages(u8* chunk_data, u64 chunk_index, size_t first_page, size_t page_count, u64 file_size, u64 write_offset, u64 write_count);
+
+    Inode& m_inode;
+    // NOTE: This is guarded by the global page cache lock.
+    HashMap<u64, NonnullRefPtr<Chunk>> m_chunks;
+};
+
+}
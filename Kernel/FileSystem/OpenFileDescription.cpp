@@ -11,7 +11,9 @@
 #include <Kernel/Devices/TTY/MasterPTY.h>
 #include <Kernel/Devices/TTY/TTY.h>
 #include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/EventPoll.h>
 #include <Kernel/FileSystem/FIFO.h>
+#include <Kernel/FileSystem/IORing.h>
 #include <Kernel/FileSystem/InodeFile.h>
 #include <Kernel/FileSystem/InodeWatcher.h>
 #include <Kernel/FileSystem/MountFile.h>
@@ -53,6 +55,7 @@ OpenFileDescription::OpenFileDescription(File& file)
 
 OpenFileDescription::~OpenFileDescription()
 {
+    m_file->blocker_set().description_will_be_destroyed(*this);
     m_file->detach(*this);
     // FIXME: Should this error path be observed somehow?
     (void)m_file->close();
@@ -108,6 +111,7 @@ ErrorOr<off_t> OpenFileDescription::seek(off_t offset, int whence)
     if (!m_file->is_seekable())
         return ESPIPE;
 
+    MutexLocker offset_locker(m_offset_lock);
     auto metadata = this->metadata();
 
     auto new_offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
@@ -162,6 +166,13 @@ ErrorOr<size_t> OpenFileDescription::write(u64 offset, UserOrKernelBuffer const&
 
 ErrorOr<size_t> OpenFileDescription::read(UserOrKernelBuffer& buffer, size_t count)
 {
+    // POSIX requires reads and writes that use the file offset to be atomic with respect to each other,
+    // even when they come from different threads. Only seekable files have a meaningful offset though,
+    // and those are the only ones where we can afford to hold a lock across the whole operation.
+    MutexLocker offset_locker;
+    if (m_file->is_seekable())
+        offset_locker.attach_and_lock(m_offset_lock);
+
     auto offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
         if (Checked<off_t>::addition_would_overflow(state.current_offset, count))
             return EOVERFLOW;
@@ -176,6 +187,23 @@ ErrorOr<size_t> OpenFileDescription::read(UserOrKernelBuffer& buffer, size_t cou
 
 ErrorOr<size_t> OpenFileDescription::write(UserOrKernelBuffer const& data, size_t size)
 {
+    MutexLocker offset_locker;
+    if (m_file->is_seekable()) {
+        offset_locker.attach_and_lock(m_offset_lock);
+        if (should_append()) {
+            // NOTE: Appends to inodes are positioned by the inode itself, under the same lock as the write,
+            //       so that appenders using other open file descriptions can't overwrite each other's data.
+            if (m_file->is_inode()) {
+                off_t offset = 0;
+                auto nwritten = TRY(static_cast<InodeFile&>(*m_file).append(*this, data, size, offset));
+                m_state.with([&](auto& state) { state.current_offset = offset + nwritten; });
+                evaluate_block_conditions();
+                return nwritten;
+            }
+            TRY(seek(0, SEEK_END));
+        }
+    }
+
     auto offset = TRY(m_state.with([&](auto& state) -> ErrorOr<off_t> {
         if (Checked<off_t>::addition_would_overflow(state.current_offset, size))
             return EOVERFLOW;
@@ -313,6 +341,44 @@ InodeWatcher* OpenFileDescription::inode_watcher()
     return static_cast<InodeWatcher*>(m_file.ptr());
 }
 
+bool OpenFileDescription::is_event_poll() const
+{
+    return m_file->is_event_poll();
+}
+
+EventPoll const* OpenFileDescription::event_poll() const
+{
+    if (!is_event_poll())
+        return nullptr;
+    return static_cast<EventPoll const*>(m_file.ptr());
+}
+
+EventPoll* OpenFileDescription::event_poll()
+{
+    if (!is_event_poll())
+        return nullptr;
+    return static_cast<EventPoll*>(m_file.ptr());
+}
+
+bool OpenFileDescription::is_io_ring() const
+{
+    return m_file->is_io_ring();
+}
+
+IORing const* OpenFileDescription::io_ring() const
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing const*>(m_file.ptr());
+}
+
+IORing* OpenFileDescription::io_ring()
+{
+    if (!is_io_ring())
+        return nullptr;
+    return static_cast<IORing*>(m_file.ptr());
+}
+
 bool OpenFileDescription::is_mount_file() const
 {
     return m_file->is_mount_file();
@@ -80,6 +80,14 @@ public:
     InodeWatcher const* inode_watcher() const;
     InodeWatcher* inode_watcher();
 
+    bool is_event_poll() const;
+    EventPoll const* event_poll() const;
+    EventPoll* event_poll();
+
+    bool is_io_ring() const;
+    IORing const* io_ring() const;
+    IORing* io_ring();
+
     bool is_mount_file() const;
     MountFile const* mount_file() const;
     MountFile* mount_file();
@@ -132,6 +140,18 @@ public:
     ErrorOr<void> apply_flock(Process const&, Userspace<flock const*>, ShouldBlock);
     ErrorOr<void> get_flock(Userspace<flock*>) const;
 
+    struct ReadaheadState {
+        u64 next_offset { 0 };
+        u64 readahead_end { 0 };
+        size_t window { 0 };
+    };
+
+    template<typename Callback>
+    decltype(auto) with_readahead_state(Callback callback)
+    {
+        return m_state.with([&](auto& state) -> decltype(auto) { return callback(state.readahead); });
+    }
+
 private:
     explicit OpenFileDescription(File&);
 
@@ -149,6 +169,7 @@ private:
         OwnPtr<OpenFileDescriptionData> data;
         RefPtr<Custody> custody;
         off_t current_offset { 0 };
+        ReadaheadState readahead;
         u32 file_flags { 0 };
         bool readable : 1 { false };
         bool writable : 1 { false };
@@ -160,5 +181,8 @@ private:
     };
 
     RecursiveSpinlockProtected<State, LockRank::None> m_state {};
+
+    // Held across reads, writes and seeks that use the current offset.
+    Mutex m_offset_lock { "OpenFileDescription offset"sv };
 };
 }
@@ -4,9 +4,12 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/JsonObjectSerializer.h>
 #include <Kernel/Bus/PCI/Access.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Devices/Storage/DeviceAttribute.h>
+#include <Kernel/Library/KBufferBuilder.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
 
@@ -19,6 +22,10 @@ StringView StorageDeviceAttributeSysFSComponent::name() const
         return "sector_size"sv;
     case Type::CommandSet:
         return "command_set"sv;
+    case Type::Scheduler:
+        return "scheduler"sv;
+    case Type::QueueStatistics:
+        return "queue_statistics"sv;
     default:
         VERIFY_NOT_REACHED();
     }
@@ -48,6 +55,60 @@ ErrorOr<size_t> StorageDeviceAttributeSysFSComponent::read_bytes(off_t offset, s
     return nread;
 }
 
+mode_t StorageDeviceAttributeSysFSComponent::permissions() const
+{
+    if (m_type == Type::Scheduler)
+        return 0644;
+    return SysFSComponent::permissions();
+}
+
+ErrorOr<size_t> StorageDeviceAttributeSysFSComponent::write_bytes(off_t, size_t count, UserOrKernelBuffer const& buffer, OpenFileDescription*)
+{
+    if (m_type != Type::Scheduler)
+        return EROFS;
+
+    char* value = nullptr;
+    auto new_value = TRY(KString::try_create_uninitialized(count, value));
+    TRY(buffer.read(value, count));
+    // NOTE: If we are in a jail, don't let the current process change how the device schedules its requests.
+    if (Process::current().is_jailed())
+        return Error::from_errno(EPERM);
+    auto policy = StorageRequestQueue::policy_from_string_view(new_value->view().trim("\n"sv));
+    if (!policy.has_value())
+        return Error::from_errno(EINVAL);
+    m_device->request_queue().set_policy(policy.value());
+    return count;
+}
+
+ErrorOr<void> StorageDeviceAttributeSysFSComponent::truncate(u64 size)
+{
+    if (m_type != Type::Scheduler || size != 0)
+        return EPERM;
+    return {};
+}
+
+static ErrorOr<NonnullOwnPtr<KBuffer>> try_to_generate_queue_statistics(StorageRequestQueue const& request_queue)
+{
+    auto builder = TRY(KBufferBuilder::try_create());
+    auto statistics = request_queue.statistics();
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("scheduler"sv, StorageRequestQueue::policy_to_string_view(request_queue.policy())));
+    TRY(json.add("requests"sv, statistics.requests));
+    TRY(json.add("dispatched_requests"sv, statistics.dispatched_requests));
+    TRY(json.add("merged_requests"sv, statistics.merged_requests));
+    TRY(json.add("expired_deadlines"sv, statistics.expired_deadlines));
+    TRY(json.add("plugs"sv, statistics.plugs));
+    TRY(json.add("queued_requests"sv, statistics.queued_requests));
+    TRY(json.add("max_queued_requests"sv, statistics.max_queued_requests));
+    TRY(json.add("in_flight_requests"sv, statistics.in_flight_requests));
+    TRY(json.add("max_blocks_per_request"sv, statistics.max_blocks_per_request));
+    TRY(json.finish());
+    auto buffer = builder.build();
+    if (!buffer)
+        return ENOMEM;
+    return buffer.release_nonnull();
+}
+
 ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_generate_buffer() const
 {
     OwnPtr<KString> value;
@@ -61,6 +122,11 @@ ErrorOr<NonnullOwnPtr<KBuffer>> StorageDeviceAttributeSysFSComponent::try_to_gen
     case Type::CommandSet:
         value = TRY(KString::formatted("{}", m_device->command_set_to_string_view()));
         break;
+    case Type::Scheduler:
+        value = TRY(KString::formatted("{}", StorageRequestQueue::policy_to_string_view(m_device->request_queue().policy())));
+        break;
+    case Type::QueueStatistics:
+        return try_to_generate_queue_statistics(m_device->request_queue());
     default:
         VERIFY_NOT_REACHED();
     }
@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/StackSamplingFrequency.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/ContinuousProfiler.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSStackSamplingFrequency::SysFSStackSamplingFrequency(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSStackSamplingFrequency> SysFSStackSamplingFrequency::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSStackSamplingFrequency(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSStackSamplingFrequency::try_generate(KBufferBuilder& builder)
+{
+    return builder.appendff("{}\n", ContinuousProfiler::the().frequency());
+}
+
+ErrorOr<size_t> SysFSStackSamplingFrequency::write_bytes(off_t, size_t count, UserOrKernelBuffer const& buffer, OpenFileDescription*)
+{
+    MutexLocker locker(m_refresh_lock);
+    char value[16];
+    if (count > sizeof(value))
+        return EINVAL;
+    TRY(buffer.read(value, count));
+    auto frequency = StringView { value, count }.trim("\n"sv).to_number<u32>();
+    if (!frequency.has_value())
+        return EINVAL;
+    // NOTE: If we are in a jail, don't let the current process to change the variable.
+    if (Process::current().is_jailed())
+        return Error::from_errno(EPERM);
+    TRY(ContinuousProfiler::the().set_frequency(frequency.value()));
+    return count;
+}
+
+ErrorOr<void> SysFSStackSamplingFrequency::truncate(u64 size)
+{
+    if (size != 0)
+        return EPERM;
+    return {};
+}
+
+mode_t SysFSStackSamplingFrequency::permissions() const
+{
+    // NOTE: Sampling is system-wide, so only the root user may turn it on or off.
+    return S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH;
+}
+
+}
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/GlobalInformation.h>
+#include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSStackSamplingFrequency final : public SysFSGlobalInformation {
+public:
+    virtual StringView name() const override { return "stack_sampling_frequency"sv; }
+    static NonnullRefPtr<SysFSStackSamplingFrequency> must_create(SysFSDirectory const&);
+
+private:
+    explicit SysFSStackSamplingFrequency(SysFSDirectory const&);
+
+    // ^SysFSGlobalInformation
+    virtual ErrorOr<void> try_generate(KBufferBuilder&) override;
+
+    // ^SysFSExposedComponent
+    virtual ErrorOr<size_t> write_bytes(off_t, size_t, UserOrKernelBuffer const&, OpenFileDescription*) override;
+    virtual mode_t permissions() const override;
+    virtual ErrorOr<void> truncate(u64) override;
+};
+
+}
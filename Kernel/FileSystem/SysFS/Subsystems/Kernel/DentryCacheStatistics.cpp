@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/DentryCache.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DentryCacheStatistics.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSDentryCacheStatistics::SysFSDentryCacheStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSDentryCacheStatistics> SysFSDentryCacheStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSDentryCacheStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSDentryCacheStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto statistics = DentryCache::the().statistics();
+    auto lookups = statistics.hits + statistics.negative_hits + statistics.misses;
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("hits"sv, statistics.hits));
+    TRY(json.add("negative_hits"sv, statistics.negative_hits));
+    TRY(json.add("misses"sv, statistics.misses));
+    // In hundredths of a percent, counting negative hits as hits.
+    TRY(json.add("hit_rate"sv, lookups == 0 ? 0 : (statistics.hits + statistics.negative_hits) * 10000 / lookups));
+    TRY(json.add("invalidations"sv, statistics.invalidations));
+    TRY(json.add("evictions"sv, statistics.evictions));
+    TRY(json.add("entries"sv, statistics.entry_count));
+    TRY(json.add("size"sv, statistics.size_in_bytes));
+    TRY(json.add("maximum_size"sv, statistics.maximum_size_in_bytes));
+    TRY(json.finish());
+    return {};
+}
+
+}
@@ -0,0 +1,28 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/RefPtr.h>
+#include <AK/Types.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/GlobalInformation.h>
+#include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Library/UserOrKernelBuffer.h>
+
+namespace Kernel {
+
+class SysFSDentryCacheStatistics final : public SysFSGlobalInformation {
+public:
+    virtual StringView name() const override { return "dentry_cache"sv; }
+
+    static NonnullRefPtr<SysFSDentryCacheStatistics> must_create(SysFSDirectory const& parent_directory);
+
+private:
+    explicit SysFSDentryCacheStatistics(SysFSDirectory const& parent_directory);
+    virtual ErrorOr<void> try_generate(KBufferBuilder& builder) override;
+};
+
+}
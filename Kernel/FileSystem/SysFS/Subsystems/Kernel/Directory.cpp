@@ -12,6 +12,7 @@
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/CPUInfo.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Configuration/Directory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/ConstantInformation.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DentryCacheStatistics.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DeviceMajorNumberAllocations.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Directory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/DiskUsage.h>
@@ -20,12 +21,16 @@
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Keymap.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Log.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MemoryStatus.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MutexContentionStatistics.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Network/Directory.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/PowerStateSwitch.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Processes.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Profile.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/RequestPanic.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/SchedulerStatistics.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/StackSamples.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/SystemStatistics.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/TLBShootdownStatistics.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/Uptime.h>
 
 namespace Kernel {
@@ -37,6 +42,10 @@ UNMAP_AFTER_INIT NonnullRefPtr<SysFSGlobalKernelStatsDirectory> SysFSGlobalKerne
         list.append(SysFSDiskUsage::must_create(*global_kernel_stats_directory));
         list.append(SysFSMemoryStatus::must_create(*global_kernel_stats_directory));
         list.append(SysFSSystemStatistics::must_create(*global_kernel_stats_directory));
+        list.append(SysFSSchedulerStatistics::must_create(*global_kernel_stats_directory));
+        list.append(SysFSDentryCacheStatistics::must_create(*global_kernel_stats_directory));
+        list.append(SysFSTLBShootdownStatistics::must_create(*global_kernel_stats_directory));
+        list.append(SysFSMutexContentionStatistics::must_create(*global_kernel_stats_directory));
         list.append(SysFSOverallProcesses::must_create(*global_kernel_stats_directory));
         list.append(SysFSCPUInformation::must_create(*global_kernel_stats_directory));
         list.append(SysFSKernelLog::must_create(*global_kernel_stats_directory));
@@ -44,6 +53,7 @@ UNMAP_AFTER_INIT NonnullRefPtr<SysFSGlobalKernelStatsDirectory> SysFSGlobalKerne
         list.append(SysFSKeymap::must_create(*global_kernel_stats_directory));
         list.append(SysFSUptime::must_create(*global_kernel_stats_directory));
         list.append(SysFSProfile::must_create(*global_kernel_stats_directory));
+        list.append(SysFSStackSamples::must_create(*global_kernel_stats_directory));
         list.append(SysFSPowerStateSwitchNode::must_create(*global_kernel_stats_directory));
         list.append(SysFSSystemRequestPanic::must_create(*global_kernel_stats_directory));
 
@@ -5,6 +5,10 @@
  */
 
 #include <AK/JsonObjectSerializer.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/InodeFile.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MemoryStatus.h>
 #include <Kernel/Memory/MemoryManager.h>
 #include <Kernel/Sections.h>
@@ -27,6 +31,9 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     get_kmalloc_stats(stats);
 
     auto system_memory = MM.get_system_memory_info();
+    auto page_cache = InodePageCache::statistics();
+    auto readahead = InodeFile::readahead_statistics();
+    auto large_pages = MM.large_page_statistics();
 
     auto json = TRY(JsonObjectSerializer<>::try_create(builder));
     TRY(json.add("kmalloc_allocated"sv, stats.bytes_allocated));
@@ -37,6 +44,34 @@ ErrorOr<void> SysFSMemoryStatus::try_generate(KBufferBuilder& builder)
     TRY(json.add("physical_uncommitted"sv, system_memory.physical_pages_uncommitted));
     TRY(json.add("kmalloc_call_count"sv, stats.kmalloc_call_count));
     TRY(json.add("kfree_call_count"sv, stats.kfree_call_count));
+    TRY(json.add("page_cache_pages"sv, page_cache.cached_pages));
+    TRY(json.add("page_cache_dirty_pages"sv, page_cache.dirty_pages));
+    TRY(json.add("page_cache_hits"sv, page_cache.hits));
+    TRY(json.add("page_cache_misses"sv, page_cache.misses));
+    TRY(json.add("page_cache_reclaimed_pages"sv, page_cache.reclaimed_pages));
+    TRY(json.add("page_cache_readahead_pages"sv, page_cache.readahead_pages));
+    TRY(json.add("readahead_hits"sv, readahead.hits));
+    TRY(json.add("readahead_misses"sv, readahead.misses));
+    TRY(json.add("readahead_requests"sv, readahead.requests));
+    TRY(json.add("readahead_bytes"sv, readahead.bytes));
+    TRY(json.add("large_page_allocations"sv, large_pages.allocations));
+    TRY(json.add("large_page_allocation_failures"sv, large_pages.allocation_failures));
+    TRY(json.add("large_page_splits"sv, large_pages.splits));
+
+    auto processor_caches = TRY(json.add_array("kmalloc_processor_caches"sv));
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        kmalloc_processor_cache_stats cache_stats;
+        get_kmalloc_processor_cache_stats(processor, cache_stats);
+        auto cache = TRY(processor_caches.add_object());
+        TRY(cache.add("processor"sv, processor));
+        TRY(cache.add("allocation_hits"sv, cache_stats.allocation_hits));
+        TRY(cache.add("allocation_misses"sv, cache_stats.allocation_misses));
+        TRY(cache.add("free_hits"sv, cache_stats.free_hits));
+        TRY(cache.add("free_misses"sv, cache_stats.free_misses));
+        TRY(cache.add("cached_bytes"sv, cache_stats.cached_bytes));
+        TRY(cache.finish());
+    }
+    TRY(processor_caches.finish());
     TRY(json.finish());
     return {};
 }
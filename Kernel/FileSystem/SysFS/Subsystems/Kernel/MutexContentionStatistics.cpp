@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonArraySerializer.h>
+#include <AK/JsonObjectSerializer.h>
+#include <AK/QuickSort.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/MutexContentionStatistics.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSMutexContentionStatistics::SysFSMutexContentionStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSMutexContentionStatistics> SysFSMutexContentionStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSMutexContentionStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSMutexContentionStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto statistics = TRY(Mutex::contention_statistics());
+    quick_sort(statistics, [](auto const& a, auto const& b) { return a.contended_acquisitions > b.contended_acquisitions; });
+
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    for (auto const& entry : statistics) {
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("name"sv, entry.name.is_empty() ? "(unnamed)"sv : entry.name));
+        TRY(obj.add("contended_acquisitions"sv, entry.contended_acquisitions));
+        TRY(obj.add("acquired_by_spinning"sv, entry.acquired_by_spinning));
+        TRY(obj.add("blocked"sv, entry.blocked));
+        TRY(obj.add("spin_iterations"sv, entry.spin_iterations));
+        TRY(obj.finish());
+    }
+    TRY(array.finish());
+    return {};
+}
+
+}
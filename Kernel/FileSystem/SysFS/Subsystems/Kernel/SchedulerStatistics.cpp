@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/SchedulerStatistics.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/Scheduler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSSchedulerStatistics::SysFSSchedulerStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSSchedulerStatistics> SysFSSchedulerStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSSchedulerStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSSchedulerStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto array = TRY(JsonArraySerializer<>::try_create(builder));
+    TRY(Scheduler::try_for_each_processor_statistics([&](auto const& statistics) -> ErrorOr<void> {
+        auto obj = TRY(array.add_object());
+        TRY(obj.add("processor"sv, statistics.processor));
+        TRY(obj.add("queue_depth"sv, statistics.queue_depth));
+        TRY(obj.add("steals"sv, statistics.steals));
+        TRY(obj.add("stolen"sv, statistics.stolen));
+        TRY(obj.finish());
+        return {};
+    }));
+    TRY(array.finish());
+    return {};
+}
+
+}
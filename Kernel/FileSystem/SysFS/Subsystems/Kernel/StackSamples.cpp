@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/StackSamples.h>
+#include <Kernel/Sections.h>
+#include <Kernel/Tasks/ContinuousProfiler.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSStackSamples::SysFSStackSamples(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSStackSamples> SysFSStackSamples::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSStackSamples(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSStackSamples::try_generate(KBufferBuilder& builder)
+{
+    // NOTE: Every read takes the samples, so the next read only sees what was sampled after this one.
+    return ContinuousProfiler::the().take_samples_as_json(builder);
+}
+
+mode_t SysFSStackSamples::permissions() const
+{
+    return S_IRUSR;
+}
+
+}
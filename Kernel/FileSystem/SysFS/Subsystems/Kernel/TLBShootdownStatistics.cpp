@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/JsonObjectSerializer.h>
+#include <Kernel/FileSystem/SysFS/Subsystems/Kernel/TLBShootdownStatistics.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
+#include <Kernel/Sections.h>
+
+namespace Kernel {
+
+UNMAP_AFTER_INIT SysFSTLBShootdownStatistics::SysFSTLBShootdownStatistics(SysFSDirectory const& parent_directory)
+    : SysFSGlobalInformation(parent_directory)
+{
+}
+
+UNMAP_AFTER_INIT NonnullRefPtr<SysFSTLBShootdownStatistics> SysFSTLBShootdownStatistics::must_create(SysFSDirectory const& parent_directory)
+{
+    return adopt_ref_if_nonnull(new (nothrow) SysFSTLBShootdownStatistics(parent_directory)).release_nonnull();
+}
+
+ErrorOr<void> SysFSTLBShootdownStatistics::try_generate(KBufferBuilder& builder)
+{
+    auto& statistics = Memory::g_tlb_shootdown_statistics;
+    u64 batches = statistics.batches.load();
+    u64 batched_ranges = statistics.batched_ranges.load();
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("shootdowns"sv, statistics.shootdowns.load()));
+    TRY(json.add("ipis_sent"sv, statistics.ipis_sent.load()));
+    TRY(json.add("ipis_avoided"sv, statistics.ipis_avoided.load()));
+    TRY(json.add("local_flushes"sv, statistics.local_flushes.load()));
+    TRY(json.add("batches"sv, batches));
+    TRY(json.add("batched_ranges"sv, batched_ranges));
+    // Every range after the first one in a batch would have been a flush of its own.
+    TRY(json.add("flushes_avoided_by_batching"sv, batched_ranges - min(batches, batched_ranges)));
+    TRY(json.add("full_flushes"sv, statistics.full_flushes.load()));
+    TRY(json.finish());
+    return {};
+}
+
+}
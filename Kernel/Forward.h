@@ -23,6 +23,7 @@ class Device;
 class DeviceControlDevice;
 class DiskCache;
 class DoubleBuffer;
+class EventPoll;
 class File;
 class FATInode;
 class OpenFileDescription;
@@ -30,9 +31,11 @@ class DisplayConnector;
 class FileSystem;
 class FutexQueue;
 class HostnameContext;
+class IORing;
 class IPv4Socket;
 class Inode;
 class InodeIdentifier;
+class InodePageCache;
 class InodeWatcher;
 class MountFile;
 class KBuffer;
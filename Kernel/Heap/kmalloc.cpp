@@ -10,6 +10,7 @@
 #include <Kernel/Debug.h>
 #include <Kernel/Heap/Heap.h>
 #include <Kernel/Heap/kmalloc.h>
+#include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/KSyms.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Library/StdLib.h>
@@ -162,12 +163,29 @@ public:
         return ptr;
     }
 
+    // Hands out up to `count` slabs at once. The slabs are not scrubbed.
+    size_t allocate_batch(void** slabs, size_t count)
+    {
+        size_t allocated = 0;
+        for (; allocated < count; ++allocated) {
+            auto* ptr = allocate(m_slab_size, CallerWillInitializeMemory::Yes);
+            if (!ptr)
+                break;
+            slabs[allocated] = ptr;
+        }
+        return allocated;
+    }
+
     void deallocate(void* ptr)
     {
 #ifndef HAS_ADDRESS_SANITIZER
         memset(ptr, KFREE_SCRUB_BYTE, m_slab_size);
 #endif
+        deallocate_without_scrubbing(ptr);
+    }
 
+    void deallocate_without_scrubbing(void* ptr)
+    {
         auto* block = (KmallocSlabBlock*)((FlatPtr)ptr & KmallocSlabBlock::block_mask);
         bool block_was_full = block->is_full();
         block->deallocate(ptr);
@@ -412,7 +430,8 @@ struct KmallocGlobalData {
 
     KmallocSubheap::List subheaps;
 
-    KmallocSlabheap slabheaps[6] = { 16, 32, 64, 128, 256, 512 };
+    static constexpr size_t slabheap_count = 6;
+    KmallocSlabheap slabheaps[slabheap_count] = { 16, 32, 64, 128, 256, 512 };
 
     bool expansion_in_progress { false };
 };
@@ -425,6 +444,56 @@ static size_t g_kfree_call_count;
 static size_t g_nested_kfree_calls;
 bool g_dump_kmalloc_stacks;
 
+// Every processor keeps a magazine of free slabs for each slabheap size class, so most small
+// allocations and frees never have to take the global kmalloc lock. An empty magazine is refilled
+// from its slabheap, and a full one is flushed back to it, half a magazine at a time.
+// NOTE: Slabs sitting in a magazine keep their slab block alive, so try_purge() can't reclaim it.
+//       Magazines are small enough that this doesn't matter in practice.
+struct KmallocMagazine {
+    static constexpr size_t capacity = 32;
+    static constexpr size_t batch_size = capacity / 2;
+
+    size_t count { 0 };
+    void* slabs[capacity];
+};
+
+struct KmallocProcessorCache {
+    KmallocMagazine magazines[KmallocGlobalData::slabheap_count];
+
+    // NOTE: These are only ever written by the owning processor, with interrupts disabled.
+    size_t allocation_hits { 0 };
+    size_t allocation_misses { 0 };
+    size_t free_hits { 0 };
+    size_t free_misses { 0 };
+};
+
+// AddressSanitizer tracks the state of every slab, which the magazines would bypass.
+#ifdef HAS_ADDRESS_SANITIZER
+static constexpr bool s_processor_caches_enabled = false;
+#else
+static constexpr bool s_processor_caches_enabled = true;
+#endif
+static KmallocProcessorCache s_processor_caches[MAX_CPU_COUNT];
+
+static Optional<size_t> slabheap_index_for_allocation(size_t size, size_t alignment)
+{
+    for (size_t i = 0; i < KmallocGlobalData::slabheap_count; ++i) {
+        auto slab_size = g_kmalloc_global->slabheaps[i].slab_size();
+        if (size <= slab_size && alignment <= slab_size)
+            return i;
+    }
+    return {};
+}
+
+static Optional<size_t> slabheap_index_for_deallocation(size_t size)
+{
+    for (size_t i = 0; i < KmallocGlobalData::slabheap_count; ++i) {
+        if (size <= g_kmalloc_global->slabheaps[i].slab_size())
+            return i;
+    }
+    return {};
+}
+
 void kmalloc_enable_expand()
 {
     g_kmalloc_global->enable_expansion();
@@ -439,6 +508,62 @@ UNMAP_AFTER_INIT void kmalloc_init()
     s_lock.initialize();
 }
 
+static void* kmalloc_from_processor_cache(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
+{
+    auto slabheap_index = slabheap_index_for_allocation(size, alignment);
+    if (!slabheap_index.has_value())
+        return nullptr;
+
+    InterruptDisabler disabler;
+    auto& cache = s_processor_caches[Processor::current_id()];
+    auto& magazine = cache.magazines[*slabheap_index];
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+
+    if (magazine.count == 0) {
+        SpinlockLocker lock(s_lock);
+        magazine.count = slabheap.allocate_batch(magazine.slabs, KmallocMagazine::batch_size);
+        // Let the global allocator deal with purging or expanding the heap.
+        if (magazine.count == 0)
+            return nullptr;
+        ++cache.allocation_misses;
+    } else {
+        ++cache.allocation_hits;
+    }
+
+    auto* ptr = magazine.slabs[--magazine.count];
+    if (caller_will_initialize_memory == CallerWillInitializeMemory::No)
+        memset(ptr, KMALLOC_SCRUB_BYTE, slabheap.slab_size());
+    return ptr;
+}
+
+static bool kfree_to_processor_cache(void* ptr, size_t size)
+{
+    auto slabheap_index = slabheap_index_for_deallocation(size);
+    if (!slabheap_index.has_value())
+        return false;
+
+    VERIFY(g_kmalloc_global->is_valid_kmalloc_address(VirtualAddress { ptr }));
+
+    InterruptDisabler disabler;
+    auto& cache = s_processor_caches[Processor::current_id()];
+    auto& magazine = cache.magazines[*slabheap_index];
+    auto& slabheap = g_kmalloc_global->slabheaps[*slabheap_index];
+
+    memset(ptr, KFREE_SCRUB_BYTE, slabheap.slab_size());
+
+    if (magazine.count == KmallocMagazine::capacity) {
+        SpinlockLocker lock(s_lock);
+        for (size_t i = 0; i < KmallocMagazine::batch_size; ++i)
+            slabheap.deallocate_without_scrubbing(magazine.slabs[--magazine.count]);
+        ++cache.free_misses;
+    } else {
+        ++cache.free_hits;
+    }
+
+    magazine.slabs[magazine.count++] = ptr;
+    return true;
+}
+
 static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMemory caller_will_initialize_memory)
 {
     // Catch bad callers allocating under spinlock.
@@ -449,15 +574,21 @@ static void* kmalloc_impl(size_t size, size_t alignment, CallerWillInitializeMem
     // Alignment must be a power of two.
     VERIFY(is_power_of_two(alignment));
 
-    SpinlockLocker lock(s_lock);
-    ++g_kmalloc_call_count;
+    void* ptr = nullptr;
+    if (s_processor_caches_enabled && !g_dump_kmalloc_stacks)
+        ptr = kmalloc_from_processor_cache(size, alignment, caller_will_initialize_memory);
 
-    if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
-        dbgln("kmalloc({})", size);
-        Kernel::dump_backtrace();
-    }
+    if (!ptr) {
+        SpinlockLocker lock(s_lock);
+        ++g_kmalloc_call_count;
 
-    void* ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+        if (g_dump_kmalloc_stacks && Kernel::g_kernel_symbols_available.was_set()) {
+            dbgln("kmalloc({})", size);
+            Kernel::dump_backtrace();
+        }
+
+        ptr = g_kmalloc_global->allocate(size, alignment, caller_will_initialize_memory);
+    }
 
     Thread* current_thread = Thread::current();
     if (!current_thread)
@@ -500,6 +631,17 @@ void kfree_sized(void* ptr, size_t size)
         Processor::verify_no_spinlocks_held();
     }
 
+    if (s_processor_caches_enabled && kfree_to_processor_cache(ptr, size)) {
+        Thread* current_thread = Thread::current();
+        if (!current_thread)
+            current_thread = Processor::idle_thread();
+        if (current_thread) {
+            VERIFY(current_thread->is_allocation_enabled());
+            PerformanceManager::add_kfree_perf_event(*current_thread, 0, (FlatPtr)ptr);
+        }
+        return;
+    }
+
     SpinlockLocker lock(s_lock);
     ++g_kfree_call_count;
     ++g_nested_kfree_calls;
@@ -604,4 +746,27 @@ void get_kmalloc_stats(kmalloc_stats& stats)
     stats.bytes_free = g_kmalloc_global->free_bytes();
     stats.kmalloc_call_count = g_kmalloc_call_count;
     stats.kfree_call_count = g_kfree_call_count;
+
+    // Slabs cached in magazines are free as far as the users of kmalloc are concerned.
+    for (u32 processor = 0; processor < Processor::count(); ++processor) {
+        kmalloc_processor_cache_stats cache_stats;
+        get_kmalloc_processor_cache_stats(processor, cache_stats);
+        stats.bytes_allocated -= cache_stats.cached_bytes;
+        stats.bytes_free += cache_stats.cached_bytes;
+        stats.kmalloc_call_count += cache_stats.allocation_hits + cache_stats.allocation_misses;
+        stats.kfree_call_count += cache_stats.free_hits + cache_stats.free_misses;
+    }
+}
+
+void get_kmalloc_processor_cache_stats(u32 processor, kmalloc_processor_cache_stats& stats)
+{
+    VERIFY(processor < MAX_CPU_COUNT);
+    auto const& cache = s_processor_caches[processor];
+    stats.allocation_hits = cache.allocation_hits;
+    stats.allocation_misses = cache.allocation_misses;
+    stats.free_hits = cache.free_hits;
+    stats.free_misses = cache.free_misses;
+    stats.cached_bytes = 0;
+    for (size_t i = 0; i < KmallocGlobalData::slabheap_count; ++i)
+        stats.cached_bytes += cache.magazines[i].count * g_kmalloc_global->slabheaps[i].slab_size();
 }
@@ -55,6 +55,15 @@ struct kmalloc_stats {
 };
 void get_kmalloc_stats(kmalloc_stats&);
 
+struct kmalloc_processor_cache_stats {
+    size_t allocation_hits;
+    size_t allocation_misses;
+    size_t free_hits;
+    size_t free_misses;
+    size_t cached_bytes;
+};
+void get_kmalloc_processor_cache_stats(u32 processor, kmalloc_processor_cache_stats&);
+
 extern bool g_dump_kmalloc_stacks;
 
 inline void* operator new(size_t, void* p) { return p; }
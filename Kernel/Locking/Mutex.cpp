@@ -5,6 +5,8 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
+#include <AK/HashFunctions.h>
 #include <AK/SetOnce.h>
 #include <Kernel/Debug.h>
 #include <Kernel/KSyms.h>
@@ -17,6 +19,117 @@ extern SetOnce g_not_in_early_boot;
 
 namespace Kernel {
 
+// NOTE: This is updated on every contended acquisition of any mutex, so it must not have a lock of its own.
+//       Each slot is claimed for a lock name exactly once, and its counters are only ever atomically incremented.
+struct ContentionStatisticsSlot {
+    enum class State : u8 {
+        Free,
+        Claiming,
+        Ready,
+    };
+    Atomic<State> state { State::Free };
+    StringView name;
+    Atomic<u64> contended_acquisitions { 0 };
+    Atomic<u64> acquired_by_spinning { 0 };
+    Atomic<u64> blocked { 0 };
+    Atomic<u64> spin_iterations { 0 };
+};
+
+static constexpr size_t contention_statistics_table_size = 256;
+static Array<ContentionStatisticsSlot, contention_statistics_table_size> s_contention_statistics;
+
+bool Mutex::is_contended(Mode mode, Thread const* current_thread) const
+{
+    VERIFY(m_lock.is_locked());
+    switch (m_mode) {
+    case Mode::Unlocked:
+        return false;
+    case Mode::Exclusive:
+        return m_holder != bit_cast<uintptr_t>(current_thread);
+    case Mode::Shared:
+        return mode == Mode::Exclusive;
+    default:
+        VERIFY_NOT_REACHED();
+    }
+}
+
+size_t Mutex::spin_while_holder_is_running(Mode mode, Thread const* current_thread, SpinlockLocker<Spinlock<LockRank::None>>& lock)
+{
+    size_t iterations = 0;
+    while (iterations < maximum_spin_iterations && is_contended(mode, current_thread)) {
+        // We only know who holds the lock when it's held exclusively. The holder can't go away while we hold m_lock,
+        // so this is the only place where we look at it. It must be on another processor if it's running.
+        if (m_mode != Mode::Exclusive)
+            break;
+        auto holder = m_holder;
+        if (bit_cast<Thread*>(holder)->state() != Thread::State::Running)
+            break;
+
+        lock.unlock();
+        for (size_t i = 0; i < spin_iterations_between_holder_checks; ++i) {
+            ++iterations;
+            Processor::pause();
+            if (AK::atomic_load(&m_holder, AK::memory_order_relaxed) != holder)
+                break;
+        }
+        lock.lock();
+    }
+    return iterations;
+}
+
+void Mutex::record_contention(size_t spin_iterations, bool acquired_by_spinning) const
+{
+    // Mutex names are almost always string literals, so the characters' address identifies the name well enough.
+    // If the same name ends up in more than one slot, contention_statistics() adds them up again.
+    auto const* characters = m_name.characters_without_null_termination();
+    auto index = ptr_hash(characters) % contention_statistics_table_size;
+    for (size_t probe = 0; probe < contention_statistics_table_size; ++probe) {
+        auto& slot = s_contention_statistics[(index + probe) % contention_statistics_table_size];
+        auto state = slot.state.load(AK::memory_order_acquire);
+        if (state == ContentionStatisticsSlot::State::Free && slot.state.compare_exchange_strong(state, ContentionStatisticsSlot::State::Claiming, AK::memory_order_acquire)) {
+            slot.name = m_name;
+            slot.state.store(ContentionStatisticsSlot::State::Ready, AK::memory_order_release);
+        } else if (state != ContentionStatisticsSlot::State::Ready || slot.name.characters_without_null_termination() != characters || slot.name.length() != m_name.length()) {
+            continue;
+        }
+
+        slot.contended_acquisitions.fetch_add(1, AK::memory_order_relaxed);
+        if (acquired_by_spinning)
+            slot.acquired_by_spinning.fetch_add(1, AK::memory_order_relaxed);
+        else
+            slot.blocked.fetch_add(1, AK::memory_order_relaxed);
+        slot.spin_iterations.fetch_add(spin_iterations, AK::memory_order_relaxed);
+        return;
+    }
+    // The table is full, so this lock goes unaccounted.
+}
+
+ErrorOr<Vector<Mutex::ContentionStatistics>> Mutex::contention_statistics()
+{
+    Vector<ContentionStatistics> statistics;
+    TRY(statistics.try_ensure_capacity(contention_statistics_table_size));
+    for (auto const& slot : s_contention_statistics) {
+        if (slot.state.load(AK::memory_order_acquire) != ContentionStatisticsSlot::State::Ready)
+            continue;
+        ContentionStatistics* entry = nullptr;
+        for (auto& existing_entry : statistics) {
+            if (existing_entry.name == slot.name) {
+                entry = &existing_entry;
+                break;
+            }
+        }
+        if (!entry) {
+            statistics.unchecked_append({ .name = slot.name });
+            entry = &statistics.last();
+        }
+        entry->contended_acquisitions += slot.contended_acquisitions.load(AK::memory_order_relaxed);
+        entry->acquired_by_spinning += slot.acquired_by_spinning.load(AK::memory_order_relaxed);
+        entry->blocked += slot.blocked.load(AK::memory_order_relaxed);
+        entry->spin_iterations += slot.spin_iterations.load(AK::memory_order_relaxed);
+    }
+    return statistics;
+}
+
 void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
 {
     // NOTE: This may be called from an interrupt handler (not an IRQ handler)
@@ -29,8 +142,16 @@ void Mutex::lock(Mode mode, [[maybe_unused]] LockLocation const& location)
     }
     VERIFY(mode != Mode::Unlocked);
     auto* current_thread = Thread::current();
+    // Spinning only makes sense if the holder can make progress on another processor meanwhile.
+    // The big lock is held for long stretches of a syscall, so don't bother with it.
+    bool may_spin = m_behavior == MutexBehavior::Regular && Processor::count() > 1 && !Processor::in_critical();
 
     SpinlockLocker lock(m_lock);
+    if (is_contended(mode, current_thread)) {
+        size_t spin_iterations = may_spin ? spin_while_holder_is_running(mode, current_thread, lock) : 0;
+        record_contention(spin_iterations, !is_contended(mode, current_thread));
+    }
+
     bool did_block = false;
     Mode current_mode = m_mode;
     switch (current_mode) {
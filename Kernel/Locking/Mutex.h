@@ -11,6 +11,7 @@
 #include <AK/Atomic.h>
 #include <AK/HashMap.h>
 #include <AK/Types.h>
+#include <AK/Vector.h>
 #include <Kernel/Forward.h>
 #include <Kernel/Locking/LockLocation.h>
 #include <Kernel/Locking/LockMode.h>
@@ -76,6 +77,17 @@ public:
         }
     }
 
+    // Contention is accounted per lock name, since most mutexes are members of objects that come and go.
+    struct ContentionStatistics {
+        StringView name;
+        u64 contended_acquisitions { 0 };
+        // Contended acquisitions that got the lock while spinning, without having to block.
+        u64 acquired_by_spinning { 0 };
+        u64 blocked { 0 };
+        u64 spin_iterations { 0 };
+    };
+    static ErrorOr<Vector<ContentionStatistics>> contention_statistics();
+
 private:
     using BlockedThreadList = IntrusiveList<&Thread::m_blocked_threads_list_node>;
 
@@ -86,6 +98,15 @@ private:
     void block(Thread&, Mode, SpinlockLocker<Spinlock<LockRank::None>>&, u32);
     void unblock_waiters(Mode);
 
+    // Waiting for a holder that is running on another processor is usually cheaper than
+    // the two context switches that blocking costs, as long as the critical section is short.
+    static constexpr size_t maximum_spin_iterations = 4096;
+    static constexpr size_t spin_iterations_between_holder_checks = 64;
+
+    [[nodiscard]] bool is_contended(Mode, Thread const*) const;
+    size_t spin_while_holder_is_running(Mode, Thread const*, SpinlockLocker<Spinlock<LockRank::None>>&);
+    void record_contention(size_t spin_iterations, bool acquired_by_spinning) const;
+
     StringView m_name;
     Mode m_mode { Mode::Unlocked };
 
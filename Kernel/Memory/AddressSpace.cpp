@@ -12,6 +12,7 @@
 #include <Kernel/Memory/AnonymousVMObject.h>
 #include <Kernel/Memory/InodeVMObject.h>
 #include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Security/Random.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/PowerStateSwitchTask.h>
@@ -67,6 +68,11 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         return {};
     }
 
+    // Regions that we unmap completely can only be destroyed once the TLB flush is done, since that may free their pages.
+    // NOTE: This has to be declared before the batch, so that it is destroyed after the batch flushes.
+    Vector<NonnullOwnPtr<Region>, 2> unmapped_regions;
+    TLBFlushBatch tlb_flush_batch(*m_page_directory);
+
     if (auto* old_region = find_region_containing(range_to_unmap)) {
         if (!old_region->is_mmap())
             return EPERM;
@@ -76,7 +82,8 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         // Remove the old region from our regions tree, since were going to add another region
         // with the exact same start address.
         auto region = take_region(*old_region);
-        region->unmap();
+        region->unmap(ShouldFlushTLB::No);
+        tlb_flush_batch.add(region->range());
 
         auto new_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
 
@@ -84,7 +91,7 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
         for (auto* new_region : new_regions) {
             // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
             // leaves the caller in an undefined state.
-            TRY(new_region->map(page_directory()));
+            TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
         }
 
         PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -106,19 +113,24 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
             return EPERM;
     }
 
+    TRY(unmapped_regions.try_ensure_capacity(regions.size()));
     Vector<Region*, 2> new_regions;
 
     for (auto* old_region : regions) {
         // If it's a full match we can remove the entire old region.
         if (old_region->range().intersect(range_to_unmap).size() == old_region->size()) {
-            deallocate_region(*old_region);
+            auto region = take_region(*old_region);
+            region->unmap(ShouldFlushTLB::No);
+            tlb_flush_batch.add(region->range());
+            unmapped_regions.unchecked_append(move(region));
             continue;
         }
 
         // Remove the old region from our regions tree, since were going to add another region
         // with the exact same start address.
         auto region = take_region(*old_region);
-        region->unmap();
+        region->unmap(ShouldFlushTLB::No);
+        tlb_flush_batch.add(region->range());
 
         // Otherwise, split the regions and collect them for future mapping.
         auto split_regions = TRY(try_split_region_around_range(*region, range_to_unmap));
@@ -129,7 +141,7 @@ ErrorOr<void> AddressSpace::unmap_mmap_range(VirtualAddress addr, size_t size)
     for (auto* new_region : new_regions) {
         // TODO: Ideally we should do this in a way that can be rolled back on failure, as failing here
         // leaves the caller in an undefined state.
-        TRY(new_region->map(page_directory()));
+        TRY(new_region->map(page_directory(), ShouldFlushTLB::No));
     }
 
     PerformanceManager::add_unmap_perf_event(Process::current(), range_to_unmap);
@@ -148,6 +160,7 @@ ErrorOr<Region*> AddressSpace::try_allocate_split_region(Region const& source_re
     new_region->set_syscall_region(source_region.is_syscall_region());
     new_region->set_mmap(source_region.is_mmap(), source_region.mmapped_from_readable(), source_region.mmapped_from_writable());
     new_region->set_stack(source_region.is_stack());
+    new_region->set_large_pages_allowed(source_region.are_large_pages_allowed());
     TRY(m_region_tree.place_specifically(*new_region, range));
     return new_region.leak_ptr();
 }
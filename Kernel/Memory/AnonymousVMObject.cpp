@@ -267,6 +267,37 @@ NonnullRefPtr<PhysicalRAMPage> AnonymousVMObject::allocate_committed_page(Badge<
     return m_unused_committed_pages->take_one();
 }
 
+bool AnonymousVMObject::try_install_large_page(Badge<Region>, size_t first_page_index, PhysicalAddress paddr)
+{
+    SpinlockLocker locker(m_lock);
+    VERIFY(first_page_index + pages_per_large_page <= page_count());
+
+    if (m_volatile)
+        return false;
+
+    size_t lazy_committed_page_count = 0;
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        auto const& page = physical_pages()[first_page_index + i];
+        if (page->is_lazy_committed_page())
+            ++lazy_committed_page_count;
+        else if (!page->is_shared_zero_page())
+            return false;
+    }
+
+    // The large page was allocated from uncommitted memory, so we give back what we had committed for these pages.
+    if (lazy_committed_page_count > 0) {
+        VERIFY(m_unused_committed_pages.has_value());
+        m_unused_committed_pages->uncommit(lazy_committed_page_count);
+    }
+
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        physical_pages()[first_page_index + i] = PhysicalRAMPage::create(paddr.offset(i * PAGE_SIZE));
+        if (!m_cow_map.is_null())
+            m_cow_map.set(first_page_index + i, false);
+    }
+    return true;
+}
+
 void AnonymousVMObject::reset_cow_map()
 {
     for (size_t i = 0; i < page_count(); ++i) {
@@ -31,6 +31,9 @@ public:
     bool should_cow(size_t page_index, bool) const;
     ErrorOr<void> set_should_cow(size_t page_index, bool);
 
+    // Replaces a naturally aligned block of not yet populated pages with the pages of a freshly allocated large page.
+    bool try_install_large_page(Badge<Region>, size_t first_page_index, PhysicalAddress);
+
     bool is_purgeable() const { return m_purgeable; }
     bool is_volatile() const { return m_volatile; }
 
@@ -15,6 +15,7 @@
 #include <Kernel/Boot/BootInfo.h>
 #include <Kernel/Boot/Multiboot.h>
 #include <Kernel/FileSystem/Inode.h>
+#include <Kernel/FileSystem/InodePageCache.h>
 #include <Kernel/Firmware/DeviceTree/DeviceTree.h>
 #include <Kernel/Heap/kmalloc.h>
 #include <Kernel/Interrupts/InterruptDisabler.h>
@@ -971,6 +972,10 @@ PageTableEntry* MemoryManager::pte(PageDirectory& page_directory, VirtualAddress
     PageDirectoryEntry const& pde = pd[page_directory_index];
     if (!pde.is_present())
         return nullptr;
+#if ARCH(X86_64)
+    if (pde.is_huge())
+        return nullptr;
+#endif
 
     return &quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()))[page_table_index];
 }
@@ -985,6 +990,15 @@ PageTableEntry* MemoryManager::ensure_pte(PageDirectory& page_directory, Virtual
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     auto& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    if (pde.is_present() && pde.is_huge()) {
+        // Someone wants to map an individual page inside a large page, so go back to mapping each page on its own.
+        if (!split_large_page(page_directory, vaddr))
+            return nullptr;
+        pd = quickmap_pd(page_directory, page_directory_table_index);
+        VERIFY(&pde == &pd[page_directory_index]);
+    }
+#endif
     if (pde.is_present())
         return &quickmap_pt(PhysicalAddress(pde.page_table_base()))[page_table_index];
 
@@ -1026,6 +1040,10 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
 
     auto* pd = quickmap_pd(page_directory, page_directory_table_index);
     PageDirectoryEntry& pde = pd[page_directory_index];
+#if ARCH(X86_64)
+    // NOTE: Large pages are only ever released as a whole, see release_large_page().
+    VERIFY(!pde.is_present() || !pde.is_huge());
+#endif
     if (pde.is_present()) {
         auto* page_table = quickmap_pt(PhysicalAddress((FlatPtr)pde.page_table_base()));
         auto& pte = page_table[page_table_index];
@@ -1049,6 +1067,125 @@ void MemoryManager::release_pte(PageDirectory& page_directory, VirtualAddress va
     }
 }
 
+bool MemoryManager::map_large_page(PageDirectory& page_directory, VirtualAddress vaddr, PhysicalAddress paddr, bool writable, bool executable, bool user_allowed)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    VERIFY(vaddr.get() % large_page_size == 0);
+    VERIFY(paddr.get() % large_page_size == 0);
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+
+    // The caller owns all of the memory covered by this entry, so any page table that's
+    // currently there only maps pages that the large page is about to replace.
+    Optional<PhysicalAddress> replaced_page_table;
+    if (pde.is_present() && !pde.is_huge())
+        replaced_page_table = PhysicalAddress { pde.page_table_base() };
+
+    pde.clear();
+    pde.set_page_table_base(paddr.get());
+    pde.set_huge(true);
+    pde.set_present(true);
+    pde.set_writable(writable);
+    pde.set_user_allowed(user_allowed);
+    pde.set_global(&page_directory == m_kernel_page_directory.ptr());
+    if (Processor::current().has_nx())
+        pde.set_execute_disabled(!executable);
+
+    if (replaced_page_table.has_value()) {
+        // Make sure no processor is still walking the old page table before freeing it.
+        flush_tlb(&page_directory, vaddr, pages_per_large_page);
+        get_physical_page_entry(*replaced_page_table).allocated.physical_page.unref();
+    }
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    (void)paddr;
+    (void)writable;
+    (void)executable;
+    (void)user_allowed;
+    return false;
+#endif
+}
+
+bool MemoryManager::release_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || !pde.is_huge())
+        return false;
+    pde.clear();
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
+bool MemoryManager::split_large_page(PageDirectory& page_directory, VirtualAddress vaddr)
+{
+#if ARCH(X86_64)
+    VERIFY_INTERRUPTS_DISABLED();
+    VERIFY(page_directory.get_lock().is_locked_by_current_processor());
+    u32 page_directory_table_index = (vaddr.get() >> 30) & 0x1ff;
+    u32 page_directory_index = (vaddr.get() >> 21) & 0x1ff;
+
+    auto page_table_or_error = allocate_physical_page(ShouldZeroFill::No);
+    if (page_table_or_error.is_error()) {
+        dbgln("MM: Unable to allocate page table to split large page at {}", vaddr);
+        return false;
+    }
+    auto page_table = page_table_or_error.release_value();
+
+    // NOTE: Allocating the page table may have purged memory, which could have remapped this very entry.
+    auto* pd = quickmap_pd(page_directory, page_directory_table_index);
+    auto& pde = pd[page_directory_index];
+    if (!pde.is_present() || !pde.is_huge())
+        return true;
+
+    auto* page_table_entries = quickmap_pt(page_table->paddr());
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        auto& pte = page_table_entries[i];
+        pte.clear();
+        pte.set_physical_page_base(pde.page_table_base() + i * PAGE_SIZE);
+        pte.set_present(true);
+        pte.set_writable(pde.is_writable());
+        pte.set_user_allowed(pde.is_user_allowed());
+        pte.set_global(pde.is_global());
+        pte.set_execute_disabled(pde.is_execute_disabled());
+    }
+
+    pde.set_huge(false);
+    pde.set_page_table_base(page_table->paddr().get());
+    pde.set_writable(true);
+    pde.set_user_allowed(true);
+    pde.set_execute_disabled(false);
+
+    // NOTE: This leaked ref is matched by the unref in MemoryManager::release_pte()
+    (void)page_table.leak_ref();
+
+    flush_tlb(&page_directory, VirtualAddress { vaddr.get() & ~(large_page_size - 1) }, pages_per_large_page);
+    m_large_page_splits.fetch_add(1, AK::memory_order_relaxed);
+    return true;
+#else
+    (void)page_directory;
+    (void)vaddr;
+    return false;
+#endif
+}
+
 UNMAP_AFTER_INIT void MemoryManager::initialize(u32 cpu)
 {
     dmesgln("Initialize MMU");
@@ -1344,6 +1481,57 @@ void MemoryManager::deallocate_physical_page(PhysicalAddress paddr)
     });
 }
 
+ErrorOr<PhysicalAddress> MemoryManager::allocate_large_physical_page()
+{
+    if constexpr (!large_pages_are_supported)
+        return ENOTSUP;
+
+    auto paddr = m_global_data.with([&](auto& global_data) -> Optional<PhysicalAddress> {
+        // We need to make sure we don't touch pages that we have committed to
+        if (global_data.system_memory_info.physical_pages_uncommitted < pages_per_large_page)
+            return {};
+
+        for (auto& region : global_data.physical_regions) {
+            auto paddr = region->take_free_large_page();
+            if (paddr.has_value()) {
+                global_data.system_memory_info.physical_pages_uncommitted -= pages_per_large_page;
+                global_data.system_memory_info.physical_pages_used += pages_per_large_page;
+                return paddr;
+            }
+        }
+        return {};
+    });
+
+    if (!paddr.has_value()) {
+        m_large_page_allocation_failures.fetch_add(1, AK::memory_order_relaxed);
+        return ENOMEM;
+    }
+    m_large_page_allocations.fetch_add(1, AK::memory_order_relaxed);
+
+    for (size_t i = 0; i < pages_per_large_page; ++i) {
+        InterruptDisabler disabler;
+        auto* ptr = quickmap_page(paddr->offset(i * PAGE_SIZE));
+        memset(ptr, 0, PAGE_SIZE);
+        unquickmap_page();
+    }
+    return *paddr;
+}
+
+void MemoryManager::deallocate_large_physical_page(PhysicalAddress paddr)
+{
+    for (size_t i = 0; i < pages_per_large_page; ++i)
+        deallocate_physical_page(paddr.offset(i * PAGE_SIZE));
+}
+
+MemoryManager::LargePageStatistics MemoryManager::large_page_statistics() const
+{
+    return {
+        .allocations = m_large_page_allocations.load(AK::memory_order_relaxed),
+        .allocation_failures = m_large_page_allocation_failures.load(AK::memory_order_relaxed),
+        .splits = m_large_page_splits.load(AK::memory_order_relaxed),
+    };
+}
+
 RefPtr<PhysicalRAMPage> MemoryManager::find_free_physical_page(bool committed)
 {
     RefPtr<PhysicalRAMPage> page;
@@ -1389,6 +1577,25 @@ NonnullRefPtr<PhysicalRAMPage> MemoryManager::allocate_committed_physical_page(B
 }
 
 ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
+{
+    auto page_or_error = try_allocate_physical_page(should_zero_fill, did_purge);
+    if (!page_or_error.is_error())
+        return page_or_error;
+
+    // Last resort, we drop clean pages from the inode page caches.
+    // NOTE: This can't be done while holding the MM lock, as it has to unmap the page cache's kernel regions.
+    if (auto reclaimed_page_count = InodePageCache::reclaim_clean_pages(InodePageCache::pages_per_chunk)) {
+        dbgln("MM: Page cache reclaim saved the day! Released {} pages from the inode page cache", reclaimed_page_count);
+        page_or_error = try_allocate_physical_page(should_zero_fill, did_purge);
+        if (!page_or_error.is_error())
+            return page_or_error;
+    }
+
+    dmesgln("MM: no physical pages available");
+    return ENOMEM;
+}
+
+ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::try_allocate_physical_page(ShouldZeroFill should_zero_fill, bool* did_purge)
 {
     return m_global_data.with([&](auto&) -> ErrorOr<NonnullRefPtr<PhysicalRAMPage>> {
         auto page = find_free_physical_page(false);
@@ -1428,10 +1635,8 @@ ErrorOr<NonnullRefPtr<PhysicalRAMPage>> MemoryManager::allocate_physical_page(Sh
                 return IterationDecision::Continue;
             });
         }
-        if (!page) {
-            dmesgln("MM: no physical pages available");
+        if (!page)
             return ENOMEM;
-        }
 
         if (should_zero_fill == ShouldZeroFill::Yes) {
             // FIXME: To prevent aliasing memory with different memory types, this page should be mapped using the same memory type it will use later for the actual mapping.
@@ -1502,6 +1707,16 @@ void MemoryManager::flush_tlb(PageDirectory const* page_directory, VirtualAddres
     Processor::flush_tlb(page_directory, vaddr, page_count);
 }
 
+void MemoryManager::flush_tlb(PageDirectory const* page_directory, ReadonlySpan<VirtualRange> ranges)
+{
+    Processor::flush_tlb(page_directory, ranges);
+}
+
+void MemoryManager::flush_entire_tlb(PageDirectory const* page_directory)
+{
+    Processor::flush_entire_tlb(page_directory);
+}
+
 PageDirectoryEntry* MemoryManager::quickmap_pd(PageDirectory& directory, size_t pdpt_index)
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -1649,6 +1864,13 @@ void CommittedPhysicalPageSet::uncommit_one()
     MM.uncommit_physical_pages({}, 1);
 }
 
+void CommittedPhysicalPageSet::uncommit(size_t page_count)
+{
+    VERIFY(m_page_count >= page_count);
+    m_page_count -= page_count;
+    MM.uncommit_physical_pages({}, page_count);
+}
+
 void MemoryManager::copy_physical_page(PhysicalRAMPage& physical_page, u8 page_buffer[PAGE_SIZE])
 {
     auto* quickmapped_page = quickmap_page(physical_page);
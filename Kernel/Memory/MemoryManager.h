@@ -34,6 +34,16 @@ constexpr FlatPtr page_round_down(FlatPtr x)
     return x & ~(PAGE_SIZE - 1);
 }
 
+// A large page maps a whole page table's worth of memory with a single page directory entry.
+static constexpr size_t large_page_size = 2 * MiB;
+static constexpr size_t pages_per_large_page = large_page_size / PAGE_SIZE;
+
+#if ARCH(X86_64)
+static constexpr bool large_pages_are_supported = true;
+#else
+static constexpr bool large_pages_are_supported = false;
+#endif
+
 inline FlatPtr virtual_to_low_physical(FlatPtr virtual_)
 {
     return virtual_ - g_boot_info.physical_to_virtual_offset;
@@ -117,6 +127,7 @@ public:
 
     [[nodiscard]] NonnullRefPtr<PhysicalRAMPage> take_one();
     void uncommit_one();
+    void uncommit(size_t page_count);
 
     void operator=(CommittedPhysicalPageSet&&) = delete;
 
@@ -129,6 +140,7 @@ class MemoryManager {
     friend class AnonymousVMObject;
     friend class Region;
     friend class RegionTree;
+    friend class TLBFlushBatch;
     friend class VMObject;
     friend struct ::KmallocGlobalData;
 
@@ -170,6 +182,18 @@ public:
     ErrorOr<Vector<NonnullRefPtr<PhysicalRAMPage>>> allocate_contiguous_physical_pages(size_t size, MemoryType memory_type_for_zero_fill);
     void deallocate_physical_page(PhysicalAddress);
 
+    // Returns a zero-filled, naturally aligned and physically contiguous block of `pages_per_large_page` pages.
+    // The pages are taken from the uncommitted pool, and have no PhysicalRAMPage objects yet.
+    ErrorOr<PhysicalAddress> allocate_large_physical_page();
+    void deallocate_large_physical_page(PhysicalAddress);
+
+    struct LargePageStatistics {
+        u64 allocations { 0 };
+        u64 allocation_failures { 0 };
+        u64 splits { 0 };
+    };
+    LargePageStatistics large_page_statistics() const;
+
     ErrorOr<NonnullOwnPtr<Region>> allocate_contiguous_kernel_region(size_t, StringView name, Region::Access access, MemoryType = MemoryType::Normal);
     ErrorOr<NonnullOwnPtr<Region>> allocate_dma_buffer_page(StringView name, Region::Access access, RefPtr<PhysicalRAMPage>& dma_buffer_page, MemoryType = MemoryType::NonCacheable);
     ErrorOr<NonnullOwnPtr<Region>> allocate_dma_buffer_page(StringView name, Region::Access access, MemoryType = MemoryType::NonCacheable);
@@ -274,8 +298,11 @@ private:
     void parse_memory_map_multiboot(GlobalData&);
     static void flush_tlb_local(VirtualAddress, size_t page_count = 1);
     static void flush_tlb(PageDirectory const*, VirtualAddress, size_t page_count = 1);
+    static void flush_tlb(PageDirectory const*, ReadonlySpan<VirtualRange>);
+    static void flush_entire_tlb(PageDirectory const*);
 
     RefPtr<PhysicalRAMPage> find_free_physical_page(bool);
+    ErrorOr<NonnullRefPtr<PhysicalRAMPage>> try_allocate_physical_page(ShouldZeroFill, bool* did_purge);
 
     ALWAYS_INLINE u8* quickmap_page(PhysicalRAMPage& page)
     {
@@ -295,6 +322,11 @@ private:
     };
     void release_pte(PageDirectory&, VirtualAddress, IsLastPTERelease);
 
+    // NOTE: ensure_pte() splits a large page mapping it runs into back into a page table, while pte() ignores them.
+    bool map_large_page(PageDirectory&, VirtualAddress, PhysicalAddress, bool writable, bool executable, bool user_allowed);
+    bool release_large_page(PageDirectory&, VirtualAddress);
+    bool split_large_page(PageDirectory&, VirtualAddress);
+
     // NOTE: These are outside of GlobalData as they are only assigned on startup,
     //       and then never change. Atomic ref-counting covers that case without
     //       the need for additional synchronization.
@@ -308,6 +340,10 @@ private:
     size_t m_physical_page_entries_count { 0 };
 
     RecursiveSpinlockProtected<GlobalData, LockRank::None> m_global_data;
+
+    Atomic<u64> m_large_page_allocations { 0 };
+    Atomic<u64> m_large_page_allocation_failures { 0 };
+    Atomic<u64> m_large_page_splits { 0 };
 };
 
 inline bool PhysicalRAMPage::is_shared_zero_page() const
@@ -55,8 +55,20 @@ void PhysicalRegion::initialize_zones()
         return zone_count;
     };
 
-    // First make 16 MiB zones (with 4096 pages each)
-    m_large_zones = make_zones(large_zone_size);
+    // Start with a few small zones that align the rest of the region to a large page boundary, so any
+    // large page sized blocks that the zones after them hand out are naturally aligned as well.
+    while (base_address.get() % large_page_size) {
+        size_t pages_per_zone = 1u << count_trailing_zeroes(base_address.get() / PAGE_SIZE);
+        if (remaining_pages < pages_per_zone)
+            break;
+        m_zones.append(adopt_nonnull_own_or_enomem(new (nothrow) PhysicalZone(base_address, pages_per_zone)).release_value_but_fixme_should_propagate_errors());
+        m_usable_zones.append(*m_zones.last());
+        base_address = base_address.offset(pages_per_zone * PAGE_SIZE);
+        remaining_pages -= pages_per_zone;
+    }
+
+    // Then make 16 MiB zones (with 4096 pages each)
+    make_zones(large_zone_size);
 
     // Then divide any remaining space into 1 MiB zones (with 256 pages each)
     make_zones(small_zone_size);
@@ -102,6 +114,26 @@ Vector<NonnullRefPtr<PhysicalRAMPage>> PhysicalRegion::take_contiguous_free_page
     return physical_pages;
 }
 
+Optional<PhysicalAddress> PhysicalRegion::take_free_large_page()
+{
+    constexpr auto order = count_trailing_zeroes(large_page_size / PAGE_SIZE);
+
+    for (auto& zone : m_usable_zones) {
+        if (zone.base().get() % large_page_size)
+            continue;
+        auto page_base = zone.allocate_block(order);
+        if (!page_base.has_value())
+            continue;
+        if (zone.is_empty()) {
+            // We've exhausted this zone, move it to the full zones list.
+            m_full_zones.append(zone);
+        }
+        VERIFY(page_base->get() % large_page_size == 0);
+        return page_base;
+    }
+    return {};
+}
+
 RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
 {
     if (m_usable_zones.is_empty())
@@ -121,16 +153,18 @@ RefPtr<PhysicalRAMPage> PhysicalRegion::take_free_page()
 
 void PhysicalRegion::return_page(PhysicalAddress paddr)
 {
-    auto large_zone_base = lower().get();
-    auto small_zone_base = lower().get() + (m_large_zones * large_zone_size);
-
-    size_t zone_index;
-    if (paddr.get() < small_zone_base)
-        zone_index = (paddr.get() - large_zone_base) / large_zone_size;
-    else
-        zone_index = m_large_zones + (paddr.get() - small_zone_base) / small_zone_size;
+    // NOTE: Zones are created in ascending order and don't overlap, but they aren't all the same size.
+    size_t low = 0;
+    size_t high = m_zones.size();
+    while (high - low > 1) {
+        auto middle = low + (high - low) / 2;
+        if (m_zones[middle]->base() <= paddr)
+            low = middle;
+        else
+            high = middle;
+    }
 
-    auto& zone = m_zones[zone_index];
+    auto& zone = m_zones[low];
     VERIFY(zone->contains(paddr));
     zone->deallocate_block(paddr, 0);
     if (m_full_zones.contains(*zone))
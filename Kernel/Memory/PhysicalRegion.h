@@ -35,6 +35,7 @@ public:
     OwnPtr<PhysicalRegion> try_take_pages_from_beginning(size_t);
 
     RefPtr<PhysicalRAMPage> take_free_page();
+    Optional<PhysicalAddress> take_free_large_page();
     Vector<NonnullRefPtr<PhysicalRAMPage>> take_contiguous_free_pages(size_t count);
     void return_page(PhysicalAddress);
 
@@ -46,8 +47,6 @@ private:
 
     Vector<NonnullOwnPtr<PhysicalZone>> m_zones;
 
-    size_t m_large_zones { 0 };
-
     PhysicalZone::List m_usable_zones;
     PhysicalZone::List m_full_zones;
 
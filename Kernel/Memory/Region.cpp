@@ -118,6 +118,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
         region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
         region->set_shared(m_shared);
         region->set_syscall_region(is_syscall_region());
+        region->set_large_pages_allowed(m_large_pages_allowed);
         return region;
     }
 
@@ -143,6 +144,7 @@ ErrorOr<NonnullOwnPtr<Region>> Region::try_clone()
     }
     clone_region->set_syscall_region(is_syscall_region());
     clone_region->set_mmap(m_mmap, m_mmapped_from_readable, m_mmapped_from_writable);
+    clone_region->set_large_pages_allowed(m_large_pages_allowed);
     return clone_region;
 }
 
@@ -256,6 +258,59 @@ bool Region::map_individual_page_impl(size_t page_index, PhysicalAddress paddr,
     return true;
 }
 
+bool Region::should_use_large_pages() const
+{
+    if constexpr (!large_pages_are_supported)
+        return false;
+    return m_large_pages_allowed && !m_stack && m_memory_type == MemoryType::Normal && vmobject().is_anonymous();
+}
+
+bool Region::map_large_page_impl(size_t page_index)
+{
+    VERIFY(m_page_directory->get_lock().is_locked_by_current_processor());
+
+    if (!should_use_large_pages() || (!is_readable() && !is_writable()))
+        return false;
+
+    auto page_vaddr = vaddr_from_page_index(page_index);
+    if (page_vaddr.get() % large_page_size != 0 || page_index + pages_per_large_page > page_count())
+        return false;
+
+    bool user_allowed = page_vaddr.get() >= USER_RANGE_BASE && is_user_address(page_vaddr);
+    if (is_mmap() && !user_allowed) {
+        PANIC("About to map mmap'ed page at a kernel address");
+    }
+
+    // A large page can only be used if the whole block is backed by one naturally aligned and
+    // physically contiguous run of pages that all have to be mapped with the same permissions.
+    PhysicalAddress paddr;
+    bool any_page_should_cow = false;
+    bool all_pages_should_cow = true;
+    {
+        SpinlockLocker vmobject_locker(vmobject().m_lock);
+        for (size_t i = 0; i < pages_per_large_page; ++i) {
+            auto const& page = physical_page_slot(page_index + i);
+            if (!page || page->is_shared_zero_page() || page->is_lazy_committed_page() || !page->may_return_to_freelist())
+                return false;
+            if (i == 0) {
+                paddr = page->paddr();
+                if (paddr.get() % large_page_size != 0)
+                    return false;
+            } else if (page->paddr() != paddr.offset(i * PAGE_SIZE)) {
+                return false;
+            }
+            bool page_should_cow = should_cow(page_index + i);
+            any_page_should_cow |= page_should_cow;
+            all_pages_should_cow &= page_should_cow;
+        }
+    }
+    if (any_page_should_cow && !all_pages_should_cow)
+        return false;
+
+    bool writable = is_writable() && !all_pages_should_cow;
+    return MM.map_large_page(*m_page_directory, page_vaddr, paddr, writable, is_executable(), user_allowed);
+}
+
 bool Region::map_individual_page_impl(size_t page_index)
 {
     RefPtr<PhysicalRAMPage> page;
@@ -295,6 +350,10 @@ void Region::unmap_with_locks_held(ShouldFlushTLB should_flush_tlb, SpinlockLock
     size_t count = page_count();
     for (size_t i = 0; i < count; ++i) {
         auto vaddr = vaddr_from_page_index(i);
+        if (vaddr.get() % large_page_size == 0 && i + pages_per_large_page <= count && MM.release_large_page(*m_page_directory, vaddr)) {
+            i += pages_per_large_page - 1;
+            continue;
+        }
         MM.release_pte(*m_page_directory, vaddr, i == count - 1 ? MemoryManager::IsLastPTERelease::Yes : MemoryManager::IsLastPTERelease::No);
     }
     if (should_flush_tlb == ShouldFlushTLB::Yes)
@@ -320,6 +379,10 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, ShouldFlushTLB should_f
     set_page_directory(page_directory);
     size_t page_index = 0;
     while (page_index < page_count()) {
+        if (map_large_page_impl(page_index)) {
+            page_index += pages_per_large_page;
+            continue;
+        }
         if (!map_individual_page_impl(page_index))
             break;
         ++page_index;
@@ -353,14 +416,14 @@ ErrorOr<void> Region::map(PageDirectory& page_directory, PhysicalAddress paddr,
     return ENOMEM;
 }
 
-void Region::remap()
+void Region::remap(ShouldFlushTLB should_flush_tlb)
 {
     VERIFY(m_page_directory);
     ErrorOr<void> result;
     if (m_vmobject->is_mmio())
-        result = map(*m_page_directory, static_cast<MMIOVMObject const&>(*m_vmobject).base_address());
+        result = map(*m_page_directory, static_cast<MMIOVMObject const&>(*m_vmobject).base_address(), should_flush_tlb);
     else
-        result = map(*m_page_directory);
+        result = map(*m_page_directory, should_flush_tlb);
     if (result.is_error())
         TODO();
 }
@@ -504,6 +567,11 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     if (current_thread != nullptr)
         current_thread->did_zero_fault();
 
+    if (!m_shared && should_use_large_pages()) {
+        if (auto response = try_handle_zero_fault_with_large_page(page_index_in_region); response.has_value())
+            return response.release_value();
+    }
+
     RefPtr<PhysicalRAMPage> new_physical_page;
 
     if (page_in_slot_at_time_of_fault.is_lazy_committed_page()) {
@@ -546,6 +614,42 @@ PageFaultResponse Region::handle_zero_fault(size_t page_index_in_region, Physica
     return PageFaultResponse::Continue;
 }
 
+Optional<PageFaultResponse> Region::try_handle_zero_fault_with_large_page(size_t page_index_in_region)
+{
+    auto large_page_vaddr = VirtualAddress { vaddr_from_page_index(page_index_in_region).get() & ~(large_page_size - 1) };
+    if (large_page_vaddr < vaddr() || large_page_vaddr.offset(large_page_size) > range().end())
+        return {};
+    auto first_page_index = page_index_from_address(large_page_vaddr);
+
+    auto paddr_or_error = MM.allocate_large_physical_page();
+    if (paddr_or_error.is_error())
+        return {};
+    auto paddr = paddr_or_error.release_value();
+
+    auto& anonymous_vmobject = static_cast<AnonymousVMObject&>(vmobject());
+    if (!anonymous_vmobject.try_install_large_page({}, translate_to_vmobject_page(first_page_index), paddr)) {
+        // Some of the pages have been faulted in already, so this block has to stay on small pages.
+        MM.deallocate_large_physical_page(paddr);
+        return {};
+    }
+    dbgln_if(PAGE_FAULT_DEBUG, "      >> ALLOCATED LARGE {} for {}", paddr, large_page_vaddr);
+
+    SpinlockLocker page_lock(m_page_directory->get_lock());
+    bool success = map_large_page_impl(first_page_index);
+    if (!success) {
+        // The pages are installed in the VMObject already, so they all have to be mapped one way or another.
+        success = true;
+        for (size_t i = 0; i < pages_per_large_page && success; ++i)
+            success = map_individual_page_impl(first_page_index + i);
+    }
+    MemoryManager::flush_tlb(m_page_directory, large_page_vaddr, pages_per_large_page);
+    if (!success) {
+        dmesgln("MM: handle_zero_fault was unable to allocate a physical page");
+        return PageFaultResponse::OutOfMemory;
+    }
+    return PageFaultResponse::Continue;
+}
+
 PageFaultResponse Region::handle_cow_fault(size_t page_index_in_region)
 {
     auto current_thread = Thread::current();
@@ -593,9 +697,49 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
     if (current_thread)
         current_thread->did_inode_fault();
 
-    u8 page_buffer[PAGE_SIZE];
     auto& inode = inode_vmobject.inode();
 
+    auto map_loaded_page = [&](NonnullRefPtr<PhysicalRAMPage> new_physical_page) {
+        SpinlockLocker locker(inode_vmobject.m_lock);
+
+        // Someone else can assign a new page before we get here, so check if physical_page_slot is still null.
+        if (physical_page_slot.is_null()) {
+            physical_page_slot = move(new_physical_page);
+            // Something went wrong if a newly loaded page is already marked dirty
+            VERIFY(!inode_vmobject.is_page_dirty(page_index_in_vmobject));
+        } else {
+            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
+        }
+
+        if (mark_page_dirty)
+            inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
+        if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
+            return PageFaultResponse::OutOfMemory;
+        return PageFaultResponse::Continue;
+    };
+
+    if (inode_vmobject.is_shared_inode() && inode.has_page_cache()) {
+        // Shared mappings map the page cache pages directly, so they always see the same data as read() and write().
+        auto page_or_error = inode.page_cache_physical_page(page_index_in_vmobject);
+        if (page_or_error.is_error()) {
+            dmesgln("handle_inode_fault: Error ({}) while getting page from the page cache", page_or_error.error());
+            return PageFaultResponse::ShouldCrash;
+        }
+        auto page = page_or_error.release_value();
+        if (!page)
+            return PageFaultResponse::BusError;
+
+        if (is_executable()) {
+            InterruptDisabler disabler;
+            u8* ptr = MM.quickmap_page(*page);
+            Processor::flush_instruction_cache(VirtualAddress { ptr }, PAGE_SIZE);
+            MM.unquickmap_page();
+        }
+
+        return map_loaded_page(page.release_nonnull());
+    }
+
+    u8 page_buffer[PAGE_SIZE];
     auto buffer = UserOrKernelBuffer::for_kernel_buffer(page_buffer);
     auto result = inode.read_bytes(page_index_in_vmobject * PAGE_SIZE, PAGE_SIZE, buffer, nullptr);
 
@@ -637,24 +781,7 @@ PageFaultResponse Region::handle_inode_fault(size_t page_index_in_region, bool m
         MM.unquickmap_page();
     }
 
-    {
-        SpinlockLocker locker(inode_vmobject.m_lock);
-
-        // Someone else can assign a new page before we get here, so check if physical_page_slot is still null.
-        if (physical_page_slot.is_null()) {
-            physical_page_slot = new_physical_page;
-            // Something went wrong if a newly loaded page is already marked dirty
-            VERIFY(!inode_vmobject.is_page_dirty(page_index_in_vmobject));
-        } else {
-            dbgln_if(PAGE_FAULT_DEBUG, "handle_inode_fault: Page faulted in by someone else, remapping.");
-        }
-
-        if (mark_page_dirty)
-            inode_vmobject.set_page_dirty(page_index_in_vmobject, true);
-        if (!remap_vmobject_page(page_index_in_vmobject, *physical_page_slot))
-            return PageFaultResponse::OutOfMemory;
-        return PageFaultResponse::Continue;
-    }
+    return map_loaded_page(move(new_physical_page));
 }
 
 PageFaultResponse Region::handle_dirty_on_write_fault(size_t page_index_in_region)
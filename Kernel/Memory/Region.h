@@ -85,6 +85,9 @@ public:
     [[nodiscard]] bool is_stack() const { return m_stack; }
     void set_stack(bool stack) { m_stack = stack; }
 
+    [[nodiscard]] bool are_large_pages_allowed() const { return m_large_pages_allowed; }
+    void set_large_pages_allowed(bool allowed) { m_large_pages_allowed = allowed; }
+
     [[nodiscard]] bool is_immutable() const { return m_immutable.was_set(); }
     void set_immutable() { m_immutable.set(); }
 
@@ -208,7 +211,7 @@ public:
     void unmap(ShouldFlushTLB = ShouldFlushTLB::Yes);
     void unmap_with_locks_held(ShouldFlushTLB, SpinlockLocker<RecursiveSpinlock<LockRank::None>>& pd_locker);
 
-    void remap();
+    void remap(ShouldFlushTLB = ShouldFlushTLB::Yes);
 
     [[nodiscard]] bool is_mapped() const { return m_page_directory != nullptr; }
 
@@ -244,6 +247,10 @@ private:
     [[nodiscard]] PageFaultResponse handle_inode_fault(size_t page_index, bool mark_page_dirty = false);
     [[nodiscard]] PageFaultResponse handle_zero_fault(size_t page_index, PhysicalRAMPage& page_in_slot_at_time_of_fault);
     [[nodiscard]] PageFaultResponse handle_dirty_on_write_fault(size_t page_index);
+    [[nodiscard]] Optional<PageFaultResponse> try_handle_zero_fault_with_large_page(size_t page_index);
+
+    [[nodiscard]] bool should_use_large_pages() const;
+    [[nodiscard]] bool map_large_page_impl(size_t page_index);
 
     [[nodiscard]] bool map_individual_page_impl(size_t page_index);
     [[nodiscard]] bool map_individual_page_impl(size_t page_index, RefPtr<PhysicalRAMPage>);
@@ -263,6 +270,7 @@ private:
     bool m_syscall_region : 1 { false };
     bool m_mmapped_from_readable : 1 { false };
     bool m_mmapped_from_writable : 1 { false };
+    bool m_large_pages_allowed : 1 { true };
 
     MemoryType m_memory_type;
 
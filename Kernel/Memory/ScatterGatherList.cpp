@@ -9,9 +9,14 @@
 namespace Kernel::Memory {
 
 ErrorOr<LockRefPtr<ScatterGatherList>> ScatterGatherList::try_create(AsyncBlockDeviceRequest& request, Span<NonnullRefPtr<PhysicalRAMPage>> allocated_pages, size_t device_block_size, StringView region_name)
+{
+    return try_create(allocated_pages, request.block_count() * device_block_size, region_name);
+}
+
+ErrorOr<LockRefPtr<ScatterGatherList>> ScatterGatherList::try_create(Span<NonnullRefPtr<PhysicalRAMPage>> allocated_pages, size_t size_in_bytes, StringView region_name)
 {
     auto vm_object = TRY(AnonymousVMObject::try_create_with_physical_pages(allocated_pages));
-    auto size = TRY(page_round_up((request.block_count() * device_block_size)));
+    auto size = TRY(page_round_up(size_in_bytes));
     auto region = TRY(MM.allocate_kernel_region_with_vmobject(vm_object, size, region_name, Region::Access::Read | Region::Access::Write, MemoryType::Normal));
 
     return adopt_lock_ref_if_nonnull(new (nothrow) ScatterGatherList(vm_object, move(region)));
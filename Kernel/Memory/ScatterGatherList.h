@@ -20,6 +20,7 @@ namespace Kernel::Memory {
 class ScatterGatherList final : public AtomicRefCounted<ScatterGatherList> {
 public:
     static ErrorOr<LockRefPtr<ScatterGatherList>> try_create(AsyncBlockDeviceRequest&, Span<NonnullRefPtr<PhysicalRAMPage>> allocated_pages, size_t device_block_size, StringView region_name);
+    static ErrorOr<LockRefPtr<ScatterGatherList>> try_create(Span<NonnullRefPtr<PhysicalRAMPage>> allocated_pages, size_t size_in_bytes, StringView region_name);
     VMObject const& vmobject() const { return m_vm_object; }
     VirtualAddress dma_region() const { return m_dma_region->vaddr(); }
     size_t scatters_count() const { return m_vm_object->physical_pages().size(); }
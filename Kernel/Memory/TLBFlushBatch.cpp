@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Memory/MemoryManager.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
+
+namespace Kernel::Memory {
+
+TLBShootdownStatistics g_tlb_shootdown_statistics;
+
+void TLBFlushBatch::add(VirtualRange const& range)
+{
+    // Kernel mappings are global, so they would survive a full flush.
+    VERIFY(is_user_range(range));
+    ++m_added_range_count;
+
+    if (m_needs_full_flush)
+        return;
+
+    m_page_count += range.size() / PAGE_SIZE;
+    if (m_page_count > full_flush_threshold_in_pages) {
+        m_needs_full_flush = true;
+        return;
+    }
+
+    if (!m_ranges.is_empty() && m_ranges.last().end() == range.base()) {
+        m_ranges.last() = VirtualRange { m_ranges.last().base(), m_ranges.last().size() + range.size() };
+        return;
+    }
+    if (m_ranges.size() == maximum_range_count) {
+        m_needs_full_flush = true;
+        return;
+    }
+    m_ranges.unchecked_append(range);
+}
+
+void TLBFlushBatch::flush()
+{
+    if (m_added_range_count == 0)
+        return;
+
+    ++g_tlb_shootdown_statistics.batches;
+    g_tlb_shootdown_statistics.batched_ranges += m_added_range_count;
+    if (m_needs_full_flush) {
+        ++g_tlb_shootdown_statistics.full_flushes;
+        MemoryManager::flush_entire_tlb(&m_page_directory);
+    } else {
+        MemoryManager::flush_tlb(&m_page_directory, m_ranges.span());
+    }
+
+    m_ranges.clear_with_capacity();
+    m_added_range_count = 0;
+    m_page_count = 0;
+    m_needs_full_flush = false;
+}
+
+}
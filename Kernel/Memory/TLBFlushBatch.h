@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Noncopyable.h>
+#include <AK/Vector.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Memory/VirtualRange.h>
+
+namespace Kernel::Memory {
+
+struct TLBShootdownStatistics {
+    // Flushes that had to interrupt other processors, and how many processors they interrupted.
+    Atomic<u64> shootdowns { 0 };
+    Atomic<u64> ipis_sent { 0 };
+    // Processors that were left alone because they weren't running the address space.
+    Atomic<u64> ipis_avoided { 0 };
+    // Flushes that didn't have to interrupt any other processor at all.
+    Atomic<u64> local_flushes { 0 };
+    // Every batch ends in a single flush, no matter how many ranges were added to it.
+    Atomic<u64> batches { 0 };
+    Atomic<u64> batched_ranges { 0 };
+    // Batches that were big enough to flush all user mappings instead.
+    Atomic<u64> full_flushes { 0 };
+};
+
+extern TLBShootdownStatistics g_tlb_shootdown_statistics;
+
+// Collects the ranges that an address space operation unmapped or remapped, and flushes them
+// from the TLBs of all processors at once when the operation is done.
+//
+// Since other processors may keep using stale TLB entries until then, the physical pages
+// that were mapped in these ranges must not be freed before the batch is flushed.
+class TLBFlushBatch {
+    AK_MAKE_NONCOPYABLE(TLBFlushBatch);
+    AK_MAKE_NONMOVABLE(TLBFlushBatch);
+
+public:
+    explicit TLBFlushBatch(PageDirectory const& page_directory)
+        : m_page_directory(page_directory)
+    {
+    }
+
+    ~TLBFlushBatch() { flush(); }
+
+    void add(VirtualRange const&);
+    void flush();
+
+private:
+    static constexpr size_t maximum_range_count = 8;
+    // Beyond this many pages, reloading the page directory is cheaper than invalidating every single one.
+    static constexpr size_t full_flush_threshold_in_pages = 32;
+
+    PageDirectory const& m_page_directory;
+    Vector<VirtualRange, maximum_range_count> m_ranges;
+    size_t m_added_range_count { 0 };
+    size_t m_page_count { 0 };
+    bool m_needs_full_flush { false };
+};
+
+}
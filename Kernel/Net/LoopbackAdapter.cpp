@@ -26,6 +26,8 @@ LoopbackAdapter::LoopbackAdapter(StringView interface_name)
     // by the data-link (Ethernet in this case) or physical layers, we need to subtract it from the MTU.
     set_mtu(65536 - sizeof(EthernetFrameHeader));
     set_mac_address({ 19, 85, 2, 9, 0x55, 0xaa });
+    // Packets never leave the machine, so there's nothing a checksum could protect against.
+    set_offloads(Offload::TransmitChecksum | Offload::ReceiveChecksum);
 }
 
 LoopbackAdapter::~LoopbackAdapter() = default;
@@ -36,4 +38,9 @@ void LoopbackAdapter::send_raw(ReadonlyBytes payload)
     did_receive(payload);
 }
 
+void LoopbackAdapter::send_raw_with_offloads(ReadonlyBytes payload, PacketOffloads const&)
+{
+    send_raw(payload);
+}
+
 }
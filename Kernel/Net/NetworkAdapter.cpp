@@ -10,6 +10,9 @@
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/NetworkAdapter.h>
 #include <Kernel/Net/NetworkingManagement.h>
+#include <Kernel/Net/Routing.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPSocket.h>
 #include <Kernel/Tasks/Process.h>
 
 namespace Kernel {
@@ -28,6 +31,72 @@ void NetworkAdapter::send_packet(ReadonlyBytes packet)
     send_raw(packet);
 }
 
+void NetworkAdapter::send_packet(ReadonlyBytes packet, PacketOffloads const& offloads)
+{
+    size_t headers_size = offloads.tcp_header_offset + offloads.tcp_header_size;
+    VERIFY(packet.size() >= headers_size);
+    bool needs_segmentation = offloads.tcp_segment_size != 0 && packet.size() - headers_size > offloads.tcp_segment_size;
+
+    if (!needs_segmentation && !offloads.needs_tcp_checksum)
+        return send_packet(packet);
+
+    if ((!needs_segmentation || has_offload(Offload::TCPSegmentation)) && has_offload(Offload::TransmitChecksum)) {
+        m_packets_out++;
+        m_bytes_out += packet.size();
+        send_raw_with_offloads(packet, offloads);
+        return;
+    }
+
+    send_segments_in_software(packet, offloads);
+}
+
+void NetworkAdapter::send_segments_in_software(ReadonlyBytes packet, PacketOffloads const& offloads)
+{
+    size_t headers_size = offloads.tcp_header_offset + offloads.tcp_header_size;
+    auto payload = packet.slice(headers_size);
+    size_t segment_size = offloads.tcp_segment_size != 0 ? offloads.tcp_segment_size : payload.size();
+    auto const& original_tcp_packet = *bit_cast<TCPPacket const*>(packet.offset_pointer(offloads.tcp_header_offset));
+
+    size_t offset = 0;
+    do {
+        size_t payload_size = min(segment_size, payload.size() - offset);
+        bool is_last_segment = offset + payload_size == payload.size();
+        auto segment = acquire_packet_buffer(headers_size + payload_size);
+        if (!segment) {
+            // TCP will send the rest again once it notices it's missing.
+            m_packets_dropped++;
+            return;
+        }
+        memcpy(segment->buffer->data(), packet.data(), headers_size);
+        memcpy(segment->buffer->data() + headers_size, payload.offset_pointer(offset), payload_size);
+
+        auto& ipv4_packet = *bit_cast<IPv4Packet*>(segment->buffer->data() + layer3_payload_offset());
+        ipv4_packet.set_length(segment->buffer->size() - layer3_payload_offset());
+        ipv4_packet.set_checksum(0);
+        ipv4_packet.set_checksum(ipv4_packet.compute_checksum());
+
+        auto& tcp_packet = *bit_cast<TCPPacket*>(segment->buffer->data() + offloads.tcp_header_offset);
+        tcp_packet.set_sequence_number(original_tcp_packet.sequence_number() + offset);
+        // Only the last segment gets to finish the data, like it would have without segmentation.
+        if (!is_last_segment)
+            tcp_packet.set_flags(tcp_packet.flags() & ~(TCPFlags::FIN | TCPFlags::PSH));
+
+        m_packets_out++;
+        m_bytes_out += segment->buffer->size();
+        if (has_offload(Offload::TransmitChecksum)) {
+            tcp_packet.set_checksum(TCPSocket::compute_tcp_pseudo_header_checksum(ipv4_packet.source(), ipv4_packet.destination(), offloads.tcp_header_size + payload_size));
+            send_raw_with_offloads(segment->bytes(), { .tcp_header_offset = offloads.tcp_header_offset, .tcp_header_size = offloads.tcp_header_size, .needs_tcp_checksum = true, .tcp_segment_size = 0 });
+        } else {
+            tcp_packet.set_checksum(0);
+            tcp_packet.set_checksum(TCPSocket::compute_tcp_checksum(ipv4_packet.source(), ipv4_packet.destination(), tcp_packet, payload_size));
+            send_raw(segment->bytes());
+        }
+        release_packet_buffer(*segment);
+
+        offset += payload_size;
+    } while (offset < payload.size());
+}
+
 void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet)
 {
     size_t size_in_bytes = sizeof(EthernetFrameHeader) + sizeof(ARPPacket);
@@ -47,7 +116,9 @@ void NetworkAdapter::send(MACAddress const& destination, ARPPacket const& packet
 void NetworkAdapter::fill_in_ipv4_header(PacketWithTimestamp& packet, IPv4Address const& source_ipv4, MACAddress const& destination_mac, IPv4Address const& destination_ipv4, TransportProtocol protocol, size_t payload_size, u8 type_of_service, u8 ttl)
 {
     size_t ipv4_packet_size = sizeof(IPv4Packet) + payload_size;
-    VERIFY(ipv4_packet_size <= mtu());
+    // TCP packets may be bigger, they are split into segments on their way out.
+    VERIFY(ipv4_packet_size <= mtu() || protocol == TransportProtocol::TCP);
+    VERIFY(ipv4_packet_size <= NumericLimits<u16>::max());
 
     size_t ethernet_frame_size = ipv4_payload_offset() + payload_size;
     VERIFY(packet.buffer->size() == ethernet_frame_size);
@@ -103,38 +174,92 @@ void NetworkAdapter::fill_in_ipv6_header(PacketWithTimestamp& packet, IPv6Addres
     ipv6.set_hop_limit(hop_limit);
 }
 
+// Hashes the IPv4 addresses, protocol and ports of a frame, much like receive side scaling hardware does.
+static u32 flow_hash(ReadonlyBytes frame)
+{
+    if (frame.size() < sizeof(EthernetFrameHeader) + sizeof(IPv4Packet))
+        return 0;
+    auto& eth = *reinterpret_cast<EthernetFrameHeader const*>(frame.data());
+    // Everything but IPv4 is rare enough to go to the first queue.
+    if (eth.ether_type() != EtherType::IPv4)
+        return 0;
+    auto& ipv4 = *static_cast<IPv4Packet const*>(eth.payload());
+
+    u32 hash = pair_int_hash(ipv4.source().to_u32(), ipv4.destination().to_u32());
+    hash = pair_int_hash(hash, ipv4.protocol());
+
+    // Only the first fragment of a datagram carries the ports,
+    // so fragmented datagrams are hashed by their addresses alone to keep them together.
+    if (ipv4.is_a_fragment())
+        return hash;
+    auto protocol = static_cast<TransportProtocol>(ipv4.protocol());
+    if (protocol != TransportProtocol::TCP && protocol != TransportProtocol::UDP)
+        return hash;
+
+    // TCP and UDP headers both start with the source and destination ports.
+    size_t ports_offset = sizeof(EthernetFrameHeader) + ipv4.internet_header_length() * sizeof(u32);
+    if (frame.size() < ports_offset + sizeof(u32))
+        return hash;
+    u32 ports;
+    memcpy(&ports, frame.offset_pointer(ports_offset), sizeof(ports));
+    return pair_int_hash(hash, ports);
+}
+
 void NetworkAdapter::did_receive(ReadonlyBytes payload)
+{
+    enqueue_received_packet(payload, NetworkTask::worker_for_flow_hash(flow_hash(payload)));
+}
+
+void NetworkAdapter::did_receive(ReadonlyBytes payload, size_t receive_ring)
+{
+    enqueue_received_packet(payload, receive_ring % NetworkTask::worker_count());
+}
+
+void NetworkAdapter::enqueue_received_packet(ReadonlyBytes payload, size_t queue_index)
 {
     InterruptDisabler disabler;
     m_packets_in++;
     m_bytes_in += payload.size();
 
-    if (m_packet_queue_size == max_packet_buffers) {
+    if (m_packet_queue_size.fetch_add(1) >= max_packet_buffers) {
+        m_packet_queue_size--;
         m_packets_dropped++;
         return;
     }
 
     auto packet = acquire_packet_buffer(payload.size());
     if (!packet) {
+        m_packet_queue_size--;
         dbgln("Discarding packet because we're out of memory");
         return;
     }
 
     memcpy(packet->buffer->data(), payload.data(), payload.size());
 
-    m_packet_queue.append(*packet);
-    m_packet_queue_size++;
+    m_receive_queues[queue_index].with([&](auto& queue) {
+        queue.append(*packet);
+    });
 
     if (on_receive)
-        on_receive();
+        on_receive(queue_index);
 }
 
-size_t NetworkAdapter::dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+bool NetworkAdapter::has_queued_packets(size_t queue_index) const
 {
-    InterruptDisabler disabler;
-    if (m_packet_queue.is_empty())
+    return m_receive_queues[queue_index].with([](auto const& queue) {
+        return !queue.is_empty();
+    });
+}
+
+size_t NetworkAdapter::dequeue_packet(size_t queue_index, u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp)
+{
+    auto packet_with_timestamp = m_receive_queues[queue_index].with([](auto& queue) -> RefPtr<PacketWithTimestamp> {
+        if (queue.is_empty())
+            return nullptr;
+        return queue.take_first();
+    });
+    if (!packet_with_timestamp)
         return 0;
-    auto packet_with_timestamp = m_packet_queue.take_first();
     m_packet_queue_size--;
     packet_timestamp = packet_with_timestamp->timestamp;
     auto& packet_buffer = packet_with_timestamp->buffer;
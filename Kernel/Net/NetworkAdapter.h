@@ -6,8 +6,11 @@
 
 #pragma once
 
+#include <AK/Array.h>
+#include <AK/Atomic.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/ByteBuffer.h>
+#include <AK/EnumBits.h>
 #include <AK/Function.h>
 #include <AK/IPv6Address.h>
 #include <AK/IntrusiveList.h>
@@ -18,12 +21,14 @@
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Library/LockWeakable.h>
 #include <Kernel/Library/UserOrKernelBuffer.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/ICMP.h>
 #include <Kernel/Net/IP/ARP.h>
 #include <Kernel/Net/IP/IP.h>
 #include <Kernel/Net/IP/IPv4.h>
 #include <Kernel/Net/IP/IPv6.h>
+#include <Kernel/Net/NetworkTask.h>
 
 namespace Kernel {
 
@@ -45,6 +50,17 @@ struct PacketWithTimestamp final : public AtomicRefCounted<PacketWithTimestamp>
     IntrusiveListNode<PacketWithTimestamp, RefPtr<PacketWithTimestamp>> packet_node;
 };
 
+// Work on an outgoing TCP packet that the sender left for the adapter.
+struct PacketOffloads {
+    u16 tcp_header_offset { 0 };
+    u16 tcp_header_size { 0 };
+    // The checksum field of the TCP header only holds the checksum of the pseudo header,
+    // and the TCP header and payload still have to be added to it.
+    bool needs_tcp_checksum { false };
+    // The payload has to be split into segments of at most this size. Zero if it fits into a single segment.
+    u16 tcp_segment_size { 0 };
+};
+
 class NetworkingManagement;
 class NetworkAdapter
     : public AtomicRefCounted<NetworkAdapter>
@@ -55,6 +71,17 @@ public:
         Ethernet
     };
 
+    enum class Offload : u8 {
+        None = 0,
+        // Completes the TCP checksums of outgoing IPv4 packets.
+        TransmitChecksum = 1 << 0,
+        // Validates the checksums of incoming packets, and may hand us packets with partial checksums from the host.
+        ReceiveChecksum = 1 << 1,
+        // Splits outgoing TCP packets over IPv4 into segments (TSO).
+        TCPSegmentation = 1 << 2,
+    };
+    AK_ENUM_BITWISE_FRIEND_OPERATORS(Offload);
+
     static constexpr i32 LINKSPEED_INVALID = -1;
 
     virtual ~NetworkAdapter();
@@ -92,13 +119,17 @@ public:
     void fill_in_ipv4_header(PacketWithTimestamp&, IPv4Address const&, MACAddress const&, IPv4Address const&, TransportProtocol, size_t, u8 type_of_service, u8 ttl);
     void fill_in_ipv6_header(PacketWithTimestamp&, IPv6Address const&, MACAddress const&, IPv6Address const&, TransportProtocol, size_t, u8 hop_limit);
 
-    size_t dequeue_packet(u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
+    // There is one receive queue for every NetworkTask worker.
+    size_t dequeue_packet(size_t queue_index, u8* buffer, size_t buffer_size, UnixDateTime& packet_timestamp);
 
-    bool has_queued_packets() const { return !m_packet_queue.is_empty(); }
+    bool has_queued_packets(size_t queue_index) const;
 
     u32 mtu() const { return m_mtu; }
     void set_mtu(u32 mtu) { m_mtu = mtu; }
 
+    Offload offloads() const { return m_offloads; }
+    bool has_offload(Offload offload) const { return has_flag(m_offloads, offload); }
+
     u32 packets_in() const { return m_packets_in; }
     u32 bytes_in() const { return m_bytes_in; }
     u32 packets_out() const { return m_packets_out; }
@@ -112,15 +143,24 @@ public:
     constexpr size_t ipv4_payload_offset() const { return layer3_payload_offset() + sizeof(IPv4Packet); }
     constexpr size_t ipv6_payload_offset() const { return layer3_payload_offset() + sizeof(IPv6PacketHeader); }
 
-    Function<void()> on_receive;
+    Function<void(size_t queue_index)> on_receive;
 
     void send_packet(ReadonlyBytes);
+    // Whatever the adapter can't do itself is done in software right before the packet goes out,
+    // so the rest of the stack still gets to handle one big packet instead of many small ones.
+    void send_packet(ReadonlyBytes, PacketOffloads const&);
 
 protected:
     NetworkAdapter(StringView);
     void set_mac_address(MACAddress const& mac_address) { m_mac_address = mac_address; }
+    void set_offloads(Offload offloads) { m_offloads = offloads; }
+    // Picks a receive queue by hashing the packet's flow.
     void did_receive(ReadonlyBytes);
+    // For adapters with several receive rings, which already keep every flow on a single ring.
+    void did_receive(ReadonlyBytes, size_t receive_ring);
     virtual void send_raw(ReadonlyBytes) = 0;
+    // Only called with the offloads the adapter claims to support.
+    virtual void send_raw_with_offloads(ReadonlyBytes, PacketOffloads const&) { VERIFY_NOT_REACHED(); }
     void autoconfigure_link_local_ipv6();
 
 private:
@@ -136,8 +176,11 @@ private:
 
     using PacketList = IntrusiveList<&PacketWithTimestamp::packet_node>;
 
-    PacketList m_packet_queue;
-    size_t m_packet_queue_size { 0 };
+    void enqueue_received_packet(ReadonlyBytes, size_t queue_index);
+    void send_segments_in_software(ReadonlyBytes, PacketOffloads const&);
+
+    Array<SpinlockProtected<PacketList, LockRank::None>, NetworkTask::maximum_worker_count> m_receive_queues;
+    Atomic<size_t> m_packet_queue_size { 0 };
     RecursiveSpinlockProtected<PacketList, LockRank::None> m_unused_packets {};
     FixedStringBuffer<IFNAMSIZ> m_name;
     u32 m_packets_in { 0 };
@@ -146,6 +189,7 @@ private:
     u32 m_bytes_out { 0 };
     u32 m_mtu { 1500 };
     u32 m_packets_dropped { 0 };
+    Offload m_offloads { Offload::None };
 };
 
 }
@@ -6,9 +6,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Locking/Mutex.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Net/EtherType.h>
 #include <Kernel/Net/EthernetFrameHeader.h>
 #include <Kernel/Net/ICMP.h>
@@ -42,28 +44,22 @@ static void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_pac
 static void flush_delayed_tcp_acks();
 static void retransmit_tcp_packets();
 
-static Thread* network_task = nullptr;
-static HashTable<NonnullRefPtr<TCPSocket>>* delayed_ack_sockets;
+struct NetworkWorker {
+    Thread* thread { nullptr };
+    WaitQueue packet_wait_queue;
+};
+
+static Array<NetworkWorker, NetworkTask::maximum_worker_count> s_workers;
+static size_t s_worker_count = 1;
+static Singleton<SpinlockProtected<HashTable<NonnullRefPtr<TCPSocket>>, LockRank::None>> s_delayed_ack_sockets;
 
 [[noreturn]] static void NetworkTask_main(void*);
 
 void NetworkTask::spawn()
 {
-    auto [_, first_thread] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr));
-    network_task = first_thread;
-}
-
-bool NetworkTask::is_current()
-{
-    return Thread::current() == network_task;
-}
-
-void NetworkTask_main(void*)
-{
-    delayed_ack_sockets = new HashTable<NonnullRefPtr<TCPSocket>>;
+    // Every worker is pinned to its own processor.
+    s_worker_count = min<size_t>(Processor::count(), maximum_worker_count);
 
-    WaitQueue packet_wait_queue;
-    int pending_packets = 0;
     NetworkingManagement::the().for_each([&](auto& adapter) {
         dmesgln("NetworkTask: {} network adapter found: hw={}", adapter.class_name(), adapter.mac_address().to_string());
 
@@ -72,12 +68,45 @@ void NetworkTask_main(void*)
             adapter.set_ipv4_netmask({ 255, 0, 0, 0 });
         }
 
-        adapter.on_receive = [&]() {
-            pending_packets++;
-            packet_wait_queue.wake_all();
+        adapter.on_receive = [](size_t queue_index) {
+            s_workers[queue_index].packet_wait_queue.wake_all();
         };
     });
 
+    auto [process, first_thread] = MUST(Process::create_kernel_process("Network Task"sv, NetworkTask_main, nullptr, s_worker_count > 1 ? 1u : THREAD_AFFINITY_DEFAULT));
+    s_workers[0].thread = first_thread;
+    for (size_t i = 1; i < s_worker_count; ++i) {
+        auto thread = MUST(process->create_kernel_thread(NetworkTask_main, reinterpret_cast<void*>(i), THREAD_PRIORITY_NORMAL, MUST(KString::formatted("Network Task #{}", i))->view(), 1u << i));
+        s_workers[i].thread = thread.ptr();
+    }
+    dmesgln("NetworkTask: Processing received packets on {} worker(s)", s_worker_count);
+}
+
+bool NetworkTask::is_current()
+{
+    auto* current_thread = Thread::current();
+    for (size_t i = 0; i < s_worker_count; ++i) {
+        if (s_workers[i].thread == current_thread)
+            return true;
+    }
+    return false;
+}
+
+size_t NetworkTask::worker_count()
+{
+    return s_worker_count;
+}
+
+void NetworkTask::wake_for_retransmit()
+{
+    s_workers[0].packet_wait_queue.wake_all();
+}
+
+void NetworkTask_main(void* worker_index_as_pointer)
+{
+    auto worker_index = reinterpret_cast<size_t>(worker_index_as_pointer);
+    auto& worker = s_workers[worker_index];
+
     size_t buffer_size = 64 * KiB;
     auto region_or_error = MM.allocate_kernel_region(buffer_size, "Kernel Packet Buffer"sv, Memory::Region::Access::ReadWrite);
     if (region_or_error.is_error())
@@ -94,23 +123,25 @@ void NetworkTask_main(void*)
 
     while (!Process::current().is_dying()) {
         flush_delayed_tcp_acks();
-        retransmit_tcp_packets();
+        // The retransmission timers of all sockets are handled by the first worker.
+        if (worker_index == 0)
+            retransmit_tcp_packets();
         size_t packet_size = 0;
-        if (!pending_packets) {
-            auto timeout_time = Duration::from_milliseconds(500);
+        NetworkingManagement::the().for_each([&](auto& adapter) {
+            if (packet_size || !adapter.has_queued_packets(worker_index)) {
+                return;
+            }
+            packet_size = adapter.dequeue_packet(worker_index, meta.buffer, buffer_size, meta.packet_timestamp);
+            dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Worker {} dequeued packet from {} ({} bytes)", worker_index, adapter.name(), packet_size);
+            meta.adapter = adapter;
+        });
+        if (!packet_size) {
+            // NOTE: A wakeup that arrives before we start waiting is not lost, the wait returns immediately.
+            //       This is also how often we flush delayed ACKs.
+            auto timeout_time = Duration::from_milliseconds(100);
             auto timeout = Thread::BlockTimeout { false, &timeout_time };
-            [[maybe_unused]] auto result = packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
+            [[maybe_unused]] auto result = worker.packet_wait_queue.wait_on(timeout, "NetworkTask"sv);
             continue;
-        } else {
-            NetworkingManagement::the().for_each([&](auto& adapter) {
-                if (packet_size || !adapter.has_queued_packets()) {
-                    return;
-                }
-                packet_size = adapter.dequeue_packet(meta.buffer, buffer_size, meta.packet_timestamp);
-                pending_packets--;
-                dbgln_if(NETWORK_TASK_DEBUG, "NetworkTask: Dequeued packet from {} ({} bytes)", adapter.name(), packet_size);
-                meta.adapter = adapter;
-            });
         }
         if (packet_size < sizeof(EthernetFrameHeader)) {
             dbgln("NetworkTask: Packet is too small to be an Ethernet packet! ({})", packet_size);
@@ -476,13 +507,23 @@ void send_delayed_tcp_ack(TCPSocket& socket)
         return;
     }
 
-    delayed_ack_sockets->set(move(socket));
+    s_delayed_ack_sockets->with([&](auto& delayed_ack_sockets) {
+        delayed_ack_sockets.set(socket);
+    });
 }
 
 void flush_delayed_tcp_acks()
 {
+    // Take the sockets out of the set first, as they are added to it with their mutex held.
+    HashTable<NonnullRefPtr<TCPSocket>> delayed_ack_sockets;
+    s_delayed_ack_sockets->with([&](auto& sockets) {
+        swap(delayed_ack_sockets, sockets);
+    });
+    if (delayed_ack_sockets.is_empty())
+        return;
+
     Vector<NonnullRefPtr<TCPSocket>, 32> remaining_sockets;
-    for (auto& socket : *delayed_ack_sockets) {
+    for (auto& socket : delayed_ack_sockets) {
         MutexLocker locker(socket->mutex());
         if (socket->should_delay_next_ack()) {
             MUST(remaining_sockets.try_append(*socket));
@@ -491,13 +532,14 @@ void flush_delayed_tcp_acks()
         [[maybe_unused]] auto result = socket->send_ack();
     }
 
-    if (remaining_sockets.size() != delayed_ack_sockets->size()) {
-        delayed_ack_sockets->clear();
-        if (remaining_sockets.size() > 0)
-            dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
-        for (auto&& socket : remaining_sockets)
-            delayed_ack_sockets->set(move(socket));
-    }
+    if (remaining_sockets.is_empty())
+        return;
+    if (remaining_sockets.size() != delayed_ack_sockets.size())
+        dbgln("flush_delayed_tcp_acks: {} sockets remaining", remaining_sockets.size());
+    s_delayed_ack_sockets->with([&](auto& sockets) {
+        for (auto& socket : remaining_sockets)
+            sockets.set(socket);
+    });
 }
 
 void send_tcp_rst(IPv4Packet const& ipv4_packet, TCPPacket const& tcp_packet, RefPtr<NetworkAdapter> adapter)
@@ -592,19 +634,6 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
     dbgln_if(TCP_DEBUG, "handle_tcp: got socket {}; state={}", socket->tuple().to_string(), TCPSocket::to_string(socket->state()));
 
     socket->receive_tcp_packet(tcp_packet, ipv4_packet.payload_size());
-    Optional<u8> send_window_scale;
-    if (tcp_packet.has_syn()) {
-        tcp_packet.for_each_option([&send_window_scale](auto const& option) {
-            if (option.kind() != TCPOptionKind::WindowScale)
-                return;
-            if (option.length() != sizeof(TCPOptionWindowScale))
-                return;
-            auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
-            if (scale > 14)
-                return; // Maximum allowed as per RFC7323
-            send_window_scale = scale;
-        });
-    }
 
     switch (socket->state()) {
     case TCPSocket::State::Closed:
@@ -637,10 +666,9 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             dbgln_if(TCP_DEBUG, "handle_tcp: created new client socket with tuple {}", client->tuple().to_string());
             client->set_sequence_number(1000);
             client->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            client->apply_syn_options(tcp_packet);
             [[maybe_unused]] auto rc2 = client->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             client->set_state(TCPSocket::State::SynReceived);
-            if (send_window_scale.has_value())
-                client->set_send_window_scale(*send_window_scale);
             return;
         }
         default:
@@ -652,10 +680,9 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
         switch (tcp_packet.flags()) {
         case TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
+            socket->apply_syn_options(tcp_packet);
             (void)socket->send_tcp_packet(TCPFlags::SYN | TCPFlags::ACK);
             socket->set_state(TCPSocket::State::SynReceived);
-            if (send_window_scale.has_value())
-                socket->set_send_window_scale(*send_window_scale);
             return;
         case TCPFlags::ACK | TCPFlags::SYN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
@@ -663,8 +690,7 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
             socket->set_state(TCPSocket::State::Established);
             socket->set_setup_state(Socket::SetupState::Completed);
             socket->set_connected(true);
-            if (send_window_scale.has_value())
-                socket->set_send_window_scale(*send_window_scale);
+            socket->apply_syn_options(tcp_packet);
             return;
         case TCPFlags::ACK | TCPFlags::FIN:
             socket->set_ack_number(tcp_packet.sequence_number() + payload_size + 1);
@@ -851,18 +877,30 @@ void handle_tcp(IPv4Packet const& ipv4_packet, UnixDateTime const& packet_timest
 
 void retransmit_tcp_packets()
 {
-    // We must keep the sockets alive until after we've unlocked the hash table
+    // Only sockets whose retransmission timer expired are on the list.
+    // We must keep the sockets alive until after we've unlocked the list
     // in case retransmit_packets() realizes that it wants to close the socket.
-    Vector<NonnullRefPtr<TCPSocket>, 16> sockets;
-    TCPSocket::sockets_for_retransmit().for_each_shared([&](auto const& socket) {
-        // We ignore allocation failures above the first 16 guaranteed socket slots, as
-        // we will just retransmit their packets the next time around
-        (void)sockets.try_append(socket);
-    });
+    static constexpr size_t batch_size = 16;
+    for (;;) {
+        Vector<NonnullRefPtr<TCPSocket>, batch_size> sockets;
+        TCPSocket::sockets_due_for_retransmit().with([&](auto& list) {
+            while (sockets.size() < batch_size) {
+                auto* socket = list.take_first();
+                if (!socket)
+                    break;
+                // A socket that is already being destroyed has nothing left to retransmit.
+                if (!socket->try_ref())
+                    continue;
+                sockets.unchecked_append(adopt_ref(*socket));
+            }
+        });
+        if (sockets.is_empty())
+            return;
 
-    for (auto& socket : sockets) {
-        MutexLocker socket_locker(socket->mutex());
-        socket->retransmit_packets();
+        for (auto& socket : sockets) {
+            MutexLocker socket_locker(socket->mutex());
+            socket->retransmit_packets();
+        }
     }
 }
 
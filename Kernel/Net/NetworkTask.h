@@ -6,10 +6,21 @@
 
 #pragma once
 
+#include <AK/Types.h>
+
 namespace Kernel {
 class NetworkTask {
 public:
+    // Received packets are processed by one worker thread per processor, up to this many.
+    static constexpr size_t maximum_worker_count = 8;
+
     static void spawn();
     static bool is_current();
+
+    static size_t worker_count();
+    // Wakes up the worker that handles TCP retransmissions, after a retransmission timer expired.
+    static void wake_for_retransmit();
+    // Every packet of a flow has to go to the same worker, so that they are processed in order.
+    static size_t worker_for_flow_hash(u32 flow_hash) { return flow_hash % worker_count(); }
 };
 }
@@ -74,7 +74,33 @@ private:
     NetworkOrdered<u8> m_value;
 };
 
+class [[gnu::packed]] TCPOptionSACKPermitted : public TCPOption {
+public:
+    TCPOptionSACKPermitted()
+        : TCPOption(TCPOptionKind::SACKPermitted, sizeof(TCPOptionSACKPermitted))
+    {
+    }
+};
+
+// RFC 2018: Each block describes a contiguous run of data that was received out of order.
+class [[gnu::packed]] TCPOptionSACK : public TCPOption {
+public:
+    struct [[gnu::packed]] Block {
+        NetworkOrdered<u32> left_edge;
+        NetworkOrdered<u32> right_edge;
+    };
+
+    size_t block_count() const { return (length() - sizeof(TCPOption)) / sizeof(Block); }
+    Block const& block(size_t index) const
+    {
+        VERIFY(index < block_count());
+        return reinterpret_cast<Block const*>(reinterpret_cast<u8 const*>(this) + sizeof(TCPOption))[index];
+    }
+};
+
 static_assert(AssertSize<TCPOptionMSS, 4>());
+static_assert(AssertSize<TCPOptionSACKPermitted, 2>());
+static_assert(AssertSize<TCPOptionSACK::Block, 8>());
 
 class [[gnu::packed]] TCPPacket {
 public:
@@ -135,6 +161,8 @@ public:
             }
             if (option->length() < sizeof(TCPOption))
                 return; // minimal option length
+            if (option->length() > (size_t)options_end - (size_t)next_option)
+                return; // Option extends past the end of the header
             callback(*option);
             next_option += option->length();
         }
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <Kernel/Net/TCPCongestionControl.h>
+
+namespace Kernel {
+
+StringView TCPCongestionControl::to_string(Algorithm algorithm)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return "newreno"sv;
+    case Algorithm::Cubic:
+        return "cubic"sv;
+    }
+    VERIFY_NOT_REACHED();
+}
+
+Optional<TCPCongestionControl::Algorithm> TCPCongestionControl::algorithm_from_name(StringView name)
+{
+    if (name == "newreno"sv || name == "reno"sv)
+        return Algorithm::NewReno;
+    if (name == "cubic"sv)
+        return Algorithm::Cubic;
+    return {};
+}
+
+ErrorOr<NonnullOwnPtr<TCPCongestionControl>> TCPCongestionControl::try_create(Algorithm algorithm, u32 mss)
+{
+    switch (algorithm) {
+    case Algorithm::NewReno:
+        return adopt_nonnull_own_or_enomem<TCPCongestionControl>(new (nothrow) TCPNewRenoCongestionControl(mss));
+    case Algorithm::Cubic:
+        return adopt_nonnull_own_or_enomem<TCPCongestionControl>(new (nothrow) TCPCubicCongestionControl(mss));
+    }
+    VERIFY_NOT_REACHED();
+}
+
+TCPCongestionControl::TCPCongestionControl(u32 mss)
+    : m_mss(mss)
+{
+    // RFC 6928, 2: IW = min (10*MSS, max (2*MSS, 14600))
+    set_congestion_window(min<u64>(initial_window_segments * mss, max<u64>(2 * mss, 14600)));
+}
+
+void TCPCongestionControl::set_congestion_window(u64 window)
+{
+    m_congestion_window = static_cast<u32>(clamp<u64>(window, m_mss, maximum_congestion_window));
+}
+
+void TCPCongestionControl::set_mss(u32 mss)
+{
+    VERIFY(mss > 0);
+    if (mss == m_mss)
+        return;
+    // Keep the window at the same number of segments.
+    u64 window = static_cast<u64>(m_congestion_window) * mss / m_mss;
+    m_mss = mss;
+    set_congestion_window(window);
+}
+
+void TCPCongestionControl::on_ack(u32 acked_bytes, MonotonicTime now, Duration smoothed_rtt)
+{
+    if (acked_bytes == 0)
+        return;
+
+    if (is_in_slow_start()) {
+        // RFC 5681, 3.1: cwnd += min (N, SMSS)
+        set_congestion_window(static_cast<u64>(m_congestion_window) + min(acked_bytes, m_mss));
+        return;
+    }
+
+    increase_in_congestion_avoidance(acked_bytes, now, smoothed_rtt);
+}
+
+void TCPCongestionControl::on_enter_fast_recovery(u32 flight_size, MonotonicTime now)
+{
+    m_slow_start_threshold = slow_start_threshold_after_loss(flight_size, now);
+    // RFC 5681, 3.2: Inflate the window by the three segments that have left the network.
+    set_congestion_window(static_cast<u64>(m_slow_start_threshold) + 3 * m_mss);
+}
+
+void TCPCongestionControl::on_duplicate_ack_during_fast_recovery()
+{
+    set_congestion_window(static_cast<u64>(m_congestion_window) + m_mss);
+}
+
+void TCPCongestionControl::on_partial_ack(u32 acked_bytes)
+{
+    // RFC 6582, 3.2, step 3: Deflate the window by the amount of new data acknowledged,
+    // then add back one segment if at least that much was acknowledged.
+    u64 window = m_congestion_window - min(acked_bytes, m_congestion_window);
+    if (acked_bytes >= m_mss)
+        window += m_mss;
+    set_congestion_window(window);
+}
+
+void TCPCongestionControl::on_exit_fast_recovery(u32 flight_size)
+{
+    // RFC 6582, 3.2, step 3: Set cwnd to min (ssthresh, max(FlightSize, SMSS) + SMSS).
+    set_congestion_window(min<u64>(m_slow_start_threshold, static_cast<u64>(max(flight_size, m_mss)) + m_mss));
+}
+
+void TCPCongestionControl::on_retransmit_timeout(u32 flight_size, MonotonicTime now, bool is_first_timeout)
+{
+    // RFC 5681, 3.1: ssthresh must only be reduced once for consecutive timeouts of the same segment.
+    if (is_first_timeout)
+        m_slow_start_threshold = slow_start_threshold_after_loss(flight_size, now);
+    set_congestion_window(m_mss);
+    reset_after_timeout();
+}
+
+u32 TCPNewRenoCongestionControl::slow_start_threshold_after_loss(u32 flight_size, MonotonicTime)
+{
+    // RFC 5681, 3.1: ssthresh = max (FlightSize / 2, 2*SMSS)
+    m_bytes_acked = 0;
+    return max(flight_size / 2, 2 * m_mss);
+}
+
+void TCPNewRenoCongestionControl::increase_in_congestion_avoidance(u32 acked_bytes, MonotonicTime, Duration)
+{
+    // RFC 3465, 2.1: Grow by one segment once a full window worth of bytes has been acknowledged.
+    m_bytes_acked += acked_bytes;
+    if (m_bytes_acked < m_congestion_window)
+        return;
+    m_bytes_acked -= m_congestion_window;
+    set_congestion_window(static_cast<u64>(m_congestion_window) + m_mss);
+}
+
+static u64 integer_cube_root(u64 value)
+{
+    // 2642245 is the largest number whose cube fits in 64 bits.
+    u64 low = 0;
+    u64 high = 2642245;
+    while (low < high) {
+        u64 middle = (low + high + 1) / 2;
+        if (middle * middle * middle <= value)
+            low = middle;
+        else
+            high = middle - 1;
+    }
+    return low;
+}
+
+// RFC 9438, 4.1: C = 0.4 and beta_cubic = 0.7, expressed as fractions of ten.
+static constexpr u64 cubic_c_tenths = 4;
+static constexpr u64 cubic_beta_tenths = 7;
+// RFC 9438, 4.3: alpha_cubic = 3 * (1 - beta_cubic) / (1 + beta_cubic), in thousandths.
+static constexpr u64 cubic_alpha_thousandths = 529;
+
+u32 TCPCubicCongestionControl::slow_start_threshold_after_loss(u32, MonotonicTime)
+{
+    m_epoch_start.clear();
+
+    // RFC 9438, 4.7: Fast convergence releases bandwidth to new flows
+    // when the window stopped growing before reaching the previous maximum.
+    if (m_congestion_window < m_last_window_max) {
+        m_last_window_max = m_congestion_window;
+        m_window_max = static_cast<u32>(static_cast<u64>(m_congestion_window) * (10 + cubic_beta_tenths) / 20);
+    } else {
+        m_last_window_max = m_congestion_window;
+        m_window_max = m_congestion_window;
+    }
+
+    return max(static_cast<u32>(static_cast<u64>(m_congestion_window) * cubic_beta_tenths / 10), 2 * m_mss);
+}
+
+void TCPCubicCongestionControl::reset_after_timeout()
+{
+    m_epoch_start.clear();
+}
+
+void TCPCubicCongestionControl::increase_in_congestion_avoidance(u32 acked_bytes, MonotonicTime now, Duration smoothed_rtt)
+{
+    if (!m_epoch_start.has_value()) {
+        m_epoch_start = now;
+        m_window_estimate = m_congestion_window;
+        if (m_congestion_window < m_window_max) {
+            // K = cubic_root((W_max - cwnd_epoch) / C), converted from segments and seconds to bytes and milliseconds.
+            u64 deficit = m_window_max - m_congestion_window;
+            m_k_ms = static_cast<i64>(integer_cube_root(deficit * 10 * 1'000'000'000 / (cubic_c_tenths * m_mss)));
+        } else {
+            m_k_ms = 0;
+            m_window_max = m_congestion_window;
+        }
+    }
+
+    // RFC 9438, 4.2: Aim for the window that the cubic function reaches one round trip from now.
+    i64 t_ms = (now - *m_epoch_start).to_milliseconds() + smoothed_rtt.to_milliseconds();
+    i64 delta_ms = clamp<i64>(t_ms - m_k_ms, -100'000, 100'000);
+    i64 cube = delta_ms * delta_ms * delta_ms;
+    i64 offset = cube / 1000 * static_cast<i64>(cubic_c_tenths * m_mss) / 10 / 1'000'000;
+    i64 target = static_cast<i64>(m_window_max) + offset;
+    target = clamp<i64>(target, m_congestion_window, static_cast<i64>(m_congestion_window) * 3 / 2);
+
+    // RFC 9438, 4.3: In the Reno-friendly region, grow at least as fast as Reno would.
+    m_window_estimate += static_cast<u64>(acked_bytes) * m_mss * cubic_alpha_thousandths / 1000 / m_congestion_window;
+    if (m_window_estimate > static_cast<u64>(target)) {
+        set_congestion_window(m_window_estimate);
+        return;
+    }
+
+    // RFC 9438, 4.4: cwnd += (W_cubic(t + RTT) - cwnd) / cwnd for every acknowledged segment.
+    u64 increase = static_cast<u64>(target - m_congestion_window) * acked_bytes / m_congestion_window;
+    set_congestion_window(static_cast<u64>(m_congestion_window) + increase);
+}
+
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Error.h>
+#include <AK/NonnullOwnPtr.h>
+#include <AK/NumericLimits.h>
+#include <AK/Optional.h>
+#include <AK/StringView.h>
+#include <AK/Time.h>
+
+namespace Kernel {
+
+// Decides how much unacknowledged data a TCP connection may have in flight.
+// TCPSocket reports acknowledgements and losses, and the algorithm adjusts the congestion window in response.
+// All window sizes are in bytes.
+class TCPCongestionControl {
+public:
+    enum class Algorithm {
+        NewReno,
+        Cubic,
+    };
+
+    static constexpr Algorithm default_algorithm = Algorithm::Cubic;
+
+    static StringView to_string(Algorithm);
+    static Optional<Algorithm> algorithm_from_name(StringView);
+
+    static ErrorOr<NonnullOwnPtr<TCPCongestionControl>> try_create(Algorithm, u32 mss);
+
+    virtual ~TCPCongestionControl() = default;
+
+    virtual Algorithm algorithm() const = 0;
+
+    u32 congestion_window() const { return m_congestion_window; }
+    u32 slow_start_threshold() const { return m_slow_start_threshold; }
+    u32 mss() const { return m_mss; }
+    bool is_in_slow_start() const { return m_congestion_window < m_slow_start_threshold; }
+
+    void set_mss(u32 mss);
+
+    // Called for every ACK that acknowledges new data while not in fast recovery.
+    void on_ack(u32 acked_bytes, MonotonicTime now, Duration smoothed_rtt);
+
+    // RFC 5681, 3.2: The third duplicate ACK triggers fast retransmit and fast recovery.
+    void on_enter_fast_recovery(u32 flight_size, MonotonicTime now);
+    void on_duplicate_ack_during_fast_recovery();
+    // RFC 6582, 3.2: An ACK that acknowledges some but not all of the data outstanding when recovery started.
+    void on_partial_ack(u32 acked_bytes);
+    void on_exit_fast_recovery(u32 flight_size);
+
+    // RFC 5681, 3.1: After a retransmission timeout the window collapses to a single segment.
+    void on_retransmit_timeout(u32 flight_size, MonotonicTime now, bool is_first_timeout);
+
+protected:
+    explicit TCPCongestionControl(u32 mss);
+
+    // RFC 6928: The initial window is 10 segments.
+    static constexpr u32 initial_window_segments = 10;
+    static constexpr u32 maximum_congestion_window = 16 * MiB;
+
+    virtual u32 slow_start_threshold_after_loss(u32 flight_size, MonotonicTime now) = 0;
+    virtual void increase_in_congestion_avoidance(u32 acked_bytes, MonotonicTime now, Duration smoothed_rtt) = 0;
+    virtual void reset_after_timeout() { }
+
+    void set_congestion_window(u64);
+
+    u32 m_mss { 0 };
+    u32 m_congestion_window { 0 };
+    u32 m_slow_start_threshold { NumericLimits<u32>::max() };
+};
+
+// RFC 5681 and RFC 6582: Additive increase by one segment per round trip, halving on loss.
+class TCPNewRenoCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPNewRenoCongestionControl(u32 mss)
+        : TCPCongestionControl(mss)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::NewReno; }
+
+private:
+    virtual u32 slow_start_threshold_after_loss(u32 flight_size, MonotonicTime now) override;
+    virtual void increase_in_congestion_avoidance(u32 acked_bytes, MonotonicTime now, Duration smoothed_rtt) override;
+
+    // RFC 3465: Appropriate byte counting.
+    u32 m_bytes_acked { 0 };
+};
+
+// RFC 9438: The window grows as a cubic function of the time since the last loss,
+// which makes growth independent of the round-trip time on long fat networks.
+class TCPCubicCongestionControl final : public TCPCongestionControl {
+public:
+    explicit TCPCubicCongestionControl(u32 mss)
+        : TCPCongestionControl(mss)
+    {
+    }
+
+    virtual Algorithm algorithm() const override { return Algorithm::Cubic; }
+
+private:
+    virtual u32 slow_start_threshold_after_loss(u32 flight_size, MonotonicTime now) override;
+    virtual void increase_in_congestion_avoidance(u32 acked_bytes, MonotonicTime now, Duration smoothed_rtt) override;
+    virtual void reset_after_timeout() override;
+
+    // The window just before the last reduction.
+    u32 m_window_max { 0 };
+    u32 m_last_window_max { 0 };
+    // The window estimated for Reno-style growth, to stay TCP-friendly on short round trips.
+    u64 m_window_estimate { 0 };
+    Optional<MonotonicTime> m_epoch_start;
+    // Time it takes the cubic function to reach m_window_max again.
+    i64 m_k_ms { 0 };
+};
+
+}
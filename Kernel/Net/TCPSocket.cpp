@@ -24,6 +24,17 @@
 
 namespace Kernel {
 
+// RFC 9293, 3.4: Sequence numbers wrap around, so they have to be compared modulo 2^32.
+static bool sequence_number_less_than(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) < 0;
+}
+
+static bool sequence_number_less_than_or_equal(u32 a, u32 b)
+{
+    return static_cast<i32>(a - b) <= 0;
+}
+
 void TCPSocket::for_each(Function<void(TCPSocket const&)> callback)
 {
     sockets_by_tuple().for_each_shared([&](auto const& it) {
@@ -153,6 +164,15 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create_client(IPv4Address const
         auto receive_buffer = TRY(try_create_receive_buffer());
         auto client = TRY(TCPSocket::try_create(protocol(), move(receive_buffer)));
 
+        // Accepted connections inherit the congestion control algorithm of the listening socket.
+        auto algorithm = congestion_control_algorithm();
+        if (algorithm != client->congestion_control_algorithm()) {
+            auto congestion_control = TRY(TCPCongestionControl::try_create(algorithm, default_mss));
+            client->m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+                unacked_packets.congestion_control = move(congestion_control);
+            });
+        }
+
         client->set_setup_state(SetupState::InProgress);
         client->set_local_address(new_local_address);
         client->set_local_port(new_local_port);
@@ -185,12 +205,16 @@ void TCPSocket::release_for_accept(NonnullRefPtr<TCPSocket> socket)
     [[maybe_unused]] auto rc = queue_connection_from(move(socket));
 }
 
-TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer)
+TCPSocket::TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullRefPtr<Timer> retransmit_timer, NonnullOwnPtr<TCPCongestionControl> congestion_control)
     : IPv4Socket(SOCK_STREAM, protocol, move(receive_buffer), move(scratch_buffer))
     , m_last_ack_sent_time(TimeManagement::the().monotonic_time())
-    , m_last_retransmit_time(TimeManagement::the().monotonic_time())
+    , m_retransmit_timer_start(TimeManagement::the().monotonic_time())
     , m_timer(timer)
+    , m_retransmit_timer(retransmit_timer)
 {
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        unacked_packets.congestion_control = move(congestion_control);
+    });
 }
 
 TCPSocket::~TCPSocket()
@@ -205,7 +229,9 @@ ErrorOr<NonnullRefPtr<TCPSocket>> TCPSocket::try_create(int protocol, NonnullOwn
     // Note: Scratch buffer is only used for SOCK_STREAM sockets.
     auto scratch_buffer = TRY(KBuffer::try_create_with_size("TCPSocket: Scratch buffer"sv, 65536));
     auto timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
-    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer));
+    auto retransmit_timer = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) Timer));
+    auto congestion_control = TRY(TCPCongestionControl::try_create(TCPCongestionControl::default_algorithm, default_mss));
+    return adopt_nonnull_ref_or_enomem(new (nothrow) TCPSocket(protocol, move(receive_buffer), move(scratch_buffer), timer, retransmit_timer, move(congestion_control)));
 }
 
 ErrorOr<size_t> TCPSocket::protocol_size(ReadonlyBytes raw_ipv4_packet)
@@ -227,12 +253,63 @@ ErrorOr<size_t> TCPSocket::protocol_receive(ReadonlyBytes raw_ipv4_packet, UserO
 }
 
 ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t data_length)
+{
+    return send_data(data_length, [&](Bytes payload) {
+        return data.read(payload.data(), payload.size());
+    });
+}
+
+ErrorOr<size_t> TCPSocket::send_from_file(OpenFileDescription&, OpenFileDescription& source, u64 offset, size_t size)
+{
+    if (is_shut_down_for_writing())
+        return set_so_error(EPIPE);
+
+    MutexLocker locker(mutex());
+    if (!is_connected())
+        return set_so_error(EPIPE);
+
+    // NOTE: The file is read straight into the packet buffer. For files in the page cache this is
+    //       the only copy the data ever sees on its way out.
+    auto nsent = TRY(send_data(size, [&](Bytes payload) -> ErrorOr<void> {
+        auto buffer = UserOrKernelBuffer::for_kernel_buffer(payload.data());
+        auto nread = TRY(source.read(buffer, offset, payload.size()));
+        // The file was truncated underneath us.
+        if (nread != payload.size())
+            return EIO;
+        return {};
+    }));
+    Thread::current()->did_ipv4_socket_write(nsent);
+    return nsent;
+}
+
+ErrorOr<size_t> TCPSocket::send_data(size_t data_length, Function<ErrorOr<void>(Bytes)> const& write_payload)
 {
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     RoutingDecision routing_decision = route_to(peer_address(), local_address(), adapter);
     if (routing_decision.is_zero())
         return set_so_error(EHOSTUNREACH);
-    size_t mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    size_t mss = send_mss(routing_decision);
+
+    // Never put more data into the network than both the peer and the congestion window allow.
+    size_t space_in_window = 0;
+    size_t segmentation_size = 0;
+    bool has_data_in_flight = false;
+    m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        unacked_packets.congestion_control->set_mss(mss);
+        segmentation_size = send_segmentation_size(unacked_packets, mss);
+        auto window = send_window(unacked_packets);
+        auto in_flight = unacked_packets.bytes_in_flight();
+        space_in_window = window > in_flight ? window - in_flight : 0;
+        has_data_in_flight = in_flight > 0;
+    });
+    if (!has_data_in_flight) {
+        // RFC 9293, 3.8.6.1: With nothing in flight, a zero window is probed with a single byte,
+        // which the retransmission timer keeps resending until the window opens up.
+        space_in_window = max<size_t>(space_in_window, 1);
+    } else if (space_in_window < min(data_length, mss)) {
+        // Avoid the silly window syndrome: Wait for room for a full segment while there is data in flight.
+        return set_so_error(EAGAIN);
+    }
 
     if (!m_no_delay) {
         // RFC 896 (Nagle’s algorithm): https://www.ietf.org/rfc/rfc0896
@@ -246,8 +323,8 @@ ErrorOr<size_t> TCPSocket::protocol_send(UserOrKernelBuffer const& data, size_t
             return set_so_error(EAGAIN);
     }
 
-    data_length = min(data_length, mss);
-    TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, &data, data_length, &routing_decision));
+    data_length = min(min(data_length, segmentation_size), space_in_window);
+    TRY(send_tcp_packet(TCPFlags::PSH | TCPFlags::ACK, data_length, &routing_decision, write_payload));
     return data_length;
 }
 
@@ -259,6 +336,15 @@ ErrorOr<void> TCPSocket::send_ack(bool allow_duplicate)
 }
 
 ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* payload, size_t payload_size, RoutingDecision* user_routing_decision)
+{
+    if (!payload)
+        return send_tcp_packet(flags, payload_size, user_routing_decision, {});
+    return send_tcp_packet(flags, payload_size, user_routing_decision, [&](Bytes payload_bytes) {
+        return payload->read(payload_bytes.data(), payload_bytes.size());
+    });
+}
+
+ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, size_t payload_size, RoutingDecision* user_routing_decision, Function<ErrorOr<void>(Bytes)> const& write_payload)
 {
     auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
     RoutingDecision routing_decision = user_routing_decision ? *user_routing_decision : route_to(peer_address(), local_address(), adapter);
@@ -269,7 +355,11 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     bool const has_mss_option = flags & TCPFlags::SYN;
     bool const has_window_scale_option = flags & TCPFlags::SYN;
-    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0) + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0);
+    // We always offer SACK in our own SYN, but only agree to it in a SYN-ACK if the peer offered it first.
+    bool const has_sack_permitted_option = (flags & TCPFlags::SYN) && (!(flags & TCPFlags::ACK) || m_sack_permitted);
+    size_t const options_size = (has_mss_option ? sizeof(TCPOptionMSS) : 0)
+        + (has_window_scale_option ? sizeof(TCPOptionWindowScale) : 0)
+        + (has_sack_permitted_option ? sizeof(TCPOptionSACKPermitted) : 0);
     size_t const tcp_header_size = sizeof(TCPPacket) + align_up_to(options_size, 4);
     size_t const buffer_size = ipv4_payload_offset + tcp_header_size + payload_size;
     auto packet = routing_decision.adapter->acquire_packet_buffer(buffer_size);
@@ -287,12 +377,13 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
     if ((flags & TCPFlags::SYN) == 0 && m_window_scaling_supported)
         window_size >>= receive_window_scale();
     tcp_packet.set_window_size(min(window_size, NumericLimits<u16>::max()));
+    auto const sequence_number = m_sequence_number;
     tcp_packet.set_sequence_number(m_sequence_number);
     tcp_packet.set_data_offset(tcp_header_size / sizeof(u32));
     tcp_packet.set_flags(flags);
 
-    if (payload) {
-        if (auto result = payload->read(tcp_packet.payload(), payload_size); result.is_error()) {
+    if (write_payload) {
+        if (auto result = write_payload({ tcp_packet.payload(), payload_size }); result.is_error()) {
             routing_decision.adapter->release_packet_buffer(*packet);
             return set_so_error(result.release_error());
         }
@@ -322,22 +413,56 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
         memcpy(next_option, &window_scale_option, sizeof(window_scale_option));
         next_option += sizeof(window_scale_option);
     }
+    if (has_sack_permitted_option) {
+        TCPOptionSACKPermitted sack_permitted_option;
+        memcpy(next_option, &sack_permitted_option, sizeof(sack_permitted_option));
+        next_option += sizeof(sack_permitted_option);
+    }
     if ((options_size % 4) != 0)
         *next_option = to_underlying(TCPOptionKind::End);
 
-    tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    PacketOffloads offloads {
+        .tcp_header_offset = static_cast<u16>(ipv4_payload_offset),
+        .tcp_header_size = static_cast<u16>(tcp_header_size),
+        .needs_tcp_checksum = false,
+        .tcp_segment_size = 0,
+    };
+    if (auto mss = send_mss(routing_decision); payload_size > mss)
+        offloads.tcp_segment_size = mss;
+    // Segments get their own checksums, so there's no point in computing one for the whole packet.
+    if (offloads.tcp_segment_size != 0 || routing_decision.adapter->has_offload(NetworkAdapter::Offload::TransmitChecksum)) {
+        offloads.needs_tcp_checksum = true;
+        tcp_packet.set_checksum(compute_tcp_pseudo_header_checksum(local_address(), peer_address(), tcp_header_size + payload_size));
+    } else {
+        tcp_packet.set_checksum(compute_tcp_checksum(local_address(), peer_address(), tcp_packet, payload_size));
+    }
 
     bool expect_ack { tcp_packet.has_syn() || payload_size > 0 };
     if (expect_ack) {
         bool append_failed { false };
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
-            auto result = unacked_packets.packets.try_append({ m_sequence_number, packet, ipv4_payload_offset, *routing_decision.adapter });
+            auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+            bool was_empty = unacked_packets.packets.is_empty();
+            OutgoingPacket outgoing_packet {
+                .sequence_number = sequence_number,
+                .ack_number = m_sequence_number,
+                .payload_size = payload_size,
+                .buffer = packet,
+                .ipv4_payload_offset = ipv4_payload_offset,
+                .offloads = offloads,
+                .adapter = *routing_decision.adapter,
+                .sent_time = now,
+            };
+            auto result = unacked_packets.packets.try_append(move(outgoing_packet));
             if (result.is_error()) {
                 dbgln("TCPSocket: Dropped outbound packet because try_append() failed");
                 append_failed = true;
                 return;
             }
             unacked_packets.size += payload_size;
+            // RFC 6298, 5.1: Start the timer if it isn't running already.
+            if (was_empty)
+                m_retransmit_timer_start = now;
             enqueue_for_retransmit();
         });
         if (append_failed)
@@ -346,7 +471,7 @@ ErrorOr<void> TCPSocket::send_tcp_packet(u16 flags, UserOrKernelBuffer const* pa
 
     m_packets_out++;
     m_bytes_out += buffer_size;
-    routing_decision.adapter->send_packet(packet->bytes());
+    routing_decision.adapter->send_packet(packet->bytes(), offloads);
     if (!expect_ack)
         routing_decision.adapter->release_packet_buffer(*packet);
 
@@ -357,39 +482,136 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
 {
     if (packet.has_ack()) {
         u32 ack_number = packet.ack_number();
+        size_t payload_size = size - packet.header_size();
 
         dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet: {}", ack_number);
 
-        int removed = 0;
+        auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+
         m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+            auto& congestion_control = *unacked_packets.congestion_control;
+
+            // The window in a SYN segment is never scaled (RFC 7323, 2.2).
+            u32 window_size = packet.window_size();
+            if (!packet.has_syn())
+                window_size <<= m_send_window_scale;
+
+            u32 first_unacked = unacked_packets.packets.is_empty() ? m_sequence_number : unacked_packets.packets.first().sequence_number;
+            if (sequence_number_less_than(ack_number, first_unacked)) {
+                // This is an old ACK that was overtaken by newer ones.
+                return;
+            }
+
+            // RFC 5681, 2: A duplicate ACK acknowledges nothing new, carries no data and doesn't change the window.
+            bool is_duplicate_ack = !unacked_packets.packets.is_empty()
+                && ack_number == first_unacked
+                && payload_size == 0
+                && !packet.has_syn()
+                && !packet.has_fin()
+                && window_size == m_send_window_size;
+
+            m_send_window_size = window_size;
+
+            if (m_sack_permitted)
+                process_sack_blocks(packet, unacked_packets);
+
+            int removed = 0;
+            size_t acked_bytes = 0;
+            Optional<Duration> rtt_sample;
             while (!unacked_packets.packets.is_empty()) {
                 auto& packet = unacked_packets.packets.first();
 
                 dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: iterate: {}", packet.ack_number);
 
-                if (packet.ack_number <= ack_number) {
-                    auto old_adapter = packet.adapter.strong_ref();
-                    if (old_adapter)
-                        old_adapter->release_packet_buffer(*packet.buffer);
-                    TCPPacket& tcp_packet = *(TCPPacket*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                    if (m_send_window_size != tcp_packet.window_size()) {
-                        m_send_window_size = tcp_packet.window_size() << m_send_window_scale;
+                if (!sequence_number_less_than_or_equal(packet.ack_number, ack_number))
+                    break;
+
+                // RFC 6298, 3: Karn's algorithm: Don't take samples from retransmitted packets, since we can't tell which copy was acknowledged.
+                if (packet.tx_counter == 0)
+                    rtt_sample = now - packet.sent_time;
+
+                auto old_adapter = packet.adapter.strong_ref();
+                if (old_adapter)
+                    old_adapter->release_packet_buffer(*packet.buffer);
+                unacked_packets.size -= packet.payload_size;
+                if (packet.sacked)
+                    unacked_packets.sacked_size -= packet.payload_size;
+                if (packet.lost)
+                    unacked_packets.lost_size -= packet.payload_size;
+                acked_bytes += packet.payload_size;
+                unacked_packets.packets.take_first();
+                removed++;
+            }
+
+            // Packets that are split into segments on their way out get acknowledged a few segments at a time.
+            // Account for those right away, or the congestion window would only grow once per packet.
+            if (!unacked_packets.packets.is_empty()) {
+                auto& packet = unacked_packets.packets.first();
+                if (packet.payload_size > 0 && sequence_number_less_than(packet.sequence_number, ack_number)) {
+                    u32 newly_acked_size = ack_number - packet.sequence_number;
+                    VERIFY(newly_acked_size < packet.payload_size);
+                    if (packet.tx_counter == 0)
+                        rtt_sample = now - packet.sent_time;
+                    packet.sequence_number = ack_number;
+                    packet.payload_size -= newly_acked_size;
+                    unacked_packets.size -= newly_acked_size;
+                    if (packet.sacked)
+                        unacked_packets.sacked_size -= newly_acked_size;
+                    if (packet.lost)
+                        unacked_packets.lost_size -= newly_acked_size;
+                    acked_bytes += newly_acked_size;
+                }
+            }
+
+            if (removed > 0 || acked_bytes > 0) {
+                m_received_duplicate_acks = 0;
+                m_retransmit_attempts = 0;
+                // RFC 6298, 5.3: Restart the timer whenever new data is acknowledged.
+                m_retransmit_timer_start = now;
+                if (rtt_sample.has_value())
+                    update_retransmit_timeout(*rtt_sample);
+
+                if (m_recovery_point.has_value()) {
+                    if (sequence_number_less_than_or_equal(*m_recovery_point, ack_number)) {
+                        congestion_control.on_exit_fast_recovery(unacked_packets.bytes_in_flight());
+                        m_recovery_point.clear();
+                    } else {
+                        // RFC 6582, 3.2, step 3: A partial ACK means the next packet was lost as well.
+                        congestion_control.on_partial_ack(acked_bytes);
+                        mark_lost_packets(unacked_packets, true);
                     }
-                    auto payload_size = packet.buffer->buffer->data() + packet.buffer->buffer->size() - (u8*)tcp_packet.payload();
-                    unacked_packets.size -= payload_size;
-                    evaluate_block_conditions();
-                    unacked_packets.packets.take_first();
-                    removed++;
                 } else {
-                    break;
+                    congestion_control.on_ack(acked_bytes, now, m_smoothed_rtt.value_or(m_retransmit_timeout));
+                }
+            } else if (is_duplicate_ack) {
+                ++m_received_duplicate_acks;
+                if (m_recovery_point.has_value()) {
+                    congestion_control.on_duplicate_ack_during_fast_recovery();
+                    if (m_sack_permitted)
+                        mark_lost_packets(unacked_packets, false);
+                } else if (m_received_duplicate_acks == duplicate_ack_threshold) {
+                    dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) entering fast recovery at {}", this, ack_number);
+                    m_recovery_point = m_sequence_number;
+                    congestion_control.on_enter_fast_recovery(unacked_packets.bytes_in_flight(), now);
+                    // RFC 5681, 3.2: Fast retransmit: The first unacknowledged packet goes out right away.
+                    mark_lost_packets(unacked_packets, true);
+                    retransmit_lost_packets(unacked_packets, true);
+                    if (m_sack_permitted)
+                        mark_lost_packets(unacked_packets, false);
                 }
             }
 
+            retransmit_lost_packets(unacked_packets, false);
+
             if (unacked_packets.packets.is_empty()) {
                 m_retransmit_attempts = 0;
+                m_recovery_point.clear();
                 dequeue_for_retransmit();
             }
 
+            if (removed > 0 || acked_bytes > 0 || is_duplicate_ack)
+                evaluate_block_conditions();
+
             dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket: receive_tcp_packet acknowledged {} packets", removed);
         });
     }
@@ -398,6 +620,95 @@ void TCPSocket::receive_tcp_packet(TCPPacket const& packet, u16 size)
     m_bytes_in += packet.header_size() + size;
 }
 
+void TCPSocket::process_sack_blocks(TCPPacket const& packet, UnackedPackets& unacked_packets)
+{
+    packet.for_each_option([&](auto const& option) {
+        if (option.kind() != TCPOptionKind::SACK)
+            return;
+        if ((option.length() - sizeof(TCPOption)) % sizeof(TCPOptionSACK::Block) != 0)
+            return;
+        auto const& sack_option = static_cast<TCPOptionSACK const&>(option);
+        for (size_t i = 0; i < sack_option.block_count(); ++i) {
+            u32 left_edge = sack_option.block(i).left_edge;
+            u32 right_edge = sack_option.block(i).right_edge;
+            if (!sequence_number_less_than(left_edge, right_edge))
+                continue;
+            for (auto& outgoing_packet : unacked_packets.packets) {
+                if (outgoing_packet.sacked || outgoing_packet.payload_size == 0)
+                    continue;
+                if (sequence_number_less_than(outgoing_packet.sequence_number, left_edge))
+                    continue;
+                if (sequence_number_less_than(right_edge, outgoing_packet.ack_number))
+                    break;
+                outgoing_packet.sacked = true;
+                unacked_packets.sacked_size += outgoing_packet.payload_size;
+                if (outgoing_packet.lost) {
+                    outgoing_packet.lost = false;
+                    unacked_packets.lost_size -= outgoing_packet.payload_size;
+                }
+            }
+        }
+    });
+}
+
+void TCPSocket::mark_lost_packets(UnackedPackets& unacked_packets, bool only_first)
+{
+    auto mark_lost = [&](OutgoingPacket& packet) {
+        if (packet.sacked || packet.lost)
+            return;
+        packet.lost = true;
+        unacked_packets.lost_size += packet.payload_size;
+    };
+
+    if (unacked_packets.packets.is_empty())
+        return;
+
+    if (only_first) {
+        mark_lost(unacked_packets.packets.first());
+        return;
+    }
+
+    // RFC 6675, 4: Everything below the highest SACKed sequence number that hasn't been SACKed itself
+    // is a hole, and presumed lost. Packets that were already retransmitted once are left to the timer.
+    Optional<u32> highest_sacked;
+    for (auto& packet : unacked_packets.packets) {
+        if (packet.sacked)
+            highest_sacked = packet.ack_number;
+    }
+    if (!highest_sacked.has_value())
+        return;
+
+    for (auto& packet : unacked_packets.packets) {
+        if (!sequence_number_less_than(packet.sequence_number, *highest_sacked))
+            break;
+        if (packet.tx_counter == 0)
+            mark_lost(packet);
+    }
+}
+
+void TCPSocket::retransmit_lost_packets(UnackedPackets& unacked_packets, bool ignore_congestion_window)
+{
+    if (unacked_packets.lost_size == 0 && !ignore_congestion_window)
+        return;
+
+    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
+    auto routing_decision = route_to(peer_address(), local_address(), adapter);
+    if (routing_decision.is_zero())
+        return;
+
+    auto congestion_window = unacked_packets.congestion_control->congestion_window();
+    for (auto& packet : unacked_packets.packets) {
+        if (!packet.lost)
+            continue;
+        if (!ignore_congestion_window && unacked_packets.bytes_in_flight() + packet.payload_size > congestion_window)
+            break;
+        ignore_congestion_window = false;
+        packet.lost = false;
+        unacked_packets.lost_size -= packet.payload_size;
+        retransmit_packet(packet, routing_decision);
+    }
+}
+
 bool TCPSocket::should_delay_next_ack() const
 {
     // FIXME: We don't know the MSS here so make a reasonable guess.
@@ -463,6 +774,24 @@ NetworkOrdered<u16> TCPSocket::compute_tcp_checksum(IPv4Address const& source, I
     return ~(checksum & 0xffff);
 }
 
+NetworkOrdered<u16> TCPSocket::compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length)
+{
+    struct [[gnu::packed]] PseudoHeader {
+        IPv4Address source;
+        IPv4Address destination;
+        u8 zero;
+        u8 protocol;
+        NetworkOrdered<u16> tcp_length;
+    };
+    static_assert(sizeof(PseudoHeader) == 12);
+
+    PseudoHeader pseudo_header { source, destination, 0, (u8)TransportProtocol::TCP, tcp_length };
+    InternetChecksum checksum;
+    checksum.add({ &pseudo_header, sizeof(pseudo_header) });
+    u16 complemented_checksum = checksum.finish();
+    return static_cast<u16>(~complemented_checksum);
+}
+
 ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*> user_value, socklen_t user_value_size)
 {
     if (level != IPPROTO_TCP)
@@ -480,6 +809,23 @@ ErrorOr<void> TCPSocket::setsockopt(int level, int option, Userspace<void const*
             return EINVAL;
         m_no_delay = value;
         return {};
+    case TCP_CONGESTION: {
+        if (user_value_size == 0 || user_value_size > TCP_CA_NAME_MAX)
+            return EINVAL;
+        char name_buffer[TCP_CA_NAME_MAX];
+        TRY(copy_from_user(name_buffer, static_ptr_cast<char const*>(user_value), user_value_size));
+        auto name = StringView { name_buffer, strnlen(name_buffer, user_value_size) };
+        auto algorithm = TCPCongestionControl::algorithm_from_name(name);
+        if (!algorithm.has_value())
+            return ENOENT;
+        return m_unacked_packets.with_exclusive([&](auto& unacked_packets) -> ErrorOr<void> {
+            auto& current = *unacked_packets.congestion_control;
+            if (current.algorithm() == *algorithm)
+                return {};
+            unacked_packets.congestion_control = TRY(TCPCongestionControl::try_create(*algorithm, current.mss()));
+            return {};
+        });
+    }
     default:
         dbgln("setsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -505,6 +851,16 @@ ErrorOr<void> TCPSocket::getsockopt(OpenFileDescription& description, int level,
         size = sizeof(nodelay);
         return copy_to_user(value_size, &size);
     }
+    case TCP_CONGESTION: {
+        auto name = TCPCongestionControl::to_string(congestion_control_algorithm());
+        if (size <= name.length())
+            return EINVAL;
+        char name_buffer[TCP_CA_NAME_MAX] {};
+        memcpy(name_buffer, name.characters_without_null_termination(), name.length());
+        size = min<socklen_t>(size, sizeof(name_buffer));
+        TRY(copy_to_user(static_ptr_cast<char*>(value), name_buffer, size));
+        return copy_to_user(value_size, &size);
+    }
     default:
         dbgln("getsockopt({}) at IPPROTO_TCP not implemented.", option);
         return ENOPROTOOPT;
@@ -678,95 +1034,265 @@ ErrorOr<void> TCPSocket::close()
     return result;
 }
 
-static Singleton<MutexProtected<TCPSocket::RetransmitList>> s_sockets_for_retransmit;
+static Singleton<SpinlockProtected<TCPSocket::RetransmitList, LockRank::None>> s_sockets_due_for_retransmit;
 
-MutexProtected<TCPSocket::RetransmitList>& TCPSocket::sockets_for_retransmit()
+SpinlockProtected<TCPSocket::RetransmitList, LockRank::None>& TCPSocket::sockets_due_for_retransmit()
 {
-    return *s_sockets_for_retransmit;
+    return *s_sockets_due_for_retransmit;
+}
+
+Duration TCPSocket::backed_off_retransmit_timeout() const
+{
+    // RFC 6298, 5.5: Back off the timer exponentially for every retransmission - even for SYN packets (RFC 1122).
+    auto retransmit_timeout = m_retransmit_timeout;
+    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts && retransmit_timeout < maximum_retransmit_timeout; i++)
+        retransmit_timeout = retransmit_timeout + retransmit_timeout;
+    return min(retransmit_timeout, maximum_retransmit_timeout);
 }
 
 void TCPSocket::enqueue_for_retransmit()
 {
-    sockets_for_retransmit().with_exclusive([&](auto& list) {
+    auto generation = sockets_due_for_retransmit().with([&](auto&) -> Optional<u32> {
+        // If the timer already expired, retransmit_packets() will start it again once it has handled that.
+        if (m_retransmit_timer_state != RetransmitTimerState::Idle)
+            return {};
+        m_retransmit_timer_state = RetransmitTimerState::Pending;
+        return ++m_retransmit_timer_generation;
+    });
+    if (!generation.has_value())
+        return;
+
+    // NOTE: The timer isn't restarted when m_retransmit_timer_start moves, which happens on every ACK.
+    //       Instead, retransmit_packets() notices that it fired early and starts it again for the rest of the time.
+    auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+    auto remaining = (m_retransmit_timer_start + backed_off_retransmit_timeout()) - now;
+    auto deadline = TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE) + remaining;
+    auto timer_was_added = TimerQueue::the().add_timer_without_id(*m_retransmit_timer, CLOCK_MONOTONIC_COARSE, deadline, retransmit_timer_slack, [this, generation = generation.value()]() {
+        retransmit_timer_expired(generation);
+    });
+    if (!timer_was_added)
+        retransmit_timer_expired(generation.value());
+}
+
+void TCPSocket::retransmit_timer_expired(u32 generation)
+{
+    // NOTE: This runs from the timer's deferred call, so we can't take the socket's mutex here.
+    //       The socket stays alive until this returns, since dequeue_for_retransmit() cancels the timer first.
+    bool is_due = sockets_due_for_retransmit().with([&](auto& list) {
+        // The timer was stopped (and maybe started again) after it had already fired.
+        if (m_retransmit_timer_state != RetransmitTimerState::Pending || m_retransmit_timer_generation != generation)
+            return false;
+        m_retransmit_timer_state = RetransmitTimerState::Due;
         list.append(*this);
+        return true;
     });
+    if (is_due)
+        NetworkTask::wake_for_retransmit();
 }
 
 void TCPSocket::dequeue_for_retransmit()
 {
-    sockets_for_retransmit().with_exclusive([&](auto& list) {
-        list.remove(*this);
+    auto previous_state = sockets_due_for_retransmit().with([&](auto& list) {
+        auto previous_state = exchange(m_retransmit_timer_state, RetransmitTimerState::Idle);
+        if (previous_state != RetransmitTimerState::Idle)
+            ++m_retransmit_timer_generation;
+        // The network task may already have taken us off the list, it will notice that we're no longer due.
+        if (m_retransmit_list_node.is_in_list())
+            list.remove(*this);
+        return previous_state;
     });
+    // NOTE: Cancel the timer before anyone can start it again, which needs our mutex.
+    if (previous_state == RetransmitTimerState::Pending)
+        TimerQueue::the().cancel_timer(*m_retransmit_timer);
 }
 
 void TCPSocket::retransmit_packets()
 {
-    auto now = TimeManagement::the().monotonic_time();
+    // We might have been dequeued (and maybe enqueued again) after the timer expired.
+    bool was_due = sockets_due_for_retransmit().with([&](auto&) {
+        if (m_retransmit_timer_state != RetransmitTimerState::Due)
+            return false;
+        m_retransmit_timer_state = RetransmitTimerState::Idle;
+        return true;
+    });
+    if (!was_due)
+        return;
 
-    // RFC6298 says we should have at least one second between retransmits. According to
-    // RFC1122 we must do exponential backoff - even for SYN packets.
-    i64 retransmit_interval = 1;
-    for (decltype(m_retransmit_attempts) i = 0; i < m_retransmit_attempts; i++)
-        retransmit_interval *= 2;
+    auto now = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+    auto retransmit_timeout = backed_off_retransmit_timeout();
 
-    if (m_last_retransmit_time > now - Duration::from_seconds(retransmit_interval))
+    if (now < m_retransmit_timer_start + retransmit_timeout) {
+        // The timer was restarted by an ACK since we armed it.
+        enqueue_for_retransmit();
         return;
+    }
 
     dbgln_if(TCP_SOCKET_DEBUG, "TCPSocket({}) handling retransmit", this);
 
-    m_last_retransmit_time = now;
+    m_retransmit_timer_start = now;
     ++m_retransmit_attempts;
 
-    if (m_retransmit_attempts > maximum_retransmits) {
+    bool is_connecting = m_state == State::SynSent || m_state == State::SynReceived;
+    if (m_retransmit_attempts > (is_connecting ? maximum_syn_retransmits : maximum_retransmits)) {
         set_state(TCPSocket::State::Closed);
         set_error(TCPSocket::Error::RetransmitTimeout);
         set_setup_state(Socket::SetupState::Completed);
         return;
     }
 
-    auto adapter = bound_interface().with([](auto& bound_device) -> RefPtr<NetworkAdapter> { return bound_device; });
-    auto routing_decision = route_to(peer_address(), local_address(), adapter);
-    if (routing_decision.is_zero())
-        return;
-
     m_unacked_packets.with_exclusive([&](auto& unacked_packets) {
+        if (unacked_packets.packets.is_empty())
+            return;
+
+        unacked_packets.congestion_control->on_retransmit_timeout(unacked_packets.bytes_in_flight(), now, m_retransmit_attempts == 1);
+        m_recovery_point.clear();
+        m_received_duplicate_acks = 0;
+
+        // RFC 2018, 8: The receiver is allowed to discard SACKed data, so after a timeout we start over
+        // and consider everything that is still unacknowledged lost. The first packet goes out now,
+        // and the rest follow as ACKs open up the congestion window again.
         for (auto& packet : unacked_packets.packets) {
-            packet.tx_counter++;
-
-            if constexpr (TCP_SOCKET_DEBUG) {
-                auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
-                dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
-                    local_address(), local_port(),
-                    peer_address(), peer_port(),
-                    (tcp_packet.has_syn() ? "SYN " : ""),
-                    (tcp_packet.has_ack() ? "ACK " : ""),
-                    (tcp_packet.has_fin() ? "FIN " : ""),
-                    (tcp_packet.has_rst() ? "RST " : ""),
-                    tcp_packet.sequence_number(),
-                    tcp_packet.ack_number(),
-                    packet.tx_counter);
-            }
+            packet.sacked = false;
+            packet.lost = true;
+        }
+        unacked_packets.sacked_size = 0;
+        unacked_packets.lost_size = unacked_packets.size;
+        retransmit_lost_packets(unacked_packets, true);
+        // RFC 6298, 5.6: Start the retransmission timer again.
+        enqueue_for_retransmit();
+    });
+}
 
-            size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
-            if (ipv4_payload_offset != packet.ipv4_payload_offset) {
-                // FIXME: Add support for this. This can happen if after a route change
-                // we ended up on another adapter which doesn't have the same layer 2 type
-                // like the previous adapter.
-                VERIFY_NOT_REACHED();
-            }
+void TCPSocket::retransmit_packet(OutgoingPacket& packet, RoutingDecision const& routing_decision)
+{
+    packet.tx_counter++;
+    packet.sent_time = TimeManagement::the().monotonic_time(TimePrecision::Precise);
+    m_retransmitted_packets++;
+
+    if constexpr (TCP_SOCKET_DEBUG) {
+        auto& tcp_packet = *(TCPPacket const*)(packet.buffer->buffer->data() + packet.ipv4_payload_offset);
+        dbgln("Sending TCP packet from {}:{} to {}:{} with ({}{}{}{}) seq_no={}, ack_no={}, tx_counter={}",
+            local_address(), local_port(),
+            peer_address(), peer_port(),
+            (tcp_packet.has_syn() ? "SYN " : ""),
+            (tcp_packet.has_ack() ? "ACK " : ""),
+            (tcp_packet.has_fin() ? "FIN " : ""),
+            (tcp_packet.has_rst() ? "RST " : ""),
+            tcp_packet.sequence_number(),
+            tcp_packet.ack_number(),
+            packet.tx_counter);
+    }
+
+    size_t ipv4_payload_offset = routing_decision.adapter->ipv4_payload_offset();
+    if (ipv4_payload_offset != packet.ipv4_payload_offset) {
+        // FIXME: Add support for this. This can happen if after a route change
+        // we ended up on another adapter which doesn't have the same layer 2 type
+        // like the previous adapter.
+        VERIFY_NOT_REACHED();
+    }
+
+    auto packet_buffer = packet.buffer->bytes();
+
+    routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
+        local_address(), routing_decision.next_hop, peer_address(),
+        TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
+    routing_decision.adapter->send_packet(packet_buffer, packet.offloads);
+    m_packets_out++;
+    m_bytes_out += packet_buffer.size();
+}
+
+void TCPSocket::update_retransmit_timeout(Duration rtt_sample)
+{
+    // RFC 6298, 2
+    static constexpr i64 clock_granularity_us = 10'000;
+
+    i64 sample_us = rtt_sample.to_microseconds();
+    i64 smoothed_rtt_us;
+    i64 rtt_variance_us;
+    if (!m_smoothed_rtt.has_value()) {
+        smoothed_rtt_us = sample_us;
+        rtt_variance_us = sample_us / 2;
+    } else {
+        smoothed_rtt_us = m_smoothed_rtt->to_microseconds();
+        rtt_variance_us = m_rtt_variance.to_microseconds();
+        rtt_variance_us = (3 * rtt_variance_us + AK::abs(smoothed_rtt_us - sample_us)) / 4;
+        smoothed_rtt_us = (7 * smoothed_rtt_us + sample_us) / 8;
+    }
+    m_smoothed_rtt = Duration::from_microseconds(smoothed_rtt_us);
+    m_rtt_variance = Duration::from_microseconds(rtt_variance_us);
+
+    // NOTE: RFC 6298 asks for a minimum of one second, but like most other stacks we go lower,
+    //       since waiting a whole second on a LAN leaves the link idle for far too long.
+    auto retransmit_timeout = Duration::from_microseconds(smoothed_rtt_us + max(clock_granularity_us, 4 * rtt_variance_us));
+    m_retransmit_timeout = clamp(retransmit_timeout, minimum_retransmit_timeout, maximum_retransmit_timeout);
+}
+
+u32 TCPSocket::send_mss(RoutingDecision const& routing_decision) const
+{
+    u32 local_mss = routing_decision.adapter->mtu() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    return min(local_mss, m_peer_mss);
+}
+
+u32 TCPSocket::send_segmentation_size(UnackedPackets const& unacked_packets, u32 mss) const
+{
+    // Big packets are cheaper to send, but when one segment is lost the whole packet goes out again.
+    // Keep them at a quarter of the congestion window, so a loss doesn't cost more than that.
+    u32 size = min(maximum_segmentation_payload_size, unacked_packets.congestion_control->congestion_window() / 4);
+    return max(mss, size - size % mss);
+}
 
-            auto packet_buffer = packet.buffer->bytes();
+u32 TCPSocket::send_window(UnackedPackets const& unacked_packets) const
+{
+    return min(m_send_window_size, unacked_packets.congestion_control->congestion_window());
+}
 
-            routing_decision.adapter->fill_in_ipv4_header(*packet.buffer,
-                local_address(), routing_decision.next_hop, peer_address(),
-                TransportProtocol::TCP, packet_buffer.size() - ipv4_payload_offset, type_of_service(), ttl());
-            routing_decision.adapter->send_packet(packet_buffer);
-            m_packets_out++;
-            m_bytes_out += packet_buffer.size();
+void TCPSocket::apply_syn_options(TCPPacket const& packet)
+{
+    VERIFY(packet.has_syn());
+    m_peer_mss = default_mss;
+    m_sack_permitted = false;
+    packet.for_each_option([&](auto const& option) {
+        switch (option.kind()) {
+        case TCPOptionKind::WindowScale: {
+            if (option.length() != sizeof(TCPOptionWindowScale))
+                return;
+            auto scale = static_cast<TCPOptionWindowScale const&>(option).value();
+            if (scale > 14)
+                return; // Maximum allowed as per RFC7323
+            set_send_window_scale(scale);
+            return;
+        }
+        case TCPOptionKind::MSS:
+            if (option.length() != sizeof(TCPOptionMSS))
+                return;
+            m_peer_mss = max<u32>(static_cast<TCPOptionMSS const&>(option).value(), 64);
+            return;
+        case TCPOptionKind::SACKPermitted:
+            if (option.length() != sizeof(TCPOptionSACKPermitted))
+                return;
+            m_sack_permitted = true;
+            return;
+        default:
+            return;
         }
     });
 }
 
+TCPCongestionControl::Algorithm TCPSocket::congestion_control_algorithm() const
+{
+    return m_unacked_packets.with_shared([](auto const& unacked_packets) { return unacked_packets.congestion_control->algorithm(); });
+}
+
+u32 TCPSocket::congestion_window() const
+{
+    return m_unacked_packets.with_shared([](auto const& unacked_packets) { return unacked_packets.congestion_control->congestion_window(); });
+}
+
+u32 TCPSocket::slow_start_threshold() const
+{
+    return m_unacked_packets.with_shared([](auto const& unacked_packets) { return unacked_packets.congestion_control->slow_start_threshold(); });
+}
+
 bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size) const
 {
     if (!IPv4Socket::can_write(file_description, size))
@@ -775,11 +1301,12 @@ bool TCPSocket::can_write(OpenFileDescription const& file_description, u64 size)
     if (m_state == State::SynSent || m_state == State::SynReceived)
         return false;
 
-    if (!file_description.is_blocking())
-        return true;
-
+    // NOTE: This has to agree with send_data(), or writers would spin on EAGAIN.
     return m_unacked_packets.with_shared([&](auto& unacked_packets) {
-        return unacked_packets.size + size <= m_send_window_size;
+        auto in_flight = unacked_packets.bytes_in_flight();
+        if (in_flight == 0)
+            return true;
+        return in_flight + unacked_packets.congestion_control->mss() <= send_window(unacked_packets);
     });
 }
 }
@@ -14,7 +14,11 @@
 #include <AK/Time.h>
 #include <Kernel/Library/LockWeakPtr.h>
 #include <Kernel/Locking/MutexProtected.h>
+#include <Kernel/Locking/SpinlockProtected.h>
 #include <Kernel/Net/IP/Socket.h>
+#include <Kernel/Net/NetworkAdapter.h>
+#include <Kernel/Net/TCP.h>
+#include <Kernel/Net/TCPCongestionControl.h>
 #include <Kernel/Time/TimerQueue.h>
 
 namespace Kernel {
@@ -143,6 +147,17 @@ public:
         m_send_window_scale = scale;
     }
 
+    // Picks up the window scale, MSS and SACK-permitted options from the peer's SYN.
+    void apply_syn_options(TCPPacket const&);
+
+    TCPCongestionControl::Algorithm congestion_control_algorithm() const;
+    u32 congestion_window() const;
+    u32 slow_start_threshold() const;
+    Optional<Duration> smoothed_rtt() const { return m_smoothed_rtt; }
+    Duration retransmit_timeout() const { return m_retransmit_timeout; }
+    u32 retransmitted_packets() const { return m_retransmitted_packets; }
+    bool is_sack_permitted() const { return m_sack_permitted; }
+
     // FIXME: Make this configurable?
     static constexpr u32 maximum_duplicate_acks = 5;
     void set_duplicate_acks(u32 acks) { m_duplicate_acks = acks; }
@@ -150,6 +165,7 @@ public:
 
     ErrorOr<void> send_ack(bool allow_duplicate = false);
     ErrorOr<void> send_tcp_packet(u16 flags, UserOrKernelBuffer const* = nullptr, size_t = 0, RoutingDecision* = nullptr);
+    ErrorOr<void> send_tcp_packet(u16 flags, size_t payload_size, RoutingDecision*, Function<ErrorOr<void>(Bytes)> const& write_payload);
     void receive_tcp_packet(TCPPacket const&, u16 size);
 
     bool should_delay_next_ack() const;
@@ -170,8 +186,11 @@ public:
     virtual ErrorOr<void> close() override;
 
     virtual bool can_write(OpenFileDescription const&, u64) const override;
+    virtual ErrorOr<size_t> send_from_file(OpenFileDescription&, OpenFileDescription& source, u64 offset, size_t) override;
 
     static NetworkOrdered<u16> compute_tcp_checksum(IPv4Address const& source, IPv4Address const& destination, TCPPacket const&, u16 payload_size);
+    // The uncomplemented checksum of the pseudo header alone, which is where checksum offloading picks up.
+    static NetworkOrdered<u16> compute_tcp_pseudo_header_checksum(IPv4Address const& source, IPv4Address const& destination, u16 tcp_length);
 
     virtual ErrorOr<void> setsockopt(int level, int option, Userspace<void const*>, socklen_t) override;
     virtual ErrorOr<void> getsockopt(OpenFileDescription&, int level, int option, Userspace<void*>, Userspace<socklen_t*>) override;
@@ -180,13 +199,14 @@ protected:
     void set_direction(Direction direction) { m_direction = direction; }
 
 private:
-    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer);
+    explicit TCPSocket(int protocol, NonnullOwnPtr<DoubleBuffer> receive_buffer, NonnullOwnPtr<KBuffer> scratch_buffer, NonnullRefPtr<Timer> timer, NonnullRefPtr<Timer> retransmit_timer, NonnullOwnPtr<TCPCongestionControl>);
     virtual StringView class_name() const override { return "TCPSocket"sv; }
 
     virtual void shut_down_for_writing() override;
 
     virtual ErrorOr<size_t> protocol_receive(ReadonlyBytes raw_ipv4_packet, UserOrKernelBuffer& buffer, size_t buffer_size, int flags) override;
     virtual ErrorOr<size_t> protocol_send(UserOrKernelBuffer const&, size_t) override;
+    ErrorOr<size_t> send_data(size_t, Function<ErrorOr<void>(Bytes)> const& write_payload);
     virtual ErrorOr<void> protocol_connect(OpenFileDescription&) override;
     virtual ErrorOr<size_t> protocol_size(ReadonlyBytes raw_ipv4_packet) override;
     virtual bool protocol_is_disconnected() const override;
@@ -197,6 +217,20 @@ private:
 
     void enqueue_for_retransmit();
     void dequeue_for_retransmit();
+    void retransmit_timer_expired(u32 generation);
+    Duration backed_off_retransmit_timeout() const;
+
+    struct OutgoingPacket;
+    struct UnackedPackets;
+
+    u32 send_mss(RoutingDecision const&) const;
+    u32 send_segmentation_size(UnackedPackets const&, u32 mss) const;
+    u32 send_window(UnackedPackets const&) const;
+    void update_retransmit_timeout(Duration rtt_sample);
+    void process_sack_blocks(TCPPacket const&, UnackedPackets&);
+    void mark_lost_packets(UnackedPackets&, bool only_first);
+    void retransmit_lost_packets(UnackedPackets&, bool ignore_congestion_window);
+    void retransmit_packet(OutgoingPacket&, RoutingDecision const&);
 
     static constexpr size_t receive_window_scale()
     {
@@ -220,31 +254,85 @@ private:
     u32 m_bytes_out { 0 };
 
     struct OutgoingPacket {
+        u32 sequence_number { 0 };
+        // The sequence number that acknowledges this packet.
         u32 ack_number { 0 };
+        size_t payload_size { 0 };
         RefPtr<PacketWithTimestamp> buffer;
         size_t ipv4_payload_offset;
+        PacketOffloads offloads;
         LockWeakPtr<NetworkAdapter> adapter;
+        MonotonicTime sent_time;
         int tx_counter { 0 };
+        // The peer has told us that it holds this packet, but can't acknowledge it yet because of a hole before it.
+        bool sacked { false };
+        // The packet is presumed lost and waits to be retransmitted.
+        bool lost { false };
     };
 
     struct UnackedPackets {
         SinglyLinkedList<OutgoingPacket> packets;
         size_t size { 0 };
+        size_t sacked_size { 0 };
+        size_t lost_size { 0 };
+        // NOTE: The congestion state lives here so that it is only ever accessed with this lock held.
+        OwnPtr<TCPCongestionControl> congestion_control;
+
+        // RFC 6675: The "pipe", i.e. an estimate of how many bytes are still in the network.
+        size_t bytes_in_flight() const { return size - sacked_size - lost_size; }
     };
 
     MutexProtected<UnackedPackets> m_unacked_packets;
 
+    // Receiver side: how many duplicate ACKs we have sent for out-of-order data.
     u32 m_duplicate_acks { 0 };
 
+    // Sender side: how many duplicate ACKs the peer has sent us in a row.
+    static constexpr u32 duplicate_ack_threshold = 3;
+    u32 m_received_duplicate_acks { 0 };
+    // While in fast recovery, the highest sequence number sent when recovery began.
+    Optional<u32> m_recovery_point;
+
+    // RFC 9293, 3.7.1: Without an MSS option, the peer must be assumed to accept 536 byte segments.
+    static constexpr u32 default_mss = 536;
+    // Data packets carry no options, and their IPv4 length field has to fit in 16 bits even before segmentation.
+    static constexpr u32 maximum_segmentation_payload_size = NumericLimits<u16>::max() - sizeof(IPv4Packet) - sizeof(TCPPacket);
+    u32 m_peer_mss { default_mss };
+    bool m_sack_permitted { false };
+
+    // RFC 6298: Retransmission timer.
+    static constexpr Duration initial_retransmit_timeout = Duration::from_seconds(1);
+    static constexpr Duration minimum_retransmit_timeout = Duration::from_milliseconds(200);
+    static constexpr Duration maximum_retransmit_timeout = Duration::from_seconds(60);
+    // Retransmission timers of different sockets that expire this close to each other are handled together.
+    static constexpr Duration retransmit_timer_slack = Duration::from_milliseconds(20);
+    Optional<Duration> m_smoothed_rtt;
+    Duration m_rtt_variance;
+    Duration m_retransmit_timeout { initial_retransmit_timeout };
+    u32 m_retransmitted_packets { 0 };
+
     u32 m_last_ack_number_sent { 0 };
     MonotonicTime m_last_ack_sent_time;
 
     static constexpr Duration maximum_segment_lifetime = Duration::from_seconds(120);
 
     // FIXME: Make this configurable (sysctl)
-    static constexpr u32 maximum_retransmits = 5;
-    MonotonicTime m_last_retransmit_time;
+    static constexpr u32 maximum_retransmits = 15;
+    static constexpr u32 maximum_syn_retransmits = 5;
+    MonotonicTime m_retransmit_timer_start;
     u32 m_retransmit_attempts { 0 };
+    enum class RetransmitTimerState {
+        Idle,
+        // The retransmission timer is running.
+        Pending,
+        // The timer expired, and the socket is waiting for the network task to retransmit.
+        Due,
+    };
+    // NOTE: These are protected by the sockets_due_for_retransmit() lock, since the timer can't take our mutex.
+    //       The generation changes every time the timer is started or stopped, so that a timer callback or a
+    //       list entry that is left over from before can tell that it's stale.
+    RetransmitTimerState m_retransmit_timer_state { RetransmitTimerState::Idle };
+    u32 m_retransmit_timer_generation { 0 };
 
     // Default to maximum window size. receive_tcp_packet() will update from the
     // peer's advertised window size.
@@ -259,10 +347,12 @@ private:
     Optional<IPv4SocketTuple> m_registered_socket_tuple;
 
     NonnullRefPtr<Timer> m_timer;
+    NonnullRefPtr<Timer> m_retransmit_timer;
 
 public:
     using RetransmitList = IntrusiveList<&TCPSocket::m_retransmit_list_node>;
-    static MutexProtected<TCPSocket::RetransmitList>& sockets_for_retransmit();
+    // Sockets whose retransmission timer expired, waiting for the network task to handle them.
+    static SpinlockProtected<TCPSocket::RetransmitList, LockRank::None>& sockets_due_for_retransmit();
 };
 
 }
@@ -4,8 +4,11 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/ScopeGuard.h>
+#include <Kernel/Arch/Delay.h>
 #include <Kernel/Bus/PCI/IDs.h>
 #include <Kernel/Bus/VirtIO/Transport/PCIe/TransportLink.h>
+#include <Kernel/Net/NetworkTask.h>
 #include <Kernel/Net/NetworkingManagement.h>
 #include <Kernel/Net/VirtIO/VirtIONetworkAdapter.h>
 
@@ -48,8 +51,8 @@ static constexpr u16 VIRTIO_NET_S_LINK_UP = 1;
 static constexpr u16 VIRTIO_NET_S_ANNOUNCE = 2;
 
 static constexpr u8 VIRTIO_NET_HDR_F_NEEDS_CSUM = 1;
-static constexpr u8 VIRTIO_NET_HDR_F_DATA_VALID = 1;
-static constexpr u8 VIRTIO_NET_HDR_F_RSC_INFO = 1;
+static constexpr u8 VIRTIO_NET_HDR_F_DATA_VALID = 2;
+static constexpr u8 VIRTIO_NET_HDR_F_RSC_INFO = 4;
 static constexpr u8 VIRTIO_NET_HDR_GSO_NONE = 0;
 static constexpr u8 VIRTIO_NET_HDR_GSO_TCPV4 = 1;
 static constexpr u8 VIRTIO_NET_HDR_GSO_UDP = 3;
@@ -69,6 +72,16 @@ struct [[gnu::packed]] VirtIONetConfig {
     LittleEndian<u32> supported_hash_types;
 };
 
+static constexpr u8 VIRTIO_NET_CTRL_MQ = 4;
+static constexpr u8 VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET = 0;
+static constexpr u8 VIRTIO_NET_OK = 0;
+
+struct [[gnu::packed]] VirtIONetCtrlMQPairsSet {
+    u8 command_class;
+    u8 command;
+    LittleEndian<u16> virtqueue_pairs;
+};
+
 struct [[gnu::packed]] VirtIONetHdr {
     u8 flags;
     u8 gso_type;
@@ -84,12 +97,17 @@ struct [[gnu::packed]] VirtIONetHdr {
 
 using namespace VirtIO;
 
-static constexpr u16 RECEIVEQ = 0;
+// Queue pair N consists of receiveqN (2 * N) and transmitqN (2 * N + 1), the control queue comes after the last pair.
+static constexpr u16 receive_queue_index(u16 receive_ring) { return 2 * receive_ring; }
 static constexpr u16 TRANSMITQ = 1;
 
 static constexpr size_t MAX_RX_FRAME_SIZE = 1514; // Non-jumbo Ethernet frame limit.
-static constexpr size_t RX_BUFFER_SIZE = sizeof(VirtIONetHdr) * MAX_RX_FRAME_SIZE;
+static constexpr size_t RX_BUFFER_SIZE = sizeof(VirtIONetHdr) + MAX_RX_FRAME_SIZE;
+static constexpr size_t TX_RING_SIZE = 2 * MiB;
 static constexpr u16 MAX_INFLIGHT_PACKETS = 128;
+// Every queue pair needs its own memory, so don't enable multiqueue on devices that want an unreasonable amount of them.
+static constexpr u16 MAX_SUPPORTED_QUEUE_PAIRS = 64;
+static constexpr size_t CONTROL_COMMAND_TIMEOUT_US = 100'000;
 
 UNMAP_AFTER_INIT ErrorOr<bool> VirtIONetworkAdapter::probe(PCI::DeviceIdentifier const& pci_device_identifier)
 {
@@ -115,8 +133,7 @@ UNMAP_AFTER_INIT VirtIONetworkAdapter::VirtIONetworkAdapter(StringView interface
 
 UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize(Badge<NetworkingManagement>)
 {
-    m_rx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Rx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
-    m_tx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Tx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS));
+    m_tx_buffers = TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Tx buffer"sv, TX_RING_SIZE));
 
     return initialize_virtio_resources();
 }
@@ -127,8 +144,16 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
     TRY(Device::initialize_virtio_resources());
     m_device_config = TRY(transport_entity().get_config(VirtIO::ConfigurationType::Device));
 
+    u16 max_queue_pairs = 1;
     TRY(negotiate_features([&](u64 supported_features) {
         u64 negotiated = 0;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_MQ | VIRTIO_NET_F_CTRL_VQ)) {
+            max_queue_pairs = transport_entity().config_read16(*m_device_config, offsetof(VirtIONetConfig, max_virtqueue_pairs));
+            if (max_queue_pairs > 1 && max_queue_pairs <= MAX_SUPPORTED_QUEUE_PAIRS)
+                negotiated |= VIRTIO_NET_F_MQ | VIRTIO_NET_F_CTRL_VQ;
+            else
+                max_queue_pairs = 1;
+        }
         if (is_feature_set(supported_features, VIRTIO_NET_F_STATUS))
             negotiated |= VIRTIO_NET_F_STATUS;
         if (is_feature_set(supported_features, VIRTIO_NET_F_MAC))
@@ -137,30 +162,104 @@ UNMAP_AFTER_INIT ErrorOr<void> VirtIONetworkAdapter::initialize_virtio_resources
             negotiated |= VIRTIO_NET_F_SPEED_DUPLEX;
         if (is_feature_set(supported_features, VIRTIO_NET_F_MTU))
             negotiated |= VIRTIO_NET_F_MTU;
+        if (is_feature_set(supported_features, VIRTIO_NET_F_CSUM)) {
+            negotiated |= VIRTIO_NET_F_CSUM;
+            // Segmentation requires checksum offloading, since every segment needs a new checksum.
+            if (is_feature_set(supported_features, VIRTIO_NET_F_HOST_TSO4))
+                negotiated |= VIRTIO_NET_F_HOST_TSO4;
+        }
+        if (is_feature_set(supported_features, VIRTIO_NET_F_GUEST_CSUM))
+            negotiated |= VIRTIO_NET_F_GUEST_CSUM;
         return negotiated;
     }));
 
     TRY(handle_device_config_change());
-    TRY(setup_queues(2)); // receive & transmit
+
+    auto offloads = Offload::None;
+    if (is_feature_accepted(VIRTIO_NET_F_CSUM))
+        offloads |= Offload::TransmitChecksum;
+    if (is_feature_accepted(VIRTIO_NET_F_HOST_TSO4))
+        offloads |= Offload::TCPSegmentation;
+    if (is_feature_accepted(VIRTIO_NET_F_GUEST_CSUM))
+        offloads |= Offload::ReceiveChecksum;
+    set_offloads(offloads);
+
+    if (is_feature_accepted(VIRTIO_NET_F_MQ)) {
+        // The control queue always comes after the maximum number of queue pairs, even if we use fewer of them.
+        m_control_queue_index = 2 * max_queue_pairs;
+        m_queue_pairs = min<u16>(max_queue_pairs, min<size_t>(Processor::count(), NetworkTask::maximum_worker_count));
+        m_control_buffer = TRY(MM.allocate_contiguous_kernel_region(PAGE_SIZE, "VirtIONetworkAdapter Control"sv, Memory::Region::Access::ReadWrite));
+        TRY(setup_queues(*m_control_queue_index + 1));
+    } else {
+        TRY(setup_queues(2)); // receive & transmit
+    }
+
+    for (u16 receive_ring = 0; receive_ring < m_queue_pairs; ++receive_ring)
+        TRY(m_rx_buffers.try_append(TRY(Memory::RingBuffer::try_create("VirtIONetworkAdapter Rx buffer"sv, RX_BUFFER_SIZE * MAX_INFLIGHT_PACKETS))));
 
     finish_init();
 
-    {
-        // Supply receive buffers.
-        auto& rx_queue = get_queue(RECEIVEQ);
-        SpinlockLocker queue_lock(rx_queue.lock());
-        VirtIO::QueueChain chain(rx_queue);
-        while (m_rx_buffers->available_bytes() > RX_BUFFER_SIZE) {
-            // We know that the RingBuffer will not wraparound in this loop. But it's still awkward.
-            auto buffer_start = MUST(m_rx_buffers->reserve_space(RX_BUFFER_SIZE));
-            VERIFY(chain.add_buffer_to_chain(buffer_start, RX_BUFFER_SIZE, VirtIO::BufferType::DeviceWritable));
-            supply_chain_and_notify(RECEIVEQ, chain);
+    for (u16 receive_ring = 0; receive_ring < m_queue_pairs; ++receive_ring)
+        supply_receive_buffers(receive_ring);
+
+    if (m_queue_pairs > 1) {
+        if (auto result = set_queue_pairs(m_queue_pairs); result.is_error()) {
+            dmesgln("VirtIONetworkAdapter: Failed to enable {} queue pairs: {}", m_queue_pairs, result.error());
+            m_queue_pairs = 1;
+        } else {
+            dmesgln("VirtIONetworkAdapter: Using {} queue pairs", m_queue_pairs);
         }
     }
 
     return {};
 }
 
+void VirtIONetworkAdapter::supply_receive_buffers(u16 receive_ring)
+{
+    auto queue_index = receive_queue_index(receive_ring);
+    auto& rx_queue = get_queue(queue_index);
+    auto& rx_buffers = *m_rx_buffers[receive_ring];
+    SpinlockLocker queue_lock(rx_queue.lock());
+    VirtIO::QueueChain chain(rx_queue);
+    while (rx_buffers.available_bytes() > RX_BUFFER_SIZE) {
+        // We know that the RingBuffer will not wraparound in this loop. But it's still awkward.
+        auto buffer_start = MUST(rx_buffers.reserve_space(RX_BUFFER_SIZE));
+        VERIFY(chain.add_buffer_to_chain(buffer_start, RX_BUFFER_SIZE, VirtIO::BufferType::DeviceWritable));
+        supply_chain_and_notify(queue_index, chain);
+    }
+}
+
+ErrorOr<void> VirtIONetworkAdapter::set_queue_pairs(u16 queue_pairs)
+{
+    auto& queue = get_queue(*m_control_queue_index);
+    queue.disable_interrupts();
+    SpinlockLocker lock(queue.lock());
+
+    auto* command = reinterpret_cast<VirtIONetCtrlMQPairsSet*>(m_control_buffer->vaddr().as_ptr());
+    command->command_class = VIRTIO_NET_CTRL_MQ;
+    command->command = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+    command->virtqueue_pairs = queue_pairs;
+    auto* ack = m_control_buffer->vaddr().offset(sizeof(VirtIONetCtrlMQPairsSet)).as_ptr();
+    *ack = 0xff;
+
+    auto buffer_start = m_control_buffer->physical_page(0)->paddr();
+    VirtIO::QueueChain chain { queue };
+    chain.add_buffer_to_chain(buffer_start, sizeof(VirtIONetCtrlMQPairsSet), VirtIO::BufferType::DeviceReadable);
+    chain.add_buffer_to_chain(buffer_start.offset(sizeof(VirtIONetCtrlMQPairsSet)), sizeof(u8), VirtIO::BufferType::DeviceWritable);
+    supply_chain_and_notify(*m_control_queue_index, chain);
+    full_memory_barrier();
+
+    ScopeGuard clear_used_buffers([&] {
+        queue.discard_used_buffers();
+    });
+    for (size_t elapsed_us = 0; elapsed_us < CONTROL_COMMAND_TIMEOUT_US; ++elapsed_us) {
+        if (queue.new_data_available())
+            return *ack == VIRTIO_NET_OK ? ErrorOr<void> {} : Error::from_errno(EIO);
+        microseconds_delay(1);
+    }
+    return Error::from_errno(EBUSY);
+}
+
 ErrorOr<void> VirtIONetworkAdapter::handle_device_config_change()
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: handle_device_config_change");
@@ -197,9 +296,16 @@ void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: handle_queue_update {}", queue_index);
 
-    if (queue_index == RECEIVEQ) {
+    if (queue_index == m_control_queue_index) {
+        // Control commands are waited for synchronously.
+        return;
+    }
+
+    if (queue_index % 2 == 0 && queue_index / 2 < m_rx_buffers.size()) {
         // FIXME: Disable interrupts while receiving as recommended by the spec.
-        auto& queue = get_queue(RECEIVEQ);
+        u16 receive_ring = queue_index / 2;
+        auto& rx_buffers = *m_rx_buffers[receive_ring];
+        auto& queue = get_queue(queue_index);
         SpinlockLocker queue_lock(queue.lock());
         size_t used;
         VirtIO::QueueChain popped_chain = queue.pop_used_buffer_chain(used);
@@ -207,12 +313,19 @@ void VirtIONetworkAdapter::handle_queue_update(u16 queue_index)
         while (!popped_chain.is_empty()) {
             VERIFY(popped_chain.length() == 1);
             popped_chain.for_each([&](PhysicalAddress addr, size_t length) {
-                size_t offset = addr.as_ptr() - m_rx_buffers->start_of_region().as_ptr();
-                auto* message = reinterpret_cast<VirtIONetHdr*>(m_rx_buffers->vaddr().offset(offset).as_ptr());
-                did_receive({ message->frame, length - sizeof(VirtIONetHdr) });
+                size_t offset = addr.as_ptr() - rx_buffers.start_of_region().as_ptr();
+                auto* message = reinterpret_cast<VirtIONetHdr*>(rx_buffers.vaddr().offset(offset).as_ptr());
+                // NOTE: With VIRTIO_NET_F_GUEST_CSUM, frames from the host may only carry partial checksums (VIRTIO_NET_HDR_F_NEEDS_CSUM).
+                //       That's fine, since we don't verify the checksums of incoming TCP packets ourselves.
+                ReadonlyBytes frame { message->frame, length - sizeof(VirtIONetHdr) };
+                // The device already keeps every flow on one receive queue, so there's no need to hash it again.
+                if (m_queue_pairs > 1)
+                    did_receive(frame, receive_ring);
+                else
+                    did_receive(frame);
             });
 
-            supply_chain_and_notify(RECEIVEQ, popped_chain);
+            supply_chain_and_notify(queue_index, popped_chain);
             popped_chain = queue.pop_used_buffer_chain(used);
         }
     } else if (queue_index == TRANSMITQ) {
@@ -256,7 +369,30 @@ static bool copy_data_to_chain(VirtIO::QueueChain& chain, Memory::RingBuffer& ri
 void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
 {
     dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw length={}", payload.size());
+    send_with_header(payload, {});
+}
+
+void VirtIONetworkAdapter::send_raw_with_offloads(ReadonlyBytes payload, PacketOffloads const& offloads)
+{
+    dbgln_if(VIRTIO_DEBUG, "VirtIONetworkAdapter: send_raw_with_offloads length={}, segment_size={}", payload.size(), offloads.tcp_segment_size);
+
+    VirtIONetHdr hdr {};
+    if (offloads.needs_tcp_checksum) {
+        hdr.flags = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+        hdr.csum_start = offloads.tcp_header_offset;
+        // The checksum field comes after the ports, the sequence and acknowledgement numbers, the flags and the window size.
+        hdr.csum_offset = 16;
+    }
+    if (offloads.tcp_segment_size != 0) {
+        hdr.gso_type = VIRTIO_NET_HDR_GSO_TCPV4;
+        hdr.gso_size = offloads.tcp_segment_size;
+        hdr.hdr_len = offloads.tcp_header_offset + offloads.tcp_header_size;
+    }
+    send_with_header(payload, hdr);
+}
 
+void VirtIONetworkAdapter::send_with_header(ReadonlyBytes payload, VirtIONetHdr const& hdr)
+{
     auto& queue = get_queue(TRANSMITQ);
     SpinlockLocker queue_lock(queue.lock());
     VirtIO::QueueChain chain(queue);
@@ -269,8 +405,7 @@ void VirtIONetworkAdapter::send_raw(ReadonlyBytes payload)
     }
 
     // FIXME: Handle errors from pushing to the chain and rewind the RingBuffer.
-    VirtIONetHdr hdr {};
-    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8*>(&hdr), sizeof(hdr)));
+    VERIFY(copy_data_to_chain(chain, *m_tx_buffers, reinterpret_cast<u8 const*>(&hdr), sizeof(hdr)));
     VERIFY(copy_data_to_chain(chain, *m_tx_buffers, payload.data(), payload.size()));
 
     supply_chain_and_notify(TRANSMITQ, chain);
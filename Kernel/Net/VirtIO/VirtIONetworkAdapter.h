@@ -12,6 +12,10 @@
 
 namespace Kernel {
 
+namespace VirtIO {
+struct VirtIONetHdr;
+}
+
 class VirtIONetworkAdapter
     : public VirtIO::Device
     , public NetworkAdapter {
@@ -42,6 +46,11 @@ private:
 
     // NetworkAdapter
     virtual void send_raw(ReadonlyBytes) override;
+    virtual void send_raw_with_offloads(ReadonlyBytes, PacketOffloads const&) override;
+
+    void send_with_header(ReadonlyBytes, VirtIO::VirtIONetHdr const&);
+    void supply_receive_buffers(u16 receive_ring);
+    ErrorOr<void> set_queue_pairs(u16);
 
 private:
     VirtIO::Configuration const* m_device_config { nullptr };
@@ -52,7 +61,13 @@ private:
     i32 m_link_speed { LINKSPEED_INVALID };
     bool m_link_duplex { false };
 
-    OwnPtr<Memory::RingBuffer> m_rx_buffers;
+    // With multiqueue, every queue pair gets its own receive ring, which is processed by its own NetworkTask worker.
+    // We only ever transmit on the first queue pair.
+    u16 m_queue_pairs { 1 };
+    Optional<u16> m_control_queue_index;
+    OwnPtr<Memory::Region> m_control_buffer;
+
+    Vector<NonnullOwnPtr<Memory::RingBuffer>> m_rx_buffers;
     OwnPtr<Memory::RingBuffer> m_tx_buffers;
 };
 
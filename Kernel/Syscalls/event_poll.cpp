@@ -0,0 +1,124 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <Kernel/API/POSIX/sys/event_poll.h>
+#include <Kernel/Debug.h>
+#include <Kernel/FileSystem/EventPoll.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+using BlockFlags = Thread::FileBlocker::BlockFlags;
+
+ErrorOr<FlatPtr> Process::sys$create_event_poll(u32 flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~EVENT_POLL_CLOEXEC)
+        return EINVAL;
+
+    auto event_poll = TRY(EventPoll::try_create());
+    auto description = TRY(OpenFileDescription::try_create(move(event_poll)));
+
+    description->set_readable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & EVENT_POLL_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$event_poll_ctl(Userspace<Syscall::SC_event_poll_ctl_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto event_poll_description = TRY(open_file_description(params.event_poll_fd));
+    auto* event_poll = event_poll_description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    if (params.op == EVENT_POLL_CTL_DEL) {
+        TRY(event_poll->remove(params.fd));
+        return 0;
+    }
+
+    if (params.op != EVENT_POLL_CTL_ADD && params.op != EVENT_POLL_CTL_MOD)
+        return EINVAL;
+
+    event_poll_event event {};
+    TRY(copy_from_user(&event, params.event));
+
+    if (params.op == EVENT_POLL_CTL_MOD) {
+        TRY(event_poll->modify(params.fd, event.events, event.data));
+        return 0;
+    }
+
+    auto description = TRY(open_file_description(params.fd));
+    TRY(event_poll->add(params.fd, *description, event.events, event.data));
+    return 0;
+}
+
+ErrorOr<FlatPtr> Process::sys$event_poll_wait(Userspace<Syscall::SC_event_poll_wait_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.max_events <= 0)
+        return EINVAL;
+    size_t max_events = min(static_cast<size_t>(params.max_events), static_cast<size_t>(FD_SETSIZE));
+
+    auto description = TRY(open_file_description(params.event_poll_fd));
+    auto* event_poll = description->event_poll();
+    if (!event_poll)
+        return EINVAL;
+
+    Thread::BlockTimeout timeout;
+    bool is_nonblocking = false;
+    if (params.timeout) {
+        auto timeout_time = TRY(copy_time_from_user(params.timeout));
+        is_nonblocking = timeout_time <= Duration::zero();
+        timeout = Thread::BlockTimeout(false, &timeout_time);
+    }
+
+    Vector<event_poll_event> events;
+    auto* current_thread = Thread::current();
+    for (;;) {
+        TRY(event_poll->collect_ready_events(events, max_events));
+        if (!events.is_empty() || is_nonblocking)
+            break;
+
+        // NOTE: The EventPoll is readable whenever its ready list is non-empty. Entries on the
+        //       ready list may turn out to not be ready after all, so we simply try again.
+        Thread::SelectBlocker::FDVector fds_info;
+        fds_info.unchecked_append({ description, BlockFlags::Read });
+
+        dbgln_if(POLL_SELECT_DEBUG, "Waiting on event poll fd {}, timeout={}", params.event_poll_fd, params.timeout);
+
+        auto block_result = current_thread->block<Thread::SelectBlocker>(timeout, fds_info);
+        if (block_result.was_interrupted())
+            return EINTR;
+        if (block_result == Thread::BlockResult::InterruptedByTimeout)
+            is_nonblocking = true;
+    }
+
+    if (!events.is_empty())
+        TRY(copy_n_to_user(params.events, events.data(), events.size()));
+
+    return events.size();
+}
+
+}
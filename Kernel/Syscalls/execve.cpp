@@ -563,8 +563,21 @@ ErrorOr<void> Process::do_exec(NonnullRefPtr<OpenFileDescription> main_program_d
         property = {};
     });
 
+    // NOTE: When the kernel creates the process for someone else (like for posix_spawn()), the current thread
+    //       isn't one of ours, and the process only has the one thread that will start running the new program.
     auto* current_thread = Thread::current();
-    current_thread->reset_signals_for_exec();
+    new_main_thread = nullptr;
+    if (&current_thread->process() == this) {
+        new_main_thread = current_thread;
+    } else {
+        for_each_thread([&](auto& thread) {
+            new_main_thread = &thread;
+            return IterationDecision::Break;
+        });
+    }
+    VERIFY(new_main_thread);
+
+    new_main_thread->reset_signals_for_exec();
 
     clear_signal_handlers_for_exec();
 
@@ -582,17 +595,6 @@ ErrorOr<void> Process::do_exec(NonnullRefPtr<OpenFileDescription> main_program_d
         m_fds.with_exclusive([&](auto& fds) { fds[main_program_fd_allocation->fd].set(move(main_program_description), FD_CLOEXEC); });
     }
 
-    new_main_thread = nullptr;
-    if (&current_thread->process() == this) {
-        new_main_thread = current_thread;
-    } else {
-        for_each_thread([&](auto& thread) {
-            new_main_thread = &thread;
-            return IterationDecision::Break;
-        });
-    }
-    VERIFY(new_main_thread);
-
     auto credentials = this->credentials();
     auto auxv = generate_auxiliary_vector(load_result.load_base, load_result.entry_eip, credentials->uid(), credentials->euid(), credentials->gid(), credentials->egid(), path->view(), main_program_fd_allocation);
 
@@ -957,28 +959,8 @@ ErrorOr<FlatPtr> Process::sys$execve(Userspace<Syscall::SC_execve_params const*>
 
         auto path = TRY(get_syscall_path_argument(params.path));
 
-        auto copy_user_strings = [](auto const& list, auto& output) -> ErrorOr<void> {
-            if (!list.length)
-                return {};
-            Checked<size_t> size = sizeof(*list.strings);
-            size *= list.length;
-            if (size.has_overflow())
-                return EOVERFLOW;
-            Vector<Syscall::StringArgument, 32> strings;
-            TRY(strings.try_resize(list.length));
-            TRY(copy_from_user(strings.data(), list.strings, size.value()));
-            for (size_t i = 0; i < list.length; ++i) {
-                auto string = TRY(try_copy_kstring_from_user(strings[i]));
-                TRY(output.try_append(move(string)));
-            }
-            return {};
-        };
-
-        Vector<NonnullOwnPtr<KString>> arguments;
-        TRY(copy_user_strings(params.arguments, arguments));
-
-        Vector<NonnullOwnPtr<KString>> environment;
-        TRY(copy_user_strings(params.environment, environment));
+        auto arguments = TRY(get_syscall_string_list_argument(params.arguments));
+        auto environment = TRY(get_syscall_string_list_argument(params.environment));
 
         TRY(exec(move(path), move(arguments), move(environment), new_main_thread, previous_interrupts_state));
     }
@@ -16,17 +16,17 @@
 
 namespace Kernel {
 
-ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+ErrorOr<Process::ProcessAndFirstThread> Process::create_forked_child()
 {
-    VERIFY_NO_PROCESS_BIG_LOCK(this);
-    TRY(require_promise(Pledge::proc));
-
     auto credentials = this->credentials();
     auto child_and_first_thread = TRY(Process::create_with_forked_name(credentials->uid(), credentials->gid(), pid(), m_is_kernel_process, vfs_root_context(), hostname_context(), current_directory(), executable(), tty(), this));
     auto& child = child_and_first_thread.process;
     auto& child_first_thread = child_and_first_thread.first_thread;
 
-    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+    ArmedScopeGuard thread_finalizer_guard = [&child, &child_first_thread]() {
+        // NOTE: Nobody got to see the child yet, so don't let its death show up as a waitable child of ours.
+        //       Its own PID can't be looked up, since it was never registered.
+        child->with_mutable_protected_data([](auto& protected_data) { protected_data.ppid = protected_data.pid; });
         SpinlockLocker lock(g_scheduler_lock);
         child_first_thread->detach();
         child_first_thread->set_state(Thread::State::Dying);
@@ -85,6 +85,25 @@ ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
     // A child process created via fork(2) inherits a copy of its parent's alternate signal stack settings.
     child_first_thread->m_alternative_signal_stack = Thread::current()->m_alternative_signal_stack;
 
+    thread_finalizer_guard.disarm();
+    return child_and_first_thread;
+}
+
+ErrorOr<FlatPtr> Process::sys$fork(RegisterState& regs)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::proc));
+
+    auto child_and_first_thread = TRY(create_forked_child());
+    auto& child = child_and_first_thread.process;
+    auto& child_first_thread = child_and_first_thread.first_thread;
+
+    ArmedScopeGuard thread_finalizer_guard = [&child_first_thread]() {
+        SpinlockLocker lock(g_scheduler_lock);
+        child_first_thread->detach();
+        child_first_thread->set_state(Thread::State::Dying);
+    };
+
     auto& child_regs = child_first_thread->m_regs;
 #if ARCH(X86_64)
     child_regs.rax = 0; // fork() returns 0 in the child :^)
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Array.h>
 #include <AK/Singleton.h>
 #include <Kernel/Debug.h>
 #include <Kernel/Memory/InodeVMObject.h>
@@ -13,23 +14,38 @@
 
 namespace Kernel {
 
-static Singleton<RecursiveSpinlockProtected<HashMap<GlobalFutexKey, NonnullLockRefPtr<FutexQueue>>, LockRank::None>> s_global_futex_queues;
+// Futex queues are spread over a fixed number of buckets, each with its own lock, so that
+// threads waiting on and waking unrelated futexes (in the same process or not) don't contend.
+static constexpr size_t futex_bucket_count = 256;
+
+struct alignas(64) FutexBucket {
+    SpinlockProtected<HashMap<GlobalFutexKey, NonnullLockRefPtr<FutexQueue>>, LockRank::None> queues {};
+};
+
+static Singleton<Array<FutexBucket, futex_bucket_count>> s_futex_buckets;
+
+static FutexBucket& futex_bucket_for(GlobalFutexKey const& futex_key)
+{
+    return (*s_futex_buckets)[Traits<GlobalFutexKey>::hash(futex_key) % futex_bucket_count];
+}
 
 void Process::clear_futex_queues_on_exec()
 {
-    s_global_futex_queues->with([this](auto& queues) {
-        auto const* address_space = this->address_space().with([](auto& space) { return space.ptr(); });
-        queues.remove_all_matching([address_space](auto& futex_key, auto& futex_queue) {
-            if ((futex_key.raw.offset & futex_key_private_flag) == 0)
-                return false;
-            if (futex_key.private_.address_space != address_space)
-                return false;
-            bool did_wake_all;
-            futex_queue->wake_all(did_wake_all);
-            VERIFY(did_wake_all); // No one should be left behind...
-            return true;
+    auto const* address_space = this->address_space().with([](auto& space) { return space.ptr(); });
+    for (auto& bucket : *s_futex_buckets) {
+        bucket.queues.with([address_space](auto& queues) {
+            queues.remove_all_matching([address_space](auto& futex_key, auto& futex_queue) {
+                if ((futex_key.raw.offset & futex_key_private_flag) == 0)
+                    return false;
+                if (futex_key.private_.address_space != address_space)
+                    return false;
+                bool did_wake_all;
+                futex_queue->wake_all(did_wake_all);
+                VERIFY(did_wake_all); // No one should be left behind...
+                return true;
+            });
         });
-    });
+    }
 }
 
 ErrorOr<GlobalFutexKey> Process::get_futex_key(FlatPtr user_address, bool shared)
@@ -90,7 +106,7 @@ ErrorOr<GlobalFutexKey> Process::get_futex_key(FlatPtr user_address, bool shared
 
 ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> user_params)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     auto params = TRY(copy_typed_from_user(user_params));
 
     Thread::BlockTimeout timeout;
@@ -105,9 +121,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
 
     switch (cmd) {
     case FUTEX_WAIT:
-    case FUTEX_WAIT_BITSET:
-    case FUTEX_REQUEUE:
-    case FUTEX_CMP_REQUEUE: {
+    case FUTEX_WAIT_BITSET: {
         if (params.timeout) {
             auto timeout_time = TRY(copy_time_from_user(params.timeout));
             bool is_absolute = cmd != FUTEX_WAIT;
@@ -126,7 +140,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
 
     auto find_futex_queue = [&](GlobalFutexKey futex_key, bool create_if_not_found, bool* did_create = nullptr) -> ErrorOr<LockRefPtr<FutexQueue>> {
         VERIFY(!create_if_not_found || did_create != nullptr);
-        return s_global_futex_queues->with([&](auto& queues) -> ErrorOr<LockRefPtr<FutexQueue>> {
+        return futex_bucket_for(futex_key).queues.with([&](auto& queues) -> ErrorOr<LockRefPtr<FutexQueue>> {
             auto it = queues.find(futex_key);
             if (it != queues.end())
                 return it->value;
@@ -141,7 +155,7 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
     };
 
     auto remove_futex_queue = [&](GlobalFutexKey futex_key) {
-        return s_global_futex_queues->with([&](auto& queues) {
+        return futex_bucket_for(futex_key).queues.with([&](auto& queues) {
             auto it = queues.find(futex_key);
             if (it == queues.end())
                 return;
@@ -173,16 +187,9 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         bool did_create;
         LockRefPtr<FutexQueue> futex_queue;
         auto futex_key = TRY(get_futex_key(user_address, shared));
+        // Announce our wait before looking at the value. Anyone who changes the value afterwards and then wakes
+        // the futex will find the queue and wake us, even if we haven't actually started blocking by then.
         do {
-            auto user_value = user_atomic_load_relaxed(params.userspace_address);
-            if (!user_value.has_value())
-                return EFAULT;
-            if (user_value.value() != params.val) {
-                dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
-                return EAGAIN;
-            }
-            atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
-
             did_create = false;
             futex_queue = TRY(find_futex_queue(futex_key, true, &did_create));
             VERIFY(futex_queue);
@@ -190,6 +197,17 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
             // was removed before we were able to queue an imminent wait.
         } while (!did_create && !futex_queue->queue_imminent_wait());
 
+        auto user_value = user_atomic_load_relaxed(params.userspace_address);
+        if (!user_value.has_value() || user_value.value() != params.val) {
+            if (futex_queue->cancel_imminent_wait())
+                remove_futex_queue(futex_key);
+            if (!user_value.has_value())
+                return EFAULT;
+            dbgln_if(FUTEX_DEBUG, "futex wait: EAGAIN. user value: {:p} @ {:p} != val: {}", user_value.value(), params.userspace_address, params.val);
+            return EAGAIN;
+        }
+        atomic_thread_fence(AK::MemoryOrder::memory_order_acquire);
+
         // We must not hold the lock before blocking. But we have a reference
         // to the FutexQueue so that we can keep it alive.
 
@@ -218,23 +236,32 @@ ErrorOr<FlatPtr> Process::sys$futex(Userspace<Syscall::SC_futex_params const*> u
         if (!futex_queue)
             return 0;
 
+        auto futex_key2 = TRY(get_futex_key(user_address2, shared));
         LockRefPtr<FutexQueue> target_futex_queue;
+        if (params.val2 > 0) {
+            // Look up the target queue before touching the source queue, so that we never take a bucket lock
+            // while holding a queue lock. Our imminent wait keeps the target from being removed until the
+            // requeued waiters have arrived.
+            bool did_create;
+            do {
+                did_create = false;
+                target_futex_queue = TRY(find_futex_queue(futex_key2, true, &did_create));
+                VERIFY(target_futex_queue);
+            } while (!did_create && !target_futex_queue->queue_imminent_wait());
+        }
+
         bool is_empty = false;
         bool is_target_empty = false;
-        auto futex_key2 = TRY(get_futex_key(user_address2, shared));
-        auto woken_or_requeued = TRY(futex_queue->wake_n_requeue(
+        auto woken_or_requeued_or_error = futex_queue->wake_n_requeue(
             params.val, [&]() -> ErrorOr<FutexQueue*> {
-                // NOTE: futex_queue's lock is being held while this callback is called
-                // The reason we're doing this in a callback is that we don't want to always
-                // create a target queue, only if we actually have anything to move to it!
-                target_futex_queue = TRY(find_futex_queue(futex_key2, true));
                 return target_futex_queue.ptr();
             },
-            params.val2, is_empty, is_target_empty));
+            params.val2, is_empty, is_target_empty);
+        if (target_futex_queue && target_futex_queue->cancel_imminent_wait())
+            remove_futex_queue(futex_key2);
+        auto woken_or_requeued = TRY(woken_or_requeued_or_error);
         if (is_empty)
             remove_futex_queue(futex_key);
-        if (is_target_empty && target_futex_queue)
-            remove_futex_queue(futex_key2);
         return woken_or_requeued;
     };
 
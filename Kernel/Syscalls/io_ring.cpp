@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <Kernel/API/POSIX/sys/io_ring.h>
+#include <Kernel/FileSystem/IORing.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+ErrorOr<FlatPtr> Process::sys$create_io_ring(unsigned entries, unsigned flags)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+
+    if (flags & ~IO_RING_CLOEXEC)
+        return EINVAL;
+
+    auto io_ring = TRY(IORing::try_create(*this, entries));
+    auto description = TRY(OpenFileDescription::try_create(move(io_ring)));
+
+    // NOTE: The ring has to be writable so that it can be mapped shared and writable.
+    description->set_readable(true);
+    description->set_writable(true);
+
+    return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<FlatPtr> {
+        auto fd_allocation = TRY(fds.allocate());
+        fds[fd_allocation.fd].set(move(description));
+
+        if (flags & IO_RING_CLOEXEC)
+            fds[fd_allocation.fd].set_flags(fds[fd_allocation.fd].flags() | FD_CLOEXEC);
+
+        return fd_allocation.fd;
+    });
+}
+
+ErrorOr<FlatPtr> Process::sys$io_ring_enter(Userspace<Syscall::SC_io_ring_enter_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    auto description = TRY(open_file_description(params.ring_fd));
+    auto* io_ring = description->io_ring();
+    if (!io_ring)
+        return EINVAL;
+
+    Optional<MonotonicTime> give_up_time;
+    if (params.timeout) {
+        auto timeout = TRY(copy_time_from_user(params.timeout));
+        give_up_time = TimeManagement::the().monotonic_time() + max(timeout, Duration::zero());
+    }
+
+    return TRY(io_ring->enter(params.to_submit, params.min_complete, give_up_time));
+}
+
+}
@@ -17,6 +17,7 @@
 #include <Kernel/Memory/PrivateInodeVMObject.h>
 #include <Kernel/Memory/Region.h>
 #include <Kernel/Memory/SharedInodeVMObject.h>
+#include <Kernel/Memory/TLBFlushBatch.h>
 #include <Kernel/Tasks/PerformanceEventBuffer.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
@@ -141,6 +142,12 @@ ErrorOr<FlatPtr> Process::sys$mmap(Userspace<Syscall::SC_mmap_params const*> use
         requested_range = { {}, rounded_size };
     }
 
+    // Private anonymous memory gets populated with large pages where possible, which requires them to be aligned.
+    if constexpr (Memory::large_pages_are_supported) {
+        if (map_anonymous && map_private && !map_stack && requested_range.base().is_null() && rounded_size >= Memory::large_page_size)
+            alignment = max(alignment, Memory::large_page_size);
+    }
+
     Memory::Region* region = nullptr;
 
     RefPtr<OpenFileDescription> description;
@@ -268,7 +275,9 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
             // Remove the old region from our regions tree, since were going to add another region
             // with the exact same start address.
             auto region = space->take_region(*old_region);
-            region->unmap();
+            Memory::TLBFlushBatch tlb_flush_batch(space->page_directory());
+            region->unmap(Memory::ShouldFlushTLB::No);
+            tlb_flush_batch.add(region->range());
 
             // This vector is the region(s) adjacent to our range.
             // We need to allocate a new region for the range we wanted to change permission bits on.
@@ -282,9 +291,9 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
 
             // Map the new regions using our page directory (they were just allocated and don't have one).
             for (auto* adjacent_region : adjacent_regions) {
-                TRY(adjacent_region->map(space->page_directory()));
+                TRY(adjacent_region->map(space->page_directory(), Memory::ShouldFlushTLB::No));
             }
-            TRY(new_region->map(space->page_directory()));
+            TRY(new_region->map(space->page_directory(), Memory::ShouldFlushTLB::No));
             return 0;
         }
 
@@ -308,6 +317,8 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
 
             // Finally, iterate over each region, either updating its access flags if the range covers it wholly,
             // or carving out a new subregion with the appropriate access flags set.
+            // The TLB is flushed once for all of them at the end.
+            Memory::TLBFlushBatch tlb_flush_batch(space->page_directory());
             for (auto* old_region : regions) {
                 if (old_region->access() == Memory::prot_to_region_access_flags(prot))
                     continue;
@@ -319,13 +330,15 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
                     old_region->set_writable(prot & PROT_WRITE);
                     old_region->set_executable(prot & PROT_EXEC);
 
-                    old_region->remap();
+                    old_region->remap(Memory::ShouldFlushTLB::No);
+                    tlb_flush_batch.add(old_region->range());
                     continue;
                 }
                 // Remove the old region from our regions tree, since were going to add another region
                 // with the exact same start address.
                 auto region = space->take_region(*old_region);
-                region->unmap();
+                region->unmap(Memory::ShouldFlushTLB::No);
+                tlb_flush_batch.add(region->range());
 
                 // This vector is the region(s) adjacent to our range.
                 // We need to allocate a new region for the range we wanted to change permission bits on.
@@ -344,9 +357,9 @@ ErrorOr<FlatPtr> Process::sys$mprotect(Userspace<void*> addr, size_t size, int p
 
                 // Map the new region using our page directory (they were just allocated and don't have one) if any.
                 if (adjacent_regions.size())
-                    TRY(adjacent_regions[0]->map(space->page_directory()));
+                    TRY(adjacent_regions[0]->map(space->page_directory(), Memory::ShouldFlushTLB::No));
 
-                TRY(new_region->map(space->page_directory()));
+                TRY(new_region->map(space->page_directory(), Memory::ShouldFlushTLB::No));
             }
 
             return 0;
@@ -387,6 +400,12 @@ ErrorOr<FlatPtr> Process::sys$madvise(Userspace<void*> address, size_t size, int
             TRY(vmobject.set_volatile(advice == MADV_SET_VOLATILE, was_purged));
             return was_purged ? 1 : 0;
         }
+        if (advice == MADV_HUGEPAGE || advice == MADV_NOHUGEPAGE) {
+            if (!region->vmobject().is_anonymous())
+                return EINVAL;
+            region->set_large_pages_allowed(advice == MADV_HUGEPAGE);
+            return 0;
+        }
         return EINVAL;
     });
 }
@@ -0,0 +1,268 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Checked.h>
+#include <AK/ScopeGuard.h>
+#include <Kernel/API/POSIX/spawn.h>
+#include <Kernel/Devices/TTY/TTY.h>
+#include <Kernel/FileSystem/Custody.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/FileSystem/VirtualFileSystem.h>
+#include <Kernel/Memory/ScopedAddressSpaceSwitcher.h>
+#include <Kernel/Security/Credentials.h>
+#include <Kernel/Tasks/PerformanceManager.h>
+#include <Kernel/Tasks/Process.h>
+#include <Kernel/Tasks/ProcessGroup.h>
+#include <Kernel/Tasks/Scheduler.h>
+#include <Kernel/Tasks/ScopedProcessList.h>
+
+namespace Kernel {
+
+static constexpr int supported_spawn_flags = POSIX_SPAWN_RESETIDS | POSIX_SPAWN_SETPGROUP | POSIX_SPAWN_SETSCHEDPARAM | POSIX_SPAWN_SETSCHEDULER | POSIX_SPAWN_SETSIGDEF | POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSID;
+
+// NOTE: These run on the new child, before it has executed anything. They behave like the
+//       corresponding syscalls would if the child made them itself, in the same order.
+ErrorOr<void> Process::apply_spawn_attributes(Thread& main_thread, Syscall::SC_posix_spawn_params const& params)
+{
+    auto replace_credentials = [&](auto callback) -> ErrorOr<void> {
+        auto credentials = this->credentials();
+        auto new_credentials = TRY(callback(*credentials));
+        with_mutable_protected_data([&](auto& protected_data) {
+            protected_data.credentials = move(new_credentials);
+        });
+        return {};
+    };
+
+    if (params.flags & POSIX_SPAWN_RESETIDS) {
+        TRY(replace_credentials([](Credentials const& credentials) {
+            return Credentials::create(credentials.uid(), credentials.gid(), credentials.uid(), credentials.gid(), credentials.suid(), credentials.sgid(), credentials.extra_gids(), credentials.sid(), credentials.pgid());
+        }));
+    }
+
+    if (params.flags & POSIX_SPAWN_SETPGROUP) {
+        if (params.pgroup < 0)
+            return EINVAL;
+        // NOTE: The child can't be a session leader yet, and is in its parent's session.
+        ProcessGroupID new_pgid = params.pgroup ? ProcessGroupID(params.pgroup) : pid().value();
+        if (new_pgid != pid().value() && get_sid_from_pgid(new_pgid) != sid())
+            return EPERM;
+        auto process_group = TRY(ProcessGroup::find_or_create(new_pgid));
+        TRY(replace_credentials([new_pgid](Credentials const& credentials) {
+            return Credentials::create(credentials.uid(), credentials.gid(), credentials.euid(), credentials.egid(), credentials.suid(), credentials.sgid(), credentials.extra_gids(), credentials.sid(), new_pgid);
+        }));
+        with_mutable_protected_data([&](auto& protected_data) {
+            protected_data.process_group = move(process_group);
+        });
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSCHEDPARAM) {
+        if (params.sched_priority < THREAD_PRIORITY_MIN || params.sched_priority > THREAD_PRIORITY_MAX)
+            return EINVAL;
+        main_thread.set_priority((u32)params.sched_priority);
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSIGDEF) {
+        for (size_t signal = 1; signal < m_signal_action_data.size(); ++signal) {
+            if (signal == SIGKILL || signal == SIGSTOP)
+                continue;
+            if (params.sigdefault & (1 << (signal - 1)))
+                m_signal_action_data[signal] = {};
+        }
+    }
+
+    if (params.flags & POSIX_SPAWN_SETSIGMASK)
+        main_thread.update_signal_mask(params.sigmask);
+
+    if (params.flags & POSIX_SPAWN_SETSID) {
+        // NOTE: ProcessGroup::create_if_unused_pgid() will fail with EPERM
+        //       if a process group with the same PGID already exists.
+        auto process_group = TRY(ProcessGroup::create_if_unused_pgid(ProcessGroupID(pid().value())));
+        auto new_sid = SessionID(pid().value());
+        TRY(replace_credentials([new_sid](Credentials const& credentials) {
+            return Credentials::create(credentials.uid(), credentials.gid(), credentials.euid(), credentials.egid(), credentials.suid(), credentials.sgid(), credentials.extra_gids(), new_sid, credentials.pgid());
+        }));
+        with_mutable_protected_data([&](auto& protected_data) {
+            protected_data.tty = nullptr;
+            protected_data.process_group = move(process_group);
+        });
+    }
+
+    // FIXME: POSIX_SPAWN_SETSCHEDULER
+    return {};
+}
+
+// NOTE: require_promise() would flag a violation on the current thread, which belongs to the parent.
+//       The parent only asked for the action on the child's behalf, so it just gets an error back.
+static ErrorOr<void> require_spawned_child_promise(Process const& child, Pledge promise)
+{
+    if (child.has_promises() && !child.has_promised(promise))
+        return EPERM;
+    return {};
+}
+
+ErrorOr<void> Process::apply_spawn_file_action(SpawnFileAction const& action)
+{
+    switch (action.type) {
+    case Syscall::SpawnFileActionType::Open: {
+        if (action.fd < 0 || static_cast<size_t>(action.fd) >= OpenFileDescriptions::max_open())
+            return EBADF;
+        if (action.options & (O_NOFOLLOW_NOERROR | O_UNLINK_INTERNAL))
+            return EINVAL;
+        if (action.options & O_WRONLY)
+            TRY(require_spawned_child_promise(*this, Pledge::wpath));
+        else if (action.options & O_RDONLY)
+            TRY(require_spawned_child_promise(*this, Pledge::rpath));
+        if (action.options & O_CREAT)
+            TRY(require_spawned_child_promise(*this, Pledge::cpath));
+
+        auto description = TRY(VirtualFileSystem::open(vfs_root_context(), credentials(), action.path->view(), action.options, (action.mode & 0777) & ~umask(), current_directory()));
+        if (description->inode() && description->inode()->bound_socket())
+            return ENXIO;
+        m_fds.with_exclusive([&](auto& fds) {
+            if (!fds.m_fds_metadatas[action.fd].is_allocated())
+                fds.m_fds_metadatas[action.fd].allocate();
+            fds[action.fd].set(move(description), (action.options & O_CLOEXEC) ? FD_CLOEXEC : 0);
+        });
+        return {};
+    }
+    case Syscall::SpawnFileActionType::Close: {
+        auto description = TRY(open_file_description(action.fd));
+        auto result = description->close();
+        m_fds.with_exclusive([&](auto& fds) { fds[action.fd] = {}; });
+        return result;
+    }
+    case Syscall::SpawnFileActionType::Dup2:
+        return m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
+            auto description = TRY(fds.open_file_description(action.fd));
+            if (action.fd == action.new_fd)
+                return {};
+            if (action.new_fd < 0 || static_cast<size_t>(action.new_fd) >= OpenFileDescriptions::max_open())
+                return EBADF;
+            if (!fds.m_fds_metadatas[action.new_fd].is_allocated())
+                fds.m_fds_metadatas[action.new_fd].allocate();
+            fds[action.new_fd].set(move(description));
+            return {};
+        });
+    case Syscall::SpawnFileActionType::Chdir: {
+        TRY(require_spawned_child_promise(*this, Pledge::rpath));
+        RefPtr<Custody> new_directory = TRY(VirtualFileSystem::open_directory(vfs_root_context(), credentials(), action.path->view(), current_directory()));
+        m_current_directory.with([&](auto& current_directory) {
+            swap(current_directory, new_directory);
+        });
+        return {};
+    }
+    case Syscall::SpawnFileActionType::Fchdir: {
+        auto description = TRY(open_file_description(action.fd));
+        if (!description->is_directory())
+            return ENOTDIR;
+        if (!description->metadata().may_execute(credentials()))
+            return EACCES;
+        m_current_directory.with([&](auto& current_directory) {
+            current_directory = description->custody();
+        });
+        return {};
+    }
+    }
+    return EINVAL;
+}
+
+ErrorOr<FlatPtr> Process::sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*> user_params)
+{
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
+    TRY(require_promise(Pledge::proc));
+    TRY(require_promise(Pledge::exec));
+
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.arguments.length > ARG_MAX || params.environment.length > ARG_MAX)
+        return E2BIG;
+    // NOTE: Like for execve(), the caller is expected to always pass at least one argument.
+    if (params.arguments.length == 0)
+        return EINVAL;
+    if (params.flags & ~supported_spawn_flags)
+        return EINVAL;
+
+    // Copy in everything the child needs up front, since we won't be in our own address space while loading the executable.
+    auto path = TRY(get_syscall_path_argument(params.path));
+    auto arguments = TRY(get_syscall_string_list_argument(params.arguments));
+    auto environment = TRY(get_syscall_string_list_argument(params.environment));
+
+    Vector<SpawnFileAction> file_actions;
+    if (params.file_actions_count) {
+        Checked<size_t> size = sizeof(*params.file_actions);
+        size *= params.file_actions_count;
+        if (size.has_overflow())
+            return EOVERFLOW;
+        Vector<Syscall::SpawnFileAction> user_file_actions;
+        TRY(user_file_actions.try_resize(params.file_actions_count));
+        TRY(copy_from_user(user_file_actions.data(), params.file_actions, size.value()));
+        TRY(file_actions.try_ensure_capacity(user_file_actions.size()));
+        for (auto const& user_action : user_file_actions) {
+            OwnPtr<KString> action_path;
+            if (user_action.type == Syscall::SpawnFileActionType::Open || user_action.type == Syscall::SpawnFileActionType::Chdir)
+                action_path = TRY(get_syscall_path_argument(user_action.path));
+            file_actions.unchecked_append({ user_action.type, user_action.fd, user_action.new_fd, user_action.options, user_action.mode, move(action_path) });
+        }
+    }
+
+    // NOTE: Unlike fork(), the child doesn't get a copy of our address space, since it is about to be replaced anyway.
+    auto child_and_first_thread = TRY(create_forked_child());
+    auto& child = child_and_first_thread.process;
+    auto& child_first_thread = child_and_first_thread.first_thread;
+
+    ArmedScopeGuard thread_finalizer_guard = [&child, &child_first_thread]() {
+        // NOTE: Failing to spawn shouldn't leave a child behind for us to wait for. Its own PID can't be
+        //       looked up, since it was never registered.
+        child->with_mutable_protected_data([](auto& protected_data) { protected_data.ppid = protected_data.pid; });
+        SpinlockLocker lock(g_scheduler_lock);
+        child_first_thread->detach();
+        child_first_thread->set_state(Thread::State::Dying);
+    };
+
+    TRY(child->apply_spawn_attributes(*child_first_thread, params));
+    for (auto const& action : file_actions)
+        TRY(child->apply_spawn_file_action(action));
+
+    m_scoped_process_list.with([&](auto& list_ptr) {
+        if (list_ptr) {
+            child->m_scoped_process_list.with([&](auto& child_list_ptr) {
+                child_list_ptr = list_ptr;
+            });
+        }
+    });
+
+    PerformanceManager::add_process_created_event(*child);
+
+    Thread* new_main_thread = nullptr;
+    {
+        // NOTE: Loading the executable switches into the child's address space, so make sure we come back to ours.
+        ScopedAddressSpaceSwitcher switcher(*this);
+        InterruptsState previous_interrupts_state = InterruptsState::Enabled;
+        TRY(child->exec(move(path), move(arguments), move(environment), new_main_thread, previous_interrupts_state));
+        // NOTE: exec() returns in a critical section with interrupts disabled, as it expects the
+        //       caller to switch to the new program right away. We aren't that program though.
+        Processor::restore_interrupts_state(previous_interrupts_state);
+        Processor::leave_critical();
+    }
+    VERIFY(new_main_thread == child_first_thread.ptr());
+
+    thread_finalizer_guard.disarm();
+
+    m_scoped_process_list.with([&](auto& list_ptr) {
+        if (list_ptr)
+            list_ptr->attach(*child);
+    });
+
+    Process::register_new(*child);
+
+    SpinlockLocker lock(g_scheduler_lock);
+    child_first_thread->set_affinity(Thread::current()->affinity());
+    child_first_thread->set_state(Thread::State::Runnable);
+
+    return child->pid().value();
+}
+
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/NumericLimits.h>
+#include <Kernel/FileSystem/OpenFileDescription.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Net/Socket.h>
+#include <Kernel/Tasks/Process.h>
+
+namespace Kernel {
+
+static constexpr size_t sendfile_bounce_buffer_size = 64 * KiB;
+
+ErrorOr<FlatPtr> Process::sys$sendfile(Userspace<Syscall::SC_sendfile_params const*> user_params)
+{
+    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    TRY(require_promise(Pledge::stdio));
+    auto params = TRY(copy_typed_from_user(user_params));
+
+    if (params.count > static_cast<size_t>(NumericLimits<ssize_t>::max()))
+        return EINVAL;
+
+    auto in_description = TRY(open_file_description(params.in_fd));
+    if (!in_description->is_readable())
+        return EBADF;
+    if (!in_description->file().is_regular_file())
+        return EINVAL;
+
+    auto out_description = TRY(open_file_description(params.out_fd));
+    if (!out_description->is_writable())
+        return EBADF;
+
+    off_t offset = 0;
+    if (params.offset) {
+        TRY(copy_from_user(&offset, params.offset));
+        if (offset < 0)
+            return EINVAL;
+    } else {
+        offset = in_description->offset();
+    }
+
+    u64 file_size = in_description->inode()->size();
+    size_t count = 0;
+    if (static_cast<u64>(offset) < file_size)
+        count = min(static_cast<u64>(params.count), file_size - offset);
+
+    size_t total_nsent = 0;
+    auto update_offset = [&]() -> ErrorOr<void> {
+        off_t new_offset = offset + total_nsent;
+        if (params.offset)
+            return copy_to_user(params.offset, &new_offset);
+        TRY(in_description->seek(new_offset, SEEK_SET));
+        return {};
+    };
+
+    // Sockets that support it read the file straight into their outgoing packets.
+    if (auto* socket = out_description->socket()) {
+        while (total_nsent < count) {
+            if (!out_description->can_write()) {
+                if (!out_description->is_blocking()) {
+                    if (total_nsent > 0)
+                        break;
+                    return EAGAIN;
+                }
+                auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
+                if (Thread::current()->block<Thread::WriteBlocker>({}, *out_description, unblock_flags).was_interrupted()) {
+                    if (total_nsent > 0)
+                        break;
+                    return EINTR;
+                }
+                continue;
+            }
+
+            auto nsent_or_error = socket->send_from_file(*out_description, *in_description, offset + total_nsent, count - total_nsent);
+            if (nsent_or_error.is_error()) {
+                auto error = nsent_or_error.release_error();
+                if (total_nsent > 0 || error.code() == ENOTSUP)
+                    break;
+                if (error.code() == EAGAIN)
+                    continue;
+                if (error.code() == EPIPE)
+                    Thread::current()->send_signal(SIGPIPE, &Process::current());
+                return error;
+            }
+            VERIFY(nsent_or_error.value() > 0);
+            total_nsent += nsent_or_error.value();
+        }
+        if (total_nsent > 0 || count == 0) {
+            TRY(update_offset());
+            return total_nsent;
+        }
+    }
+
+    if (count == 0)
+        return 0;
+
+    // Everything else goes through a kernel buffer, which still saves the trip through userspace.
+    auto bounce_buffer = TRY(KBuffer::try_create_with_size("sendfile"sv, min(count, sendfile_bounce_buffer_size)));
+    auto buffer = UserOrKernelBuffer::for_kernel_buffer(bounce_buffer->data());
+    while (total_nsent < count) {
+        auto chunk_size = min(bounce_buffer->size(), count - total_nsent);
+        auto nread_or_error = in_description->read(buffer, offset + total_nsent, chunk_size);
+        if (nread_or_error.is_error()) {
+            if (total_nsent > 0)
+                break;
+            return nread_or_error.release_error();
+        }
+        auto nread = nread_or_error.value();
+        if (nread == 0)
+            break;
+
+        auto nwritten_or_error = do_write(*out_description, buffer, nread);
+        if (nwritten_or_error.is_error()) {
+            if (total_nsent > 0)
+                break;
+            return nwritten_or_error.release_error();
+        }
+        total_nsent += nwritten_or_error.value();
+        if (nwritten_or_error.value() < nread)
+            break;
+    }
+
+    TRY(update_offset());
+    return total_nsent;
+}
+
+}
@@ -92,36 +92,37 @@ ErrorOr<FlatPtr> Process::sys$accept4(Userspace<Syscall::SC_accept4_params const
     TRY(require_promise(Pledge::accept));
     auto params = TRY(copy_typed_from_user(user_params));
 
-    int accepting_socket_fd = params.sockfd;
+    auto accepting_socket_description = TRY(open_file_description(params.sockfd));
     Userspace<sockaddr*> user_address((FlatPtr)params.addr);
     Userspace<socklen_t*> user_address_size((FlatPtr)params.addrlen);
-    int flags = params.flags;
+    return accept_impl(*accepting_socket_description, user_address, user_address_size, params.flags, accepting_socket_description->is_blocking());
+}
+
+ErrorOr<FlatPtr> Process::accept_impl(OpenFileDescription& accepting_socket_description, Userspace<sockaddr*> user_address, Userspace<socklen_t*> user_address_size, int flags, bool blocking)
+{
+    if (!accepting_socket_description.is_socket())
+        return ENOTSOCK;
+    auto& socket = *accepting_socket_description.socket();
 
     socklen_t address_size = 0;
     if (user_address)
         TRY(copy_from_user(&address_size, static_ptr_cast<socklen_t const*>(user_address_size)));
 
     ScopedDescriptionAllocation fd_allocation;
-    RefPtr<OpenFileDescription> accepting_socket_description;
-
     TRY(m_fds.with_exclusive([&](auto& fds) -> ErrorOr<void> {
         fd_allocation = TRY(fds.allocate());
-        accepting_socket_description = TRY(fds.open_file_description(accepting_socket_fd));
         return {};
     }));
-    if (!accepting_socket_description->is_socket())
-        return ENOTSOCK;
-    auto& socket = *accepting_socket_description->socket();
 
     LockRefPtr<Socket> accepted_socket;
     for (;;) {
         accepted_socket = socket.accept();
         if (accepted_socket)
             break;
-        if (!accepting_socket_description->is_blocking())
+        if (!blocking)
             return EAGAIN;
         auto unblock_flags = Thread::FileBlocker::BlockFlags::None;
-        if (Thread::current()->block<Thread::AcceptBlocker>({}, *accepting_socket_description, unblock_flags).was_interrupted())
+        if (Thread::current()->block<Thread::AcceptBlocker>({}, accepting_socket_description, unblock_flags).was_interrupted())
             return EINTR;
     }
 
@@ -183,7 +184,7 @@ ErrorOr<FlatPtr> Process::sys$shutdown(int sockfd, int how)
 
 ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*> user_msg, int flags)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
     auto msg = TRY(copy_typed_from_user(user_msg));
 
@@ -256,7 +257,7 @@ ErrorOr<FlatPtr> Process::sys$sendmsg(int sockfd, Userspace<const struct msghdr*
 
 ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user_msg, int flags)
 {
-    VERIFY_PROCESS_BIG_LOCK_ACQUIRED(this);
+    VERIFY_NO_PROCESS_BIG_LOCK(this);
     TRY(require_promise(Pledge::stdio));
 
     struct msghdr msg;
@@ -320,9 +321,12 @@ ErrorOr<FlatPtr> Process::sys$recvmsg(int sockfd, Userspace<struct msghdr*> user
         auto descriptions = TRY(local_socket.recvfds(description, space_for_fds));
         Vector<int> fdnums;
         for (auto& description : descriptions) {
-            auto fd_allocation = TRY(m_fds.with_exclusive([](auto& fds) { return fds.allocate(); }));
-            m_fds.with_exclusive([&](auto& fds) { fds[fd_allocation.fd].set(*description, 0); });
-            fdnums.append(fd_allocation.fd);
+            auto fd = TRY(m_fds.with_exclusive([&](auto& fds) -> ErrorOr<int> {
+                auto fd_allocation = TRY(fds.allocate());
+                fds[fd_allocation.fd].set(*description, 0);
+                return fd_allocation.fd;
+            }));
+            TRY(fdnums.try_append(fd));
         }
         if (!fdnums.is_empty())
             TRY(try_add_cmsg(SOL_SOCKET, SCM_RIGHTS, fdnums.data(), fdnums.size() * sizeof(int)));
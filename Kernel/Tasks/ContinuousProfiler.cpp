@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/HashFunctions.h>
+#include <AK/JsonObjectSerializer.h>
+#include <AK/QuickSort.h>
+#include <AK/Singleton.h>
+#include <Kernel/Arch/RegisterState.h>
+#include <Kernel/Tasks/ContinuousProfiler.h>
+#include <Kernel/Tasks/PerformanceEventBuffer.h>
+#include <Kernel/Tasks/Thread.h>
+
+namespace Kernel {
+
+static Singleton<ContinuousProfiler> s_the;
+
+// NOTE: This lives outside of the singleton, so that timer ticks don't have to touch it while we aren't sampling.
+static Atomic<u32> s_ticks_per_sample { 0 };
+
+// How many neighboring slots are tried before a sample is dropped.
+static constexpr size_t max_probe_count = 8;
+
+ContinuousProfiler& ContinuousProfiler::the()
+{
+    return *s_the;
+}
+
+ErrorOr<NonnullOwnPtr<KBuffer>> ContinuousProfiler::try_create_stacks()
+{
+    // NOTE: Samples are recorded from timer interrupts, so the tables must never have to fault pages in.
+    auto buffer = TRY(KBuffer::try_create_with_size("ContinuousProfiler: Stacks"sv, stacks_per_processor * sizeof(Stack), Memory::Region::Access::ReadWrite, AllocationStrategy::AllocateNow));
+    memset(buffer->data(), 0, buffer->size());
+    return buffer;
+}
+
+ErrorOr<void> ContinuousProfiler::set_frequency(u32 frequency)
+{
+    if (frequency > max_frequency)
+        return EINVAL;
+
+    MutexLocker locker(m_lock);
+    if (frequency == 0) {
+        s_ticks_per_sample.store(0, AK::memory_order_relaxed);
+        m_frequency.store(0, AK::memory_order_relaxed);
+        for (auto& processor : m_processors) {
+            OwnPtr<KBuffer> stacks;
+            {
+                SpinlockLocker processor_locker(processor.lock);
+                stacks = move(processor.stacks);
+                processor.samples = 0;
+                processor.dropped_samples = 0;
+            }
+            processor.spare_stacks = nullptr;
+        }
+        return {};
+    }
+
+    for (size_t processor_id = 0; processor_id < Processor::count(); ++processor_id) {
+        auto& processor = m_processors[processor_id];
+        if (!processor.spare_stacks)
+            processor.spare_stacks = TRY(try_create_stacks());
+        // NOTE: The tables are only ever replaced with m_lock held, so we may look at them without the processor's lock.
+        if (processor.stacks)
+            continue;
+        auto stacks = TRY(try_create_stacks());
+        SpinlockLocker processor_locker(processor.lock);
+        processor.stacks = move(stacks);
+    }
+
+    m_frequency.store(frequency, AK::memory_order_relaxed);
+    s_ticks_per_sample.store(max(1u, (max_frequency + frequency / 2) / frequency), AK::memory_order_relaxed);
+    return {};
+}
+
+void ContinuousProfiler::timer_tick(Thread& thread, RegisterState const& regs)
+{
+    if (s_ticks_per_sample.load(AK::memory_order_relaxed) == 0)
+        return;
+    the().record_sample(thread, regs);
+}
+
+void ContinuousProfiler::record_sample(Thread& thread, RegisterState const& regs)
+{
+    auto ticks_per_sample = s_ticks_per_sample.load(AK::memory_order_relaxed);
+    if (ticks_per_sample == 0)
+        return;
+
+    // NOTE: Only this processor's timer tick ever looks at its countdown.
+    auto& processor = m_processors[Processor::current_id()];
+    if (processor.ticks_until_next_sample > 0) {
+        --processor.ticks_until_next_sample;
+        return;
+    }
+    processor.ticks_until_next_sample = ticks_per_sample - 1;
+
+    if (thread.is_idle_thread() || thread.is_profiling_suppressed())
+        return;
+
+    auto backtrace = PerformanceEventBuffer::raw_backtrace(regs.bp(), regs.ip());
+    u32 depth = min(backtrace.size(), max_stack_depth);
+    pid_t pid = thread.pid().value();
+    u32 hash = int_hash(pid);
+    for (size_t i = 0; i < depth; ++i)
+        hash = pair_int_hash(hash, ptr_hash(backtrace[i]));
+
+    SpinlockLocker locker(processor.lock);
+    if (!processor.stacks)
+        return;
+    ++processor.samples;
+
+    auto* stacks = stacks_in(*processor.stacks);
+    for (size_t probe = 0; probe < max_probe_count; ++probe) {
+        auto& stack = stacks[(hash + probe) & (stacks_per_processor - 1)];
+        if (stack.count == 0) {
+            stack.hash = hash;
+            stack.count = 1;
+            stack.pid = pid;
+            stack.depth = depth;
+            memcpy(stack.frames, backtrace.data(), depth * sizeof(FlatPtr));
+            return;
+        }
+        if (stack.hash == hash && stack.pid == pid && stack.depth == depth && memcmp(stack.frames, backtrace.data(), depth * sizeof(FlatPtr)) == 0) {
+            ++stack.count;
+            return;
+        }
+    }
+    ++processor.dropped_samples;
+}
+
+ErrorOr<void> ContinuousProfiler::take_samples_as_json(KBufferBuilder& builder)
+{
+    MutexLocker locker(m_lock);
+
+    // Swap out every processor's table first, so that the counts we report all cover the same period.
+    u64 samples = 0;
+    u64 dropped_samples = 0;
+    Vector<Stack const*> taken_stacks;
+    for (size_t processor_id = 0; processor_id < Processor::count(); ++processor_id) {
+        auto& processor = m_processors[processor_id];
+        if (!processor.spare_stacks)
+            continue;
+        {
+            SpinlockLocker processor_locker(processor.lock);
+            if (!processor.stacks)
+                continue;
+            swap(processor.stacks, processor.spare_stacks);
+            samples += exchange(processor.samples, 0);
+            dropped_samples += exchange(processor.dropped_samples, 0);
+        }
+        auto* stacks = stacks_in(*processor.spare_stacks);
+        for (size_t i = 0; i < stacks_per_processor; ++i) {
+            if (stacks[i].count != 0)
+                TRY(taken_stacks.try_append(&stacks[i]));
+        }
+    }
+
+    // The same stack may have been sampled on several processors, so sort them next to each other to merge them.
+    auto is_same_stack = [](Stack const& a, Stack const& b) {
+        return a.hash == b.hash && a.pid == b.pid && a.depth == b.depth && memcmp(a.frames, b.frames, a.depth * sizeof(FlatPtr)) == 0;
+    };
+    quick_sort(taken_stacks, [](Stack const* a, Stack const* b) {
+        if (a->hash != b->hash)
+            return a->hash < b->hash;
+        if (a->pid != b->pid)
+            return a->pid < b->pid;
+        if (a->depth != b->depth)
+            return a->depth < b->depth;
+        return memcmp(a->frames, b->frames, a->depth * sizeof(FlatPtr)) < 0;
+    });
+
+    auto json = TRY(JsonObjectSerializer<>::try_create(builder));
+    TRY(json.add("frequency"sv, frequency()));
+    TRY(json.add("samples"sv, samples));
+    TRY(json.add("dropped_samples"sv, dropped_samples));
+    auto stacks_array = TRY(json.add_array("stacks"sv));
+    for (size_t i = 0; i < taken_stacks.size();) {
+        auto const& stack = *taken_stacks[i];
+        u64 count = 0;
+        for (; i < taken_stacks.size() && is_same_stack(stack, *taken_stacks[i]); ++i)
+            count += taken_stacks[i]->count;
+
+        auto stack_object = TRY(stacks_array.add_object());
+        TRY(stack_object.add("pid"sv, stack.pid));
+        TRY(stack_object.add("count"sv, count));
+        auto frames_array = TRY(stack_object.add_array("frames"sv));
+        for (size_t frame = 0; frame < stack.depth; ++frame)
+            TRY(frames_array.add(stack.frames[frame]));
+        TRY(frames_array.finish());
+        TRY(stack_object.finish());
+    }
+    TRY(stacks_array.finish());
+    TRY(json.finish());
+
+    for (size_t processor_id = 0; processor_id < Processor::count(); ++processor_id) {
+        if (auto& spare_stacks = m_processors[processor_id].spare_stacks)
+            memset(spare_stacks->data(), 0, spare_stacks->size());
+    }
+    return {};
+}
+
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Array.h>
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/OwnPtr.h>
+#include <Kernel/Arch/Processor.h>
+#include <Kernel/Forward.h>
+#include <Kernel/Library/KBuffer.h>
+#include <Kernel/Library/KBufferBuilder.h>
+#include <Kernel/Locking/Mutex.h>
+#include <Kernel/Locking/Spinlock.h>
+#include <Kernel/Time/TimeManagement.h>
+
+namespace Kernel {
+
+// ContinuousProfiler is a system-wide sampling profiler that is cheap enough to leave running.
+// Every processor samples the thread it is running from its own timer tick, and counts the
+// sample in its own hash table of stacks, keyed by a hash of the process and its backtrace.
+// Nothing else is recorded per sample, so memory use doesn't grow the longer it runs.
+//
+// Reading the samples swaps every processor's table for an empty one, so each read returns
+// the aggregated counts of everything that was sampled since the previous read.
+class ContinuousProfiler {
+public:
+    static constexpr size_t max_stack_depth = 32;
+    static constexpr size_t stacks_per_processor = 512;
+    // Samples are taken on the system timer tick, so we can't sample more often than it ticks.
+    static constexpr u32 max_frequency = OPTIMAL_TICKS_PER_SECOND_RATE;
+
+    static ContinuousProfiler& the();
+
+    u32 frequency() const { return m_frequency.load(AK::memory_order_relaxed); }
+    // Starts sampling at the given frequency, or stops sampling and frees all tables if it is 0.
+    ErrorOr<void> set_frequency(u32);
+
+    // Called from every processor's system timer tick, with interrupts disabled.
+    static void timer_tick(Thread&, RegisterState const&);
+
+    ErrorOr<void> take_samples_as_json(KBufferBuilder&);
+
+private:
+    struct Stack {
+        u32 hash;
+        u32 count;
+        pid_t pid;
+        u32 depth;
+        FlatPtr frames[max_stack_depth];
+    };
+
+    struct ProcessorState {
+        Spinlock<LockRank::None> lock {};
+        // NOTE: The tables are guarded by the lock, while the spare table only ever gets touched with m_lock held.
+        OwnPtr<KBuffer> stacks;
+        OwnPtr<KBuffer> spare_stacks;
+        u32 ticks_until_next_sample { 0 };
+        u64 samples { 0 };
+        u64 dropped_samples { 0 };
+    };
+
+    static ErrorOr<NonnullOwnPtr<KBuffer>> try_create_stacks();
+    static Stack* stacks_in(KBuffer& buffer) { return reinterpret_cast<Stack*>(buffer.data()); }
+
+    void record_sample(Thread&, RegisterState const&);
+
+    Atomic<u32> m_frequency { 0 };
+    Mutex m_lock { "ContinuousProfiler"sv };
+    Array<ProcessorState, MAX_CPU_COUNT> m_processors;
+};
+
+}
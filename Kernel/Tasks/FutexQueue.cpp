@@ -13,6 +13,17 @@ namespace Kernel {
 FutexQueue::FutexQueue() = default;
 FutexQueue::~FutexQueue() = default;
 
+// Threads with an imminent wait have already compared the futex value, but haven't blocked yet, so we can't
+// unblock them. Make them consume a wake instead of blocking, otherwise they would miss it and sleep forever.
+u32 FutexQueue::wake_imminent_waiters_locked(u32 count)
+{
+    VERIFY(m_lock.is_locked());
+    VERIFY(m_pending_wakes <= m_imminent_waits);
+    auto woken = static_cast<u32>(min<size_t>(count, m_imminent_waits - m_pending_wakes));
+    m_pending_wakes += woken;
+    return woken;
+}
+
 bool FutexQueue::should_add_blocker(Thread::Blocker& b, void*)
 {
     VERIFY(m_lock.is_locked());
@@ -25,6 +36,11 @@ bool FutexQueue::should_add_blocker(Thread::Blocker& b, void*)
         dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was removed", this, b.thread());
         return false;
     }
+    if (m_pending_wakes > 0) {
+        m_pending_wakes--;
+        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should not block thread {}: was woken before blocking", this, b.thread());
+        return false;
+    }
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: should block thread {}", this, b.thread());
 
     return true;
@@ -38,19 +54,28 @@ ErrorOr<u32> FutexQueue::wake_n_requeue(u32 wake_count, Function<ErrorOr<FutexQu
     dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue({}, {})", this, wake_count, requeue_count);
 
     u32 did_wake = 0, did_requeue = 0;
-    unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
-        VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
-        auto& blocker = static_cast<Thread::FutexBlocker&>(b);
-
-        dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, blocker.thread());
-        VERIFY(did_wake < wake_count);
-        if (blocker.unblock()) {
-            if (++did_wake >= wake_count)
-                stop_iterating = true;
-            return true;
-        }
-        return false;
-    });
+    // A pure requeue (without waking anyone) is perfectly valid.
+    if (wake_count > 0) {
+        unblock_all_blockers_whose_conditions_are_met_locked([&](Thread::Blocker& b, void*, bool& stop_iterating) {
+            VERIFY(b.blocker_type() == Thread::Blocker::Type::Futex);
+            auto& blocker = static_cast<Thread::FutexBlocker&>(b);
+
+            dbgln_if(FUTEXQUEUE_DEBUG, "FutexQueue @ {}: wake_n_requeue unblocking {}", this, blocker.thread());
+            VERIFY(did_wake < wake_count);
+            if (blocker.unblock()) {
+                if (++did_wake >= wake_count)
+                    stop_iterating = true;
+                return true;
+            }
+            return false;
+        });
+        if (did_wake < wake_count)
+            did_wake += wake_imminent_waiters_locked(wake_count - did_wake);
+    }
+    // Threads that are about to block can't be moved to the target queue, so wake them instead. They will
+    // spuriously return and wait again, which waiters have to expect anyway, so they aren't counted as woken.
+    if (requeue_count > 0)
+        (void)wake_imminent_waiters_locked(NumericLimits<u32>::max());
     is_empty = is_empty_and_no_imminent_waits_locked();
     if (requeue_count > 0) {
         auto blockers_to_requeue = do_take_blockers(requeue_count);
@@ -109,6 +134,12 @@ u32 FutexQueue::wake_n(u32 wake_count, Optional<u32> const& bitset, bool& is_emp
         }
         return false;
     });
+    if (did_wake < wake_count) {
+        // We don't know the bitsets of threads that are about to block, so wake all of them in that case.
+        // Those that don't match will spuriously return, which waiters have to expect anyway.
+        auto woken = wake_imminent_waiters_locked(bitset.has_value() ? NumericLimits<u32>::max() : wake_count - did_wake);
+        did_wake += min(woken, wake_count - did_wake);
+    }
     is_empty = is_empty_and_no_imminent_waits_locked();
     return did_wake;
 }
@@ -128,6 +159,7 @@ u32 FutexQueue::wake_all(bool& is_empty)
         }
         return false;
     });
+    did_wake += wake_imminent_waiters_locked(NumericLimits<u32>::max());
     is_empty = is_empty_and_no_imminent_waits_locked();
     return did_wake;
 }
@@ -146,6 +178,16 @@ bool FutexQueue::queue_imminent_wait()
     return true;
 }
 
+bool FutexQueue::cancel_imminent_wait()
+{
+    SpinlockLocker lock(m_lock);
+    VERIFY(m_imminent_waits > 0);
+    m_imminent_waits--;
+    // If a wake was meant for us, leave it to the others that are about to block, if there are any.
+    m_pending_wakes = min(m_pending_wakes, m_imminent_waits);
+    return is_empty_and_no_imminent_waits_locked();
+}
+
 bool FutexQueue::try_remove()
 {
     SpinlockLocker lock(m_lock);
@@ -30,6 +30,8 @@ public:
     }
 
     bool queue_imminent_wait();
+    // Gives up an imminent wait without blocking, returns whether the queue is now unused.
+    bool cancel_imminent_wait();
     bool try_remove();
 
     bool is_empty_and_no_imminent_waits()
@@ -43,7 +45,11 @@ protected:
     virtual bool should_add_blocker(Thread::Blocker& b, void*) override;
 
 private:
+    u32 wake_imminent_waiters_locked(u32 count);
+
     size_t m_imminent_waits { 1 }; // We only create this object if we're going to be waiting, so start out with 1
+    // Wakes that were meant for threads with an imminent wait, which they consume instead of blocking.
+    size_t m_pending_wakes { 0 };
     bool m_was_removed { false };
 };
 
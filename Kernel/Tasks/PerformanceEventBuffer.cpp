@@ -30,7 +30,7 @@ NEVER_INLINE ErrorOr<void> PerformanceEventBuffer::append(int type, FlatPtr arg1
     return append_with_ip_and_bp(current_thread->pid(), current_thread->tid(), 0, base_pointer, type, 0, arg1, arg2, arg3, filesystem_event);
 }
 
-static Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(FlatPtr frame_pointer, FlatPtr pc)
+Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> PerformanceEventBuffer::raw_backtrace(FlatPtr frame_pointer, FlatPtr pc)
 {
     Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> backtrace;
     if (pc != 0)
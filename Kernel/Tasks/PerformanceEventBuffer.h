@@ -8,6 +8,7 @@
 #pragma once
 
 #include <AK/Error.h>
+#include <AK/Vector.h>
 #include <Kernel/Library/KBuffer.h>
 
 namespace Kernel {
@@ -195,6 +196,9 @@ public:
 
     ErrorOr<FlatPtr> register_string(NonnullOwnPtr<KString>);
 
+    // Walks the stack from the given frame pointer, kernel frames first and then userspace frames.
+    static Vector<FlatPtr, PerformanceEvent::max_stack_frame_count> raw_backtrace(FlatPtr frame_pointer, FlatPtr pc);
+
 private:
     explicit PerformanceEventBuffer(NonnullOwnPtr<KBuffer>);
 
@@ -5,6 +5,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/Checked.h>
 #include <AK/Singleton.h>
 #include <AK/StdLibExtras.h>
 #include <AK/Time.h>
@@ -784,6 +785,24 @@ ErrorOr<NonnullOwnPtr<KString>> Process::get_syscall_path_argument(Syscall::Stri
     return get_syscall_path_argument(path_characters, path.length);
 }
 
+ErrorOr<Vector<NonnullOwnPtr<KString>>> Process::get_syscall_string_list_argument(Syscall::StringListArgument const& list)
+{
+    Vector<NonnullOwnPtr<KString>> output;
+    if (!list.length)
+        return output;
+    Checked<size_t> size = sizeof(*list.strings);
+    size *= list.length;
+    if (size.has_overflow())
+        return EOVERFLOW;
+    Vector<Syscall::StringArgument, 32> strings;
+    TRY(strings.try_resize(list.length));
+    TRY(copy_from_user(strings.data(), list.strings, size.value()));
+    TRY(output.try_ensure_capacity(list.length));
+    for (size_t i = 0; i < list.length; ++i)
+        output.unchecked_append(TRY(try_copy_kstring_from_user(strings[i])));
+    return output;
+}
+
 ErrorOr<void> Process::dump_core()
 {
     VERIFY(is_dumpable());
@@ -354,6 +354,11 @@ public:
     ErrorOr<FlatPtr> sys$create_inode_watcher(u32 flags);
     ErrorOr<FlatPtr> sys$inode_watcher_add_watch(Userspace<Syscall::SC_inode_watcher_add_watch_params const*> user_params);
     ErrorOr<FlatPtr> sys$inode_watcher_remove_watch(int fd, int wd);
+    ErrorOr<FlatPtr> sys$create_io_ring(unsigned entries, unsigned flags);
+    ErrorOr<FlatPtr> sys$io_ring_enter(Userspace<Syscall::SC_io_ring_enter_params const*>);
+    ErrorOr<FlatPtr> sys$create_event_poll(u32 flags);
+    ErrorOr<FlatPtr> sys$event_poll_ctl(Userspace<Syscall::SC_event_poll_ctl_params const*>);
+    ErrorOr<FlatPtr> sys$event_poll_wait(Userspace<Syscall::SC_event_poll_wait_params const*>);
     ErrorOr<FlatPtr> sys$dbgputstr(Userspace<char const*>, size_t);
     ErrorOr<FlatPtr> sys$dump_backtrace();
     ErrorOr<FlatPtr> sys$gettid();
@@ -414,6 +419,7 @@ public:
     ErrorOr<FlatPtr> sys$readlink(Userspace<Syscall::SC_readlink_params const*>);
     ErrorOr<FlatPtr> sys$fork(RegisterState&);
     ErrorOr<FlatPtr> sys$execve(Userspace<Syscall::SC_execve_params const*>);
+    ErrorOr<FlatPtr> sys$posix_spawn(Userspace<Syscall::SC_posix_spawn_params const*>);
     ErrorOr<FlatPtr> sys$dup2(int old_fd, int new_fd);
     ErrorOr<FlatPtr> sys$sigaction(int signum, Userspace<sigaction const*> act, Userspace<sigaction*> old_act);
     ErrorOr<FlatPtr> sys$sigaltstack(Userspace<stack_t const*> ss, Userspace<stack_t*> old_ss);
@@ -460,6 +466,7 @@ public:
     ErrorOr<FlatPtr> sys$connect(int sockfd, Userspace<sockaddr const*>, socklen_t);
     ErrorOr<FlatPtr> sys$shutdown(int sockfd, int how);
     ErrorOr<FlatPtr> sys$sendmsg(int sockfd, Userspace<const struct msghdr*>, int flags);
+    ErrorOr<FlatPtr> sys$sendfile(Userspace<Syscall::SC_sendfile_params const*>);
     ErrorOr<FlatPtr> sys$recvmsg(int sockfd, Userspace<struct msghdr*>, int flags);
     ErrorOr<FlatPtr> sys$getsockopt(Userspace<Syscall::SC_getsockopt_params const*>);
     ErrorOr<FlatPtr> sys$setsockopt(Userspace<Syscall::SC_setsockopt_params const*>);
@@ -693,6 +700,7 @@ private:
     friend class Scheduler;
     friend class Region;
     friend class PerformanceManager;
+    friend class IORing;
 
     bool add_thread(Thread&);
     bool remove_thread(Thread&);
@@ -701,6 +709,9 @@ private:
     static ErrorOr<ProcessAndFirstThread> create_with_forked_name(UserID, GroupID, ProcessID ppid, bool is_kernel_process, NonnullRefPtr<VFSRootContext> vfs_root_context, NonnullRefPtr<HostnameContext>, RefPtr<Custody> current_directory = nullptr, RefPtr<Custody> executable = nullptr, RefPtr<TTY> = nullptr, Process* fork_parent = nullptr);
     static ErrorOr<ProcessAndFirstThread> create(StringView name, UserID, GroupID, ProcessID ppid, bool is_kernel_process, NonnullRefPtr<VFSRootContext> vfs_root_context, NonnullRefPtr<HostnameContext>, RefPtr<Custody> current_directory = nullptr, RefPtr<Custody> executable = nullptr, RefPtr<TTY> = nullptr, Process* fork_parent = nullptr);
     ErrorOr<NonnullRefPtr<Thread>> attach_resources(NonnullOwnPtr<Memory::AddressSpace>&&, Process* fork_parent);
+    // Creates a child that inherits everything from this process except for its address space, which starts out empty.
+    // The child's first thread is a clone of the current one, and has to be made runnable by the caller.
+    ErrorOr<ProcessAndFirstThread> create_forked_child();
     static ProcessID allocate_pid();
 
     void kill_threads_except_self();
@@ -711,6 +722,16 @@ private:
     void delete_perf_events_buffer();
 
     ErrorOr<void> do_exec(NonnullRefPtr<OpenFileDescription> main_program_description, Vector<NonnullOwnPtr<KString>> arguments, Vector<NonnullOwnPtr<KString>> environment, RefPtr<OpenFileDescription> interpreter_description, Thread*& new_main_thread, InterruptsState& previous_interrupts_state, Elf_Ehdr const& main_program_header, Optional<size_t> minimum_stack_size = {});
+    struct SpawnFileAction {
+        Syscall::SpawnFileActionType type;
+        int fd;
+        int new_fd;
+        int options;
+        u16 mode;
+        OwnPtr<KString> path;
+    };
+    ErrorOr<void> apply_spawn_file_action(SpawnFileAction const&);
+    ErrorOr<void> apply_spawn_attributes(Thread& main_thread, Syscall::SC_posix_spawn_params const&);
     ErrorOr<FlatPtr> do_write(OpenFileDescription&, UserOrKernelBuffer const&, size_t, Optional<off_t> = {});
 
     ErrorOr<FlatPtr> do_statvfs(FileSystem const& path, Custody const*, statvfs* buf);
@@ -726,6 +747,7 @@ private:
 
     static ErrorOr<NonnullOwnPtr<KString>> get_syscall_path_argument(Userspace<char const*> user_path, size_t path_length);
     static ErrorOr<NonnullOwnPtr<KString>> get_syscall_path_argument(Syscall::StringArgument const&);
+    static ErrorOr<Vector<NonnullOwnPtr<KString>>> get_syscall_string_list_argument(Syscall::StringListArgument const&);
 
     bool has_tracee_thread(ProcessID tracer_pid);
 
@@ -741,6 +763,7 @@ private:
     ErrorOr<FlatPtr> read_impl(int fd, Userspace<u8*> buffer, size_t size);
     ErrorOr<FlatPtr> pread_impl(int fd, Userspace<u8*>, size_t, off_t);
     ErrorOr<FlatPtr> readv_impl(int fd, Userspace<const struct iovec*> iov, int iov_count);
+    ErrorOr<FlatPtr> accept_impl(OpenFileDescription& accepting_socket_description, Userspace<sockaddr*> user_address, Userspace<socklen_t*> user_address_size, int flags, bool blocking);
 
 public:
     ErrorOr<void> traverse_as_directory(FileSystemID, Function<ErrorOr<void>(FileSystem::DirectoryEntryView const&)> callback) const;
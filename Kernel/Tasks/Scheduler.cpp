@@ -5,6 +5,7 @@
  */
 
 #include <AK/BuiltinWrappers.h>
+#include <AK/NumericLimits.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
@@ -13,6 +14,7 @@
 #include <Kernel/Interrupts/InterruptDisabler.h>
 #include <Kernel/Library/Panic.h>
 #include <Kernel/Sections.h>
+#include <Kernel/Tasks/ContinuousProfiler.h>
 #include <Kernel/Tasks/PerformanceManager.h>
 #include <Kernel/Tasks/Process.h>
 #include <Kernel/Tasks/Scheduler.h>
@@ -46,7 +48,16 @@ struct ThreadReadyQueues {
     Array<ThreadReadyQueue, count> queues;
 };
 
-static Singleton<RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None>> g_ready_queues;
+struct ProcessorReadyQueues {
+    RecursiveSpinlockProtected<ThreadReadyQueues, LockRank::None> ready_queues {};
+    // NOTE: These are only ever modified with the ready queues locked, but are
+    //       read locklessly when placing threads and when reporting statistics.
+    Atomic<u32> depth { 0 };
+    Atomic<u64> steals { 0 };
+    Atomic<u64> stolen { 0 };
+};
+
+static Singleton<Array<ProcessorReadyQueues, MAX_CPU_COUNT>> s_processor_ready_queues;
 
 static RecursiveSpinlockProtected<TotalTimeScheduled, LockRank::None> g_total_time_scheduled {};
 
@@ -55,7 +66,7 @@ static void dump_thread_list(bool = false);
 static inline u32 thread_priority_to_priority_index(u32 thread_priority)
 {
     // Converts the priority in the range of THREAD_PRIORITY_MIN...THREAD_PRIORITY_MAX
-    // to a index into g_ready_queues where 0 is the highest priority bucket
+    // to a index into the ready queues where 0 is the highest priority bucket
     VERIFY(thread_priority >= THREAD_PRIORITY_MIN && thread_priority <= THREAD_PRIORITY_MAX);
     constexpr u32 thread_priority_count = THREAD_PRIORITY_MAX - THREAD_PRIORITY_MIN + 1;
     static_assert(thread_priority_count > 0);
@@ -64,74 +75,174 @@ static inline u32 thread_priority_to_priority_index(u32 thread_priority)
     return priority_bucket;
 }
 
-Thread& Scheduler::pull_next_runnable_thread()
+static ProcessorReadyQueues& ready_queues_for_processor(u32 cpu)
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread& {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                thread.m_runnable_priority = -1;
-                ready_queue.thread_list.remove(thread);
-                if (ready_queue.thread_list.is_empty())
-                    ready_queues.mask &= ~(1u << priority);
-                // Mark it as active because we are using this thread. This is similar
-                // to comparing it with Processor::current_thread, but when there are
-                // multiple processors there's no easy way to check whether the thread
-                // is actually still needed. This prevents accidental finalization when
-                // a thread is no longer in Running state, but running on another core.
-
-                // We need to mark it active here so that this thread won't be
-                // scheduled on another core if it were to be queued before actually
-                // switching to it.
-                // FIXME: Figure out a better way maybe?
-                thread.set_active(true);
+    VERIFY(cpu < MAX_CPU_COUNT);
+    return (*s_processor_ready_queues)[cpu];
+}
+
+static u32 schedulable_processor_count()
+{
+    // NOTE: Processor::count() is not maintained on every architecture, and
+    //       thread affinity masks (a u32) can't address more than 32 processors.
+    constexpr u32 max_affinity_processors = sizeof(u32) * 8;
+    return clamp(Processor::count(), 1u, min(static_cast<u32>(MAX_CPU_COUNT), max_affinity_processors));
+}
+
+Thread* Scheduler::find_runnable_thread(ThreadReadyQueues& ready_queues, u32 affinity_mask)
+{
+    auto priority_mask = ready_queues.mask;
+    while (priority_mask != 0) {
+        auto priority = bit_scan_forward(priority_mask);
+        VERIFY(priority > 0);
+        auto& ready_queue = ready_queues.queues[--priority];
+        for (auto& thread : ready_queue.thread_list) {
+            VERIFY(thread.m_runnable_priority == (int)priority);
+            if (thread.is_active())
+                continue;
+            if (!(thread.affinity() & affinity_mask))
+                continue;
+            return &thread;
+        }
+        priority_mask &= ~(1u << priority);
+    }
+    return nullptr;
+}
+
+void Scheduler::remove_runnable_thread(ThreadReadyQueues& ready_queues, Thread& thread)
+{
+    auto priority = thread.m_runnable_priority;
+    VERIFY(priority >= 0);
+    VERIFY(ready_queues.mask & (1u << priority));
+    auto& ready_queue = ready_queues.queues[priority];
+    thread.m_runnable_priority = -1;
+    ready_queue.thread_list.remove(thread);
+    if (ready_queue.thread_list.is_empty())
+        ready_queues.mask &= ~(1u << priority);
+    ready_queues_for_processor(thread.m_runnable_processor).depth.fetch_sub(1, AK::MemoryOrder::memory_order_relaxed);
+}
+
+Thread* Scheduler::steal_runnable_thread(u32 cpu, bool remove)
+{
+    auto affinity_mask = 1u << cpu;
+    auto processor_count = schedulable_processor_count();
+
+    // Walk the other processors round-robin, starting with our neighbor, so
+    // that idle processors don't all pile onto the same victim.
+    for (u32 i = 1; i < processor_count; ++i) {
+        auto victim_cpu = (cpu + i) % processor_count;
+        auto& victim = ready_queues_for_processor(victim_cpu);
+        if (victim.depth.load(AK::MemoryOrder::memory_order_relaxed) == 0)
+            continue;
+
+        auto* thread = victim.ready_queues.with([&](auto& ready_queues) -> Thread* {
+            auto* thread = find_runnable_thread(ready_queues, affinity_mask);
+            if (!thread || !remove)
                 return thread;
-            }
-            priority_mask &= ~(1u << priority);
+            remove_runnable_thread(ready_queues, *thread);
+            return thread;
+        });
+        if (!thread)
+            continue;
+
+        if (remove) {
+            dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: Stole {} from processor {}", cpu, *thread, victim_cpu);
+            victim.stolen.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
+            ready_queues_for_processor(cpu).steals.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
         }
+        return thread;
+    }
+    return nullptr;
+}
+
+u32 Scheduler::select_processor_for(Thread const& thread)
+{
+    auto affinity = thread.affinity();
+    auto processor_count = schedulable_processor_count();
+
+    Optional<u32> least_loaded_cpu;
+    u32 least_depth = NumericLimits<u32>::max();
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        if (!(affinity & (1u << cpu)))
+            continue;
+        auto depth = ready_queues_for_processor(cpu).depth.load(AK::MemoryOrder::memory_order_relaxed);
+        if (depth < least_depth) {
+            least_loaded_cpu = cpu;
+            least_depth = depth;
+        }
+    }
 
-        auto* idle_thread = Processor::idle_thread();
-        idle_thread->set_active(true);
-        return *idle_thread;
+    if (!least_loaded_cpu.has_value()) {
+        // The thread is only affine to processors that aren't up yet. Park it
+        // on the first of them, it will be picked up once that processor starts scheduling.
+        if (affinity == 0)
+            return Processor::current_id();
+        return min(static_cast<u32>(bit_scan_forward(affinity) - 1), static_cast<u32>(MAX_CPU_COUNT - 1));
+    }
+
+    // Keep threads on the processor they last ran on to benefit from warm
+    // caches, unless that processor is noticeably busier than the alternative.
+    auto last_cpu = thread.cpu();
+    if (thread.times_scheduled() > 0 && last_cpu < processor_count && (affinity & (1u << last_cpu))) {
+        auto last_depth = ready_queues_for_processor(last_cpu).depth.load(AK::MemoryOrder::memory_order_relaxed);
+        if (last_depth <= least_depth + 1)
+            return last_cpu;
+    }
+    return least_loaded_cpu.value();
+}
+
+Thread& Scheduler::pull_next_runnable_thread()
+{
+    auto cpu = Processor::current_id();
+    auto affinity_mask = 1u << cpu;
+
+    auto* thread = ready_queues_for_processor(cpu).ready_queues.with([&](auto& ready_queues) -> Thread* {
+        auto* thread = find_runnable_thread(ready_queues, affinity_mask);
+        if (thread)
+            remove_runnable_thread(ready_queues, *thread);
+        return thread;
     });
+
+    // Our own queue ran dry, try to take some work off another processor
+    // before we go idle.
+    if (!thread)
+        thread = steal_runnable_thread(cpu, true);
+
+    if (thread) {
+        // Mark it as active because we are using this thread. This is similar
+        // to comparing it with Processor::current_thread, but when there are
+        // multiple processors there's no easy way to check whether the thread
+        // is actually still needed. This prevents accidental finalization when
+        // a thread is no longer in Running state, but running on another core.
+
+        // We need to mark it active here so that this thread won't be
+        // scheduled on another core if it were to be queued before actually
+        // switching to it.
+        // FIXME: Figure out a better way maybe?
+        thread->set_active(true);
+        return *thread;
+    }
+
+    auto* idle_thread = Processor::idle_thread();
+    idle_thread->set_active(true);
+    return *idle_thread;
 }
 
 Thread* Scheduler::peek_next_runnable_thread()
 {
-    auto affinity_mask = 1u << Processor::current_id();
-
-    return g_ready_queues->with([&](auto& ready_queues) -> Thread* {
-        auto priority_mask = ready_queues.mask;
-        while (priority_mask != 0) {
-            auto priority = bit_scan_forward(priority_mask);
-            VERIFY(priority > 0);
-            auto& ready_queue = ready_queues.queues[--priority];
-            for (auto& thread : ready_queue.thread_list) {
-                VERIFY(thread.m_runnable_priority == (int)priority);
-                if (thread.is_active())
-                    continue;
-                if (!(thread.affinity() & affinity_mask))
-                    continue;
-                return &thread;
-            }
-            priority_mask &= ~(1u << priority);
-        }
+    auto cpu = Processor::current_id();
+    auto affinity_mask = 1u << cpu;
 
-        // Unlike in pull_next_runnable_thread() we don't want to fall back to
-        // the idle thread. We just want to see if we have any other thread ready
-        // to be scheduled.
-        return nullptr;
+    auto* thread = ready_queues_for_processor(cpu).ready_queues.with([&](auto& ready_queues) {
+        return find_runnable_thread(ready_queues, affinity_mask);
     });
+    if (thread)
+        return thread;
+
+    // Unlike in pull_next_runnable_thread() we don't want to fall back to
+    // the idle thread. We just want to see if we have any other thread ready
+    // to be scheduled, including ones that we would steal.
+    return steal_runnable_thread(cpu, false);
 }
 
 bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
@@ -139,9 +250,13 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
     if (thread.is_idle_thread())
         return true;
 
-    return g_ready_queues->with([&](auto& ready_queues) {
-        auto priority = thread.m_runnable_priority;
-        if (priority < 0) {
+    if (thread.m_runnable_priority < 0) {
+        VERIFY(!thread.m_ready_queue_node.is_in_list());
+        return false;
+    }
+
+    return ready_queues_for_processor(thread.m_runnable_processor).ready_queues.with([&](auto& ready_queues) {
+        if (thread.m_runnable_priority < 0) {
             VERIFY(!thread.m_ready_queue_node.is_in_list());
             return false;
         }
@@ -149,35 +264,49 @@ bool Scheduler::dequeue_runnable_thread(Thread& thread, bool check_affinity)
         if (check_affinity && !(thread.affinity() & (1 << Processor::current_id())))
             return false;
 
-        VERIFY(ready_queues.mask & (1u << priority));
-        auto& ready_queue = ready_queues.queues[priority];
-        thread.m_runnable_priority = -1;
-        ready_queue.thread_list.remove(thread);
-        if (ready_queue.thread_list.is_empty())
-            ready_queues.mask &= ~(1u << priority);
+        remove_runnable_thread(ready_queues, thread);
         return true;
     });
 }
 
 void Scheduler::enqueue_runnable_thread(Thread& thread)
 {
-    VERIFY(g_scheduler_lock.is_locked_by_current_processor());
     if (thread.is_idle_thread())
         return;
     auto priority = thread_priority_to_priority_index(thread.priority());
+    auto cpu = select_processor_for(thread);
+    auto& processor_ready_queues = ready_queues_for_processor(cpu);
 
-    g_ready_queues->with([&](auto& ready_queues) {
+    processor_ready_queues.ready_queues.with([&](auto& ready_queues) {
         VERIFY(thread.m_runnable_priority < 0);
         thread.m_runnable_priority = (int)priority;
+        thread.m_runnable_processor = cpu;
         VERIFY(!thread.m_ready_queue_node.is_in_list());
         auto& ready_queue = ready_queues.queues[priority];
         bool was_empty = ready_queue.thread_list.is_empty();
         ready_queue.thread_list.append(thread);
         if (was_empty)
             ready_queues.mask |= (1u << priority);
+        processor_ready_queues.depth.fetch_add(1, AK::MemoryOrder::memory_order_relaxed);
     });
 }
 
+ErrorOr<void> Scheduler::try_for_each_processor_statistics(Function<ErrorOr<void>(ProcessorSchedulerStatistics const&)> callback)
+{
+    auto processor_count = schedulable_processor_count();
+    for (u32 cpu = 0; cpu < processor_count; ++cpu) {
+        auto& processor_ready_queues = ready_queues_for_processor(cpu);
+        ProcessorSchedulerStatistics statistics {
+            .processor = cpu,
+            .queue_depth = processor_ready_queues.depth.load(AK::MemoryOrder::memory_order_relaxed),
+            .steals = processor_ready_queues.steals.load(AK::MemoryOrder::memory_order_relaxed),
+            .stolen = processor_ready_queues.stolen.load(AK::MemoryOrder::memory_order_relaxed),
+        };
+        TRY(callback(statistics));
+    }
+    return {};
+}
+
 UNMAP_AFTER_INIT void Scheduler::start()
 {
     VERIFY_INTERRUPTS_DISABLED();
@@ -217,26 +346,41 @@ void Scheduler::pick_next()
             Processor::set_current_in_scheduler(false);
         });
 
+    // NOTE: The ready queues are protected by their own per-processor locks, so we take the next
+    //       thread off them before acquiring the scheduler lock. That one still serializes thread
+    //       state changes and the context switch itself, so it has to be held from here on.
+    auto* thread_to_schedule = &pull_next_runnable_thread();
+
     SpinlockLocker lock(g_scheduler_lock);
 
     if constexpr (SCHEDULER_RUNNABLE_DEBUG) {
         dump_thread_list();
     }
 
-    auto& thread_to_schedule = pull_next_runnable_thread();
+    // Another processor may have changed the thread's state before we got the scheduler lock.
+    // If it was stopped or killed, or even made runnable again and put back on a ready queue,
+    // it's no longer ours to run, so let go of it and pick another one.
+    while (!thread_to_schedule->is_idle_thread() && (thread_to_schedule->state() != Thread::State::Runnable || thread_to_schedule->m_runnable_priority >= 0)) {
+        dbgln_if(SCHEDULER_DEBUG, "Scheduler[{}]: {} changed state before we could switch to it", Processor::current_id(), *thread_to_schedule);
+        thread_to_schedule->set_active(false);
+        if (thread_to_schedule->state() == Thread::State::Dying)
+            notify_finalizer();
+        thread_to_schedule = &pull_next_runnable_thread();
+    }
+
     if constexpr (SCHEDULER_DEBUG) {
         dbgln("Scheduler[{}]: Switch to {} @ {:p}",
             Processor::current_id(),
-            thread_to_schedule,
-            thread_to_schedule.regs().ip());
+            *thread_to_schedule,
+            thread_to_schedule->regs().ip());
     }
 
     // We need to leave our first critical section before switching context,
     // but since we're still holding the scheduler lock we're still in a critical section
     critical.leave();
 
-    thread_to_schedule.set_ticks_left(time_slice_for(thread_to_schedule));
-    context_switch(&thread_to_schedule);
+    thread_to_schedule->set_ticks_left(time_slice_for(*thread_to_schedule));
+    context_switch(thread_to_schedule);
 }
 
 void Scheduler::yield()
@@ -425,6 +569,8 @@ void Scheduler::timer_tick()
     // Sanity checks
     VERIFY(current_thread->current_trap());
 
+    ContinuousProfiler::timer_tick(*current_thread, *current_thread->current_trap()->regs);
+
     if (current_thread->process().is_kernel_process()) {
         // Because the previous mode when entering/exiting kernel threads never changes
         // we never update the time scheduled. So we need to update it manually on the
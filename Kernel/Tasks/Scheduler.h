@@ -7,6 +7,7 @@
 #pragma once
 
 #include <AK/Assertions.h>
+#include <AK/Error.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/Types.h>
@@ -29,6 +30,15 @@ struct TotalTimeScheduled {
     u64 total_kernel { 0 };
 };
 
+struct ProcessorSchedulerStatistics {
+    u32 processor { 0 };
+    u32 queue_depth { 0 };
+    u64 steals { 0 };
+    u64 stolen { 0 };
+};
+
+struct ThreadReadyQueues;
+
 class Scheduler {
 public:
     static void initialize();
@@ -55,6 +65,13 @@ public:
     static bool is_initialized();
     static TotalTimeScheduled get_total_time_scheduled();
     static void add_time_scheduled(u64, bool);
+    static ErrorOr<void> try_for_each_processor_statistics(Function<ErrorOr<void>(ProcessorSchedulerStatistics const&)>);
+
+private:
+    static Thread* find_runnable_thread(ThreadReadyQueues&, u32 affinity_mask);
+    static void remove_runnable_thread(ThreadReadyQueues&, Thread&);
+    static Thread* steal_runnable_thread(u32 cpu, bool remove);
+    static u32 select_processor_for(Thread const&);
 };
 
 }
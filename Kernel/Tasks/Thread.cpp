@@ -148,7 +148,7 @@ Thread::BlockResult Thread::block_impl(BlockTimeout const& timeout, Blocker& blo
     if (auto& block_timeout = blocker.override_timeout(timeout); !block_timeout.is_infinite()) {
         // Process::kill_all_threads may be called at any time, which will mark all
         // threads to die. In that case
-        timer_was_added = TimerQueue::the().add_timer_without_id(*m_block_timer, block_timeout.clock_id(), block_timeout.absolute_time(), [&]() {
+        timer_was_added = TimerQueue::the().add_timer_without_id(*m_block_timer, block_timeout.clock_id(), block_timeout.absolute_time(), block_timeout.slack(), [&]() {
             VERIFY(!Processor::current_in_irq());
             VERIFY(!g_scheduler_lock.is_locked_by_current_processor());
             VERIFY(!m_block_lock.is_locked_by_current_processor());
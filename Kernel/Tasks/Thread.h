@@ -172,6 +172,8 @@ public:
         Duration const* start_time() const { return !m_infinite ? &m_start_time : nullptr; }
         clockid_t clock_id() const { return m_clock_id; }
         bool is_infinite() const { return m_infinite; }
+        // How late the timeout may expire, so that it can be batched with other timers.
+        Duration slack() const;
 
     private:
         Duration m_time {};
@@ -1094,6 +1096,7 @@ private:
 
     IntrusiveListNode<Thread> m_process_thread_list_node;
     int m_runnable_priority { -1 };
+    u32 m_runnable_processor { 0 };
 
     friend class WaitQueue;
 
@@ -28,6 +28,19 @@ Thread::BlockTimeout::BlockTimeout(bool is_absolute, Duration const* time, Durat
         m_time += m_start_time;
 }
 
+Duration Thread::BlockTimeout::slack() const
+{
+    // Nobody can tell when a timeout on a coarse clock expired any more precisely than
+    // the clock's resolution, which is one timer tick.
+    switch (m_clock_id) {
+    case CLOCK_MONOTONIC_COARSE:
+    case CLOCK_REALTIME_COARSE:
+        return Duration::from_nanoseconds(1'000'000'000 / TimeManagement::the().ticks_per_second());
+    default:
+        return {};
+    }
+}
+
 bool Thread::Blocker::add_to_blocker_set(Thread::BlockerSet& blocker_set, void* data)
 {
     VERIFY(!m_blocker_set);
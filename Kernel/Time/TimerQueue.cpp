@@ -4,6 +4,7 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <AK/BuiltinWrappers.h>
 #include <AK/Singleton.h>
 #include <AK/Time.h>
 #include <Kernel/Sections.h>
@@ -14,7 +15,6 @@
 namespace Kernel {
 
 static Singleton<TimerQueue> s_the;
-static Spinlock<LockRank::None> g_timerqueue_lock {};
 
 Duration Timer::remaining() const
 {
@@ -45,6 +45,102 @@ Duration Timer::now(bool is_firing) const
     return TimeManagement::the().current_time(clock_id);
 }
 
+u64 TimerWheel::tick_at_or_after(Duration const& time)
+{
+    auto nanoseconds = max<i64>(time.to_nanoseconds(), 0);
+    auto tick_nanoseconds = tick_duration.to_nanoseconds();
+    return static_cast<u64>((nanoseconds + tick_nanoseconds - 1) / tick_nanoseconds);
+}
+
+u64 TimerWheel::tick_at_or_before(Duration const& time)
+{
+    return static_cast<u64>(max<i64>(time.to_nanoseconds(), 0) / tick_duration.to_nanoseconds());
+}
+
+void TimerWheel::add(Timer& timer, u64 now_tick)
+{
+    // An empty wheel can start over anywhere, so don't make it catch up with ticks that nobody cares about.
+    if (m_timer_count == 0)
+        m_current_tick = now_tick;
+
+    timer.m_due_tick = tick_at_or_after(timer.m_expires);
+    auto latest_tick = tick_at_or_before(timer.m_expires + timer.m_slack);
+    if (latest_tick > timer.m_due_tick) {
+        // Pick the tick within the slack that has the most trailing zero bits, so that timers with
+        // similar deadlines end up in the same slot, and need to be cascaded as little as possible.
+        auto highest_differing_bit = sizeof(u64) * 8 - 1 - count_leading_zeroes(timer.m_due_tick ^ latest_tick);
+        timer.m_due_tick = latest_tick & ~((1ull << highest_differing_bit) - 1);
+    }
+
+    ++m_timer_count;
+    insert(timer);
+}
+
+void TimerWheel::insert(Timer& timer)
+{
+    // Timers that are already due go into the slot that is processed next.
+    auto due_tick = max(timer.m_due_tick, m_current_tick);
+    auto ticks_until_due = due_tick - m_current_tick;
+    for (size_t level = 0; level < level_count; ++level) {
+        auto shift = bits_per_level * level;
+        if (ticks_until_due < (1ull << (shift + bits_per_level))) {
+            m_levels[level][(due_tick >> shift) & slot_mask].append(timer);
+            return;
+        }
+    }
+    m_overflow.append(timer);
+}
+
+void TimerWheel::remove(Timer& timer)
+{
+    VERIFY(m_timer_count > 0);
+    VERIFY(timer.is_queued());
+    // We don't need to know which slot the timer is in to unlink it.
+    timer.m_list_node.remove();
+    --m_timer_count;
+}
+
+void TimerWheel::reinsert_all(Timer::List& list)
+{
+    Timer::List timers;
+    while (auto* timer = list.take_first())
+        timers.append(*timer);
+    while (auto* timer = timers.take_first())
+        insert(*timer);
+}
+
+void TimerWheel::cascade()
+{
+    // Whenever the wheel moves on to the next slot of a higher level, the timers in it are due before
+    // that level's slot advances again, so they are redistributed over the levels below.
+    for (size_t level = 1; level < level_count; ++level) {
+        auto shift = bits_per_level * level;
+        if ((m_current_tick & ((1ull << shift) - 1)) != 0)
+            return;
+        reinsert_all(m_levels[level][(m_current_tick >> shift) & slot_mask]);
+    }
+    if ((m_current_tick & ((1ull << (bits_per_level * level_count)) - 1)) == 0)
+        reinsert_all(m_overflow);
+}
+
+Timer* TimerWheel::take_expired_timer(u64 now_tick)
+{
+    while (m_current_tick <= now_tick) {
+        if (auto* timer = m_levels[0][m_current_tick & slot_mask].take_first()) {
+            VERIFY(timer->m_due_tick <= m_current_tick);
+            --m_timer_count;
+            return timer;
+        }
+        if (m_timer_count == 0) {
+            m_current_tick = now_tick + 1;
+            return nullptr;
+        }
+        ++m_current_tick;
+        cascade();
+    }
+    return nullptr;
+}
+
 TimerQueue& TimerQueue::the()
 {
     return *s_the;
@@ -55,7 +151,22 @@ UNMAP_AFTER_INIT TimerQueue::TimerQueue()
     m_ticks_per_second = TimeManagement::the().ticks_per_second();
 }
 
+TimerBase& TimerQueue::base_for_current_processor()
+{
+    // NOTE: We might be moved to another processor right after this, but that's fine, since
+    //       every base can hold any timer, and the base's lock protects it from everyone else.
+    auto& base = m_bases[Processor::current_id()];
+    if (base.receives_ticks.load(AK::memory_order_acquire))
+        return base;
+    return m_bases[0];
+}
+
 bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t clock_id, Duration const& deadline, Function<void()>&& callback)
+{
+    return add_timer_without_id(move(timer), clock_id, deadline, {}, move(callback));
+}
+
+bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t clock_id, Duration const& deadline, Duration const& slack, Function<void()>&& callback)
 {
     if (deadline <= TimeManagement::the().current_time(clock_id))
         return false;
@@ -65,54 +176,55 @@ bool TimerQueue::add_timer_without_id(NonnullRefPtr<Timer> timer, clockid_t cloc
     // *must* be a RefPtr<Timer>. Otherwise, calling cancel_timer() could
     // inadvertently cancel another timer that has been created between
     // returning from the timer handler and a call to cancel_timer().
-    timer->setup(clock_id, deadline, move(callback));
+    timer->setup(clock_id, deadline, move(callback), slack);
 
-    SpinlockLocker lock(g_timerqueue_lock);
+    auto& base = base_for_current_processor();
+    SpinlockLocker lock(base.lock);
     timer->m_id = 0; // Don't generate a timer id
-    add_timer_locked(move(timer));
+    add_timer_locked(base, move(timer));
     return true;
 }
 
 TimerId TimerQueue::add_timer(NonnullRefPtr<Timer>&& timer)
 {
-    SpinlockLocker lock(g_timerqueue_lock);
-
-    timer->m_id = ++m_timer_id_count;
+    timer->m_id = m_timer_id_count.fetch_add(1, AK::memory_order_relaxed) + 1;
     VERIFY(timer->m_id != 0); // wrapped
     auto id = timer->m_id;
-    add_timer_locked(move(timer));
+
+    auto& base = base_for_current_processor();
+    SpinlockLocker lock(base.lock);
+    add_timer_locked(base, move(timer));
     return id;
 }
 
-void TimerQueue::add_timer_locked(NonnullRefPtr<Timer> timer)
+void TimerQueue::add_timer_locked(TimerBase& base, NonnullRefPtr<Timer> timer)
 {
+    VERIFY(base.lock.is_locked());
     Duration timer_expiration = timer->m_expires;
 
     timer->clear_cancelled();
     timer->clear_callback_finished();
+    timer->m_base = &base;
     timer->set_in_use();
 
-    auto& queue = queue_for_timer(*timer);
-    if (queue.list.is_empty()) {
-        queue.list.append(timer.leak_ref());
-        queue.next_timer_due = timer_expiration;
-    } else {
-        Timer* following_timer = nullptr;
-        for (auto& t : queue.list) {
-            if (t.m_expires > timer_expiration) {
-                following_timer = &t;
-                break;
-            }
-        }
-        if (following_timer) {
-            bool next_timer_needs_update = queue.list.first() == following_timer;
-            queue.list.insert_before(*following_timer, timer.leak_ref());
-            if (next_timer_needs_update)
-                queue.next_timer_due = timer_expiration;
-        } else {
-            queue.list.append(timer.leak_ref());
+    if (is_monotonic(timer->m_clock_id)) {
+        auto now_tick = TimerWheel::tick_at_or_before(TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE));
+        base.monotonic_timers.add(timer.leak_ref(), now_tick);
+        return;
+    }
+
+    auto& list = base.realtime_timers;
+    Timer* following_timer = nullptr;
+    for (auto& t : list) {
+        if (t.m_expires > timer_expiration) {
+            following_timer = &t;
+            break;
         }
     }
+    if (following_timer)
+        list.insert_before(*following_timer, timer.leak_ref());
+    else
+        list.append(timer.leak_ref());
 }
 
 bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
@@ -128,25 +240,25 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
     }
 
     bool did_already_run = timer.set_cancelled();
-    auto& timer_queue = queue_for_timer(timer);
     if (!did_already_run) {
         timer.clear_in_use();
 
-        SpinlockLocker lock(g_timerqueue_lock);
-        if (timer_queue.list.contains(timer)) {
+        auto& base = *timer.m_base;
+        SpinlockLocker lock(base.lock);
+        if (!base.timers_executing.contains(timer)) {
             // The timer has not fired, remove it
+            VERIFY(timer.is_queued());
             VERIFY(timer.ref_count() > 1);
-            remove_timer_locked(timer_queue, timer);
+            remove_timer_locked(base, timer);
             return true;
         }
 
         // The timer was queued to execute but hasn't had a chance
-        // to run. In this case, it should still be in m_timers_executing
+        // to run. In this case, it should still be in timers_executing
         // and we don't need to spin. It still holds a reference
         // that will be dropped when it does get a chance to run,
         // but since we called set_cancelled it will only drop its reference
-        VERIFY(m_timers_executing.contains(timer));
-        m_timers_executing.remove(timer);
+        base.timers_executing.remove(timer);
         return true;
     }
 
@@ -158,75 +270,69 @@ bool TimerQueue::cancel_timer(Timer& timer, bool* was_in_use)
     return false;
 }
 
-void TimerQueue::remove_timer_locked(Queue& queue, Timer& timer)
+void TimerQueue::remove_timer_locked(TimerBase& base, Timer& timer)
 {
-    bool was_next_timer = (queue.list.first() == &timer);
-    queue.list.remove(timer);
+    VERIFY(base.lock.is_locked());
+    if (is_monotonic(timer.m_clock_id))
+        base.monotonic_timers.remove(timer);
+    else
+        base.realtime_timers.remove(timer);
+
     auto now = timer.now(false);
     if (timer.m_expires > now)
         timer.m_remaining = timer.m_expires - now;
 
-    if (was_next_timer)
-        update_next_timer_due(queue);
     // Whenever we remove a timer that was still queued (but hasn't been
     // fired) we added a reference to it. So, when removing it from the
     // queue we need to drop that reference.
     timer.unref();
 }
 
-void TimerQueue::fire()
+void TimerQueue::fire_timer_locked(TimerBase& base, Timer& timer, SpinlockLocker<Spinlock<LockRank::None>>& lock)
 {
-    SpinlockLocker lock(g_timerqueue_lock);
-
-    auto fire_timers = [&](Queue& queue) {
-        auto* timer = queue.list.first();
-        VERIFY(timer);
-        VERIFY(queue.next_timer_due == timer->m_expires);
-
-        while (timer && timer->now(true) > timer->m_expires) {
-            queue.list.remove(*timer);
-
-            m_timers_executing.append(*timer);
-
-            update_next_timer_due(queue);
-
-            lock.unlock();
-
-            // Defer executing the timer outside of the irq handler
-            Processor::deferred_call_queue([this, timer]() {
-                // Check if we were cancelled in between being triggered
-                // by the timer irq handler and now. If so, just drop
-                // our reference and don't execute the callback.
-                if (!timer->set_cancelled()) {
-                    timer->m_callback();
-                    SpinlockLocker lock(g_timerqueue_lock);
-                    m_timers_executing.remove(*timer);
-                }
-                timer->clear_in_use();
-                timer->set_callback_finished();
-                // Drop the reference we added when queueing the timer
-                timer->unref();
-            });
-
-            lock.lock();
-            timer = queue.list.first();
+    base.timers_executing.append(timer);
+
+    lock.unlock();
+
+    // Defer executing the timer outside of the irq handler
+    Processor::deferred_call_queue([&base, timer = &timer]() {
+        // Check if we were cancelled in between being triggered
+        // by the timer irq handler and now. If so, just drop
+        // our reference and don't execute the callback.
+        if (!timer->set_cancelled()) {
+            timer->m_callback();
+            SpinlockLocker lock(base.lock);
+            base.timers_executing.remove(*timer);
         }
-    };
+        timer->clear_in_use();
+        timer->set_callback_finished();
+        // Drop the reference we added when queueing the timer
+        timer->unref();
+    });
 
-    if (!m_timer_queue_monotonic.list.is_empty())
-        fire_timers(m_timer_queue_monotonic);
-    if (!m_timer_queue_realtime.list.is_empty())
-        fire_timers(m_timer_queue_realtime);
+    lock.lock();
 }
 
-void TimerQueue::update_next_timer_due(Queue& queue)
+void TimerQueue::fire()
 {
-    VERIFY(g_timerqueue_lock.is_locked());
+    auto& base = m_bases[Processor::current_id()];
+    if (!base.receives_ticks.load(AK::memory_order_relaxed))
+        base.receives_ticks.store(true, AK::memory_order_release);
 
-    if (auto* next_timer = queue.list.first())
-        queue.next_timer_due = next_timer->m_expires;
-    else
-        queue.next_timer_due = {};
+    SpinlockLocker lock(base.lock);
+
+    if (!base.monotonic_timers.is_empty()) {
+        auto now_tick = TimerWheel::tick_at_or_before(TimeManagement::the().current_time(CLOCK_MONOTONIC_COARSE));
+        while (auto* timer = base.monotonic_timers.take_expired_timer(now_tick))
+            fire_timer_locked(base, *timer, lock);
+    }
+
+    while (auto* timer = base.realtime_timers.first()) {
+        if (timer->now(true) <= timer->m_expires)
+            break;
+        base.realtime_timers.remove(*timer);
+        fire_timer_locked(base, *timer, lock);
+    }
 }
 
 }
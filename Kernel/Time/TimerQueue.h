@@ -6,27 +6,35 @@
 
 #pragma once
 
+#include <AK/Array.h>
 #include <AK/AtomicRefCounted.h>
 #include <AK/Function.h>
 #include <AK/IntrusiveList.h>
 #include <AK/OwnPtr.h>
 #include <AK/Time.h>
+#include <Kernel/Arch/Processor.h>
 #include <Kernel/Library/NonnullLockRefPtr.h>
+#include <Kernel/Locking/Spinlock.h>
 #include <Kernel/Time/TimeManagement.h>
 
 namespace Kernel {
 
 AK_TYPEDEF_DISTINCT_ORDERED_ID(u64, TimerId);
 
+struct TimerBase;
+
 class Timer final : public AtomicRefCounted<Timer> {
     friend class TimerQueue;
+    friend class TimerWheel;
 
 public:
-    void setup(clockid_t clock_id, Duration expires, Function<void()>&& callback)
+    // The timer may fire up to `slack` after `expires`, which lets it be batched with other timers.
+    void setup(clockid_t clock_id, Duration expires, Function<void()>&& callback, Duration slack = {})
     {
         VERIFY(!is_queued());
         m_clock_id = clock_id;
         m_expires = expires;
+        m_slack = slack;
         m_callback = move(callback);
     }
 
@@ -41,7 +49,12 @@ private:
     TimerId m_id;
     clockid_t m_clock_id;
     Duration m_expires;
+    Duration m_slack {};
     Duration m_remaining {};
+    // The timer wheel tick this timer is due at, only used for monotonic timers.
+    u64 m_due_tick { 0 };
+    // The base this timer was queued on, which is the only one that ever touches it until it fired or was cancelled.
+    TimerBase* m_base { nullptr };
     Function<void()> m_callback;
     Atomic<bool> m_cancelled { false };
     Atomic<bool> m_callback_finished { false };
@@ -80,6 +93,57 @@ public:
     using List = IntrusiveList<&Timer::m_list_node>;
 };
 
+// Monotonic timers are kept in a hierarchical timing wheel (Varghese and Lauck, "Hashed and Hierarchical
+// Timing Wheels"), so that adding and cancelling one takes constant time, no matter how many are pending.
+// Each level has 64 slots, and one slot of a level spans all slots of the level below it. When the wheel
+// reaches a slot of a higher level, its timers are moved ("cascaded") down to the levels below, until they
+// expire from the lowest level. Timers that are due beyond the last level wait in an overflow list.
+class TimerWheel {
+public:
+    static constexpr Duration tick_duration = Duration::from_milliseconds(1);
+    static constexpr size_t bits_per_level = 6;
+    static constexpr size_t slots_per_level = 1 << bits_per_level;
+    static constexpr size_t level_count = 4;
+
+    // The tick that a timer expiring at `time` is due at, i.e. the first one that isn't before `time`.
+    static u64 tick_at_or_after(Duration const& time);
+    // The tick that `time` falls into.
+    static u64 tick_at_or_before(Duration const& time);
+
+    bool is_empty() const { return m_timer_count == 0; }
+
+    void add(Timer&, u64 now_tick);
+    void remove(Timer&);
+
+    // Takes the next timer that is due at or before `now_tick` off the wheel, or returns nullptr if there is none.
+    Timer* take_expired_timer(u64 now_tick);
+
+private:
+    static constexpr u64 slot_mask = slots_per_level - 1;
+
+    void insert(Timer&);
+    void cascade();
+    void reinsert_all(Timer::List&);
+
+    Array<Array<Timer::List, slots_per_level>, level_count> m_levels;
+    Timer::List m_overflow;
+    // Every tick before this one has been processed.
+    u64 m_current_tick { 0 };
+    size_t m_timer_count { 0 };
+};
+
+// Every processor queues the timers it adds on its own base, and fires them from its own timer interrupt.
+struct TimerBase {
+    Spinlock<LockRank::None> lock {};
+    TimerWheel monotonic_timers;
+    // Realtime timers are rare, and the realtime clock can jump around, so they are simply kept sorted by expiration.
+    Timer::List realtime_timers;
+    Timer::List timers_executing;
+    // Set once this processor's timer interrupt fired for the first time. Until then, timers added on it are
+    // queued on the bootstrap processor's base instead, since not every platform gives each processor its own timer.
+    Atomic<bool> receives_ticks { false };
+};
+
 class TimerQueue {
     friend class Timer;
 
@@ -89,38 +153,34 @@ public:
 
     TimerId add_timer(NonnullRefPtr<Timer>&&);
     bool add_timer_without_id(NonnullRefPtr<Timer>, clockid_t, Duration const&, Function<void()>&&);
+    bool add_timer_without_id(NonnullRefPtr<Timer>, clockid_t, Duration const& deadline, Duration const& slack, Function<void()>&&);
     bool cancel_timer(Timer& timer, bool* was_in_use = nullptr);
     void fire();
 
 private:
-    struct Queue {
-        Timer::List list;
-        Duration next_timer_due {};
-    };
-    void remove_timer_locked(Queue&, Timer&);
-    void update_next_timer_due(Queue&);
-    void add_timer_locked(NonnullRefPtr<Timer>);
-
-    Queue& queue_for_timer(Timer& timer)
+    static bool is_monotonic(clockid_t clock_id)
     {
-        switch (timer.m_clock_id) {
+        switch (clock_id) {
         case CLOCK_MONOTONIC:
         case CLOCK_MONOTONIC_COARSE:
         case CLOCK_MONOTONIC_RAW:
-            return m_timer_queue_monotonic;
+            return true;
         case CLOCK_REALTIME:
         case CLOCK_REALTIME_COARSE:
-            return m_timer_queue_realtime;
+            return false;
         default:
             VERIFY_NOT_REACHED();
         }
     }
 
-    u64 m_timer_id_count { 0 };
+    TimerBase& base_for_current_processor();
+    void remove_timer_locked(TimerBase&, Timer&);
+    void add_timer_locked(TimerBase&, NonnullRefPtr<Timer>);
+    void fire_timer_locked(TimerBase&, Timer&, SpinlockLocker<Spinlock<LockRank::None>>&);
+
+    Atomic<u64> m_timer_id_count { 0 };
     u64 m_ticks_per_second { 0 };
-    Queue m_timer_queue_monotonic;
-    Queue m_timer_queue_realtime;
-    Timer::List m_timers_executing;
+    Array<TimerBase, MAX_CPU_COUNT> m_bases;
 };
 
 }
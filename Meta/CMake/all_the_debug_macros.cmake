@@ -28,6 +28,7 @@ set(CSS_PARSER_DEBUG ON)
 set(CSS_TOKENIZER_DEBUG ON)
 set(CSS_TRANSITIONS_DEBUG ON)
 set(DDS_DEBUG ON)
+set(DENTRY_CACHE_DEBUG ON)
 set(DEVICETREE_DEBUG ON)
 set(DHCPV4CLIENT_DEBUG ON)
 set(DHCPV4_DEBUG ON)
@@ -143,6 +144,7 @@ set(NVME_DEBUG ON)
 set(OCCLUSIONS_DEBUG ON)
 set(OFFD_DEBUG ON)
 set(OPENTYPE_GPOS_DEBUG ON)
+set(PAGE_CACHE_DEBUG ON)
 set(PAGE_FAULT_DEBUG ON)
 set(HTML_PARSER_DEBUG ON)
 set(PATA_DEBUG ON)
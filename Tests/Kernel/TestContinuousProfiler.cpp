@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/JsonArray.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <LibCore/File.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr auto frequency_path = "/sys/kernel/conf/stack_sampling_frequency"sv;
+static constexpr auto samples_path = "/sys/kernel/stack_samples"sv;
+
+static Optional<ByteString> read_node(StringView path)
+{
+    auto file = Core::File::open(path, Core::File::OpenMode::Read);
+    if (file.is_error())
+        return {};
+    auto contents = file.value()->read_until_eof();
+    if (contents.is_error())
+        return {};
+    return ByteString(contents.value().bytes());
+}
+
+static int write_frequency(StringView value)
+{
+    int fd = open(ByteString(frequency_path).characters(), O_WRONLY | O_TRUNC);
+    if (fd < 0)
+        return -errno;
+    auto nwritten = write(fd, value.characters_without_null_termination(), value.length());
+    int saved_errno = errno;
+    close(fd);
+    return nwritten < 0 ? -saved_errno : 0;
+}
+
+static void spin_for_milliseconds(long milliseconds)
+{
+    timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (;;) {
+        timespec now;
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        auto elapsed = (now.tv_sec - start.tv_sec) * 1000 + (now.tv_nsec - start.tv_nsec) / 1'000'000;
+        if (elapsed >= milliseconds)
+            return;
+    }
+}
+
+TEST_CASE(rejects_invalid_frequencies)
+{
+    auto rc = write_frequency("not a number"sv);
+    if (rc == -EACCES || rc == -EPERM)
+        return;
+    EXPECT_EQ(rc, -EINVAL);
+    EXPECT_EQ(write_frequency("100000"sv), -EINVAL);
+}
+
+TEST_CASE(samples_are_aggregated_and_drained)
+{
+    auto original_frequency = read_node(frequency_path);
+    EXPECT(original_frequency.has_value());
+    if (!original_frequency.has_value())
+        return;
+
+    auto rc = write_frequency("250"sv);
+    if (rc == -EACCES || rc == -EPERM)
+        return;
+    EXPECT_EQ(rc, 0);
+    EXPECT_EQ(read_node(frequency_path), "250\n"sv);
+
+    // Drain whatever was sampled before, then keep a processor busy for a bit.
+    (void)read_node(samples_path);
+    spin_for_milliseconds(200);
+
+    auto contents = read_node(samples_path);
+    EXPECT(contents.has_value());
+    if (contents.has_value()) {
+        auto json = JsonValue::from_string(*contents);
+        EXPECT(!json.is_error());
+        if (!json.is_error()) {
+            auto const& samples = json.value().as_object();
+            EXPECT_EQ(samples.get_u32("frequency"sv), 250u);
+
+            u64 total_count = 0;
+            bool saw_this_process = false;
+            samples.get_array("stacks"sv)->for_each([&](JsonValue const& value) {
+                auto const& stack = value.as_object();
+                total_count += stack.get_u64("count"sv).value_or(0);
+                if (stack.get_i32("pid"sv) == getpid())
+                    saw_this_process = true;
+                EXPECT(stack.get_array("frames"sv)->size() <= 32);
+            });
+            EXPECT(total_count > 0);
+            EXPECT(saw_this_process);
+            EXPECT_EQ(total_count + samples.get_u64("dropped_samples"sv).value_or(0), samples.get_u64("samples"sv).value_or(0));
+        }
+    }
+
+    EXPECT_EQ(write_frequency(original_frequency->view()), 0);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Time.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr size_t appender_count = 4;
+static constexpr size_t blocks_per_file = 1024;
+
+static ByteString path_for_appender(size_t index)
+{
+    return ByteString::formatted("/home/anon/.ext2_parallel_append_{}", index);
+}
+
+static size_t block_size_of(int fd)
+{
+    struct statvfs stvfs;
+    VERIFY(fstatvfs(fd, &stvfs) == 0);
+    return stvfs.f_bsize;
+}
+
+// Counts the runs of blocks that are contiguous on disk.
+static size_t count_extents(int fd, size_t block_count)
+{
+    size_t extent_count = 0;
+    int previous_block = 0;
+    for (size_t i = 0; i < block_count; ++i) {
+        int block = static_cast<int>(i);
+        VERIFY(ioctl(fd, FIBMAP, &block) == 0);
+        VERIFY(block != 0);
+        if (i == 0 || block != previous_block + 1)
+            ++extent_count;
+        previous_block = block;
+    }
+    return extent_count;
+}
+
+struct Appender {
+    int fd { -1 };
+    size_t block_size { 0 };
+    bool failed { false };
+};
+
+static void* append_blocks(void* argument)
+{
+    auto& appender = *static_cast<Appender*>(argument);
+    auto* buffer = static_cast<u8*>(malloc(appender.block_size));
+    memset(buffer, 'A', appender.block_size);
+    for (size_t i = 0; i < blocks_per_file; ++i) {
+        if (write(appender.fd, buffer, appender.block_size) != static_cast<ssize_t>(appender.block_size)) {
+            appender.failed = true;
+            break;
+        }
+    }
+    free(buffer);
+    return nullptr;
+}
+
+TEST_CASE(parallel_appenders_get_contiguous_files)
+{
+    Appender appenders[appender_count];
+    pthread_t threads[appender_count];
+
+    auto cleanup_guard = ScopeGuard([&] {
+        for (size_t i = 0; i < appender_count; ++i) {
+            if (appenders[i].fd >= 0)
+                close(appenders[i].fd);
+            unlink(path_for_appender(i).characters());
+        }
+    });
+
+    for (size_t i = 0; i < appender_count; ++i) {
+        appenders[i].fd = open(path_for_appender(i).characters(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+        VERIFY(appenders[i].fd >= 0);
+        appenders[i].block_size = block_size_of(appenders[i].fd);
+    }
+
+    timespec start {};
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    for (size_t i = 0; i < appender_count; ++i)
+        VERIFY(pthread_create(&threads[i], nullptr, append_blocks, &appenders[i]) == 0);
+    for (size_t i = 0; i < appender_count; ++i)
+        VERIFY(pthread_join(threads[i], nullptr) == 0);
+
+    for (size_t i = 0; i < appender_count; ++i)
+        VERIFY(fsync(appenders[i].fd) == 0);
+
+    timespec end {};
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    auto elapsed = Duration::from_timespec(end) - Duration::from_timespec(start);
+
+    size_t total_bytes = 0;
+    size_t total_extents = 0;
+    for (size_t i = 0; i < appender_count; ++i) {
+        EXPECT(!appenders[i].failed);
+        auto extent_count = count_extents(appenders[i].fd, blocks_per_file);
+        // Every allocation reserves at least 8 blocks ahead of the file, so the files shouldn't be any more fragmented than that.
+        EXPECT(extent_count <= blocks_per_file / 8);
+        total_extents += extent_count;
+        total_bytes += blocks_per_file * appenders[i].block_size;
+    }
+
+    auto elapsed_ms = max(elapsed.to_milliseconds(), 1);
+    outln("{} appenders wrote {} KiB in {} ms ({} KiB/s), {} extents in total",
+        appender_count, total_bytes / KiB, elapsed_ms, total_bytes * 1000 / KiB / elapsed_ms, total_extents);
+}
+
+TEST_CASE(posix_fallocate_allocates_contiguous_blocks)
+{
+    static constexpr auto TEST_FILE_PATH = "/home/anon/.ext2_fallocate_test";
+
+    auto fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    auto block_size = block_size_of(fd);
+    size_t block_count = 256;
+    EXPECT_EQ(posix_fallocate(fd, 0, block_count * block_size), 0);
+
+    struct stat st;
+    EXPECT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(static_cast<size_t>(st.st_size), block_count * block_size);
+
+    // Every block should be backed by the disk, and read back as zeroes.
+    EXPECT(count_extents(fd, block_count) <= 4);
+
+    auto* buffer = static_cast<u8*>(malloc(block_size));
+    auto free_guard = ScopeGuard([&] { free(buffer); });
+    EXPECT_EQ(pread(fd, buffer, block_size, (block_count - 1) * block_size), static_cast<ssize_t>(block_size));
+    for (size_t i = 0; i < block_size; ++i)
+        EXPECT_EQ(buffer[i], 0);
+}
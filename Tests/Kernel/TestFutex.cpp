@@ -0,0 +1,201 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Time.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <pthread.h>
+#include <serenity.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr size_t maximum_thread_count = 8;
+
+static Duration now()
+{
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return Duration::from_timespec(ts);
+}
+
+static void wait_until_nonzero(u32* futex_word, bool process_shared)
+{
+    while (AK::atomic_load(futex_word) == 0)
+        futex_wait(futex_word, 0, nullptr, 0, process_shared);
+}
+
+TEST_CASE(shared_futex_across_processes)
+{
+    auto* futex_word = static_cast<u32*>(mmap(nullptr, sizeof(u32), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0));
+    VERIFY(futex_word != MAP_FAILED);
+    *futex_word = 0;
+
+    auto pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0) {
+        wait_until_nonzero(futex_word, true);
+        _exit(0);
+    }
+
+    usleep(10'000);
+    AK::atomic_store(futex_word, 1u);
+    futex_wake(futex_word, INT32_MAX, true);
+
+    int status = 0;
+    EXPECT_EQ(waitpid(pid, &status, 0), pid);
+    EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    munmap(futex_word, sizeof(u32));
+}
+
+static u32 s_condition;
+static u32 s_requeue_target;
+
+static void* wait_for_condition(void*)
+{
+    wait_until_nonzero(&s_condition, false);
+    return nullptr;
+}
+
+TEST_CASE(requeued_waiters_can_be_woken_from_the_target)
+{
+    // Run this twice, so the second round has to find (or recreate) the target queue left behind by the first.
+    for (size_t round = 0; round < 2; ++round) {
+        AK::atomic_store(&s_condition, 0u);
+        pthread_t threads[maximum_thread_count];
+        for (auto& thread : threads)
+            VERIFY(pthread_create(&thread, nullptr, wait_for_condition, nullptr) == 0);
+
+        // Move every waiter over without waking any of them, like pthread_cond_broadcast() does.
+        size_t requeued = 0;
+        auto deadline = now() + Duration::from_seconds(5);
+        while (requeued < maximum_thread_count && now() < deadline) {
+            auto rc = futex(&s_condition, FUTEX_CMP_REQUEUE | FUTEX_PRIVATE_FLAG, 0, reinterpret_cast<timespec const*>(INT32_MAX), &s_requeue_target, 0);
+            EXPECT(rc >= 0);
+            requeued += rc;
+            usleep(1000);
+        }
+        EXPECT_EQ(requeued, maximum_thread_count);
+
+        AK::atomic_store(&s_condition, 1u);
+        EXPECT_EQ(futex_wake(&s_requeue_target, INT32_MAX, false), static_cast<int>(maximum_thread_count));
+        for (auto& thread : threads)
+            EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    }
+}
+
+struct HandOff {
+    u32 turn { 0 };
+    Atomic<size_t> lost_wakes { 0 };
+};
+
+static constexpr size_t hand_off_round_trips = 20'000;
+
+// Waits for our turn, but gives up on a single wait after a second. The wakes happen right after the value
+// changes, so if a wait ever times out while it's already our turn, the wake that came with it was lost.
+static void wait_for_turn(HandOff& hand_off, u32 turn)
+{
+    while (AK::atomic_load(&hand_off.turn) != turn) {
+        timespec deadline {};
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &deadline);
+        deadline.tv_sec += 1;
+        if (futex_wait(&hand_off.turn, 1 - turn, &deadline, CLOCK_MONOTONIC_COARSE, false) < 0 && errno == ETIMEDOUT && AK::atomic_load(&hand_off.turn) == turn)
+            ++hand_off.lost_wakes;
+    }
+}
+
+static void* hand_back(void* argument)
+{
+    auto& hand_off = *static_cast<HandOff*>(argument);
+    for (size_t i = 0; i < hand_off_round_trips; ++i) {
+        wait_for_turn(hand_off, 1);
+        AK::atomic_store(&hand_off.turn, 0u);
+        futex_wake(&hand_off.turn, 1, false);
+    }
+    return nullptr;
+}
+
+TEST_CASE(wakes_racing_with_waits_are_not_lost)
+{
+    // The two threads hand the futex back and forth as fast as they can, so a wake often arrives
+    // between a waiter comparing the value and actually blocking.
+    HandOff hand_off;
+    pthread_t thread;
+    VERIFY(pthread_create(&thread, nullptr, hand_back, &hand_off) == 0);
+    for (size_t i = 0; i < hand_off_round_trips; ++i) {
+        AK::atomic_store(&hand_off.turn, 1u);
+        futex_wake(&hand_off.turn, 1, false);
+        wait_for_turn(hand_off, 0);
+    }
+    EXPECT_EQ(pthread_join(thread, nullptr), 0);
+    EXPECT_EQ(hand_off.lost_wakes.load(), 0u);
+}
+
+static constexpr size_t benchmark_duration_ms = 500;
+
+struct PingPong {
+    u32 turn { 0 };
+    size_t round_trips { 0 };
+    Atomic<bool> stop { false };
+};
+
+static void* pong(void* argument)
+{
+    auto& ping_pong = *static_cast<PingPong*>(argument);
+    while (!ping_pong.stop) {
+        if (AK::atomic_load(&ping_pong.turn) != 1) {
+            futex_wait(&ping_pong.turn, 0, nullptr, 0, false);
+            continue;
+        }
+        AK::atomic_store(&ping_pong.turn, 0u);
+        futex_wake(&ping_pong.turn, 1, false);
+    }
+    return nullptr;
+}
+
+static void* ping(void* argument)
+{
+    auto& ping_pong = *static_cast<PingPong*>(argument);
+    auto deadline = now() + Duration::from_milliseconds(benchmark_duration_ms);
+    while (now() < deadline) {
+        AK::atomic_store(&ping_pong.turn, 1u);
+        futex_wake(&ping_pong.turn, 1, false);
+        while (AK::atomic_load(&ping_pong.turn) != 0)
+            futex_wait(&ping_pong.turn, 1, nullptr, 0, false);
+        ++ping_pong.round_trips;
+    }
+    ping_pong.stop = true;
+    AK::atomic_store(&ping_pong.turn, 1u);
+    futex_wake(&ping_pong.turn, 1, false);
+    return nullptr;
+}
+
+BENCHMARK_CASE(independent_futex_ping_pong_scaling)
+{
+    // Every pair of threads bounces on its own futex, so nothing but the kernel is shared between the pairs.
+    size_t baseline = 0;
+    for (size_t pair_count = 1; pair_count <= maximum_thread_count / 2; pair_count *= 2) {
+        PingPong ping_pongs[maximum_thread_count / 2];
+        pthread_t threads[maximum_thread_count];
+        for (size_t i = 0; i < pair_count; ++i) {
+            VERIFY(pthread_create(&threads[2 * i], nullptr, pong, &ping_pongs[i]) == 0);
+            VERIFY(pthread_create(&threads[2 * i + 1], nullptr, ping, &ping_pongs[i]) == 0);
+        }
+        for (size_t i = 0; i < 2 * pair_count; ++i)
+            VERIFY(pthread_join(threads[i], nullptr) == 0);
+
+        size_t total = 0;
+        for (size_t i = 0; i < pair_count; ++i)
+            total += ping_pongs[i].round_trips;
+        size_t per_second = total * 1000 / benchmark_duration_ms;
+        if (pair_count == 1)
+            baseline = per_second;
+        outln("futex ping-pong: {} pair(s): {} round trips/s ({}.{:02}x)", pair_count, per_second,
+            per_second / max<size_t>(baseline, 1), per_second * 100 / max<size_t>(baseline, 1) % 100);
+    }
+}
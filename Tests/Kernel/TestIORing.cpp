@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Atomic.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <poll.h>
+#include <sys/io_ring.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct Ring {
+    int fd { -1 };
+    io_ring_header* header { nullptr };
+
+    Ring()
+    {
+        fd = create_io_ring(8, IO_RING_CLOEXEC);
+        VERIFY(fd >= 0);
+        auto* mapping = mmap(nullptr, PAGE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        VERIFY(mapping != MAP_FAILED);
+        header = static_cast<io_ring_header*>(mapping);
+    }
+
+    ~Ring()
+    {
+        munmap(header, PAGE_SIZE);
+        close(fd);
+    }
+
+    void queue(io_ring_submission submission)
+    {
+        auto* submissions = reinterpret_cast<io_ring_submission*>(reinterpret_cast<u8*>(header) + header->submissions_offset);
+        auto tail = header->submission_tail;
+        submissions[tail & (header->submission_entries - 1)] = submission;
+        AK::atomic_store(&header->submission_tail, tail + 1, AK::memory_order_release);
+    }
+
+    Vector<io_ring_completion> reap()
+    {
+        auto* completions = reinterpret_cast<io_ring_completion*>(reinterpret_cast<u8*>(header) + header->completions_offset);
+        Vector<io_ring_completion> result;
+        auto tail = AK::atomic_load(&header->completion_tail, AK::memory_order_acquire);
+        for (auto head = header->completion_head; head != tail; ++head)
+            result.append(completions[head & (header->completion_entries - 1)]);
+        AK::atomic_store(&header->completion_head, tail, AK::memory_order_release);
+        return result;
+    }
+};
+
+TEST_CASE(entries_are_validated)
+{
+    EXPECT_EQ(create_io_ring(0, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(create_io_ring(IO_RING_MAX_ENTRIES + 1, 0), -1);
+    EXPECT_EQ(errno, EINVAL);
+    EXPECT_EQ(create_io_ring(8, 0xff), -1);
+    EXPECT_EQ(errno, EINVAL);
+}
+
+TEST_CASE(nop_and_bad_fd)
+{
+    Ring ring;
+    EXPECT_EQ(ring.header->submission_entries, 8u);
+    EXPECT_EQ(ring.header->completion_entries, 16u);
+
+    ring.queue({ .opcode = IO_RING_OP_NOP, .user_data = 1 });
+    ring.queue({ .opcode = IO_RING_OP_READ, .fd = -1, .user_data = 2 });
+    EXPECT_EQ(io_ring_enter(ring.fd, 2, 2, nullptr), 2);
+
+    auto completions = ring.reap();
+    EXPECT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].user_data, 1u);
+    EXPECT_EQ(completions[0].result, 0);
+    EXPECT_EQ(completions[1].user_data, 2u);
+    EXPECT_EQ(completions[1].result, -EBADF);
+}
+
+TEST_CASE(read_waits_for_write_in_the_same_batch)
+{
+    Ring ring;
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    char input[] = "hello";
+    char output[sizeof(input)] {};
+    ring.queue({ .opcode = IO_RING_OP_READ, .fd = pipe_fds[0], .offset = IO_RING_CURRENT_OFFSET, .address = reinterpret_cast<FlatPtr>(output), .length = sizeof(output), .user_data = 1 });
+    ring.queue({ .opcode = IO_RING_OP_WRITE, .fd = pipe_fds[1], .offset = IO_RING_CURRENT_OFFSET, .address = reinterpret_cast<FlatPtr>(input), .length = sizeof(input), .user_data = 2 });
+    EXPECT_EQ(io_ring_enter(ring.fd, 2, 2, nullptr), 2);
+
+    auto completions = ring.reap();
+    EXPECT_EQ(completions.size(), 2u);
+    for (auto const& completion : completions)
+        EXPECT_EQ(completion.result, static_cast<i64>(sizeof(input)));
+    EXPECT_EQ(StringView(output, sizeof(output) - 1), "hello"sv);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+TEST_CASE(timeout_and_cancel)
+{
+    Ring ring;
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    ring.queue({ .opcode = IO_RING_OP_TIMEOUT, .offset = 10'000'000, .user_data = 1 });
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 1, nullptr), 1);
+    auto completions = ring.reap();
+    EXPECT_EQ(completions.size(), 1u);
+    EXPECT_EQ(completions[0].result, -ETIMEDOUT);
+
+    // Nothing is ever written, so the poll can only end by being cancelled.
+    ring.queue({ .opcode = IO_RING_OP_POLL, .fd = pipe_fds[0], .offset = POLLIN, .user_data = 2 });
+    timespec no_time {};
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 1, &no_time), 1);
+    EXPECT(ring.reap().is_empty());
+
+    ring.queue({ .opcode = IO_RING_OP_CANCEL, .offset = 2, .user_data = 3 });
+    EXPECT_EQ(io_ring_enter(ring.fd, 1, 2, nullptr), 1);
+    completions = ring.reap();
+    EXPECT_EQ(completions.size(), 2u);
+    EXPECT_EQ(completions[0].user_data, 2u);
+    EXPECT_EQ(completions[0].result, -ECANCELED);
+    EXPECT_EQ(completions[1].user_data, 3u);
+    EXPECT_EQ(completions[1].result, 0);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/Time.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+static Duration now(clockid_t clock_id = CLOCK_MONOTONIC)
+{
+    timespec ts {};
+    clock_gettime(clock_id, &ts);
+    return Duration::from_timespec(ts);
+}
+
+struct Sleeper {
+    clockid_t clock_id { CLOCK_MONOTONIC };
+    Duration duration;
+    Duration slept;
+};
+
+static void* sleep_and_measure(void* argument)
+{
+    auto& sleeper = *static_cast<Sleeper*>(argument);
+    auto start = now(sleeper.clock_id);
+    auto duration = sleeper.duration.to_timespec();
+    while (clock_nanosleep(sleeper.clock_id, 0, &duration, &duration) != 0)
+        ;
+    sleeper.slept = now(sleeper.clock_id) - start;
+    return nullptr;
+}
+
+TEST_CASE(timeouts_never_expire_early)
+{
+    // These straddle the boundaries between the levels of the kernel's timer wheel.
+    i64 const durations_ms[] = { 1, 3, 63, 64, 65, 100, 250, 4095, 4097 };
+    clockid_t const clock_ids[] = { CLOCK_MONOTONIC, CLOCK_MONOTONIC_COARSE, CLOCK_REALTIME };
+
+    Vector<Sleeper> sleepers;
+    for (auto clock_id : clock_ids) {
+        for (auto duration_ms : durations_ms)
+            sleepers.append({ .clock_id = clock_id, .duration = Duration::from_milliseconds(duration_ms), .slept = {} });
+    }
+
+    Vector<pthread_t> threads;
+    threads.resize(sleepers.size());
+    for (size_t i = 0; i < sleepers.size(); ++i)
+        VERIFY(pthread_create(&threads[i], nullptr, sleep_and_measure, &sleepers[i]) == 0);
+    for (auto thread : threads)
+        VERIFY(pthread_join(thread, nullptr) == 0);
+
+    for (auto const& sleeper : sleepers) {
+        // Coarse clocks only move once per tick, so they can't tell the last tick apart from the next one.
+        auto tolerance = sleeper.clock_id == CLOCK_MONOTONIC_COARSE ? Duration::from_milliseconds(10) : Duration::zero();
+        EXPECT(sleeper.slept + tolerance >= sleeper.duration);
+        // Don't be too picky about oversleeping, the machine running the tests might be busy.
+        EXPECT(sleeper.slept < sleeper.duration + Duration::from_seconds(1));
+    }
+}
+
+static int s_stop_pipe[2];
+
+static void* wait_for_stop(void*)
+{
+    pollfd fd { .fd = s_stop_pipe[0], .events = POLLIN, .revents = 0 };
+    // This keeps a timer pending for the whole benchmark.
+    (void)poll(&fd, 1, 60'000);
+    return nullptr;
+}
+
+static int s_ping_pipe[2];
+static int s_pong_pipe[2];
+
+static void* pong(void*)
+{
+    pollfd fd { .fd = s_ping_pipe[0], .events = POLLIN, .revents = 0 };
+    for (;;) {
+        if (poll(&fd, 1, 10'000) <= 0)
+            return nullptr;
+        char byte;
+        if (read(s_ping_pipe[0], &byte, 1) != 1 || byte == 0)
+            return nullptr;
+        VERIFY(write(s_pong_pipe[1], &byte, 1) == 1);
+    }
+}
+
+BENCHMARK_CASE(poll_with_timeout_while_many_timers_are_pending)
+{
+    static constexpr size_t round_trips = 20'000;
+    VERIFY(pipe(s_stop_pipe) == 0);
+    VERIFY(pipe(s_ping_pipe) == 0);
+    VERIFY(pipe(s_pong_pipe) == 0);
+
+    // Every poll() below arms a timeout and cancels it again when the other side answers in time.
+    size_t const pending_timer_counts[] = { 0, 128, 512 };
+    Vector<pthread_t> waiters;
+    for (auto pending_timer_count : pending_timer_counts) {
+        while (waiters.size() < pending_timer_count) {
+            pthread_t thread;
+            VERIFY(pthread_create(&thread, nullptr, wait_for_stop, nullptr) == 0);
+            waiters.append(thread);
+        }
+
+        pthread_t pong_thread;
+        VERIFY(pthread_create(&pong_thread, nullptr, pong, nullptr) == 0);
+
+        auto start = now();
+        pollfd fd { .fd = s_pong_pipe[0], .events = POLLIN, .revents = 0 };
+        for (size_t i = 0; i < round_trips; ++i) {
+            char byte = 1;
+            VERIFY(write(s_ping_pipe[1], &byte, 1) == 1);
+            VERIFY(poll(&fd, 1, 10'000) == 1);
+            VERIFY(read(s_pong_pipe[0], &byte, 1) == 1);
+        }
+        auto elapsed = now() - start;
+
+        char stop = 0;
+        VERIFY(write(s_ping_pipe[1], &stop, 1) == 1);
+        VERIFY(pthread_join(pong_thread, nullptr) == 0);
+
+        outln("{} pending timers: {} ns per round trip", pending_timer_count, elapsed.to_nanoseconds() / static_cast<i64>(round_trips));
+    }
+
+    VERIFY(close(s_stop_pipe[1]) == 0);
+    for (auto thread : waiters)
+        VERIFY(pthread_join(thread, nullptr) == 0);
+    for (int fd : { s_stop_pipe[0], s_ping_pipe[0], s_ping_pipe[1], s_pong_pipe[0], s_pong_pipe[1] })
+        close(fd);
+}
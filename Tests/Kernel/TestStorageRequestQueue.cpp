@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/JsonObject.h>
+#include <AK/JsonValue.h>
+#include <AK/ScopeGuard.h>
+#include <AK/Vector.h>
+#include <LibTest/TestCase.h>
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/statvfs.h>
+#include <unistd.h>
+
+static Vector<ByteString> storage_device_directories()
+{
+    Vector<ByteString> directories;
+    auto* dir = opendir("/sys/devices/storage");
+    if (!dir)
+        return directories;
+    while (auto* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.')
+            directories.append(ByteString::formatted("/sys/devices/storage/{}", entry->d_name));
+    }
+    closedir(dir);
+    return directories;
+}
+
+static Optional<ByteString> read_attribute(ByteString const& path)
+{
+    int fd = open(path.characters(), O_RDONLY);
+    if (fd < 0)
+        return {};
+    char buffer[4096];
+    auto nread = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    if (nread < 0)
+        return {};
+    return ByteString(buffer, nread);
+}
+
+struct QueueStatistics {
+    u64 requests { 0 };
+    u64 dispatched_requests { 0 };
+    u64 merged_requests { 0 };
+    u64 plugs { 0 };
+    u64 queued_requests { 0 };
+    u64 max_blocks_per_request { 0 };
+};
+
+static Optional<QueueStatistics> read_queue_statistics(ByteString const& directory)
+{
+    auto contents = read_attribute(ByteString::formatted("{}/queue_statistics", directory));
+    if (!contents.has_value())
+        return {};
+    auto json = JsonValue::from_string(*contents);
+    if (json.is_error() || !json.value().is_object())
+        return {};
+    auto const& statistics = json.value().as_object();
+    return QueueStatistics {
+        .requests = statistics.get_u64("requests"sv).value_or(0),
+        .dispatched_requests = statistics.get_u64("dispatched_requests"sv).value_or(0),
+        .merged_requests = statistics.get_u64("merged_requests"sv).value_or(0),
+        .plugs = statistics.get_u64("plugs"sv).value_or(0),
+        .queued_requests = statistics.get_u64("queued_requests"sv).value_or(0),
+        .max_blocks_per_request = statistics.get_u64("max_blocks_per_request"sv).value_or(0),
+    };
+}
+
+TEST_CASE(queue_statistics_are_consistent)
+{
+    for (auto const& directory : storage_device_directories()) {
+        auto contents = read_attribute(ByteString::formatted("{}/queue_statistics", directory));
+        EXPECT(contents.has_value());
+        if (!contents.has_value())
+            continue;
+
+        auto json = JsonValue::from_string(*contents);
+        EXPECT(!json.is_error());
+        if (json.is_error())
+            continue;
+        EXPECT(json.value().is_object());
+        auto const& statistics = json.value().as_object();
+
+        auto scheduler = statistics.get_byte_string("scheduler"sv);
+        EXPECT(scheduler == "fifo"sv || scheduler == "deadline"sv);
+        auto requests = statistics.get_u64("requests"sv).value_or(0);
+        auto dispatched_requests = statistics.get_u64("dispatched_requests"sv).value_or(0);
+        auto merged_requests = statistics.get_u64("merged_requests"sv).value_or(0);
+        // Every merged request stands in for at least two of the requests that were added.
+        EXPECT(merged_requests <= requests);
+        EXPECT(dispatched_requests <= requests);
+        EXPECT(statistics.get_u64("queued_requests"sv).value_or(0) <= statistics.get_u64("max_queued_requests"sv).value_or(0));
+    }
+}
+
+TEST_CASE(scheduler_can_be_switched)
+{
+    for (auto const& directory : storage_device_directories()) {
+        auto path = ByteString::formatted("{}/scheduler", directory);
+        auto original_scheduler = read_attribute(path);
+        EXPECT(original_scheduler.has_value());
+        if (!original_scheduler.has_value())
+            continue;
+
+        int fd = open(path.characters(), O_WRONLY | O_TRUNC);
+        if (fd < 0 && (errno == EPERM || errno == EACCES)) {
+            warnln("Skipping {}: {}", path, strerror(errno));
+            continue;
+        }
+        EXPECT(fd >= 0);
+        if (fd < 0)
+            continue;
+
+        EXPECT_EQ(write(fd, "fifo\n", 5), 5);
+        EXPECT_EQ(read_attribute(path).value_or({}), "fifo"sv);
+
+        errno = 0;
+        EXPECT_EQ(write(fd, "elevator", 8), -1);
+        EXPECT_EQ(errno, EINVAL);
+        EXPECT_EQ(read_attribute(path).value_or({}), "fifo"sv);
+
+        auto restored = write(fd, original_scheduler->characters(), original_scheduler->length());
+        EXPECT_EQ(restored, static_cast<ssize_t>(original_scheduler->length()));
+        EXPECT_EQ(read_attribute(path).value_or({}), *original_scheduler);
+        close(fd);
+    }
+}
+
+TEST_CASE(adjacent_blocks_are_merged_while_plugged)
+{
+    // NOTE: Regular files write their data back through the page cache, so we create a bunch of files instead.
+    //       That dirties neighboring inode table and directory blocks, which fsync() then flushes under a plug.
+    static constexpr auto TEST_DIRECTORY_PATH = "/home/anon/.storage_request_queue_test";
+    static constexpr size_t file_count = 256;
+
+    VERIFY(mkdir(TEST_DIRECTORY_PATH, 0755) == 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        for (size_t i = 0; i < file_count; ++i)
+            unlink(ByteString::formatted("{}/{}", TEST_DIRECTORY_PATH, i).characters());
+        rmdir(TEST_DIRECTORY_PATH);
+    });
+
+    struct statvfs file_system_info;
+    VERIFY(statvfs(TEST_DIRECTORY_PATH, &file_system_info) == 0);
+
+    auto directories = storage_device_directories();
+    Vector<Optional<QueueStatistics>> statistics_before;
+    for (auto const& directory : directories)
+        statistics_before.append(read_queue_statistics(directory));
+
+    for (size_t i = 0; i < file_count; ++i) {
+        int fd = open(ByteString::formatted("{}/{}", TEST_DIRECTORY_PATH, i).characters(), O_WRONLY | O_CREAT | O_EXCL, 0644);
+        VERIFY(fd >= 0);
+        close(fd);
+    }
+    int directory_fd = open(TEST_DIRECTORY_PATH, O_RDONLY | O_DIRECTORY);
+    VERIFY(directory_fd >= 0);
+    EXPECT_EQ(fsync(directory_fd), 0);
+    close(directory_fd);
+
+    bool found_device = false;
+    for (size_t i = 0; i < directories.size(); ++i) {
+        auto const& before = statistics_before[i];
+        auto after = read_queue_statistics(directories[i]);
+        if (!before.has_value() || !after.has_value() || after->requests == before->requests)
+            continue;
+        found_device = true;
+
+        auto sector_size = read_attribute(ByteString::formatted("{}/sector_size", directories[i])).value_or({}).to_number<u64>().value_or(0);
+        EXPECT(sector_size > 0);
+        if (sector_size == 0)
+            continue;
+
+        // Requests that left the queue since we started, whether on their own or merged into another one.
+        auto taken_requests = after->requests - before->requests + before->queued_requests - after->queued_requests;
+        auto dispatched_requests = after->dispatched_requests - before->dispatched_requests;
+        auto merged_requests = after->merged_requests - before->merged_requests;
+        EXPECT(after->plugs > before->plugs);
+        EXPECT(dispatched_requests > 0);
+        // Each merged request stands in for at least two of the taken ones, but is only dispatched once.
+        EXPECT(dispatched_requests + merged_requests / 2 <= taken_requests);
+
+        // The driver might not take more than a single file system block in one request, in which case there's nothing to merge.
+        if (2 * file_system_info.f_bsize / sector_size <= after->max_blocks_per_request) {
+            EXPECT(merged_requests > 0);
+            EXPECT(dispatched_requests < taken_requests);
+        }
+    }
+    EXPECT(found_device);
+}
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <AK/Time.h>
+#include <LibTest/TestCase.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr size_t maximum_thread_count = 8;
+static constexpr size_t record_size = 512;
+static constexpr size_t records_per_thread = 256;
+
+static Duration now()
+{
+    timespec ts {};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return Duration::from_timespec(ts);
+}
+
+struct Worker {
+    int fd { -1 };
+    int peer_fd { -1 };
+    size_t index { 0 };
+    size_t operations { 0 };
+    bool failed { false };
+};
+
+static void run_workers(size_t thread_count, Worker* workers, void* (*function)(void*))
+{
+    pthread_t threads[maximum_thread_count];
+    for (size_t i = 0; i < thread_count; ++i)
+        VERIFY(pthread_create(&threads[i], nullptr, function, &workers[i]) == 0);
+    for (size_t i = 0; i < thread_count; ++i)
+        VERIFY(pthread_join(threads[i], nullptr) == 0);
+}
+
+static void fill_record(u8* record, size_t writer, size_t sequence)
+{
+    memset(record, 'a' + static_cast<int>(writer), record_size);
+    memcpy(record, &sequence, sizeof(sequence));
+}
+
+static void* write_records(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    u8 record[record_size];
+    for (size_t i = 0; i < records_per_thread; ++i) {
+        fill_record(record, worker.index, i);
+        if (write(worker.fd, record, record_size) != static_cast<ssize_t>(record_size)) {
+            worker.failed = true;
+            break;
+        }
+    }
+    return nullptr;
+}
+
+// Every record must come out whole: Concurrent writes through the same description must not
+// land at the same offset, and must not interleave within a single write.
+static void verify_records(int fd, size_t thread_count)
+{
+    struct stat st;
+    EXPECT_EQ(fstat(fd, &st), 0);
+    EXPECT_EQ(static_cast<size_t>(st.st_size), thread_count * records_per_thread * record_size);
+
+    size_t records_seen[maximum_thread_count] {};
+    u8 record[record_size];
+    for (size_t offset = 0; offset < static_cast<size_t>(st.st_size); offset += record_size) {
+        EXPECT_EQ(pread(fd, record, record_size, offset), static_cast<ssize_t>(record_size));
+        size_t writer = record[record_size - 1] - 'a';
+        EXPECT(writer < thread_count);
+        if (writer >= thread_count)
+            return;
+        size_t sequence;
+        memcpy(&sequence, record, sizeof(sequence));
+        // Each writer's records must appear in the order it wrote them.
+        EXPECT_EQ(sequence, records_seen[writer]);
+        for (size_t i = sizeof(sequence); i < record_size; ++i)
+            EXPECT_EQ(record[i], record[record_size - 1]);
+        ++records_seen[writer];
+    }
+}
+
+TEST_CASE(concurrent_writes_share_the_file_offset)
+{
+    static constexpr auto TEST_FILE_PATH = "/tmp/threaded_write_test";
+    auto fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    Worker workers[maximum_thread_count];
+    for (size_t i = 0; i < maximum_thread_count; ++i)
+        workers[i] = { .fd = fd, .index = i };
+    run_workers(maximum_thread_count, workers, write_records);
+
+    for (auto& worker : workers)
+        EXPECT(!worker.failed);
+    verify_records(fd, maximum_thread_count);
+}
+
+TEST_CASE(concurrent_appends_do_not_overwrite_each_other)
+{
+    static constexpr auto TEST_FILE_PATH = "/tmp/threaded_append_test";
+    auto fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+
+    // Every thread gets its own description, so only O_APPEND keeps them apart.
+    Worker workers[maximum_thread_count];
+    for (size_t i = 0; i < maximum_thread_count; ++i) {
+        workers[i] = { .fd = open(TEST_FILE_PATH, O_WRONLY | O_APPEND), .index = i };
+        VERIFY(workers[i].fd >= 0);
+    }
+    run_workers(maximum_thread_count, workers, write_records);
+
+    for (auto& worker : workers) {
+        EXPECT(!worker.failed);
+        close(worker.fd);
+    }
+    verify_records(fd, maximum_thread_count);
+}
+
+static constexpr size_t benchmark_duration_ms = 500;
+
+static void* pread_until_deadline(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    u8 buffer[record_size];
+    auto deadline = now() + Duration::from_milliseconds(benchmark_duration_ms);
+    while (now() < deadline) {
+        for (size_t i = 0; i < 64; ++i) {
+            if (pread(worker.fd, buffer, record_size, ((worker.operations + i) % records_per_thread) * record_size) != static_cast<ssize_t>(record_size)) {
+                worker.failed = true;
+                return nullptr;
+            }
+        }
+        worker.operations += 64;
+    }
+    return nullptr;
+}
+
+static void* socket_round_trips_until_deadline(void* argument)
+{
+    auto& worker = *static_cast<Worker*>(argument);
+    u8 buffer[record_size] {};
+    iovec iov { buffer, record_size };
+    msghdr message {};
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    auto deadline = now() + Duration::from_milliseconds(benchmark_duration_ms);
+    while (now() < deadline) {
+        if (sendmsg(worker.fd, &message, 0) != static_cast<ssize_t>(record_size)
+            || recvmsg(worker.peer_fd, &message, 0) != static_cast<ssize_t>(record_size)) {
+            worker.failed = true;
+            return nullptr;
+        }
+        ++worker.operations;
+    }
+    return nullptr;
+}
+
+static void print_scaling(StringView name, size_t thread_count, Worker const* workers, size_t baseline)
+{
+    size_t total = 0;
+    for (size_t i = 0; i < thread_count; ++i)
+        total += workers[i].operations;
+    size_t per_second = total * 1000 / benchmark_duration_ms;
+    outln("{}: {} thread(s): {} ops/s ({}.{:02}x)", name, thread_count, per_second,
+        per_second / max<size_t>(baseline, 1), per_second * 100 / max<size_t>(baseline, 1) % 100);
+}
+
+BENCHMARK_CASE(threaded_pread_scaling)
+{
+    static constexpr auto TEST_FILE_PATH = "/tmp/threaded_pread_benchmark";
+    auto fd = open(TEST_FILE_PATH, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    VERIFY(fd >= 0);
+    auto cleanup_guard = ScopeGuard([&] {
+        close(fd);
+        unlink(TEST_FILE_PATH);
+    });
+    u8 record[record_size] {};
+    for (size_t i = 0; i < records_per_thread; ++i)
+        VERIFY(write(fd, record, record_size) == static_cast<ssize_t>(record_size));
+
+    size_t baseline = 0;
+    for (size_t thread_count = 1; thread_count <= maximum_thread_count; thread_count *= 2) {
+        Worker workers[maximum_thread_count];
+        for (size_t i = 0; i < thread_count; ++i)
+            workers[i] = { .fd = fd, .index = i };
+        run_workers(thread_count, workers, pread_until_deadline);
+        for (size_t i = 0; i < thread_count; ++i)
+            EXPECT(!workers[i].failed);
+        if (thread_count == 1)
+            baseline = workers[0].operations * 1000 / benchmark_duration_ms;
+        print_scaling("pread"sv, thread_count, workers, baseline);
+    }
+}
+
+BENCHMARK_CASE(threaded_sendmsg_recvmsg_scaling)
+{
+    size_t baseline = 0;
+    for (size_t thread_count = 1; thread_count <= maximum_thread_count; thread_count *= 2) {
+        Worker workers[maximum_thread_count];
+        for (size_t i = 0; i < thread_count; ++i) {
+            int fds[2];
+            VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+            workers[i] = { .fd = fds[0], .peer_fd = fds[1], .index = i };
+        }
+        run_workers(thread_count, workers, socket_round_trips_until_deadline);
+        for (size_t i = 0; i < thread_count; ++i) {
+            EXPECT(!workers[i].failed);
+            close(workers[i].fd);
+            close(workers[i].peer_fd);
+        }
+        if (thread_count == 1)
+            baseline = workers[0].operations * 1000 / benchmark_duration_ms;
+        print_scaling("sendmsg+recvmsg"sv, thread_count, workers, baseline);
+    }
+}
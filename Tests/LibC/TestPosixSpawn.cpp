@@ -0,0 +1,228 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ByteString.h>
+#include <AK/Format.h>
+#include <LibTest/TestCase.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+static constexpr auto output_path = "/tmp/posix-spawn-output";
+
+static int wait_for_exit_status(pid_t pid)
+{
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid)
+        return -1;
+    if (!WIFEXITED(status))
+        return -1;
+    return WEXITSTATUS(status);
+}
+
+static ByteString read_output()
+{
+    char buffer[256];
+    int fd = open(output_path, O_RDONLY);
+    if (fd < 0)
+        return {};
+    auto nread = read(fd, buffer, sizeof(buffer));
+    close(fd);
+    unlink(output_path);
+    if (nread < 0)
+        return {};
+    return ByteString(buffer, nread);
+}
+
+static int spawn_with_output_redirected(char const* path, char* const argv[], posix_spawn_file_actions_t* file_actions, pid_t* out_pid)
+{
+    posix_spawn_file_actions_addopen(file_actions, STDOUT_FILENO, output_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    return posix_spawn(out_pid, path, file_actions, nullptr, argv, environ);
+}
+
+TEST_CASE(spawn_runs_the_program)
+{
+    char const* argv[] = { "true", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(posix_spawn(&pid, "/bin/true", nullptr, nullptr, const_cast<char* const*>(argv), environ), 0);
+    EXPECT(pid > 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
+
+TEST_CASE(spawn_reports_a_missing_executable)
+{
+    char const* argv[] = { "does-not-exist", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(posix_spawn(&pid, "/bin/does-not-exist", nullptr, nullptr, const_cast<char* const*>(argv), environ), ENOENT);
+    EXPECT_EQ(pid, -1);
+}
+
+TEST_CASE(spawnp_searches_path)
+{
+    char const* argv[] = { "true", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(posix_spawnp(&pid, "true", nullptr, nullptr, const_cast<char* const*>(argv), environ), 0);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
+
+TEST_CASE(file_actions_open_and_chdir)
+{
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addchdir(&file_actions, "/usr");
+
+    char const* argv[] = { "pwd", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(spawn_with_output_redirected("/bin/pwd", const_cast<char* const*>(argv), &file_actions, &pid), 0);
+    posix_spawn_file_actions_destroy(&file_actions);
+
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+    EXPECT_EQ(read_output(), "/usr\n"sv);
+}
+
+TEST_CASE(file_actions_dup2_and_close)
+{
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_adddup2(&file_actions, pipe_fds[0], STDIN_FILENO);
+    posix_spawn_file_actions_addclose(&file_actions, pipe_fds[0]);
+    posix_spawn_file_actions_addclose(&file_actions, pipe_fds[1]);
+
+    char const* argv[] = { "cat", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(spawn_with_output_redirected("/bin/cat", const_cast<char* const*>(argv), &file_actions, &pid), 0);
+    posix_spawn_file_actions_destroy(&file_actions);
+
+    close(pipe_fds[0]);
+    EXPECT_EQ(write(pipe_fds[1], "hello", 5), 5);
+    close(pipe_fds[1]);
+
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+    EXPECT_EQ(read_output(), "hello"sv);
+}
+
+TEST_CASE(failing_file_action_fails_the_spawn)
+{
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addclose(&file_actions, 1000);
+
+    char const* argv[] = { "true", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(posix_spawn(&pid, "/bin/true", &file_actions, nullptr, const_cast<char* const*>(argv), environ), EBADF);
+    posix_spawn_file_actions_destroy(&file_actions);
+    EXPECT_EQ(pid, -1);
+}
+
+TEST_CASE(unpledged_file_action_fails_without_killing_the_parent)
+{
+    // The pledge has to happen in a process of its own, so that it doesn't affect the other tests.
+    pid_t parent = fork();
+    EXPECT(parent >= 0);
+    if (parent == 0) {
+        if (pledge("stdio proc exec", nullptr) < 0)
+            _exit(2);
+        posix_spawn_file_actions_t file_actions;
+        posix_spawn_file_actions_init(&file_actions);
+        char const* argv[] = { "true", nullptr };
+        pid_t pid = -1;
+        int rc = spawn_with_output_redirected("/bin/true", const_cast<char* const*>(argv), &file_actions, &pid);
+        _exit(rc == EPERM && pid == -1 ? 0 : 1);
+    }
+    EXPECT_EQ(wait_for_exit_status(parent), 0);
+}
+
+TEST_CASE(attributes_setpgroup)
+{
+    int pipe_fds[2];
+    EXPECT_EQ(pipe(pipe_fds), 0);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_adddup2(&file_actions, pipe_fds[0], STDIN_FILENO);
+    posix_spawn_file_actions_addclose(&file_actions, pipe_fds[1]);
+
+    posix_spawnattr_t attr;
+    posix_spawnattr_init(&attr);
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETPGROUP);
+    posix_spawnattr_setpgroup(&attr, 0);
+
+    // cat keeps running until we close the write end of its stdin, so we can look at it in the meantime.
+    char const* argv[] = { "cat", nullptr };
+    pid_t pid = -1;
+    EXPECT_EQ(posix_spawn(&pid, "/bin/cat", &file_actions, &attr, const_cast<char* const*>(argv), environ), 0);
+    posix_spawn_file_actions_destroy(&file_actions);
+    posix_spawnattr_destroy(&attr);
+
+    EXPECT_EQ(getpgid(pid), pid);
+
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+    EXPECT_EQ(wait_for_exit_status(pid), 0);
+}
+
+static void* grow_resident_set(size_t size)
+{
+    if (size == 0)
+        return nullptr;
+    auto* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+    VERIFY(memory != MAP_FAILED);
+    memset(memory, 0xaa, size);
+    return memory;
+}
+
+static u64 now_in_microseconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<u64>(now.tv_sec) * 1'000'000 + now.tv_nsec / 1000;
+}
+
+// Spawns /bin/true a number of times, both through posix_spawn() and fork()+execve(), with an
+// increasingly large parent. posix_spawn() shouldn't care how large the parent is.
+BENCHMARK_CASE(spawn_latency_by_parent_size)
+{
+    static constexpr size_t iterations = 20;
+    char const* argv[] = { "true", nullptr };
+
+    for (size_t megabytes : { 0, 16, 64, 256 }) {
+        size_t size = megabytes * MiB;
+        auto* memory = grow_resident_set(size);
+
+        auto spawn_start = now_in_microseconds();
+        for (size_t i = 0; i < iterations; ++i) {
+            pid_t pid;
+            EXPECT_EQ(posix_spawn(&pid, "/bin/true", nullptr, nullptr, const_cast<char* const*>(argv), environ), 0);
+            EXPECT_EQ(wait_for_exit_status(pid), 0);
+        }
+        auto spawn_time = (now_in_microseconds() - spawn_start) / iterations;
+
+        auto fork_start = now_in_microseconds();
+        for (size_t i = 0; i < iterations; ++i) {
+            pid_t pid = fork();
+            if (pid == 0) {
+                execve("/bin/true", const_cast<char* const*>(argv), environ);
+                _exit(127);
+            }
+            EXPECT(pid > 0);
+            EXPECT_EQ(wait_for_exit_status(pid), 0);
+        }
+        auto fork_time = (now_in_microseconds() - fork_start) / iterations;
+
+        outln("parent with {:>3} MiB touched: posix_spawn {:>6} us, fork+execve {:>6} us", megabytes, spawn_time, fork_time);
+
+        if (memory)
+            munmap(memory, size);
+    }
+}
@@ -0,0 +1,243 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/MemoryStream.h>
+#include <LibCore/ElapsedTimer.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/Socket.h>
+#include <LibCore/System.h>
+#include <LibIPC/Connection.h>
+#include <LibIPC/Decoder.h>
+#include <LibIPC/Encoder.h>
+#include <LibIPC/Stub.h>
+#include <LibTest/TestCase.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+
+// A hand-written endpoint with a single message, which carries a payload and optionally a file descriptor.
+// Both sides of the connection speak it, and the server sends every message right back.
+static constexpr u32 test_endpoint_magic = 0x1bc7e57;
+
+class PayloadMessage final : public IPC::Message {
+public:
+    PayloadMessage(ByteBuffer payload, Optional<IPC::File> file)
+        : m_payload(move(payload))
+        , m_file(move(file))
+    {
+    }
+
+    virtual u32 endpoint_magic() const override { return test_endpoint_magic; }
+    virtual int message_id() const override { return static_message_id(); }
+    static i32 static_message_id() { return 1; }
+    virtual char const* message_name() const override { return "Test::Payload"; }
+    virtual bool valid() const override { return true; }
+
+    static ErrorOr<NonnullOwnPtr<PayloadMessage>> decode(Stream& stream, Queue<IPC::File>& files)
+    {
+        IPC::Decoder decoder { stream, files };
+        auto payload = TRY(decoder.decode<ByteBuffer>());
+        auto file = TRY(decoder.decode<Optional<IPC::File>>());
+        return make<PayloadMessage>(move(payload), move(file));
+    }
+
+    virtual ErrorOr<IPC::MessageBuffer> encode() const override
+    {
+        IPC::MessageBuffer buffer;
+        IPC::Encoder stream(buffer);
+        TRY(stream.encode(endpoint_magic()));
+        TRY(stream.encode(message_id()));
+        TRY(stream.encode(m_payload));
+        TRY(stream.encode(m_file));
+        return buffer;
+    }
+
+    ByteBuffer const& payload() const { return m_payload; }
+    Optional<IPC::File> const& file() const { return m_file; }
+
+private:
+    ByteBuffer m_payload;
+    Optional<IPC::File> m_file;
+};
+
+class TestEndpoint {
+public:
+    static u32 static_magic() { return test_endpoint_magic; }
+
+    static ErrorOr<NonnullOwnPtr<IPC::Message>> decode_message(ReadonlyBytes buffer, Queue<IPC::File>& files)
+    {
+        FixedMemoryStream stream { buffer };
+        if (TRY(stream.read_value<u32>()) != test_endpoint_magic)
+            return Error::from_string_literal("Endpoint magic number mismatch, not my message!");
+        if (TRY(stream.read_value<i32>()) != PayloadMessage::static_message_id())
+            return Error::from_string_literal("Failed to decode Test message");
+        return TRY(PayloadMessage::decode(stream, files));
+    }
+};
+
+class TestConnection final
+    : public IPC::Stub
+    , public IPC::Connection<TestEndpoint, TestEndpoint> {
+    C_OBJECT(TestConnection);
+
+public:
+    virtual u32 magic() const override { return test_endpoint_magic; }
+    virtual ByteString name() const override { return "Test"; }
+
+    virtual ErrorOr<OwnPtr<IPC::MessageBuffer>> handle(IPC::Message const& message) override
+    {
+        auto const& payload_message = static_cast<PayloadMessage const&>(message);
+        Optional<IPC::File> file;
+        if (payload_message.file().has_value())
+            file = IPC::File::adopt_fd(payload_message.file()->take_fd());
+        auto response = TRY(PayloadMessage(TRY(ByteBuffer::copy(payload_message.payload())), move(file)).encode());
+        return make<IPC::MessageBuffer>(move(response));
+    }
+
+    virtual void die() override
+    {
+        // This is only ever called in the echo server, once the test closed its end of the connection.
+        _exit(0);
+    }
+
+    NonnullOwnPtr<PayloadMessage> round_trip(ByteBuffer payload, Optional<IPC::File> file = {})
+    {
+        MUST(post_message(PayloadMessage(move(payload), move(file))));
+        auto response = wait_for_specific_message<PayloadMessage>();
+        VERIFY(response);
+        return response.release_nonnull();
+    }
+
+private:
+    explicit TestConnection(NonnullOwnPtr<Core::LocalSocket> socket)
+        : IPC::Connection<TestEndpoint, TestEndpoint>(*this, move(socket))
+    {
+    }
+};
+
+struct EchoServer {
+    NonnullRefPtr<TestConnection> connection;
+    pid_t pid;
+
+    ~EchoServer()
+    {
+        connection->socket().close();
+        int status = 0;
+        VERIFY(waitpid(pid, &status, 0) == pid);
+        EXPECT(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+};
+
+static EchoServer spawn_echo_server()
+{
+    int fds[2];
+    VERIFY(socketpair(AF_LOCAL, SOCK_STREAM, 0, fds) == 0);
+
+    auto pid = fork();
+    VERIFY(pid >= 0);
+    if (pid == 0) {
+        close(fds[0]);
+        Core::EventLoop loop;
+        auto socket = MUST(Core::LocalSocket::adopt_fd(fds[1]));
+        MUST(socket->set_blocking(true));
+        auto connection = TestConnection::construct(move(socket));
+        loop.exec();
+        _exit(1);
+    }
+
+    close(fds[1]);
+    auto socket = MUST(Core::LocalSocket::adopt_fd(fds[0]));
+    MUST(socket->set_blocking(true));
+    return EchoServer { TestConnection::construct(move(socket)), pid };
+}
+
+static ByteBuffer make_payload(size_t size)
+{
+    auto payload = MUST(ByteBuffer::create_uninitialized(size));
+    for (size_t i = 0; i < size; ++i)
+        payload[i] = static_cast<u8>(i * 7 + (i >> 12));
+    return payload;
+}
+
+TEST_CASE(messages_around_the_out_of_line_threshold)
+{
+    Core::EventLoop loop;
+    auto server = spawn_echo_server();
+
+    size_t const sizes[] = { 1, 4096, IPC::out_of_line_message_threshold - 64, IPC::out_of_line_message_threshold, IPC::out_of_line_message_threshold + 1, 1 * MiB + 123 };
+    for (auto size : sizes) {
+        auto payload = make_payload(size);
+        auto response = server.connection->round_trip(MUST(ByteBuffer::copy(payload)));
+        EXPECT_EQ(response->payload(), payload);
+    }
+}
+
+TEST_CASE(messages_larger_than_the_socket_buffer)
+{
+    Core::EventLoop loop;
+    auto server = spawn_echo_server();
+
+    // These used to take dozens of partial writes, spinning the event loop in between.
+    auto payload = make_payload(16 * MiB);
+    auto response = server.connection->round_trip(MUST(ByteBuffer::copy(payload)));
+    EXPECT_EQ(response->payload(), payload);
+}
+
+TEST_CASE(out_of_line_message_with_file_descriptor)
+{
+    Core::EventLoop loop;
+    auto server = spawn_echo_server();
+
+    // The payload's anonymous file travels alongside the message's own file descriptors,
+    // and they must not get mixed up, even with in-line messages interleaved.
+    size_t const sizes[] = { 1 * MiB, 16, 256 * KiB };
+    for (auto size : sizes) {
+        auto pipe_fds = MUST(Core::System::pipe2(0));
+        auto payload = make_payload(size);
+        auto response = server.connection->round_trip(MUST(ByteBuffer::copy(payload)), IPC::File::adopt_fd(pipe_fds[1]));
+        EXPECT_EQ(response->payload(), payload);
+        VERIFY(response->file().has_value());
+
+        EXPECT_EQ(MUST(Core::System::write(response->file()->fd(), "ok"sv.bytes())), 2u);
+        char buffer[2];
+        EXPECT_EQ(MUST(Core::System::read(pipe_fds[0], { buffer, sizeof(buffer) })), 2u);
+        EXPECT_EQ(StringView(buffer, sizeof(buffer)), "ok"sv);
+        MUST(Core::System::close(pipe_fds[0]));
+    }
+}
+
+TEST_CASE(out_of_line_payload_shorter_than_claimed)
+{
+    Core::EventLoop loop;
+    auto server = spawn_echo_server();
+
+    // Claim a much larger payload than the anonymous file holds. The server must refuse to map it,
+    // rather than crashing once it reads past the end of the file. EchoServer checks that it exited cleanly.
+    auto fd = MUST(Core::System::anon_create(4 * KiB, O_CLOEXEC));
+    u32 const message[] = { sizeof(u32) | IPC::out_of_line_message_flag, 1 * MiB };
+    EXPECT_EQ(MUST(server.connection->socket().send_message({ message, sizeof(message) }, 0, { fd })), static_cast<ssize_t>(sizeof(message)));
+    MUST(Core::System::close(fd));
+}
+
+BENCHMARK_CASE(round_trip_latency_and_throughput_by_message_size)
+{
+    Core::EventLoop loop;
+    auto server = spawn_echo_server();
+
+    size_t const sizes[] = { 64, 1 * KiB, 4 * KiB, 16 * KiB, 32 * KiB, 64 * KiB, 256 * KiB, 1 * MiB, 4 * MiB, 16 * MiB };
+    for (auto size : sizes) {
+        auto payload = make_payload(size);
+        size_t iterations = clamp<size_t>(64 * MiB / size, 16, 2000);
+
+        auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+        for (size_t i = 0; i < iterations; ++i)
+            (void)server.connection->round_trip(MUST(ByteBuffer::copy(payload)));
+        auto elapsed_us = max<i64>(timer.elapsed_time().to_microseconds(), 1);
+
+        // Every round trip moves the payload there and back.
+        auto mib_per_second = static_cast<u64>(2 * size * iterations) * 1'000'000 / elapsed_us / MiB;
+        outln("{:>8} bytes: {:>6} us per round trip, {:>5} MiB/s", size, elapsed_us / static_cast<i64>(iterations), mib_per_second);
+    }
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <bits/pthread_cancel.h>
+#include <errno.h>
+#include <sys/event_poll.h>
+#include <syscall.h>
+
+extern "C" {
+
+int create_event_poll(unsigned flags)
+{
+    int rc = syscall(SC_create_event_poll, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_poll_ctl(int event_poll_fd, int op, int fd, struct event_poll_event const* event)
+{
+    Syscall::SC_event_poll_ctl_params params { event_poll_fd, op, fd, event };
+    int rc = syscall(SC_event_poll_ctl, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int event_poll_wait(int event_poll_fd, struct event_poll_event* events, int max_events, struct timespec const* timeout)
+{
+    __pthread_maybe_cancel();
+
+    Syscall::SC_event_poll_wait_params params { event_poll_fd, events, max_events, timeout };
+    int rc = syscall(SC_event_poll_wait, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+}
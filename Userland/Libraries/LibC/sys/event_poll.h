@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/sys/event_poll.h>
+#include <sys/cdefs.h>
+#include <time.h>
+
+__BEGIN_DECLS
+
+int create_event_poll(unsigned flags);
+int event_poll_ctl(int event_poll_fd, int op, int fd, struct event_poll_event const* event);
+int event_poll_wait(int event_poll_fd, struct event_poll_event* events, int max_events, struct timespec const* timeout);
+
+__END_DECLS
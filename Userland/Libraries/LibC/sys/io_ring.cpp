@@ -0,0 +1,29 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <bits/pthread_cancel.h>
+#include <errno.h>
+#include <sys/io_ring.h>
+#include <syscall.h>
+
+extern "C" {
+
+int create_io_ring(unsigned entries, unsigned flags)
+{
+    int rc = syscall(SC_create_io_ring, entries, flags);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+
+int io_ring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, struct timespec const* timeout)
+{
+    if (min_complete > 0)
+        __pthread_maybe_cancel();
+
+    Syscall::SC_io_ring_enter_params params { ring_fd, to_submit, min_complete, timeout };
+    int rc = syscall(SC_io_ring_enter, &params);
+    __RETURN_WITH_ERRNO(rc, rc, -1);
+}
+}
@@ -0,0 +1,18 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <Kernel/API/POSIX/sys/io_ring.h>
+#include <sys/cdefs.h>
+#include <time.h>
+
+__BEGIN_DECLS
+
+int create_io_ring(unsigned entries, unsigned flags);
+int io_ring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, struct timespec const* timeout);
+
+__END_DECLS
@@ -10,13 +10,18 @@
 #include <AK/Time.h>
 #include <AK/WeakPtr.h>
 #include <LibCore/Event.h>
+#include <LibCore/EventLoop.h>
 #include <LibCore/EventLoopImplementationUnix.h>
 #include <LibCore/EventReceiver.h>
 #include <LibCore/Notifier.h>
+#ifdef AK_OS_SERENITY
+#    include <LibCore/IORing.h>
+#endif
 #include <LibCore/Socket.h>
 #include <LibCore/System.h>
 #include <LibCore/ThreadEventQueue.h>
 #include <pthread.h>
+#include <stdlib.h>
 #include <sys/select.h>
 #include <unistd.h>
 
@@ -48,6 +53,20 @@ bool has_flag(int value, int flag)
     return (value & flag) == flag;
 }
 
+NotificationType poll_events_to_notification_type(int revents)
+{
+    NotificationType type = NotificationType::None;
+    if (has_flag(revents, POLLIN))
+        type |= NotificationType::Read;
+    if (has_flag(revents, POLLOUT))
+        type |= NotificationType::Write;
+    if (has_flag(revents, POLLHUP))
+        type |= NotificationType::HangUp;
+    if (has_flag(revents, POLLERR))
+        type |= NotificationType::Error;
+    return type;
+}
+
 class EventLoopTimeout {
 public:
     static constexpr ssize_t INVALID_INDEX = NumericLimits<ssize_t>::max();
@@ -256,6 +275,10 @@ struct ThreadData {
     {
         pid = getpid();
         initialize_wake_pipe();
+#ifdef AK_OS_SERENITY
+        initialize_event_poll();
+        initialize_io_ring();
+#endif
     }
 
     ~ThreadData()
@@ -286,6 +309,83 @@ struct ThreadData {
         notifier_by_index.append(nullptr);
     }
 
+#ifdef AK_OS_SERENITY
+    void initialize_event_poll()
+    {
+        if (event_poll_fd != -1)
+            close(event_poll_fd);
+        event_poll_fd = -1;
+        notifiers_by_fd.clear();
+
+        // If the kernel doesn't give us an event poll, we simply keep using poll().
+        auto result = Core::System::create_event_poll(EVENT_POLL_CLOEXEC);
+        if (result.is_error())
+            return;
+
+        event_poll_event event { .events = POLLIN, .data = static_cast<u64>(wake_pipe_fds[0]) };
+        if (Core::System::event_poll_ctl(result.value(), EVENT_POLL_CTL_ADD, wake_pipe_fds[0], &event).is_error()) {
+            close(result.value());
+            return;
+        }
+        event_poll_fd = result.value();
+    }
+
+    bool uses_event_poll() const { return event_poll_fd != -1; }
+
+    void update_event_poll_interest(int fd, int op)
+    {
+        auto it = notifiers_by_fd.find(fd);
+        if (it == notifiers_by_fd.end()) {
+            // The fd may have been closed already, in which case the kernel has forgotten about it.
+            (void)Core::System::event_poll_ctl(event_poll_fd, EVENT_POLL_CTL_DEL, fd, nullptr);
+            return;
+        }
+
+        event_poll_event event { .events = 0, .data = static_cast<u64>(fd) };
+        for (auto* notifier : it->value)
+            event.events |= notification_type_to_poll_events(notifier->type());
+
+        auto result = Core::System::event_poll_ctl(event_poll_fd, op, fd, &event);
+        // NOTE: A reused fd may still have an entry for its previous file, and an fd whose file is
+        //       gone has no entry at all. Either way, switching the operation does the right thing.
+        if (result.is_error() && op == EVENT_POLL_CTL_ADD && result.error().code() == EEXIST)
+            result = Core::System::event_poll_ctl(event_poll_fd, EVENT_POLL_CTL_MOD, fd, &event);
+        else if (result.is_error() && op == EVENT_POLL_CTL_MOD && result.error().code() == ENOENT)
+            result = Core::System::event_poll_ctl(event_poll_fd, EVENT_POLL_CTL_ADD, fd, &event);
+        if (result.is_error())
+            dbgln("EventLoopImplementationUnix: Failed to update event poll interest for fd {}: {}", fd, result.error());
+    }
+
+    void initialize_io_ring()
+    {
+        io_ring = nullptr;
+        io_completion_callbacks.clear();
+
+        // The I/O ring backend is opt-in for now. It waits for the event poll through the ring,
+        // so that I/O submitted with EventLoopManagerUnix::submit_io() is handled by the same wait.
+        if (!uses_event_poll() || !getenv("LIBCORE_EVENT_LOOP_IO_RING"))
+            return;
+
+        auto result = IORing::create(64);
+        if (result.is_error()) {
+            dbgln("EventLoopImplementationUnix: Failed to create I/O ring: {}", result.error());
+            return;
+        }
+        io_ring = result.release_value();
+        if (auto arm_result = arm_event_poll_in_io_ring(); arm_result.is_error()) {
+            dbgln("EventLoopImplementationUnix: Failed to wait for the event poll in the I/O ring: {}", arm_result.error());
+            io_ring = nullptr;
+        }
+    }
+
+    bool uses_io_ring() const { return io_ring != nullptr; }
+
+    ErrorOr<void> arm_event_poll_in_io_ring()
+    {
+        return io_ring->queue({ .opcode = IO_RING_OP_POLL, .fd = event_poll_fd, .offset = POLLIN, .user_data = event_poll_user_data });
+    }
+#endif
+
     // Each thread has its own timers, notifiers and a wake pipe.
     TimeoutSet timeouts;
 
@@ -293,6 +393,21 @@ struct ThreadData {
     HashMap<Notifier*, size_t> notifier_by_ptr;
     Vector<Notifier*> notifier_by_index;
 
+#ifdef AK_OS_SERENITY
+    // When the kernel supports it, notifiers live in a persistent event poll interest set instead of poll_fds,
+    // so waiting doesn't have to hand every watched fd to the kernel again. Several notifiers may share an fd.
+    int event_poll_fd { -1 };
+    HashMap<int, Vector<Notifier*, 1>> notifiers_by_fd;
+    Array<event_poll_event, 64> ready_events;
+
+    // With an I/O ring, waiting means waiting for its completions. One of them is always a POLL
+    // on the event poll, and the others finish I/O that was submitted with a callback.
+    static constexpr u64 event_poll_user_data = 0;
+    OwnPtr<IORing> io_ring;
+    HashMap<u64, Function<void(i64)>> io_completion_callbacks;
+    u64 next_io_user_data { event_poll_user_data + 1 };
+#endif
+
     // The wake pipe is used to notify another event loop that someone has called wake(), or a signal has been received.
     // wake() writes 0i32 into the pipe, signals write the signal number (guaranteed non-zero).
     Array<int, 2> wake_pipe_fds { -1, -1 };
@@ -383,7 +498,39 @@ retry:
 
 try_select_again:
     // select() and wait for file system events, calls to wake(), POSIX signals, or timer expirations.
-    ErrorOr<int> error_or_marked_fd_count = System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout);
+    auto error_or_marked_fd_count = [&]() -> ErrorOr<size_t> {
+#ifdef AK_OS_SERENITY
+        if (thread_data.uses_io_ring()) {
+            auto timeout_spec = Duration::from_milliseconds(timeout).to_timespec();
+            TRY(thread_data.io_ring->submit_and_wait(1, should_wait_forever ? nullptr : &timeout_spec));
+
+            bool event_poll_is_ready = false;
+            thread_data.io_ring->for_each_completion([&](io_ring_completion const& completion) {
+                if (completion.user_data == ThreadData::event_poll_user_data) {
+                    event_poll_is_ready = true;
+                    return;
+                }
+                auto callback = thread_data.io_completion_callbacks.take(completion.user_data);
+                if (!callback.has_value())
+                    return;
+                deferred_invoke([callback = callback.release_value(), result = completion.result]() mutable {
+                    callback(result);
+                });
+            });
+            if (!event_poll_is_ready)
+                return 0;
+
+            TRY(thread_data.arm_event_poll_in_io_ring());
+            auto no_timeout = Duration::zero().to_timespec();
+            return System::event_poll_wait(thread_data.event_poll_fd, thread_data.ready_events, &no_timeout);
+        }
+        if (thread_data.uses_event_poll()) {
+            auto timeout_spec = Duration::from_milliseconds(timeout).to_timespec();
+            return System::event_poll_wait(thread_data.event_poll_fd, thread_data.ready_events, should_wait_forever ? nullptr : &timeout_spec);
+        }
+#endif
+        return static_cast<size_t>(TRY(System::poll(thread_data.poll_fds, should_wait_forever ? -1 : timeout)));
+    }();
     auto time_after_poll = MonotonicTime::now_coarse();
     // Because POSIX, we might spuriously return from select() with EINTR; just select again.
     if (error_or_marked_fd_count.is_error()) {
@@ -392,10 +539,24 @@ try_select_again:
         dbgln("EventLoopImplementationUnix::wait_for_events: {}", error_or_marked_fd_count.error());
         VERIFY_NOT_REACHED();
     }
+    auto marked_fd_count = error_or_marked_fd_count.value();
+
+    bool wake_pipe_is_readable = [&] {
+#ifdef AK_OS_SERENITY
+        if (thread_data.uses_event_poll()) {
+            for (size_t i = 0; i < marked_fd_count; ++i) {
+                if (static_cast<int>(thread_data.ready_events[i].data) == thread_data.wake_pipe_fds[0])
+                    return true;
+            }
+            return false;
+        }
+#endif
+        return has_flag(thread_data.poll_fds[0].revents, POLLIN);
+    }();
 
     // We woke up due to a call to wake() or a POSIX signal.
     // Handle signals and see whether we need to handle events as well.
-    if (has_flag(thread_data.poll_fds[0].revents, POLLIN)) {
+    if (wake_pipe_is_readable) {
         int wake_events[8];
         ssize_t nread;
         // We might receive another signal while read()ing here. The signal will go to the handle_signal properly,
@@ -424,21 +585,33 @@ try_select_again:
             goto retry;
     }
 
-    if (error_or_marked_fd_count.value() != 0) {
+#ifdef AK_OS_SERENITY
+    if (thread_data.uses_event_poll()) {
+        // Handle file system notifiers by making them normal events.
+        for (size_t i = 0; i < marked_fd_count; ++i) {
+            auto& event = thread_data.ready_events[i];
+            auto it = thread_data.notifiers_by_fd.find(static_cast<int>(event.data));
+            if (it == thread_data.notifiers_by_fd.end())
+                continue;
+
+            auto type = poll_events_to_notification_type(event.events);
+            for (auto* notifier : it->value) {
+                auto notifier_type = type & notifier->type();
+                if (notifier_type != NotificationType::None)
+                    ThreadEventQueue::current().post_event(*notifier, make<NotifierActivationEvent>(notifier->fd(), notifier_type));
+            }
+        }
+    }
+#endif
+
+    // NOTE: When an event poll is in use, poll_fds only ever contains the wake pipe.
+    if (marked_fd_count != 0) {
         // Handle file system notifiers by making them normal events.
         for (size_t i = 1; i < thread_data.poll_fds.size(); ++i) {
             auto& revents = thread_data.poll_fds[i].revents;
             auto& notifier = *thread_data.notifier_by_index[i];
 
-            NotificationType type = NotificationType::None;
-            if (has_flag(revents, POLLIN))
-                type |= NotificationType::Read;
-            if (has_flag(revents, POLLOUT))
-                type |= NotificationType::Write;
-            if (has_flag(revents, POLLHUP))
-                type |= NotificationType::HangUp;
-            if (has_flag(revents, POLLERR))
-                type |= NotificationType::Error;
+            auto type = poll_events_to_notification_type(revents);
             type &= notifier.type();
             if (type != NotificationType::None)
                 ThreadEventQueue::current().post_event(notifier, make<NotifierActivationEvent>(notifier.fd(), type));
@@ -524,6 +697,12 @@ void EventLoopImplementationUnix::notify_forked_and_in_child()
     thread_data.notifier_by_ptr.clear();
     thread_data.notifier_by_index.clear();
     thread_data.initialize_wake_pipe();
+#ifdef AK_OS_SERENITY
+    // The event poll is shared with our parent, so we need one of our own.
+    thread_data.initialize_event_poll();
+    // Rings only work for the process that created them.
+    thread_data.initialize_io_ring();
+#endif
     if (auto* info = signals_info<false>()) {
         info->signal_handlers.clear();
         info->next_signal_id = 0;
@@ -674,10 +853,35 @@ void EventLoopManagerUnix::unregister_timer(intptr_t timer_id)
     }
 }
 
+#ifdef AK_OS_SERENITY
+ErrorOr<void> EventLoopManagerUnix::submit_io(io_ring_submission submission, Function<void(i64)>&& on_completion)
+{
+    auto& thread_data = ThreadData::the();
+    if (!thread_data.uses_io_ring())
+        return Error::from_errno(ENOTSUP);
+
+    submission.user_data = thread_data.next_io_user_data++;
+    TRY(thread_data.io_completion_callbacks.try_ensure_capacity(thread_data.io_completion_callbacks.size() + 1));
+    TRY(thread_data.io_ring->queue(submission));
+    thread_data.io_completion_callbacks.set(submission.user_data, move(on_completion));
+    return {};
+}
+#endif
+
 void EventLoopManagerUnix::register_notifier(Notifier& notifier)
 {
     auto& thread_data = ThreadData::the();
 
+#ifdef AK_OS_SERENITY
+    if (thread_data.uses_event_poll()) {
+        auto& notifiers = thread_data.notifiers_by_fd.ensure(notifier.fd());
+        notifiers.append(&notifier);
+        thread_data.update_event_poll_interest(notifier.fd(), notifiers.size() == 1 ? EVENT_POLL_CTL_ADD : EVENT_POLL_CTL_MOD);
+        notifier.set_owner_thread(s_thread_id);
+        return;
+    }
+#endif
+
     thread_data.notifier_by_ptr.set(&notifier, thread_data.poll_fds.size());
     thread_data.notifier_by_index.append(&notifier);
     thread_data.poll_fds.append({
@@ -696,6 +900,19 @@ void EventLoopManagerUnix::unregister_notifier(Notifier& notifier)
         return;
 
     auto& thread_data = *thread_data_ptr;
+
+#ifdef AK_OS_SERENITY
+    if (thread_data.uses_event_poll()) {
+        auto it = thread_data.notifiers_by_fd.find(notifier.fd());
+        VERIFY(it != thread_data.notifiers_by_fd.end());
+        VERIFY(it->value.remove_first_matching([&](auto* registered_notifier) { return registered_notifier == &notifier; }));
+        if (it->value.is_empty())
+            thread_data.notifiers_by_fd.remove(it);
+        thread_data.update_event_poll_interest(notifier.fd(), EVENT_POLL_CTL_MOD);
+        return;
+    }
+#endif
+
     auto it = thread_data.notifier_by_ptr.find(&notifier);
     VERIFY(it != thread_data.notifier_by_ptr.end());
 
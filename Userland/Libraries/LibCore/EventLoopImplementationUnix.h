@@ -11,6 +11,10 @@
 #include <AK/Time.h>
 #include <LibCore/EventLoopImplementation.h>
 
+#ifdef AK_OS_SERENITY
+#    include <sys/io_ring.h>
+#endif
+
 namespace Core {
 
 class EventLoopManagerUnix final : public EventLoopManager {
@@ -33,6 +37,13 @@ public:
     void wait_for_events(EventLoopImplementation::PumpMode);
     static Optional<MonotonicTime> get_next_timer_expiration();
 
+#ifdef AK_OS_SERENITY
+    // Hands the submission to the current thread's I/O ring, and calls `on_completion` with its result
+    // (or a negated errno code) from the event loop. Fails with ENOTSUP if the event loop has no ring.
+    // NOTE: `on_completion` is only moved from if this succeeds.
+    static ErrorOr<void> submit_io(io_ring_submission, Function<void(i64)>&& on_completion);
+#endif
+
 private:
     void dispatch_signal(int signal_number);
     static void handle_signal(int signal_number);
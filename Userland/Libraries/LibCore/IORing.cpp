@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#include <AK/ScopeGuard.h>
+#include <LibCore/IORing.h>
+#include <LibCore/System.h>
+#include <sys/mman.h>
+
+namespace Core {
+
+ErrorOr<NonnullOwnPtr<IORing>> IORing::create(unsigned entries)
+{
+    int fd = TRY(System::create_io_ring(entries, IO_RING_CLOEXEC));
+    ArmedScopeGuard close_fd = [fd] { (void)System::close(fd); };
+
+    // The header tells us how big the whole mapping is, so map just that first.
+    auto* header_mapping = TRY(System::mmap(nullptr, PAGE_SIZE, PROT_READ, MAP_SHARED, fd, 0, 0, "IORing"sv));
+    size_t mapping_size = static_cast<io_ring_header const*>(header_mapping)->mapping_size;
+    TRY(System::munmap(header_mapping, PAGE_SIZE));
+
+    auto* mapping = TRY(System::mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0, 0, "IORing"sv));
+    auto ring = adopt_nonnull_own_or_enomem(new (nothrow) IORing(fd, mapping, mapping_size));
+    if (ring.is_error()) {
+        (void)System::munmap(mapping, mapping_size);
+        return ring.release_error();
+    }
+    close_fd.disarm();
+    return ring.release_value();
+}
+
+IORing::IORing(int fd, void* mapping, size_t mapping_size)
+    : m_fd(fd)
+    , m_mapping(mapping)
+    , m_mapping_size(mapping_size)
+    , m_header(static_cast<io_ring_header*>(mapping))
+    , m_submissions(reinterpret_cast<io_ring_submission*>(static_cast<u8*>(mapping) + m_header->submissions_offset))
+    , m_completions(reinterpret_cast<io_ring_completion*>(static_cast<u8*>(mapping) + m_header->completions_offset))
+{
+}
+
+IORing::~IORing()
+{
+    (void)System::munmap(m_mapping, m_mapping_size);
+    (void)System::close(m_fd);
+}
+
+ErrorOr<void> IORing::queue(io_ring_submission const& submission)
+{
+    auto head = AK::atomic_load(&m_header->submission_head, AK::memory_order_acquire);
+    auto tail = AK::atomic_load(&m_header->submission_tail, AK::memory_order_relaxed);
+    if (tail - head >= m_header->submission_entries)
+        return Error::from_errno(ENOSPC);
+    m_submissions[tail & (m_header->submission_entries - 1)] = submission;
+    AK::atomic_store(&m_header->submission_tail, tail + 1, AK::memory_order_release);
+    ++m_queued_count;
+    return {};
+}
+
+ErrorOr<size_t> IORing::submit_and_wait(unsigned min_complete, struct timespec const* timeout)
+{
+    auto submitted_count = TRY(System::io_ring_enter(m_fd, m_queued_count, min_complete, timeout));
+    m_queued_count -= min(submitted_count, m_queued_count);
+    return submitted_count;
+}
+
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026, the SerenityOS developers.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause
+ */
+
+#pragma once
+
+#include <AK/Atomic.h>
+#include <AK/Error.h>
+#include <AK/Noncopyable.h>
+#include <AK/NonnullOwnPtr.h>
+#include <sys/io_ring.h>
+
+namespace Core {
+
+// A thin wrapper around a kernel I/O ring: submissions are queued in shared memory and handed
+// to the kernel in batches by submit_and_wait(), which also waits for their completions.
+class IORing {
+    AK_MAKE_NONCOPYABLE(IORing);
+    AK_MAKE_NONMOVABLE(IORing);
+
+public:
+    static ErrorOr<NonnullOwnPtr<IORing>> create(unsigned entries);
+    ~IORing();
+
+    int fd() const { return m_fd; }
+
+    // Fails with ENOSPC if the submission queue is full.
+    ErrorOr<void> queue(io_ring_submission const&);
+    size_t queued_count() const { return m_queued_count; }
+
+    // Submits everything that was queued, and waits for at least `min_complete` completions.
+    ErrorOr<size_t> submit_and_wait(unsigned min_complete, struct timespec const* timeout);
+
+    template<typename Callback>
+    void for_each_completion(Callback callback)
+    {
+        auto head = AK::atomic_load(&m_header->completion_head, AK::memory_order_relaxed);
+        auto tail = AK::atomic_load(&m_header->completion_tail, AK::memory_order_acquire);
+        for (; head != tail; ++head) {
+            auto completion = m_completions[head & (m_header->completion_entries - 1)];
+            // NOTE: Hand the slot back before running the callback, as it might queue more work.
+            AK::atomic_store(&m_header->completion_head, head + 1, AK::memory_order_release);
+            callback(completion);
+        }
+    }
+
+private:
+    IORing(int fd, void* mapping, size_t mapping_size);
+
+    int m_fd { -1 };
+    void* m_mapping { nullptr };
+    size_t m_mapping_size { 0 };
+    io_ring_header* m_header { nullptr };
+    io_ring_submission* m_submissions { nullptr };
+    io_ring_completion* m_completions { nullptr };
+    size_t m_queued_count { 0 };
+};
+
+}
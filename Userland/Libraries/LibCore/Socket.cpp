@@ -6,6 +6,8 @@
  */
 
 #include <AK/Coroutine.h>
+#include <LibCore/EventLoop.h>
+#include <LibCore/EventLoopImplementationUnix.h>
 #include <LibCore/Socket.h>
 #include <LibCore/System.h>
 
@@ -13,6 +15,20 @@ namespace Core {
 
 static constexpr size_t MAX_LOCAL_SOCKET_TRANSFER_FDS = 64;
 
+void Socket::async_read_some(Bytes buffer, Function<void(ErrorOr<Bytes>)> on_completion)
+{
+    deferred_invoke([result = read_some(buffer), on_completion = move(on_completion)]() mutable {
+        on_completion(move(result));
+    });
+}
+
+void Socket::async_write_some(ReadonlyBytes buffer, Function<void(ErrorOr<size_t>)> on_completion)
+{
+    deferred_invoke([result = write_some(buffer), on_completion = move(on_completion)]() mutable {
+        on_completion(move(result));
+    });
+}
+
 ErrorOr<int> Socket::create_fd(SocketDomain domain, SocketType type)
 {
     int socket_domain;
@@ -134,6 +150,67 @@ ErrorOr<size_t> PosixSocketHelper::write(ReadonlyBytes buffer, int flags)
     return TRY(System::send(m_fd, buffer.data(), buffer.size(), flags));
 }
 
+void PosixSocketHelper::async_read(Bytes buffer, int flags, Function<void(ErrorOr<Bytes>)> on_completion)
+{
+    Function<void(i64)> on_io_completion = [buffer, on_completion = move(on_completion)](i64 result) {
+        if (result < 0)
+            on_completion(Error::from_errno(-result));
+        else
+            on_completion(buffer.trim(result));
+    };
+
+#ifdef AK_OS_SERENITY
+    if (is_open()) {
+        io_ring_submission submission {
+            .opcode = IO_RING_OP_RECV,
+            .fd = m_fd,
+            .address = reinterpret_cast<FlatPtr>(buffer.data()),
+            .length = buffer.size(),
+            .flags = static_cast<u32>(flags),
+        };
+        if (!EventLoopManagerUnix::submit_io(submission, move(on_io_completion)).is_error())
+            return;
+    }
+#endif
+
+    // Without an I/O ring, read right away and report back from the event loop just like the ring would.
+    auto result = read(buffer, flags);
+    i64 io_result = result.is_error() ? -static_cast<i64>(result.error().code()) : static_cast<i64>(result.value().size());
+    deferred_invoke([io_result, on_io_completion = move(on_io_completion)] {
+        on_io_completion(io_result);
+    });
+}
+
+void PosixSocketHelper::async_write(ReadonlyBytes buffer, int flags, Function<void(ErrorOr<size_t>)> on_completion)
+{
+    Function<void(i64)> on_io_completion = [on_completion = move(on_completion)](i64 result) {
+        if (result < 0)
+            on_completion(Error::from_errno(-result));
+        else
+            on_completion(static_cast<size_t>(result));
+    };
+
+#ifdef AK_OS_SERENITY
+    if (is_open()) {
+        io_ring_submission submission {
+            .opcode = IO_RING_OP_SEND,
+            .fd = m_fd,
+            .address = reinterpret_cast<FlatPtr>(buffer.data()),
+            .length = buffer.size(),
+            .flags = static_cast<u32>(flags),
+        };
+        if (!EventLoopManagerUnix::submit_io(submission, move(on_io_completion)).is_error())
+            return;
+    }
+#endif
+
+    auto result = write(buffer, flags);
+    i64 io_result = result.is_error() ? -static_cast<i64>(result.error().code()) : static_cast<i64>(result.value());
+    deferred_invoke([io_result, on_io_completion = move(on_io_completion)] {
+        on_io_completion(io_result);
+    });
+}
+
 void PosixSocketHelper::close()
 {
     if (!is_open()) {
@@ -239,6 +316,13 @@ ErrorOr<NonnullOwnPtr<TCPSocket>> TCPSocket::adopt_fd(int fd)
     return socket;
 }
 
+Optional<int> TCPSocket::fd() const
+{
+    if (!is_open())
+        return {};
+    return m_helper.fd();
+}
+
 ErrorOr<size_t> PosixSocketHelper::pending_bytes() const
 {
     if (!is_open()) {
@@ -56,6 +56,15 @@ public:
     /// Conversely, set_notifications_enabled(true) will re-enable notifications.
     virtual void set_notifications_enabled(bool) { }
 
+    /// Reads some data into the buffer, and calls on_completion with the
+    /// result from the event loop. The buffer has to stay alive until then.
+    /// When the event loop is backed by an I/O ring, the kernel performs the
+    /// read once data arrives. Otherwise, the read happens right away, and
+    /// fails with EAGAIN if a non-blocking socket has no data yet.
+    virtual void async_read_some(Bytes, Function<void(ErrorOr<Bytes>)> on_completion);
+    /// Like async_read_some(), but for writing.
+    virtual void async_write_some(ReadonlyBytes, Function<void(ErrorOr<size_t>)> on_completion);
+
     // FIXME: This will need to be updated when IPv6 socket arrives. Perhaps a
     //        base class for all address types is appropriate.
     static ErrorOr<IPv4Address> resolve_host(ByteString const&, SocketType);
@@ -133,6 +142,10 @@ public:
     ErrorOr<Bytes> read(Bytes, int flags);
     ErrorOr<size_t> write(ReadonlyBytes, int flags);
 
+    // NOTE: Reads that go through an I/O ring don't update is_eof(), a result of zero bytes means EOF there.
+    void async_read(Bytes, int flags, Function<void(ErrorOr<Bytes>)> on_completion);
+    void async_write(ReadonlyBytes, int flags, Function<void(ErrorOr<size_t>)> on_completion);
+
     bool is_eof() const { return !is_open() || m_last_read_was_eof; }
     void did_reach_eof_on_read();
     bool is_open() const { return m_fd != -1; }
@@ -183,6 +196,8 @@ public:
 
     virtual ErrorOr<Bytes> read_some(Bytes buffer) override { return m_helper.read(buffer, default_flags()); }
     virtual ErrorOr<size_t> write_some(ReadonlyBytes buffer) override { return m_helper.write(buffer, default_flags()); }
+    virtual void async_read_some(Bytes buffer, Function<void(ErrorOr<Bytes>)> on_completion) override { m_helper.async_read(buffer, default_flags(), move(on_completion)); }
+    virtual void async_write_some(ReadonlyBytes buffer, Function<void(ErrorOr<size_t>)> on_completion) override { m_helper.async_write(buffer, default_flags(), move(on_completion)); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.is_open(); }
     virtual void close() override { m_helper.close(); }
@@ -196,6 +211,8 @@ public:
     ErrorOr<void> set_blocking(bool enabled) override { return m_helper.set_blocking(enabled); }
     ErrorOr<void> set_close_on_exec(bool enabled) override { return m_helper.set_close_on_exec(enabled); }
 
+    Optional<int> fd() const;
+
     virtual ~TCPSocket() override { close(); }
 
 private:
@@ -316,6 +333,8 @@ public:
 
     virtual ErrorOr<Bytes> read_some(Bytes buffer) override { return m_helper.read(buffer, default_flags()); }
     virtual ErrorOr<size_t> write_some(ReadonlyBytes buffer) override { return m_helper.write(buffer, default_flags()); }
+    virtual void async_read_some(Bytes buffer, Function<void(ErrorOr<Bytes>)> on_completion) override { m_helper.async_read(buffer, default_flags(), move(on_completion)); }
+    virtual void async_write_some(ReadonlyBytes buffer, Function<void(ErrorOr<size_t>)> on_completion) override { m_helper.async_write(buffer, default_flags(), move(on_completion)); }
     virtual bool is_eof() const override { return m_helper.is_eof(); }
     virtual bool is_open() const override { return m_helper.is_open(); }
     virtual void close() override { m_helper.close(); }
@@ -433,6 +452,12 @@ public:
 
     virtual size_t buffer_size() const override { return m_helper.buffer_size(); }
 
+    Optional<int> fd() const
+    requires(requires(T const& socket) { socket.fd(); })
+    {
+        return m_helper.stream().fd();
+    }
+
     virtual ~BufferedSocket() override = default;
 
 private:
@@ -550,7 +550,8 @@ ErrorOr<int> anon_create([[maybe_unused]] size_t size, [[maybe_unused]] int opti
     fd = ::anon_create(round_up_to_power_of_two(size, PAGE_SIZE), options);
 #elif defined(AK_OS_LINUX) || defined(AK_OS_FREEBSD)
     // FIXME: Support more options on Linux.
-    auto linux_options = ((options & O_CLOEXEC) > 0) ? MFD_CLOEXEC : 0;
+    // NOTE: Allowing seals lets the owner of the file promise whoever it shares it with that it won't change anymore.
+    auto linux_options = (((options & O_CLOEXEC) > 0) ? MFD_CLOEXEC : 0) | MFD_ALLOW_SEALING;
     fd = memfd_create("", linux_options);
     if (fd < 0)
         return Error::from_errno(errno);
@@ -1778,6 +1779,53 @@ ErrorOr<int> poll(Span<struct pollfd> poll_fds, int timeout)
 }
 
 #ifdef AK_OS_SERENITY
+ErrorOr<int> create_event_poll(unsigned flags)
+{
+    int fd = ::create_event_poll(flags);
+    if (fd < 0)
+        return Error::from_syscall("create_event_poll"sv, -errno);
+    return fd;
+}
+
+ErrorOr<void> event_poll_ctl(int event_poll_fd, int op, int fd, struct event_poll_event const* event)
+{
+    if (::event_poll_ctl(event_poll_fd, op, fd, event) < 0)
+        return Error::from_syscall("event_poll_ctl"sv, -errno);
+    return {};
+}
+
+ErrorOr<size_t> event_poll_wait(int event_poll_fd, Span<struct event_poll_event> events, struct timespec const* timeout)
+{
+    int rc = ::event_poll_wait(event_poll_fd, events.data(), events.size(), timeout);
+    if (rc < 0)
+        return Error::from_syscall("event_poll_wait"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
+ErrorOr<int> create_io_ring(unsigned entries, unsigned flags)
+{
+    int fd = ::create_io_ring(entries, flags);
+    if (fd < 0)
+        return Error::from_syscall("create_io_ring"sv, -errno);
+    return fd;
+}
+
+ErrorOr<size_t> io_ring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, struct timespec const* timeout)
+{
+    int rc = ::io_ring_enter(ring_fd, to_submit, min_complete, timeout);
+    if (rc < 0)
+        return Error::from_syscall("io_ring_enter"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count)
+{
+    ssize_t rc = ::sendfile(out_fd, in_fd, offset, count);
+    if (rc < 0)
+        return Error::from_syscall("sendfile"sv, -errno);
+    return static_cast<size_t>(rc);
+}
+
 ErrorOr<void> posix_fallocate(int fd, off_t offset, off_t length)
 {
     int rc = ::posix_fallocate(fd, offset, length);
@@ -47,6 +47,9 @@
 
 #ifdef AK_OS_SERENITY
 #    include <Kernel/API/Unshare.h>
+#    include <sys/event_poll.h>
+#    include <sys/io_ring.h>
+#    include <sys/sendfile.h>
 #endif
 
 namespace Core::System {
@@ -244,6 +247,15 @@ ErrorOr<void> access(StringView pathname, int mode, int flags = 0);
 ErrorOr<ByteString> readlink(StringView pathname);
 ErrorOr<int> poll(Span<struct pollfd>, int timeout);
 
+#ifdef AK_OS_SERENITY
+ErrorOr<int> create_event_poll(unsigned flags);
+ErrorOr<void> event_poll_ctl(int event_poll_fd, int op, int fd, struct event_poll_event const* event);
+ErrorOr<size_t> event_poll_wait(int event_poll_fd, Span<struct event_poll_event>, struct timespec const* timeout);
+ErrorOr<int> create_io_ring(unsigned entries, unsigned flags);
+ErrorOr<size_t> io_ring_enter(int ring_fd, unsigned to_submit, unsigned min_complete, struct timespec const* timeout);
+ErrorOr<size_t> sendfile(int out_fd, int in_fd, off_t* offset, size_t count);
+#endif
+
 #ifdef AK_OS_SERENITY
 ErrorOr<void> create_block_device(StringView name, mode_t mode, unsigned major, unsigned minor);
 ErrorOr<void> create_char_device(StringView name, mode_t mode, unsigned major, unsigned minor);
@@ -5,11 +5,13 @@
  * SPDX-License-Identifier: BSD-2-Clause
  */
 
+#include <LibCore/MappedFile.h>
 #include <LibCore/System.h>
 #include <LibIPC/Connection.h>
 #include <LibIPC/File.h>
 #include <LibIPC/Stub.h>
 #include <sys/select.h>
+#include <sys/stat.h>
 
 namespace IPC {
 
@@ -187,6 +189,44 @@ ErrorOr<void> ConnectionBase::drain_messages_from_peer()
     return {};
 }
 
+ErrorOr<ConnectionBase::OutOfLinePayload> ConnectionBase::take_out_of_line_payload(ReadonlyBytes size_bytes)
+{
+    u32 payload_size = 0;
+    if (size_bytes.size() != sizeof(payload_size))
+        return Error::from_string_literal("Invalid out-of-line message header");
+    memcpy(&payload_size, size_bytes.data(), sizeof(payload_size));
+    if (payload_size == 0)
+        return Error::from_string_literal("Invalid out-of-line message header");
+
+    // The sender passes the anonymous file before the message's own file descriptors, and all earlier
+    // messages have already taken theirs, so it's the first one in the queue.
+    if (m_unprocessed_fds.is_empty())
+        return Error::from_string_literal("Out-of-line message is missing its file descriptor");
+    auto file = m_unprocessed_fds.dequeue();
+
+    // NOTE: The peer decides which file this is and how large the payload is. If the file were shorter than
+    //       that, or could be shrunk after we've checked it, we would crash while decoding from the mapping.
+    auto stat = TRY(Core::System::fstat(file.fd()));
+    if (!S_ISREG(stat.st_mode) || static_cast<u64>(stat.st_size) < payload_size)
+        return Error::from_string_literal("Out-of-line message payload is not an anonymous file of the right size");
+#if defined(AK_OS_LINUX)
+    // Only memfds can be sealed, and the seals also keep the peer from modifying the payload while we decode it.
+    auto seals = TRY(Core::System::fcntl(file.fd(), F_GET_SEALS));
+    if ((seals & out_of_line_payload_seals) != out_of_line_payload_seals)
+        return Error::from_string_literal("Out-of-line message payload is not sealed");
+#elif defined(AK_OS_SERENITY)
+    // Anonymous files are the only regular files that aren't backed by an inode, and they can't be resized.
+    if (stat.st_ino != 0)
+        return Error::from_string_literal("Out-of-line message payload is not an anonymous file");
+#endif
+    // FIXME: Without seals, a peer that kept its own mapping of the file could still modify the payload while
+    //        we decode it. Our own sender never does, but decoders must not rely on data staying the same here.
+
+    auto mapping = TRY(Core::MappedFile::map_from_fd_and_close(file.take_fd(), {}));
+    auto bytes = mapping->bytes().trim(payload_size);
+    return OutOfLinePayload { move(mapping), bytes };
+}
+
 OwnPtr<IPC::Message> ConnectionBase::wait_for_specific_endpoint_message_impl(u32 endpoint_magic, int message_id)
 {
     for (;;) {
@@ -12,6 +12,7 @@
 #include <AK/Try.h>
 #include <LibCore/Event.h>
 #include <LibCore/EventLoop.h>
+#include <LibCore/MappedFile.h>
 #include <LibCore/Notifier.h>
 #include <LibCore/Socket.h>
 #include <LibCore/Timer.h>
@@ -71,6 +72,12 @@ protected:
     ErrorOr<void> post_message(MessageBuffer, MessageKind);
     void handle_messages();
 
+    struct OutOfLinePayload {
+        NonnullOwnPtr<Core::MappedFile> mapping;
+        ReadonlyBytes bytes;
+    };
+    ErrorOr<OutOfLinePayload> take_out_of_line_payload(ReadonlyBytes size_bytes);
+
     IPC::Stub& m_local_stub;
 
     NonnullOwnPtr<Core::LocalSocket> m_socket;
@@ -137,11 +144,27 @@ protected:
         u32 message_size = 0;
         for (; index + sizeof(message_size) < bytes.size(); index += message_size) {
             memcpy(&message_size, bytes.data() + index, sizeof(message_size));
+            bool is_out_of_line = message_size & out_of_line_message_flag;
+            message_size &= ~out_of_line_message_flag;
             if (message_size == 0 || bytes.size() - index - sizeof(uint32_t) < message_size)
                 break;
             index += sizeof(message_size);
             auto remaining_bytes = ReadonlyBytes { bytes.data() + index, message_size };
 
+            // Keep the payload of an out-of-line message mapped until we're done decoding it.
+            Optional<OutOfLinePayload> out_of_line_payload;
+            if (is_out_of_line) {
+                auto payload_or_error = take_out_of_line_payload(remaining_bytes);
+                if (payload_or_error.is_error()) {
+                    // We already consumed the header, so there is no way to resynchronize with the stream.
+                    index = bytes.size();
+                    shutdown_with_error(payload_or_error.release_error());
+                    return;
+                }
+                out_of_line_payload = payload_or_error.release_value();
+                remaining_bytes = out_of_line_payload->bytes;
+            }
+
             auto local_message = LocalEndpoint::decode_message(remaining_bytes, m_unprocessed_fds);
             if (!local_message.is_error()) {
                 m_unprocessed_messages.append(local_message.release_value());
@@ -5,8 +5,10 @@
  */
 
 #include <AK/Checked.h>
+#include <LibCore/AnonymousBuffer.h>
 #include <LibCore/EventLoop.h>
 #include <LibCore/Socket.h>
+#include <LibCore/System.h>
 #include <LibIPC/Message.h>
 #include <sched.h>
 
@@ -38,15 +40,52 @@ ErrorOr<void> MessageBuffer::append_file_descriptor(int fd)
     return {};
 }
 
+ErrorOr<void> MessageBuffer::move_payload_out_of_line()
+{
+    auto payload = m_data.span().slice(sizeof(MessageSizeType));
+    Checked<MessageSizeType> checked_payload_size { payload.size() };
+    if (checked_payload_size.has_overflow())
+        return Error::from_string_literal("Message is too large for IPC encoding");
+
+    int fd = -1;
+    {
+        auto buffer = TRY(Core::AnonymousBuffer::create_with_size(payload.size()));
+        memcpy(buffer.data<void>(), payload.data(), payload.size());
+
+        // The buffer closes its own file descriptor, so pass along a duplicate that lives as long as this message.
+        // NOTE: We don't keep our own mapping of the payload around, so we can't change it while the receiver decodes it.
+        fd = TRY(Core::System::dup(buffer.fd()));
+    }
+    auto auto_fd = TRY(adopt_nonnull_ref_or_enomem(new (nothrow) AutoCloseFileDescriptor(fd)));
+
+#if defined(AK_OS_LINUX)
+    // Promise the receiver that the payload can neither shrink nor change under it, which it checks before mapping it.
+    TRY(Core::System::fcntl(fd, F_ADD_SEALS, out_of_line_payload_seals | F_SEAL_SEAL));
+#endif
+
+    TRY(m_fds.try_prepend(move(auto_fd)));
+
+    MessageSizeType const payload_size = checked_payload_size.value();
+    m_data.resize(sizeof(MessageSizeType));
+    TRY(append_data(reinterpret_cast<u8 const*>(&payload_size), sizeof(payload_size)));
+    m_is_out_of_line = true;
+    return {};
+}
+
 ErrorOr<void> MessageBuffer::transfer_message(Core::LocalSocket& socket, bool block_event_loop)
 {
+    if (!m_is_out_of_line && m_data.size() - sizeof(MessageSizeType) >= out_of_line_message_threshold)
+        TRY(move_payload_out_of_line());
+
     Checked<MessageSizeType> checked_message_size { m_data.size() };
     checked_message_size -= sizeof(MessageSizeType);
 
-    if (checked_message_size.has_overflow())
+    if (checked_message_size.has_overflow() || (checked_message_size.value() & out_of_line_message_flag))
         return Error::from_string_literal("Message is too large for IPC encoding");
 
-    MessageSizeType const message_size = checked_message_size.value();
+    MessageSizeType message_size = checked_message_size.value();
+    if (m_is_out_of_line)
+        message_size |= out_of_line_message_flag;
     m_data.span().overwrite(0, reinterpret_cast<u8 const*>(&message_size), sizeof(message_size));
 
     auto raw_fds = Vector<int, 1> {};
@@ -12,10 +12,25 @@
 #include <AK/RefPtr.h>
 #include <AK/Vector.h>
 #include <LibCore/Forward.h>
+#include <fcntl.h>
 #include <unistd.h>
 
 namespace IPC {
 
+// Messages with a payload at least this large don't go through the socket. Their payload is put into an
+// anonymous file instead, and the receiver maps the very same pages. This avoids copying it into and out
+// of the kernel's socket buffers, which are too small to hold such a message in one go anyway.
+static constexpr size_t out_of_line_message_threshold = 32 * KiB;
+
+// Set in the size of a message that was sent out of line. What follows it in the socket is the size of
+// the payload, and the anonymous file is passed before any of the message's own file descriptors.
+static constexpr u32 out_of_line_message_flag = 1u << 31;
+
+#if defined(AK_OS_LINUX)
+// The sender seals the anonymous file with these, so that the receiver can safely map and decode it in place.
+static constexpr int out_of_line_payload_seals = F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE;
+#endif
+
 class AutoCloseFileDescriptor : public RefCounted<AutoCloseFileDescriptor> {
 public:
     AutoCloseFileDescriptor(int fd)
@@ -47,8 +62,11 @@ public:
     ErrorOr<void> transfer_message(Core::LocalSocket& socket, bool block_event_loop = false);
 
 private:
+    ErrorOr<void> move_payload_out_of_line();
+
     Vector<u8, 1024> m_data;
     Vector<NonnullRefPtr<AutoCloseFileDescriptor>, 1> m_fds;
+    bool m_is_out_of_line { false };
 };
 
 enum class ErrorCode : u32 {
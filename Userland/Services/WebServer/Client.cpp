@@ -166,17 +166,17 @@ ErrorOr<bool> Client::handle_request(HTTP::HttpRequest const& request)
         return false;
     }
 
-    auto stream = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
+    auto file = TRY(Core::File::open(real_path.bytes_as_string_view(), Core::File::OpenMode::Read));
 
     auto const info = ContentInfo {
         .type = TRY(String::from_utf8(Core::guess_mime_type_based_on_filename(real_path.bytes_as_string_view()))),
         .length = static_cast<u64>(TRY(FileSystem::size_from_stat(real_path.bytes_as_string_view())))
     };
-    TRY(send_response(*stream, request, move(info)));
+    TRY(send_response(*file, request, move(info), file->fd()));
     return true;
 }
 
-ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info)
+ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& request, ContentInfo content_info, Optional<int> response_fd)
 {
     StringBuilder builder;
     TRY(builder.try_append("HTTP/1.0 200 OK\r\n"sv));
@@ -195,6 +195,26 @@ ErrorOr<void> Client::send_response(Stream& response, HTTP::HttpRequest const& r
     TRY(m_socket->write_until_depleted(builder_contents));
     log_response(200, request);
 
+#ifdef AK_OS_SERENITY
+    // Static files are handed to the kernel, which moves them into the socket without copying them through our buffer.
+    // Whatever it didn't send (if anything) is picked up from the current file offset by the loop below.
+    if (auto socket_fd = m_socket->fd(); response_fd.has_value() && socket_fd.has_value()) {
+        u64 remaining = content_info.length;
+        while (remaining > 0) {
+            auto chunk_size = static_cast<size_t>(min(remaining, static_cast<u64>(NumericLimits<ssize_t>::max())));
+            auto nsent_or_error = Core::System::sendfile(*socket_fd, *response_fd, nullptr, chunk_size);
+            if (nsent_or_error.is_error()) {
+                if (nsent_or_error.error().code() == EINVAL)
+                    break;
+                return nsent_or_error.release_error();
+            }
+            if (nsent_or_error.value() == 0)
+                break;
+            remaining -= nsent_or_error.value();
+        }
+    }
+#endif
+
     char buffer[PAGE_SIZE];
     do {
         auto size = TRY(response.read_some({ buffer, sizeof(buffer) })).size();
@@ -7,6 +7,8 @@
 
 #include <AK/ByteBuffer.h>
 #include <AK/ByteString.h>
+#include <AK/QuickSort.h>
+#include <AK/Random.h>
 #include <AK/ScopeGuard.h>
 #include <AK/Types.h>
 #include <AK/Vector.h>
@@ -15,7 +17,9 @@
 #include <LibCore/System.h>
 #include <LibMain/Main.h>
 #include <fcntl.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -41,6 +45,18 @@ static Result average_result(Vector<Result> const& results)
 
 static ErrorOr<Result> benchmark(ByteString const& filename, int file_size, ByteBuffer& buffer, bool allow_cache);
 
+struct RandomReadResult {
+    u64 reads {};
+    u64 iops {};
+    u64 p50_latency_us {};
+    u64 p90_latency_us {};
+    u64 p99_latency_us {};
+    u64 p999_latency_us {};
+    u64 max_latency_us {};
+};
+
+static ErrorOr<RandomReadResult> random_read_benchmark(int fd, u64 size, size_t block_size, size_t queue_depth, Duration duration);
+
 ErrorOr<int> serenity_main(Main::Arguments arguments)
 {
     using namespace AK::TimeLiterals;
@@ -50,6 +66,8 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     Vector<size_t> file_sizes;
     Vector<size_t> block_sizes;
     bool allow_cache = false;
+    StringView random_read_path;
+    Vector<size_t> queue_depths;
 
     Core::ArgsParser args_parser;
     args_parser.add_option(allow_cache, "Allow using disk cache", "cache", 'c');
@@ -57,10 +75,49 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     args_parser.add_option(time_per_benchmark_sec, "Time elapsed per benchmark (seconds)", "time-per-benchmark", 't', "time-per-benchmark");
     args_parser.add_option(file_sizes, "A comma-separated list of file sizes", "file-size", 'f', "file-size");
     args_parser.add_option(block_sizes, "A comma-separated list of block sizes", "block-size", 'b', "block-size");
+    args_parser.add_option(random_read_path, "Measure random reads from an existing file or block device instead", "random-read", 'r', "path");
+    args_parser.add_option(queue_depths, "A comma-separated list of queue depths for random reads", "queue-depth", 'q', "queue-depth");
     args_parser.parse(arguments);
 
     Duration const time_per_benchmark = Duration::from_seconds(time_per_benchmark_sec);
 
+    if (!random_read_path.is_empty()) {
+        if (queue_depths.is_empty())
+            queue_depths = { 1, 2, 4, 8, 16, 32, 64 };
+        if (block_sizes.is_empty())
+            block_sizes = { 4096 };
+
+        int flags = O_RDONLY;
+        if (!allow_cache)
+            flags |= O_DIRECT;
+        int fd = TRY(Core::System::open(random_read_path, flags));
+        ScopeGuard fd_cleanup = [fd] { (void)Core::System::close(fd); };
+
+        auto stat = TRY(Core::System::fstat(fd));
+        u64 size = stat.st_size;
+        if (S_ISBLK(stat.st_mode))
+            TRY(Core::System::ioctl(fd, STORAGE_DEVICE_GET_SIZE, &size));
+
+        for (auto block_size : block_sizes) {
+            if (block_size > size) {
+                warnln("Block size {} is larger than {}", block_size, random_read_path);
+                continue;
+            }
+            // Devices that can't keep several requests in flight (like AHCI disks without NCQ) stay at about 1.00x here.
+            u64 baseline_iops = 0;
+            for (auto queue_depth : queue_depths) {
+                outln("Running: random reads block_size={} queue_depth={}", block_size, queue_depth);
+                auto result = TRY(random_read_benchmark(fd, size, block_size, queue_depth, time_per_benchmark));
+                if (baseline_iops == 0)
+                    baseline_iops = max<u64>(result.iops, 1);
+                outln("Finished: reads={} iops={} ({}.{:02}x vs. queue_depth={}) p50={}us p90={}us p99={}us p99.9={}us max={}us", result.reads, result.iops,
+                    result.iops / baseline_iops, result.iops * 100 / baseline_iops % 100, queue_depths.first(),
+                    result.p50_latency_us, result.p90_latency_us, result.p99_latency_us, result.p999_latency_us, result.max_latency_us);
+            }
+        }
+        return 0;
+    }
+
     if (file_sizes.size() == 0) {
         file_sizes = { 131072, 262144, 524288, 1048576, 5242880 };
     }
@@ -143,3 +200,83 @@ ErrorOr<Result> benchmark(ByteString const& filename, int file_size, ByteBuffer&
     result.read_bps = (u64)(timer.elapsed_milliseconds() ? (file_size / timer.elapsed_milliseconds()) : file_size) * 1000;
     return result;
 }
+
+ErrorOr<RandomReadResult> random_read_benchmark(int fd, u64 size, size_t block_size, size_t queue_depth, Duration duration)
+{
+    // Each thread keeps exactly one read in flight, so the number of threads is the queue depth the device sees.
+    struct Worker {
+        int fd { -1 };
+        u64 block_count { 0 };
+        size_t block_size { 0 };
+        Duration duration;
+        Core::ElapsedTimer const* timer { nullptr };
+        pthread_t thread {};
+        ByteBuffer buffer;
+        Vector<u32> latencies_us;
+        int error { 0 };
+    };
+    Vector<Worker> workers;
+    TRY(workers.try_resize(queue_depth));
+
+    auto timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+    for (auto& worker : workers) {
+        worker.fd = fd;
+        worker.block_count = size / block_size;
+        worker.block_size = block_size;
+        worker.duration = duration;
+        worker.timer = &timer;
+        worker.buffer = TRY(ByteBuffer::create_uninitialized(block_size));
+    }
+
+    auto run_worker = [](void* argument) -> void* {
+        auto& worker = *static_cast<Worker*>(argument);
+        while (worker.timer->elapsed_time() < worker.duration) {
+            auto offset = AK::get_random_uniform_64(worker.block_count) * worker.block_size;
+            auto read_timer = Core::ElapsedTimer::start_new(Core::TimerType::Precise);
+            if (pread(worker.fd, worker.buffer.data(), worker.block_size, offset) < 0) {
+                worker.error = errno;
+                break;
+            }
+            worker.latencies_us.append(read_timer.elapsed_time().to_microseconds());
+        }
+        return nullptr;
+    };
+
+    size_t started_workers = 0;
+    for (auto& worker : workers) {
+        if (int rc = pthread_create(&worker.thread, nullptr, run_worker, &worker); rc != 0) {
+            for (size_t i = 0; i < started_workers; ++i)
+                pthread_join(workers[i].thread, nullptr);
+            return Error::from_errno(rc);
+        }
+        ++started_workers;
+    }
+
+    for (auto& worker : workers)
+        pthread_join(worker.thread, nullptr);
+    auto elapsed_us = max<i64>(timer.elapsed_time().to_microseconds(), 1);
+
+    Vector<u32> latencies_us;
+    for (auto& worker : workers) {
+        if (worker.error != 0)
+            return Error::from_syscall("pread"sv, -worker.error);
+        TRY(latencies_us.try_extend(worker.latencies_us));
+    }
+
+    RandomReadResult result;
+    if (latencies_us.is_empty())
+        return result;
+
+    quick_sort(latencies_us);
+    auto percentile = [&](size_t per_mille) -> u64 {
+        return latencies_us[min(latencies_us.size() * per_mille / 1000, latencies_us.size() - 1)];
+    };
+    result.reads = latencies_us.size();
+    result.iops = result.reads * 1'000'000 / elapsed_us;
+    result.p50_latency_us = percentile(500);
+    result.p90_latency_us = percentile(900);
+    result.p99_latency_us = percentile(990);
+    result.p999_latency_us = percentile(999);
+    result.max_latency_us = latencies_us.last();
+    return result;
+}
@@ -89,6 +89,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     int local_address_column = -1;
     int peer_address_column = -1;
     int state_column = -1;
+    int congestion_control_column = -1;
+    int congestion_window_column = -1;
+    int rtt_column = -1;
+    int retransmits_column = -1;
     int user_column = -1;
     int program_column = -1;
 
@@ -103,6 +107,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
     local_address_column = add_column("Local Address", Alignment::Left, 22);
     peer_address_column = add_column("Peer Address", Alignment::Left, 22);
     state_column = add_column("State", Alignment::Left, 11);
+    congestion_control_column = flag_extend ? add_column("CC", Alignment::Left, 7) : -1;
+    congestion_window_column = flag_extend ? add_column("Cwnd", Alignment::Right, 8) : -1;
+    rtt_column = flag_extend ? add_column("RTT(ms)", Alignment::Right, 7) : -1;
+    retransmits_column = flag_extend ? add_column("Retrans", Alignment::Right, 7) : -1;
     user_column = flag_extend ? add_column("User", Alignment::Left, 4) : -1;
     program_column = flag_program ? add_column("PID/Program", Alignment::Left, 11) : -1;
 
@@ -248,6 +256,16 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 columns[peer_address_column].buffer = get_formatted_address(peer_address, peer_port);
             if (state_column != -1)
                 columns[state_column].buffer = state;
+            if (congestion_control_column != -1)
+                columns[congestion_control_column].buffer = if_object.get_byte_string("congestion_control"sv).value_or("-");
+            if (congestion_window_column != -1)
+                columns[congestion_window_column].buffer = String::number(if_object.get_u32("congestion_window"sv).value_or(0)).to_byte_string();
+            if (rtt_column != -1) {
+                auto smoothed_rtt_us = if_object.get_u64("smoothed_rtt_us"sv);
+                columns[rtt_column].buffer = smoothed_rtt_us.has_value() ? ByteString::formatted("{}.{:03}", *smoothed_rtt_us / 1000, *smoothed_rtt_us % 1000) : "-";
+            }
+            if (retransmits_column != -1)
+                columns[retransmits_column].buffer = String::number(if_object.get_u32("retransmitted_packets"sv).value_or(0)).to_byte_string();
             if (flag_extend && user_column != -1)
                 columns[user_column].buffer = get_formatted_user(origin_uid).to_byte_string();
             if (flag_program && program_column != -1)
@@ -331,6 +349,10 @@ ErrorOr<int> serenity_main(Main::Arguments arguments)
                 columns[peer_address_column].buffer = get_formatted_address(peer_address, peer_port);
             if (state_column != -1)
                 columns[state_column].buffer = "-";
+            for (auto column : { congestion_control_column, congestion_window_column, rtt_column, retransmits_column }) {
+                if (column != -1)
+                    columns[column].buffer = "-";
+            }
             if (flag_extend && user_column != -1)
                 columns[user_column].buffer = get_formatted_user(origin_uid).to_byte_string();
             if (flag_program && program_column != -1)